@@ -5,7 +5,12 @@ import QtQuick.Layouts
 Item {
     id: dashboardRoot
     
-    property var selectedWidget: null
+    property Item selectedItem: null
+    readonly property var selectedWidget: selectedItem ? selectedItem.config : null
+    // Widgets whose capability feeds one of the controller's bindable
+    // properties (azimuth, ra, ...) bind to it; off, or for any other
+    // capability, they bind through controller.values
+    property bool bindDedicatedProperties: true
     
     Rectangle {
         anchors.fill: parent
@@ -41,46 +46,61 @@ Item {
         }
     }
 
-    // Dynamic Widgets
+    // Dynamic Widgets. The model reports edits per row and role, so moving or
+    // relabelling a widget updates its delegate in place instead of
+    // rebuilding every widget on the dashboard.
     Repeater {
-        model: layout && layout.widgets !== undefined ? layout.widgets : []
+        model: layout ? layout.widgetModel : null
         
         Loader {
             id: widgetLoader
-            x: modelData ? modelData.x : 0
-            y: modelData ? modelData.y : 0
-            source: modelData ? "widgets/" + modelData.type + "Widget.qml" : ""
-            
-            property var widgetData: modelData
+
+            required property string widgetId
+            required property string widgetType
+            required property string label
+            required property real posX
+            required property real posY
+            required property string propertyLink
+            required property var mapping
+            required property var config
+
+            readonly property bool selected: dashboardRoot.selectedItem === widgetLoader
+
+            x: posX
+            y: posY
+            source: widgetType ? "widgets/" + widgetType + "Widget.qml" : ""
             
             onLoaded: {
-                if (!widgetData) return;
-                item.label = widgetData.label || ""
-                item.propertyLink = widgetData.propertyLink || ""
-                item.mapping = widgetData.mapping || ({})
-                item.isSelected = (dashboardRoot.selectedWidget && dashboardRoot.selectedWidget.id === widgetData.id)
+                item.label = Qt.binding(function() { return widgetLoader.label || "" })
+                item.propertyLink = Qt.binding(function() { return widgetLoader.propertyLink })
+                item.mapping = Qt.binding(function() { return widgetLoader.mapping || ({}) })
+                item.isSelected = Qt.binding(function() { return widgetLoader.selected })
                 
                 // Set up data binding
-                if (widgetData.propertyLink) {
-                    setupBinding(item, widgetData.propertyLink, widgetData.mapping)
-                }
+                setupBinding(item, propertyLink, mapping)
             }
 
+            onPropertyLinkChanged: if (item) setupBinding(item, propertyLink, mapping)
+            onMappingChanged: if (item) setupBinding(item, propertyLink, mapping)
+
             DragHandler {
                 enabled: app.editorMode
                 onActiveChanged: {
                     if (!active) {
-                        layout.updateWidget(widgetData.id, {
+                        layout.updateWidget(widgetLoader.widgetId, {
                             "x": widgetLoader.x,
                             "y": widgetLoader.y
                         })
+                        // Dragging replaced the bindings; follow the model again
+                        widgetLoader.x = Qt.binding(function() { return widgetLoader.posX })
+                        widgetLoader.y = Qt.binding(function() { return widgetLoader.posY })
                     }
                 }
             }
 
             TapHandler {
                 enabled: app.editorMode
-                onTapped: dashboardRoot.selectedWidget = widgetData
+                onTapped: dashboardRoot.selectedItem = widgetLoader
             }
 
             // Selection Highlight
@@ -88,19 +108,10 @@ Item {
                 anchors.fill: parent
                 color: "blue"
                 opacity: 0.1
-                visible: app.editorMode && (dashboardRoot.selectedWidget && dashboardRoot.selectedWidget.id === widgetData.id)
+                visible: app.editorMode && widgetLoader.selected
                 border.color: "blue"
                 border.width: 2
             }
-            
-            Connections {
-                target: dashboardRoot
-                function onSelectedWidgetChanged() {
-                    if (widgetLoader.item && widgetData) {
-                        widgetLoader.item.isSelected = (dashboardRoot.selectedWidget && dashboardRoot.selectedWidget.id === widgetData.id)
-                    }
-                }
-            }
         }
     }
 
@@ -116,7 +127,7 @@ Item {
             onClicked: {
                 app.editorMode = !app.editorMode
                 if (!app.editorMode) {
-                    dashboardRoot.selectedWidget = null
+                    dashboardRoot.selectedItem = null
                     app.saveLayout()
                 }
             }
@@ -244,12 +255,13 @@ Item {
                             Label { text: "In Min:"; Layout.preferredWidth: 50 }
                             TextField {
                                 Layout.fillWidth: true
-                                text: (dashboardRoot.selectedWidget && dashboardRoot.selectedWidget.mapping) ? dashboardRoot.selectedWidget.mapping.inMin : "0"
+                                text: (dashboardRoot.selectedWidget && dashboardRoot.selectedWidget.mapping) ? dashboardRoot.selectedWidget.mapping.in_min : "0"
                                 onEditingFinished: {
                                     if (dashboardRoot.selectedWidget && layout) {
-                                        let m = dashboardRoot.selectedWidget.mapping || {}
-                                        m.inMin = parseFloat(text)
-                                        m.type = "linear"
+                                        let m = {"in_min": parseFloat(text)}
+                                        let current = dashboardRoot.selectedWidget.mapping
+                                        if (!current || !current.type || current.type === "none")
+                                            m.type = "linear"
                                         layout.updateWidget(dashboardRoot.selectedWidget.id, {"mapping": m})
                                     }
                                 }
@@ -260,12 +272,13 @@ Item {
                             Label { text: "In Max:"; Layout.preferredWidth: 50 }
                             TextField {
                                 Layout.fillWidth: true
-                                text: (dashboardRoot.selectedWidget && dashboardRoot.selectedWidget.mapping) ? dashboardRoot.selectedWidget.mapping.inMax : "1"
+                                text: (dashboardRoot.selectedWidget && dashboardRoot.selectedWidget.mapping) ? dashboardRoot.selectedWidget.mapping.in_max : "1"
                                 onEditingFinished: {
                                     if (dashboardRoot.selectedWidget && layout) {
-                                        let m = dashboardRoot.selectedWidget.mapping || {}
-                                        m.inMax = parseFloat(text)
-                                        m.type = "linear"
+                                        let m = {"in_max": parseFloat(text)}
+                                        let current = dashboardRoot.selectedWidget.mapping
+                                        if (!current || !current.type || current.type === "none")
+                                            m.type = "linear"
                                         layout.updateWidget(dashboardRoot.selectedWidget.id, {"mapping": m})
                                     }
                                 }
@@ -276,12 +289,13 @@ Item {
                             Label { text: "Out Min:"; Layout.preferredWidth: 50 }
                             TextField {
                                 Layout.fillWidth: true
-                                text: (dashboardRoot.selectedWidget && dashboardRoot.selectedWidget.mapping) ? dashboardRoot.selectedWidget.mapping.outMin : "0"
+                                text: (dashboardRoot.selectedWidget && dashboardRoot.selectedWidget.mapping) ? dashboardRoot.selectedWidget.mapping.out_min : "0"
                                 onEditingFinished: {
                                     if (dashboardRoot.selectedWidget && layout) {
-                                        let m = dashboardRoot.selectedWidget.mapping || {}
-                                        m.outMin = parseFloat(text)
-                                        m.type = "linear"
+                                        let m = {"out_min": parseFloat(text)}
+                                        let current = dashboardRoot.selectedWidget.mapping
+                                        if (!current || !current.type || current.type === "none")
+                                            m.type = "linear"
                                         layout.updateWidget(dashboardRoot.selectedWidget.id, {"mapping": m})
                                     }
                                 }
@@ -292,12 +306,13 @@ Item {
                             Label { text: "Out Max:"; Layout.preferredWidth: 50 }
                             TextField {
                                 Layout.fillWidth: true
-                                text: (dashboardRoot.selectedWidget && dashboardRoot.selectedWidget.mapping) ? dashboardRoot.selectedWidget.mapping.outMax : "1"
+                                text: (dashboardRoot.selectedWidget && dashboardRoot.selectedWidget.mapping) ? dashboardRoot.selectedWidget.mapping.out_max : "1"
                                 onEditingFinished: {
                                     if (dashboardRoot.selectedWidget && layout) {
-                                        let m = dashboardRoot.selectedWidget.mapping || {}
-                                        m.outMax = parseFloat(text)
-                                        m.type = "linear"
+                                        let m = {"out_max": parseFloat(text)}
+                                        let current = dashboardRoot.selectedWidget.mapping
+                                        if (!current || !current.type || current.type === "none")
+                                            m.type = "linear"
                                         layout.updateWidget(dashboardRoot.selectedWidget.id, {"mapping": m})
                                     }
                                 }
@@ -310,8 +325,9 @@ Item {
                             palette.button: "red"
                             onClicked: {
                                 if (dashboardRoot.selectedWidget && layout) {
-                                    layout.removeWidget(dashboardRoot.selectedWidget.id)
-                                    dashboardRoot.selectedWidget = null
+                                    var id = dashboardRoot.selectedWidget.id
+                                    dashboardRoot.selectedItem = null
+                                    layout.removeWidget(id)
                                 }
                             }
                         }
@@ -369,6 +385,9 @@ Item {
     }
 
     function setupBinding(widget, link, mapping) {
+        // Assigning drops the binding to the previous link, so a cleared or
+        // unresolvable link leaves the widget empty instead of still live
+        widget.value = undefined;
         if (!link) return;
         
         var parts = link.split('.');
@@ -380,18 +399,19 @@ Item {
         var controller = app.getController(controllerName);
         if (!controller) return;
 
-        var updateValue = function() {
-            var rawValue = controller.getProperty(propertyName);
-            widget.value = valueMappingEngine.mapValue(rawValue, mapping);
-        };
-
-        updateValue();
-
-        // Use a persistent connection mechanism or handle cleanup
-        controller.propertyChanged.connect(function(name, value) {
-            if (name === propertyName) {
-                widget.value = valueMappingEngine.mapValue(value, mapping);
-            }
-        });
+        // Either source re-evaluates the binding only when that capability
+        // changes; the mapping is compiled once here rather than on every
+        // update
+        var mappingHandle = valueMappingEngine.compile(mapping || {});
+        var dedicated = bindDedicatedProperties ? controller.dedicatedProperty(propertyName) : "";
+        if (dedicated) {
+            widget.value = Qt.binding(function() {
+                return valueMappingEngine.mapWith(mappingHandle, controller[dedicated]);
+            });
+        } else {
+            widget.value = Qt.binding(function() {
+                return valueMappingEngine.mapWith(mappingHandle, controller.values[propertyName]);
+            });
+        }
     }
 }
@@ -1,5 +1,6 @@
 import QtQuick
 import QtQuick3D
+import ObservatoryMonitor
 
 Node {
     id: root
@@ -17,50 +18,76 @@ Node {
     property string propertyLink: ""
     property var mapping: ({})
     
+    // Interpolate between polls using a per-axis alpha-beta predictor
+    property bool smoothing: true
+
     property var targetController: null
     property string targetPropertyName: ""
-    property string targetCommand: ""
+    // Decoded value of the linked capability; re-evaluates only when that
+    // capability changes
+    readonly property var targetValue: targetController && targetPropertyName
+                                       ? targetController.values[targetPropertyName] : undefined
 
     onPropertyLinkChanged: {
         if (!propertyLink) {
             targetController = null;
             targetPropertyName = "";
-            targetCommand = "";
+            predictor.reset();
             return;
         }
         
         var parts = propertyLink.split('.');
         if (parts.length < 2) return;
         
-        var controllerName = parts[0];
         targetPropertyName = parts[1];
-        
-        var propDef = app.caps.getProperty(controllerName, targetPropertyName);
-        targetCommand = propDef ? propDef.command : targetPropertyName;
-        
-        targetController = app.getController(controllerName);
+        targetController = app.getController(parts[0]);
+        lastMapped = undefined;
+        predictor.reset();
         updateValue();
     }
     
-    onMappingChanged: updateValue()
+    // Compiled once per distinct mapping; updates only pass the handle
+    readonly property int mappingHandle: valueMappingEngine.compile(mapping || {})
+
+    // Last mapped value; unwrapped angle mappings continue from it so the
+    // model takes the short way round at 359 -> 0
+    property var lastMapped: undefined
+
+    onMappingHandleChanged: {
+        lastMapped = undefined;
+        predictor.reset();
+        updateValue();
+    }
+
+    onTargetValueChanged: updateValue()
 
     function updateValue() {
-        if (targetController && targetCommand) {
-            var rawValue = targetController.getProperty(targetCommand);
-            root.value = app.valueMappingEngine.mapValue(rawValue, mapping);
+        if (targetValue !== undefined) {
+            lastMapped = valueMappingEngine.mapFrom(mappingHandle, targetValue, lastMapped);
+            applyValue(lastMapped);
         }
     }
 
-    Connections {
-        target: root.targetController
-        ignoreUnknownSignals: true
-        function onPropertyChanged(name, val) {
-            if (name === root.targetCommand || name === root.targetPropertyName) {
-                root.value = app.valueMappingEngine.mapValue(val, root.mapping);
-            }
+    function applyValue(mapped) {
+        var n = Number(mapped);
+        if (root.smoothing && root.type !== PhysicalRelationship.None && isFinite(n)) {
+            predictor.addSample(n);
+        } else {
+            root.value = mapped;
         }
     }
-    
+
+    MotionPredictor {
+        id: predictor
+        wrapPeriod: root.type === PhysicalRelationship.Rotation ? 360 : 0
+        onValueChanged: root.value = value
+    }
+
+    FrameAnimation {
+        running: root.smoothing && predictor.moving
+        onTriggered: predictor.advance()
+    }
+
     onValueChanged: {
         if (Math.abs(value - lastAppliedValue) > 0.0001) {
             updateTransform();
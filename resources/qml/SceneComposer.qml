@@ -1,10 +1,12 @@
 import QtQuick
+import QtQml.Models
 import QtQuick3D
 
 Node {
     id: root
     
-    property var sceneNodes: []
+    // LayoutConfig.sceneModel: one delegate per node, nested like the scene
+    property var sceneModel: null
     
     // Shared materials to reduce draw calls and memory
     property PrincipledMaterial defaultMaterial: PrincipledMaterial {
@@ -18,40 +20,36 @@ Node {
     property PrincipledMaterial zMaterial: PrincipledMaterial { baseColor: "blue"; lighting: PrincipledMaterial.NoLighting }
     property PrincipledMaterial selectionMaterial: PrincipledMaterial { baseColor: "yellow"; lighting: PrincipledMaterial.NoLighting }
 
-    // Pre-calculate children map for O(1) lookup during tree traversal
-    property var childrenMap: {
-        let map = {};
-        if (sceneNodes) {
-            for (let i = 0; i < sceneNodes.length; i++) {
-                let node = sceneNodes[i];
-                let p = node.parent || "";
-                if (!map[p]) map[p] = [];
-                map[p].push(node);
-            }
-        }
-        return map;
-    }
-    
-    // Root nodes (those with empty or missing parent)
+    // Root nodes (those with empty or missing parent). Each SceneNode hosts
+    // the same kind of model for its own children, so an edit reaches only
+    // the delegate of the node it changes.
     Instantiator {
-        model: root.childrenMap[""] || []
-        
-        delegate: Loader {
-            source: "SceneNode.qml"
-            onLoaded: {
-                if (item) {
-                    item.parent = root
-                    item.nodeData = Qt.binding(function() { return modelData })
-                    item.childrenMap = Qt.binding(function() { return root.childrenMap })
-                    item.sharedMaterials = Qt.binding(function() {
-                        return {
-                            "default": root.defaultMaterial,
-                            "x": root.xMaterial,
-                            "y": root.yMaterial,
-                            "z": root.zMaterial,
-                            "selection": root.selectionMaterial
-                        }
-                    })
+        model: DelegateModel {
+            id: rootNodes
+            model: root.sceneModel
+
+            delegate: Loader {
+                id: nodeLoader
+                required property int index
+                required property var config
+
+                source: "SceneNode.qml"
+                onLoaded: {
+                    if (item) {
+                        item.parent = root
+                        item.nodeData = Qt.binding(function() { return nodeLoader.config })
+                        item.sceneModel = root.sceneModel
+                        item.nodeIndex = Qt.binding(function() { return rootNodes.modelIndex(nodeLoader.index) })
+                        item.sharedMaterials = Qt.binding(function() {
+                            return {
+                                "default": root.defaultMaterial,
+                                "x": root.xMaterial,
+                                "y": root.yMaterial,
+                                "z": root.zMaterial,
+                                "selection": root.selectionMaterial
+                            }
+                        })
+                    }
                 }
             }
         }
@@ -163,23 +163,17 @@ Rectangle {
                     TextField {
                         Layout.fillWidth: true
                         placeholderText: "In Min"
-                        text: (activeNode && activeNode.motion && activeNode.motion.mapping) ? activeNode.motion.mapping.inMin : "0"
+                        text: (activeNode && activeNode.motion && activeNode.motion.mapping) ? activeNode.motion.mapping.in_min : "0"
                         onEditingFinished: {
-                            let m = activeNode.motion || {}
-                            m.mapping = m.mapping || {}
-                            m.mapping.inMin = parseFloat(text)
-                            updateNode("motion", m)
+                            updateNode("motion", {"mapping": {"in_min": parseFloat(text)}})
                         }
                     }
                     TextField {
                         Layout.fillWidth: true
                         placeholderText: "In Max"
-                        text: (activeNode && activeNode.motion && activeNode.motion.mapping) ? activeNode.motion.mapping.inMax : "1"
+                        text: (activeNode && activeNode.motion && activeNode.motion.mapping) ? activeNode.motion.mapping.in_max : "1"
                         onEditingFinished: {
-                            let m = activeNode.motion || {}
-                            m.mapping = m.mapping || {}
-                            m.mapping.inMax = parseFloat(text)
-                            updateNode("motion", m)
+                            updateNode("motion", {"mapping": {"in_max": parseFloat(text)}})
                         }
                     }
                 }
@@ -189,23 +183,17 @@ Rectangle {
                     TextField {
                         Layout.fillWidth: true
                         placeholderText: "Out Min"
-                        text: (activeNode && activeNode.motion && activeNode.motion.mapping) ? activeNode.motion.mapping.outMin : "0"
+                        text: (activeNode && activeNode.motion && activeNode.motion.mapping) ? activeNode.motion.mapping.out_min : "0"
                         onEditingFinished: {
-                            let m = activeNode.motion || {}
-                            m.mapping = m.mapping || {}
-                            m.mapping.outMin = parseFloat(text)
-                            updateNode("motion", m)
+                            updateNode("motion", {"mapping": {"out_min": parseFloat(text)}})
                         }
                     }
                     TextField {
                         Layout.fillWidth: true
                         placeholderText: "Out Max"
-                        text: (activeNode && activeNode.motion && activeNode.motion.mapping) ? activeNode.motion.mapping.outMax : "1"
+                        text: (activeNode && activeNode.motion && activeNode.motion.mapping) ? activeNode.motion.mapping.out_max : "1"
                         onEditingFinished: {
-                            let m = activeNode.motion || {}
-                            m.mapping = m.mapping || {}
-                            m.mapping.outMax = parseFloat(text)
-                            updateNode("motion", m)
+                            updateNode("motion", {"mapping": {"out_max": parseFloat(text)}})
                         }
                     }
                 }
@@ -1,11 +1,13 @@
 import QtQuick
+import QtQml.Models
 import QtQuick3D
 
 Node {
     id: root
     
     property var nodeData: ({})
-    property var childrenMap: ({})
+    property var sceneModel: null
+    property var nodeIndex
     property var sharedMaterials: ({})
     
     // Static offset from parent
@@ -79,16 +81,25 @@ Node {
 
         // Recursively instantiate children
         Instantiator {
-            model: (nodeData && nodeData.id) ? (childrenMap[nodeData.id] || []) : []
-            
-            delegate: Loader {
-                source: "SceneNode.qml"
-                onLoaded: {
-                    if (item) {
-                        item.parent = motionNode
-                        item.nodeData = Qt.binding(function() { return modelData })
-                        item.childrenMap = Qt.binding(function() { return root.childrenMap })
-                        item.sharedMaterials = Qt.binding(function() { return root.sharedMaterials })
+            model: DelegateModel {
+                id: childNodes
+                model: root.sceneModel
+                rootIndex: root.nodeIndex
+
+                delegate: Loader {
+                    id: childLoader
+                    required property int index
+                    required property var config
+
+                    source: "SceneNode.qml"
+                    onLoaded: {
+                        if (item) {
+                            item.parent = motionNode
+                            item.nodeData = Qt.binding(function() { return childLoader.config })
+                            item.sceneModel = root.sceneModel
+                            item.nodeIndex = Qt.binding(function() { return childNodes.modelIndex(childLoader.index) })
+                            item.sharedMaterials = Qt.binding(function() { return root.sharedMaterials })
+                        }
                     }
                 }
             }
@@ -656,7 +656,7 @@ ApplicationWindow {
                     scale: Qt.vector3d(100, 100, 100)
 
                     SceneComposer {
-                        sceneNodes: layout ? layout.sceneNodes : []
+                        sceneModel: layout ? layout.sceneModel : null
                     }
                 }
             }
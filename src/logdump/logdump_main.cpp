@@ -0,0 +1,222 @@
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QDateTime>
+#include <QFile>
+#include <QFileInfo>
+#include <QDir>
+#include <QTextStream>
+#include <QRegularExpression>
+#include <iostream>
+#include <limits>
+#include "BinaryLog.h"
+#include "LogCompression.h"
+
+using namespace ObservatoryMonitor;
+
+// Record filters from the command line
+struct Filter {
+    qint64 fromMs = std::numeric_limits<qint64>::min();
+    qint64 toMs = std::numeric_limits<qint64>::max();
+    LogLevel minimumLevel = LogLevel::Debug;
+    QStringList categories;
+    QStringList controllers;
+
+    bool matches(qint64 timestampMs, LogLevel level, const QString& category, const QString& controller) const
+    {
+        if (timestampMs < fromMs || timestampMs > toMs) return false;
+        if (level < minimumLevel) return false;
+        if (!categories.isEmpty() && !categories.contains(category)) return false;
+        if (!controllers.isEmpty() && !controllers.contains(controller)) return false;
+        return true;
+    }
+};
+
+static bool isBinaryLog(const QString& path)
+{
+    QString name = QFileInfo(path).fileName();
+    if (LogCompression::isCompressed(name)) {
+        name.chop(qstrlen(LogCompression::Extension));
+    }
+    return name.endsWith(QLatin1String(BinaryLogFormat::Extension));
+}
+
+// Files given on the command line, with directories expanded to the binary
+// logs in them, compressed or not, oldest first (a day's numbered segments do
+// not sort by name)
+static QStringList collectInputs(const QStringList& paths)
+{
+    QStringList files;
+    for (const QString& path : paths) {
+        QFileInfo info(path);
+        if (info.isDir()) {
+            QDir dir(path);
+            const QStringList names = dir.entryList(
+                QStringList() << QString("*") + BinaryLogFormat::Extension
+                              << QString("*") + BinaryLogFormat::Extension + LogCompression::Extension,
+                QDir::Files, QDir::Time | QDir::Reversed);
+            for (const QString& name : names) {
+                files << dir.filePath(name);
+            }
+        } else {
+            files << path;
+        }
+    }
+    return files;
+}
+
+static bool dumpBinaryLog(const QString& path, const Filter& filter, QTextStream& out)
+{
+    BinaryLogReader reader;
+    QString errorMessage;
+    if (!reader.open(path, errorMessage)) {
+        std::cerr << "Error: " << path.toStdString() << ": " << errorMessage.toStdString() << std::endl;
+        return false;
+    }
+
+    LogEvent event;
+    while (reader.next(event)) {
+        if (!filter.matches(event.timestampMs, event.level, event.category, event.controller)) continue;
+
+        out << LogText::formatLine(QDateTime::fromMSecsSinceEpoch(event.timestampMs), event.level,
+                                   event.message(), event.category, event.controller)
+            << '\n';
+    }
+
+    if (!reader.errorString().isEmpty()) {
+        std::cerr << "Error: " << path.toStdString() << ": " << reader.errorString().toStdString() << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// Text logs, e.g. a compressed user log segment. Lines are filtered on the
+// fields LogText::formatLine() writes: the first bracketed field after the
+// level is taken as the category and the next as the controller. Lines
+// without a header follow the line before them.
+static bool dumpTextLog(const QString& path, const Filter& filter, QTextStream& out)
+{
+    QByteArray data;
+    QString errorMessage;
+    if (!LogCompression::readFile(path, data, errorMessage)) {
+        std::cerr << "Error: " << path.toStdString() << ": " << errorMessage.toStdString() << std::endl;
+        return false;
+    }
+
+    static const QRegularExpression header(
+        R"(^\[(\d{4}-\d\d-\d\d \d\d:\d\d:\d\d\.\d{3})\] \[([A-Z ]{5})\] (?:\[([^\]]*)\] )?(?:\[([^\]]*)\] )?)");
+    bool keep = false;
+    const QStringList lines = QString::fromUtf8(data).split('\n', Qt::SkipEmptyParts);
+    for (const QString& line : lines) {
+        const QRegularExpressionMatch match = header.match(line);
+        if (match.hasMatch()) {
+            const QDateTime when = QDateTime::fromString(match.captured(1), "yyyy-MM-dd HH:mm:ss.zzz");
+            LogLevel level = LogLevel::Info;
+            LogText::parseLevel(match.captured(2), level);
+            keep = filter.matches(when.toMSecsSinceEpoch(), level, match.captured(3), match.captured(4));
+        }
+        if (keep) {
+            out << line << '\n';
+        }
+    }
+    return true;
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    // Set application metadata
+    QCoreApplication::setApplicationName("observatory-logdump");
+    QCoreApplication::setApplicationVersion("0.1.0");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Observatory Monitor log decoder");
+    parser.addHelpOption();
+    parser.addVersionOption();
+    parser.addPositionalArgument("files", "Log files: binary (.omlog) or text (.log), either possibly "
+                                          "compressed (.qz), or directories of binary logs", "files...");
+
+    QCommandLineOption fromOption(QStringList() << "f" << "from",
+                                  "Start time, ISO 8601 (local time unless an offset is given)",
+                                  "time");
+    QCommandLineOption toOption(QStringList() << "t" << "to",
+                                "End time, ISO 8601 (local time unless an offset is given)",
+                                "time");
+    QCommandLineOption categoryOption(QStringList() << "c" << "category",
+                                      "Only records of this category (e.g. MQTT); repeatable", "name");
+    QCommandLineOption controllerOption("controller",
+                                        "Only records of this controller; repeatable", "name");
+    QCommandLineOption levelOption(QStringList() << "l" << "level",
+                                   "Minimum level: debug, info, warning, error, critical", "level", "debug");
+    QCommandLineOption outputOption(QStringList() << "o" << "output",
+                                    "Write text to file instead of stdout", "file");
+
+    parser.addOption(fromOption);
+    parser.addOption(toOption);
+    parser.addOption(categoryOption);
+    parser.addOption(controllerOption);
+    parser.addOption(levelOption);
+    parser.addOption(outputOption);
+
+    parser.process(app);
+
+    const QStringList inputs = collectInputs(parser.positionalArguments());
+    if (inputs.isEmpty()) {
+        std::cerr << "Error: No log files given" << std::endl;
+        return 1;
+    }
+
+    Filter filter;
+    if (!LogText::parseLevel(parser.value(levelOption), filter.minimumLevel)) {
+        std::cerr << "Error: Invalid --level: " << parser.value(levelOption).toStdString() << std::endl;
+        return 1;
+    }
+
+    if (parser.isSet(fromOption)) {
+        QDateTime from = QDateTime::fromString(parser.value(fromOption), Qt::ISODate);
+        if (!from.isValid()) {
+            std::cerr << "Error: Invalid --from time: " << parser.value(fromOption).toStdString() << std::endl;
+            return 1;
+        }
+        filter.fromMs = from.toMSecsSinceEpoch();
+    }
+
+    if (parser.isSet(toOption)) {
+        QDateTime to = QDateTime::fromString(parser.value(toOption), Qt::ISODate);
+        if (!to.isValid()) {
+            std::cerr << "Error: Invalid --to time: " << parser.value(toOption).toStdString() << std::endl;
+            return 1;
+        }
+        filter.toMs = to.toMSecsSinceEpoch();
+    }
+
+    filter.categories = parser.values(categoryOption);
+    filter.controllers = parser.values(controllerOption);
+
+    QFile outFile;
+    if (parser.isSet(outputOption)) {
+        outFile.setFileName(parser.value(outputOption));
+        if (!outFile.open(QIODevice::WriteOnly | QIODevice::Text)) {
+            std::cerr << "Error: Cannot write " << outFile.fileName().toStdString()
+                      << ": " << outFile.errorString().toStdString() << std::endl;
+            return 1;
+        }
+    } else if (!outFile.open(stdout, QIODevice::WriteOnly | QIODevice::Text)) {
+        std::cerr << "Error: Cannot write to stdout" << std::endl;
+        return 1;
+    }
+
+    QTextStream out(&outFile);
+    int exitCode = 0;
+
+    for (const QString& path : inputs) {
+        const bool ok = isBinaryLog(path) ? dumpBinaryLog(path, filter, out)
+                                          : dumpTextLog(path, filter, out);
+        if (!ok) {
+            exitCode = 1;
+        }
+    }
+
+    out.flush();
+    return exitCode;
+}
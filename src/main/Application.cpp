@@ -1,11 +1,15 @@
 #include "Application.h"
 #include "Logger.h"
+#include "MotionPredictor.h"
+#include "LayoutCache.h"
 #include <QStandardPaths>
 #include <QDir>
 #include <QFile>
 #include <QFileInfo>
+#include <QElapsedTimer>
 #include <QTimer>
 #include <QQmlContext>
+#include <QQuickWindow>
 #include <QtQml>
 #include <iostream>
 
@@ -18,6 +22,7 @@ namespace ObservatoryMonitor {
 Application::Application(int& argc, char** argv)
     : m_app(argc, argv)
     , m_controllerListModel(nullptr)
+    , m_startup(&m_controllerManager)
 {
     QCoreApplication::setApplicationName("observatory-monitor");
     QCoreApplication::setApplicationVersion("0.1.0");
@@ -25,6 +30,7 @@ Application::Application(int& argc, char** argv)
 
 Application::~Application()
 {
+    m_telemetry.close();
     Logger::instance().shutdown();
 }
 
@@ -44,7 +50,7 @@ ControllerProxy* Application::getController(const QString& name)
     }
 
     if (m_controllerManager.getControllerNames().contains(name)) {
-        ControllerProxy* proxy = new ControllerProxy(name, &m_controllerManager, this);
+        ControllerProxy* proxy = new ControllerProxy(name, &m_controllerManager, &m_capabilities, this);
         m_proxies[name] = proxy;
         return proxy;
     }
@@ -54,163 +60,182 @@ ControllerProxy* Application::getController(const QString& name)
 
 void Application::saveConfig()
 {
+    storeSettings();
+
     QString error;
     if (!m_config.saveToFile(m_configPath, error)) {
         Logger::instance().error("Failed to save configuration: " + error);
     } else {
+        // Our own write must not come back through the watcher as a reload
+        m_configHash = LayoutCache::sourceHash({m_configPath});
         Logger::instance().info("Configuration saved successfully to " + m_configPath);
     }
 }
 
-void Application::saveLayout()
+bool Application::reloadConfig()
 {
+    Config config;
     QString error;
-    if (!m_layout.saveToFile(m_layoutPath, error)) {
-        Logger::instance().error("Failed to save layout: " + error);
-    } else {
-        Logger::instance().info("Layout saved successfully to " + m_layoutPath);
+    const QByteArray hash = LayoutCache::sourceHash({m_configPath});
+    if (!config.loadFromFile(m_configPath, error) || !config.validate(error)) {
+        Logger::instance().error("Configuration reload failed, keeping current settings: " + error);
+        return false;
     }
-}
 
-void Application::setTheme(const QString& theme)
-{
-    if (m_config.gui().theme != theme) {
-        GuiConfig gui = m_config.gui();
-        gui.theme = theme;
-        m_config.setGui(gui);
-        emit themeChanged();
-    }
-}
+    QStringList previousNames = m_controllerManager.getControllerNames();
 
-void Application::setShowGauges(bool show)
-{
-    if (m_config.gui().showGauges != show) {
-        GuiConfig gui = m_config.gui();
-        gui.showGauges = show;
-        m_config.setGui(gui);
-        emit showGaugesChanged();
-    }
-}
+    m_controllerManager.loadControllersFromConfig(config);
+    m_controllerManager.setUpdateRate(config.gui().maxUpdateRate);
+    m_config = config;
+    m_configHash = hash;
 
-void Application::setShow3DView(bool show)
-{
-    if (m_config.gui().show3DView != show) {
-        GuiConfig gui = m_config.gui();
-        gui.show3DView = show;
-        m_config.setGui(gui);
-        emit show3DViewChanged();
+    QStringList names = m_controllerManager.getControllerNames();
+    previousNames.sort();
+    names.sort();
+    if (names != previousNames && m_controllerListModel) {
+        m_controllerListModel->refresh();
     }
-}
 
-void Application::setShowDashboard(bool show)
-{
-    if (m_showDashboard != show) {
-        m_showDashboard = show;
-        emit showDashboardChanged();
-    }
-}
+    // Only settings whose value differs notify
+    loadSettings(m_config);
 
-void Application::setEditorMode(bool mode)
-{
-    if (m_editorMode != mode) {
-        m_editorMode = mode;
-        emit editorModeChanged();
-    }
+    Logger::instance().info("Configuration reloaded from " + m_configPath);
+    return true;
 }
 
-void Application::setSidebarWidth(int width)
+void Application::watchConfig()
 {
-    if (m_config.gui().sidebarWidth != width) {
-        GuiConfig gui = m_config.gui();
-        gui.sidebarWidth = width;
-        m_config.setGui(gui);
-        emit sidebarWidthChanged();
-    }
+    // An editor's save is a burst of write/rename events: each one restarts
+    // the timer, so the burst reloads once after the write settles
+    m_configReloadTimer.setSingleShot(true);
+    m_configReloadTimer.setInterval(250);
+    connect(&m_configReloadTimer, &QTimer::timeout, this, [this]() {
+        // Editors often replace the file; re-add it
+        if (!m_configWatcher.files().contains(m_configPath) && QFile::exists(m_configPath)) {
+            m_configWatcher.addPath(m_configPath);
+        }
+        // Unchanged since we last loaded or saved it (e.g. our own saveConfig)
+        if (LayoutCache::sourceHash({m_configPath}) == m_configHash) return;
+        reloadConfig();
+    });
+
+    m_configWatcher.addPath(m_configPath);
+    connect(&m_configWatcher, &QFileSystemWatcher::fileChanged, &m_configReloadTimer, qOverload<>(&QTimer::start));
 }
 
-void Application::setSidebarPosition(const QString& position)
+void Application::saveLayout()
 {
-    if (m_config.gui().sidebarPosition != position) {
-        GuiConfig gui = m_config.gui();
-        gui.sidebarPosition = position;
-        m_config.setGui(gui);
-        emit sidebarPositionChanged();
+    QString error;
+    if (!m_layout.saveToFile(m_layoutPath, error)) {
+        Logger::instance().error("Failed to save layout: " + error);
+    } else {
+        Logger::instance().info("Layout saved successfully to " + m_layoutPath);
     }
 }
 
 void Application::setMqttHost(const QString& host)
 {
-    if (m_config.broker().host != host) {
-        BrokerConfig broker = m_config.broker();
-        broker.host = host;
-        m_config.setBroker(broker);
-        emit mqttHostChanged();
+    if (m_mqttHost.value() != host) {
+        m_mqttHost = host;
         updateBrokerConfig();
     }
 }
 
 void Application::setMqttPort(int port)
 {
-    if (m_config.broker().port != port) {
-        BrokerConfig broker = m_config.broker();
-        broker.port = port;
-        m_config.setBroker(broker);
-        emit mqttPortChanged();
+    if (m_mqttPort.value() != port) {
+        m_mqttPort = port;
         updateBrokerConfig();
     }
 }
 
 void Application::setMqttUsername(const QString& username)
 {
-    if (m_config.broker().username != username) {
-        BrokerConfig broker = m_config.broker();
-        broker.username = username;
-        m_config.setBroker(broker);
-        emit mqttUsernameChanged();
+    if (m_mqttUsername.value() != username) {
+        m_mqttUsername = username;
         updateBrokerConfig();
     }
 }
 
 void Application::setMqttPassword(const QString& password)
 {
-    if (m_config.broker().password != password) {
-        BrokerConfig broker = m_config.broker();
-        broker.password = password;
-        m_config.setBroker(broker);
-        emit mqttPasswordChanged();
+    if (m_mqttPassword.value() != password) {
+        m_mqttPassword = password;
         updateBrokerConfig();
     }
 }
 
 void Application::setMqttTimeout(double timeout)
 {
-    if (m_config.mqttTimeout() != timeout) {
-        m_config.setMqttTimeout(timeout);
-        emit mqttTimeoutChanged();
+    if (m_mqttTimeout.value() != timeout) {
+        m_mqttTimeout = timeout;
         updateBrokerConfig();
     }
 }
 
 void Application::setReconnectInterval(int interval)
 {
-    if (m_config.reconnectInterval() != interval) {
-        m_config.setReconnectInterval(interval);
-        emit reconnectIntervalChanged();
+    if (m_reconnectInterval.value() != interval) {
+        m_reconnectInterval = interval;
         updateBrokerConfig();
     }
 }
 
 void Application::updateBrokerConfig()
 {
+    storeSettings();
     m_controllerManager.updateBrokerConfig(m_config.broker(), m_config.mqttTimeout(), m_config.reconnectInterval());
 }
 
+void Application::loadSettings(const Config& config)
+{
+    // Applied as one group: bindings depending on several settings evaluate
+    // once, and only settings that actually changed notify
+    Qt::beginPropertyUpdateGroup();
+    const GuiConfig& gui = config.gui();
+    m_theme = gui.theme;
+    m_showGauges = gui.showGauges;
+    m_show3DView = gui.show3DView;
+    m_sidebarWidth = gui.sidebarWidth;
+    m_sidebarPosition = gui.sidebarPosition;
+
+    const BrokerConfig& broker = config.broker();
+    m_mqttHost = broker.host;
+    m_mqttPort = broker.port;
+    m_mqttUsername = broker.username;
+    m_mqttPassword = broker.password;
+    m_mqttTimeout = config.mqttTimeout();
+    m_reconnectInterval = config.reconnectInterval();
+    Qt::endPropertyUpdateGroup();
+}
+
+void Application::storeSettings()
+{
+    GuiConfig gui = m_config.gui();
+    gui.theme = m_theme;
+    gui.showGauges = m_showGauges;
+    gui.show3DView = m_show3DView;
+    gui.sidebarWidth = m_sidebarWidth;
+    gui.sidebarPosition = m_sidebarPosition;
+    m_config.setGui(gui);
+
+    BrokerConfig broker = m_config.broker();
+    broker.host = m_mqttHost;
+    broker.port = m_mqttPort;
+    broker.username = m_mqttUsername;
+    broker.password = m_mqttPassword;
+    m_config.setBroker(broker);
+    m_config.setMqttTimeout(m_mqttTimeout);
+    m_config.setReconnectInterval(m_reconnectInterval);
+}
+
 bool Application::initialize()
 {
     qmlRegisterType<ControllerProxy>("ObservatoryMonitor", 1, 0, "ControllerProxy");
     qmlRegisterUncreatableType<CapabilityRegistry>("ObservatoryMonitor", 1, 0, "CapabilityRegistry", "Access through app.caps");
     qmlRegisterUncreatableType<LayoutConfig>("ObservatoryMonitor", 1, 0, "LayoutConfig", "Access through app.layout");
     qmlRegisterUncreatableType<ValueMappingEngine>("ObservatoryMonitor", 1, 0, "ValueMappingEngine", "Access through app.valueMappingEngine");
+    qmlRegisterType<MotionPredictor>("ObservatoryMonitor", 1, 0, "MotionPredictor");
 
     if (!setupPaths()) return false;
     if (!loadConfiguration()) return false;
@@ -221,11 +246,23 @@ bool Application::initialize()
     Logger::instance().info(QString("Qt version: %1").arg(QT_VERSION_STR));
     Logger::instance().info("=================================================");
 
+    if (m_layoutFromCache) {
+        Logger::instance().info(QString("Layout loaded from cache in %1 ms").arg(m_layoutLoadMs, 0, 'f', 2));
+    } else {
+        Logger::instance().info(QString("Layout loaded from YAML in %1 ms (cache: %2)")
+                                    .arg(m_layoutLoadMs, 0, 'f', 2)
+                                    .arg(m_layoutCacheMiss.isEmpty() ? QString("none") : m_layoutCacheMiss));
+    }
+
     setupControllers();
+    setupTelemetry();
     setupQml();
+    watchConfig();
 
-    m_controllerManager.connectAll();
-    m_controllerManager.startPolling(1000, 5000);
+    // Bounded parallel connect; each controller polls once its echo topic is subscribed
+    m_startup.setMaxConcurrent(m_config.startup().maxConcurrentConnects);
+    m_startup.setReadyTimeout(m_config.startup().readyTimeout * 1000);
+    m_startup.start(1000, 5000);
     
     return true;
 }
@@ -236,6 +273,7 @@ bool Application::setupPaths()
     m_configPath = m_configDir + "/config.yaml";
     m_layoutPath = m_configDir + "/layout.yaml";
     m_capsPath = m_configDir + "/capabilities.yaml";
+    m_telemetryDir = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) + "/telemetry";
 
 #ifdef Q_OS_LINUX
     if (getuid() == 0) {
@@ -288,41 +326,72 @@ bool Application::loadConfiguration()
             return false;
         }
     }
-
-    // Load capabilities
-    if (!QFile::exists(m_capsPath)) {
-        m_capabilities.setDefaults();
-        m_capabilities.saveToFile(m_capsPath, errorMessage);
-    } else {
-        m_capabilities.loadFromFile(m_capsPath, errorMessage);
+    m_configHash = LayoutCache::sourceHash({m_configPath});
+
+    // Capabilities and layout come from the binary cache while both YAML
+    // files are unchanged, skipping the parse and validation
+    QElapsedTimer layoutTimer;
+    layoutTimer.start();
+    const QString cachePath = LayoutCache::pathFor(m_layoutPath);
+    QByteArray sourceHash;
+    if (QFile::exists(m_capsPath) && QFile::exists(m_layoutPath)) {
+        sourceHash = LayoutCache::sourceHash({m_capsPath, m_layoutPath});
     }
+    m_layoutFromCache = !sourceHash.isEmpty()
+        && LayoutCache::read(cachePath, sourceHash, m_layout, m_capabilities, m_layoutCacheMiss);
 
-    // Load layout
-    if (!QFile::exists(m_layoutPath)) {
-        m_layout.setDefaults();
-        m_layout.saveToFile(m_layoutPath, errorMessage);
+    if (m_layoutFromCache) {
+        // A model file can go missing without touching either YAML file
+        if (!m_layout.validateModelFiles(errorMessage)) {
+            Logger::instance().error("Layout validation failed: " + errorMessage);
+        }
     } else {
-        if (!m_layout.loadFromFile(m_layoutPath, errorMessage)) {
-            std::cerr << "Failed to load layout file: " << errorMessage.toStdString() << std::endl;
-            // Don't return false, just use defaults
+        // Load capabilities
+        if (!QFile::exists(m_capsPath)) {
+            m_capabilities.setDefaults();
+            m_capabilities.saveToFile(m_capsPath, errorMessage);
+        } else {
+            m_capabilities.loadFromFile(m_capsPath, errorMessage);
+        }
+
+        // Load layout
+        if (!QFile::exists(m_layoutPath)) {
             m_layout.setDefaults();
-        } else if (!m_layout.validate(&m_capabilities, errorMessage)) {
-            Logger::instance().error("Layout validation failed: " + errorMessage);
-            // We don't revert to defaults here so the user can see the error banner 
-            // and fix the layout in the editor.
+            m_layout.saveToFile(m_layoutPath, errorMessage);
+        } else {
+            if (!m_layout.loadFromFile(m_layoutPath, errorMessage)) {
+                std::cerr << "Failed to load layout file: " << errorMessage.toStdString() << std::endl;
+                // Don't return false, just use defaults
+                m_layout.setDefaults();
+            } else if (!m_layout.validate(&m_capabilities, errorMessage)) {
+                Logger::instance().error("Layout validation failed: " + errorMessage);
+                // We don't revert to defaults here so the user can see the error banner 
+                // and fix the layout in the editor.
+            } else if (!sourceHash.isEmpty()
+                       && !LayoutCache::write(cachePath, sourceHash, m_layout, m_capabilities, errorMessage)) {
+                std::cerr << "Failed to write layout cache: " << errorMessage.toStdString() << std::endl;
+            }
         }
     }
+    m_layoutLoadMs = layoutTimer.nsecsElapsed() / 1e6;
 
     if (!m_config.validate(errorMessage)) {
         std::cerr << "Configuration validation failed: " << errorMessage.toStdString() << std::endl;
         return false;
     }
 
+    loadSettings(m_config);
     return true;
 }
 
 bool Application::setupLogger()
 {
+    Logger::instance().setAsync(m_config.logging().async,
+                                m_config.logging().overflowPolicy == "block"
+                                    ? LogOverflowPolicy::Block : LogOverflowPolicy::Drop);
+    Logger::instance().setBinaryDebugLog(m_config.logging().debugFormat == "binary");
+    Logger::instance().setMaxFileSize(m_config.logging().maxFileSizeMB);
+    Logger::instance().setCompression(m_config.logging().compress);
     if (!Logger::instance().initialize(m_logDir,
                                       m_config.logging().debugEnabled,
                                       true,
@@ -347,6 +416,7 @@ QString Application::systemStatus() const
 void Application::setupControllers()
 {
     m_controllerManager.loadControllersFromConfig(m_config);
+    m_controllerManager.setUpdateRate(m_config.gui().maxUpdateRate);
     m_controllerListModel = new ControllerListModel(&m_controllerManager, this);
     
     connect(&m_controllerManager, &ControllerManager::systemStatusChanged, this, [this](SystemStatus status) {
@@ -381,6 +451,20 @@ void Application::setupControllers()
     });
 }
 
+void Application::setupTelemetry()
+{
+    TelemetryConfig telemetry = m_config.telemetry();
+    if (!telemetry.enabled) {
+        Logger::instance().info("Telemetry recording disabled");
+        return;
+    }
+
+    if (m_telemetry.open(m_telemetryDir, telemetry.rawRetentionDays, telemetry.minuteRetentionDays)) {
+        connect(&m_controllerManager, &ControllerManager::controllerDataUpdated,
+                &m_telemetry, qOverload<const QString&, const QString&, const QString&>(&TelemetryStore::record));
+    }
+}
+
 void Application::setupQml()
 {
     using namespace Qt::StringLiterals;
@@ -439,6 +523,14 @@ void Application::setupQml()
             break;
         }
     }
+
+    // Deliver coalesced controller updates once per rendered frame
+    for (QObject* root : m_engine.rootObjects()) {
+        if (QQuickWindow* window = qobject_cast<QQuickWindow*>(root)) {
+            connect(window, &QQuickWindow::afterAnimating,
+                    &m_controllerManager, &ControllerManager::flushUpdates);
+        }
+    }
     
     // Final check
     QTimer::singleShot(100, [this]() {
@@ -4,12 +4,17 @@
 #include <QObject>
 #include <QGuiApplication>
 #include <QQmlApplicationEngine>
+#include <QFileSystemWatcher>
+#include <QTimer>
+#include <QProperty>
 #include "Config.h"
 #include "CapabilityRegistry.h"
 #include "LayoutConfig.h"
 #include "ControllerManager.h"
 #include "ControllerListModel.h"
 #include "ControllerProxy.h"
+#include "TelemetryStore.h"
+#include "StartupOrchestrator.h"
 
 namespace ObservatoryMonitor {
 
@@ -17,21 +22,21 @@ class Application : public QObject
 {
     Q_OBJECT
     Q_PROPERTY(QString systemStatus READ systemStatus NOTIFY systemStatusChanged)
-    Q_PROPERTY(QString theme READ theme WRITE setTheme NOTIFY themeChanged)
-    Q_PROPERTY(bool showGauges READ showGauges WRITE setShowGauges NOTIFY showGaugesChanged)
-    Q_PROPERTY(bool show3DView READ show3DView WRITE setShow3DView NOTIFY show3DViewChanged)
-    Q_PROPERTY(bool showDashboard READ showDashboard WRITE setShowDashboard NOTIFY showDashboardChanged)
-    Q_PROPERTY(bool editorMode READ editorMode WRITE setEditorMode NOTIFY editorModeChanged)
-    Q_PROPERTY(int sidebarWidth READ sidebarWidth WRITE setSidebarWidth NOTIFY sidebarWidthChanged)
-    Q_PROPERTY(QString sidebarPosition READ sidebarPosition WRITE setSidebarPosition NOTIFY sidebarPositionChanged)
+    Q_PROPERTY(QString theme READ theme WRITE setTheme NOTIFY themeChanged BINDABLE bindableTheme)
+    Q_PROPERTY(bool showGauges READ showGauges WRITE setShowGauges NOTIFY showGaugesChanged BINDABLE bindableShowGauges)
+    Q_PROPERTY(bool show3DView READ show3DView WRITE setShow3DView NOTIFY show3DViewChanged BINDABLE bindableShow3DView)
+    Q_PROPERTY(bool showDashboard READ showDashboard WRITE setShowDashboard NOTIFY showDashboardChanged BINDABLE bindableShowDashboard)
+    Q_PROPERTY(bool editorMode READ editorMode WRITE setEditorMode NOTIFY editorModeChanged BINDABLE bindableEditorMode)
+    Q_PROPERTY(int sidebarWidth READ sidebarWidth WRITE setSidebarWidth NOTIFY sidebarWidthChanged BINDABLE bindableSidebarWidth)
+    Q_PROPERTY(QString sidebarPosition READ sidebarPosition WRITE setSidebarPosition NOTIFY sidebarPositionChanged BINDABLE bindableSidebarPosition)
 
     // MQTT Broker Properties
-    Q_PROPERTY(QString mqttHost READ mqttHost WRITE setMqttHost NOTIFY mqttHostChanged)
-    Q_PROPERTY(int mqttPort READ mqttPort WRITE setMqttPort NOTIFY mqttPortChanged)
-    Q_PROPERTY(QString mqttUsername READ mqttUsername WRITE setMqttUsername NOTIFY mqttUsernameChanged)
-    Q_PROPERTY(QString mqttPassword READ mqttPassword WRITE setMqttPassword NOTIFY mqttPasswordChanged)
-    Q_PROPERTY(double mqttTimeout READ mqttTimeout WRITE setMqttTimeout NOTIFY mqttTimeoutChanged)
-    Q_PROPERTY(int reconnectInterval READ reconnectInterval WRITE setReconnectInterval NOTIFY reconnectIntervalChanged)
+    Q_PROPERTY(QString mqttHost READ mqttHost WRITE setMqttHost NOTIFY mqttHostChanged BINDABLE bindableMqttHost)
+    Q_PROPERTY(int mqttPort READ mqttPort WRITE setMqttPort NOTIFY mqttPortChanged BINDABLE bindableMqttPort)
+    Q_PROPERTY(QString mqttUsername READ mqttUsername WRITE setMqttUsername NOTIFY mqttUsernameChanged BINDABLE bindableMqttUsername)
+    Q_PROPERTY(QString mqttPassword READ mqttPassword WRITE setMqttPassword NOTIFY mqttPasswordChanged BINDABLE bindableMqttPassword)
+    Q_PROPERTY(double mqttTimeout READ mqttTimeout WRITE setMqttTimeout NOTIFY mqttTimeoutChanged BINDABLE bindableMqttTimeout)
+    Q_PROPERTY(int reconnectInterval READ reconnectInterval WRITE setReconnectInterval NOTIFY reconnectIntervalChanged BINDABLE bindableReconnectInterval)
 
 public:
     explicit Application(int& argc, char** argv);
@@ -42,48 +47,66 @@ public:
     Q_INVOKABLE ObservatoryMonitor::ControllerProxy* getController(const QString& name);
     Q_INVOKABLE void saveConfig();
     Q_INVOKABLE void saveLayout();
+    // Re-read config.yaml and apply only what changed
+    Q_INVOKABLE bool reloadConfig();
 
     QString systemStatus() const;
 
-    QString theme() const { return m_config.gui().theme; }
-    void setTheme(const QString& theme);
+    // Settings live in bindable properties while the app runs: QML bindings
+    // on them are tracked per property and setters touch one field. They are
+    // copied from the Config on load/reload and back into it on save.
+    QString theme() const { return m_theme; }
+    void setTheme(const QString& theme) { m_theme = theme; }
+    QBindable<QString> bindableTheme() { return &m_theme; }
 
-    bool showGauges() const { return m_config.gui().showGauges; }
-    void setShowGauges(bool show);
+    bool showGauges() const { return m_showGauges; }
+    void setShowGauges(bool show) { m_showGauges = show; }
+    QBindable<bool> bindableShowGauges() { return &m_showGauges; }
 
-    bool show3DView() const { return m_config.gui().show3DView; }
-    void setShow3DView(bool show);
+    bool show3DView() const { return m_show3DView; }
+    void setShow3DView(bool show) { m_show3DView = show; }
+    QBindable<bool> bindableShow3DView() { return &m_show3DView; }
 
     bool showDashboard() const { return m_showDashboard; }
-    void setShowDashboard(bool show);
+    void setShowDashboard(bool show) { m_showDashboard = show; }
+    QBindable<bool> bindableShowDashboard() { return &m_showDashboard; }
 
     bool editorMode() const { return m_editorMode; }
-    void setEditorMode(bool mode);
+    void setEditorMode(bool mode) { m_editorMode = mode; }
+    QBindable<bool> bindableEditorMode() { return &m_editorMode; }
 
-    int sidebarWidth() const { return m_config.gui().sidebarWidth; }
-    void setSidebarWidth(int width);
+    int sidebarWidth() const { return m_sidebarWidth; }
+    void setSidebarWidth(int width) { m_sidebarWidth = width; }
+    QBindable<int> bindableSidebarWidth() { return &m_sidebarWidth; }
 
-    QString sidebarPosition() const { return m_config.gui().sidebarPosition; }
-    void setSidebarPosition(const QString& position);
+    QString sidebarPosition() const { return m_sidebarPosition; }
+    void setSidebarPosition(const QString& position) { m_sidebarPosition = position; }
+    QBindable<QString> bindableSidebarPosition() { return &m_sidebarPosition; }
 
-    // MQTT Broker Getters/Setters
-    QString mqttHost() const { return m_config.broker().host; }
+    // MQTT Broker Getters/Setters; setters push the change to the controllers
+    QString mqttHost() const { return m_mqttHost; }
     void setMqttHost(const QString& host);
+    QBindable<QString> bindableMqttHost() { return &m_mqttHost; }
 
-    int mqttPort() const { return m_config.broker().port; }
+    int mqttPort() const { return m_mqttPort; }
     void setMqttPort(int port);
+    QBindable<int> bindableMqttPort() { return &m_mqttPort; }
 
-    QString mqttUsername() const { return m_config.broker().username; }
+    QString mqttUsername() const { return m_mqttUsername; }
     void setMqttUsername(const QString& username);
+    QBindable<QString> bindableMqttUsername() { return &m_mqttUsername; }
 
-    QString mqttPassword() const { return m_config.broker().password; }
+    QString mqttPassword() const { return m_mqttPassword; }
     void setMqttPassword(const QString& password);
+    QBindable<QString> bindableMqttPassword() { return &m_mqttPassword; }
 
-    double mqttTimeout() const { return m_config.mqttTimeout(); }
+    double mqttTimeout() const { return m_mqttTimeout; }
     void setMqttTimeout(double timeout);
+    QBindable<double> bindableMqttTimeout() { return &m_mqttTimeout; }
 
-    int reconnectInterval() const { return m_config.reconnectInterval(); }
+    int reconnectInterval() const { return m_reconnectInterval; }
     void setReconnectInterval(int interval);
+    QBindable<int> bindableReconnectInterval() { return &m_reconnectInterval; }
 
 signals:
     void systemStatusChanged();
@@ -107,8 +130,12 @@ private:
     bool loadConfiguration();
     bool setupLogger();
     void setupControllers();
+    void setupTelemetry();
     void setupQml();
     void updateBrokerConfig();
+    void watchConfig();
+    void loadSettings(const Config& config);
+    void storeSettings();
 
     QGuiApplication m_app;
     QQmlApplicationEngine m_engine;
@@ -118,6 +145,7 @@ private:
     QString m_layoutPath;
     QString m_capsPath;
     QString m_logDir;
+    QString m_telemetryDir;
     
     Config m_config;
     CapabilityRegistry m_capabilities;
@@ -125,9 +153,33 @@ private:
     ValueMappingEngine m_valueMappingEngine;
     ControllerManager m_controllerManager;
     ControllerListModel* m_controllerListModel;
+    TelemetryStore m_telemetry;
+    StartupOrchestrator m_startup;
+    QFileSystemWatcher m_configWatcher;
+    QTimer m_configReloadTimer;
+    // Hash of config.yaml as last loaded or saved; watcher events that
+    // leave it unchanged do not reload
+    QByteArray m_configHash;
     QHash<QString, ControllerProxy*> m_proxies;
-    bool m_showDashboard = false;
-    bool m_editorMode = false;
+
+    // How the layout was loaded at startup, logged once the logger is up
+    bool m_layoutFromCache = false;
+    double m_layoutLoadMs = 0;
+    QString m_layoutCacheMiss;
+
+    Q_OBJECT_BINDABLE_PROPERTY(Application, QString, m_theme, &Application::themeChanged)
+    Q_OBJECT_BINDABLE_PROPERTY(Application, bool, m_showGauges, &Application::showGaugesChanged)
+    Q_OBJECT_BINDABLE_PROPERTY(Application, bool, m_show3DView, &Application::show3DViewChanged)
+    Q_OBJECT_BINDABLE_PROPERTY_WITH_ARGS(Application, bool, m_showDashboard, false, &Application::showDashboardChanged)
+    Q_OBJECT_BINDABLE_PROPERTY_WITH_ARGS(Application, bool, m_editorMode, false, &Application::editorModeChanged)
+    Q_OBJECT_BINDABLE_PROPERTY(Application, int, m_sidebarWidth, &Application::sidebarWidthChanged)
+    Q_OBJECT_BINDABLE_PROPERTY(Application, QString, m_sidebarPosition, &Application::sidebarPositionChanged)
+    Q_OBJECT_BINDABLE_PROPERTY(Application, QString, m_mqttHost, &Application::mqttHostChanged)
+    Q_OBJECT_BINDABLE_PROPERTY(Application, int, m_mqttPort, &Application::mqttPortChanged)
+    Q_OBJECT_BINDABLE_PROPERTY(Application, QString, m_mqttUsername, &Application::mqttUsernameChanged)
+    Q_OBJECT_BINDABLE_PROPERTY(Application, QString, m_mqttPassword, &Application::mqttPasswordChanged)
+    Q_OBJECT_BINDABLE_PROPERTY(Application, double, m_mqttTimeout, &Application::mqttTimeoutChanged)
+    Q_OBJECT_BINDABLE_PROPERTY(Application, int, m_reconnectInterval, &Application::reconnectIntervalChanged)
 };
 
 } // namespace ObservatoryMonitor
@@ -3,8 +3,10 @@
 
 #include <QObject>
 #include <QString>
+#include <QHash>
 #include <functional>
 #include "Types.h"
+#include "PropertyInterner.h"
 
 namespace ObservatoryMonitor {
 
@@ -32,15 +34,31 @@ public:
     QString name() const { return m_name; }
     QString type() const { return m_type; }
     virtual ControllerStatus status() const = 0;
+    // Commands sent now will be answered (e.g. the MQTT echo topic is subscribed)
+    virtual bool isReady() const { return status() == ControllerStatus::Connected; }
 
     virtual void connect() = 0;
     virtual void disconnect() = 0;
 
     virtual void sendCommand(const QString& command, ResponseCallback callback) = 0;
 
+    // Polling runs on the controller's ControllerPoller, whatever the transport
+    virtual void startPolling(int fastPollMs, int slowPollMs) = 0;
+    virtual void stopPolling() = 0;
+
+    virtual CachedValue getCachedValue(PropertyId id) const = 0;
+    virtual CachedValue getCachedValue(const QString& command) const = 0;
+    virtual QHash<QString, CachedValue> getAllCachedValues() const = 0;
+    // Properties the controller's poller fetches; other interned properties
+    // (e.g. a proxy's dispatch table) may never get a value
+    virtual QVector<PropertyId> polledProperties() const = 0;
+
 signals:
     void statusChanged(ControllerStatus status);
-    void dataUpdated(const QString& command, const QString& value);
+    void ready();
+    void dataUpdated(PropertyId id, const QString& value);
+    // A response nobody asked for (e.g. another client's command on the echo topic)
+    void unsolicitedResponse(const QString& command, const QString& response);
     void errorOccurred(const QString& error);
 
 protected:
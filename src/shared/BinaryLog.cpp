@@ -0,0 +1,479 @@
+#include "BinaryLog.h"
+#include "LogCompression.h"
+#include <QDateTime>
+#include <QFileInfo>
+#include <QtEndian>
+#include <chrono>
+#include <cstring>
+
+namespace ObservatoryMonitor {
+
+enum EntryTag : uchar {
+    SectionTag = 0x00,
+    StringTag = 0x01,
+    TemplateTag = 0x02,
+    EventTag = 0x03
+};
+
+enum ArgTag : uchar {
+    IntArg = 0,
+    DoubleArg = 1,
+    StringArg = 2,
+    StringRefArg = 3
+};
+
+// Flush the buffer to the file once it grows past this, even mid-batch
+static constexpr qsizetype FlushThreshold = 64 * 1024;
+
+static const char* const MessageTemplate = "%1";
+
+static void putVarint(QByteArray& out, quint64 value)
+{
+    do {
+        uchar byte = value & 0x7F;
+        value >>= 7;
+        if (value) byte |= 0x80;
+        out.append(static_cast<char>(byte));
+    } while (value);
+}
+
+static void putZigzag(QByteArray& out, qint64 value)
+{
+    putVarint(out, (static_cast<quint64>(value) << 1) ^ static_cast<quint64>(value >> 63));
+}
+
+static void putText(QByteArray& out, const QString& text)
+{
+    const QByteArray utf8 = text.toUtf8();
+    putVarint(out, quint64(utf8.size()));
+    out.append(utf8);
+}
+
+static bool getVarint(const uchar*& pos, const uchar* end, quint64& value)
+{
+    value = 0;
+    int shift = 0;
+    while (pos < end && shift < 64) {
+        uchar byte = *pos++;
+        value |= static_cast<quint64>(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) return true;
+        shift += 7;
+    }
+    return false;
+}
+
+static bool getZigzag(const uchar*& pos, const uchar* end, qint64& value)
+{
+    quint64 zigzag = 0;
+    if (!getVarint(pos, end, zigzag)) return false;
+    value = static_cast<qint64>(zigzag >> 1) ^ -static_cast<qint64>(zigzag & 1);
+    return true;
+}
+
+static bool getText(const uchar*& pos, const uchar* end, QString& text)
+{
+    quint64 length = 0;
+    if (!getVarint(pos, end, length) || length > quint64(end - pos)) return false;
+    text = QString::fromUtf8(reinterpret_cast<const char*>(pos), qsizetype(length));
+    pos += length;
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// BinaryLogWriter
+// ---------------------------------------------------------------------------
+
+BinaryLogWriter::~BinaryLogWriter()
+{
+    close();
+}
+
+bool BinaryLogWriter::open(const QString& path, QString& errorMessage)
+{
+    close();
+
+    // A crash can leave the last entry half written. Appending after it would
+    // make readers take the new section for the rest of that entry and lose
+    // everything written from here on, so cut it off first.
+    const qint64 existing = QFileInfo(path).size();
+    if (existing > 0 && existing < 4) {
+        QFile::resize(path, 0);     // died while writing the magic
+    } else if (existing > 0) {
+        BinaryLogReader reader;
+        if (!reader.open(path, errorMessage)) {
+            return false;
+        }
+        LogEvent event;
+        while (reader.next(event)) {}
+        // Anything else undecodable may belong to a newer format; keep it
+        if (!reader.errorString().isEmpty()) {
+            errorMessage = QString("Cannot append to '%1': %2").arg(path, reader.errorString());
+            return false;
+        }
+        if (reader.validLength() < existing && !QFile::resize(path, reader.validLength())) {
+            errorMessage = QString("Cannot truncate partial entry in '%1'").arg(path);
+            return false;
+        }
+    }
+
+    m_file.setFileName(path);
+    if (!m_file.open(QIODevice::WriteOnly | QIODevice::Append)) {
+        errorMessage = QString("Cannot open '%1': %2").arg(path, m_file.errorString());
+        return false;
+    }
+
+    if (m_file.size() == 0) {
+        uchar magic[4];
+        qToLittleEndian<quint32>(BinaryLogFormat::Magic, magic);
+        m_buffer.append(reinterpret_cast<const char*>(magic), 4);
+    }
+
+    const qint64 steadyNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+    m_buffer.append(static_cast<char>(SectionTag));
+    putVarint(m_buffer, BinaryLogFormat::Version);
+    putZigzag(m_buffer, QDateTime::currentMSecsSinceEpoch());
+    putZigzag(m_buffer, steadyNs);
+    m_lastSteadyUs = steadyNs / 1000;
+    flush();
+    return true;
+}
+
+void BinaryLogWriter::close()
+{
+    if (!m_file.isOpen()) return;
+    flush();
+    m_file.close();
+    m_strings.clear();
+    m_templates.clear();
+}
+
+void BinaryLogWriter::flush()
+{
+    if (m_buffer.isEmpty() || !m_file.isOpen()) return;
+    m_file.write(m_buffer);
+    m_file.flush();
+    m_buffer.clear();
+}
+
+quint32 BinaryLogWriter::stringId(const QString& text)
+{
+    auto it = m_strings.constFind(text);
+    if (it != m_strings.constEnd()) {
+        return it.value();
+    }
+
+    const quint32 id = quint32(m_strings.size());
+    m_strings.insert(text, id);
+    m_buffer.append(static_cast<char>(StringTag));
+    putVarint(m_buffer, id);
+    putText(m_buffer, text);
+    return id;
+}
+
+quint32 BinaryLogWriter::templateId(const char* category, const char* format)
+{
+    const QPair<const char*, const char*> key(category, format);
+    auto it = m_templates.constFind(key);
+    if (it != m_templates.constEnd()) {
+        return it.value();
+    }
+
+    quint64 categoryRef = 0;
+    if (category) {
+        categoryRef = stringId(QString::fromLatin1(category)) + 1;
+    }
+
+    const quint32 id = quint32(m_templates.size());
+    m_templates.insert(key, id);
+    m_buffer.append(static_cast<char>(TemplateTag));
+    putVarint(m_buffer, id);
+    putVarint(m_buffer, categoryRef);
+    putText(m_buffer, QString::fromUtf8(format));
+    return id;
+}
+
+void BinaryLogWriter::writeEventHeader(qint64 steadyNs, LogLevel level, quint32 templateId,
+                                       const QString& controller, qsizetype count)
+{
+    quint64 controllerRef = 0;
+    if (!controller.isEmpty()) {
+        controllerRef = stringId(controller) + 1;
+    }
+
+    // Records from different threads can reach the writer slightly out of
+    // order, so the delta may be negative
+    const qint64 steadyUs = steadyNs / 1000;
+    m_buffer.append(static_cast<char>(EventTag));
+    putZigzag(m_buffer, steadyUs - m_lastSteadyUs);
+    m_lastSteadyUs = steadyUs;
+    m_buffer.append(static_cast<char>(level));
+    putVarint(m_buffer, templateId);
+    putVarint(m_buffer, controllerRef);
+    m_buffer.append(static_cast<char>(count));
+}
+
+void BinaryLogWriter::writeArg(const LogArg& arg)
+{
+    switch (arg.type) {
+        case LogArg::Type::Int:
+            m_buffer.append(static_cast<char>(IntArg));
+            putZigzag(m_buffer, arg.integer);
+            break;
+        case LogArg::Type::Double: {
+            uchar bytes[8];
+            quint64 bits;
+            std::memcpy(&bits, &arg.real, sizeof(bits));
+            qToLittleEndian<quint64>(bits, bytes);
+            m_buffer.append(static_cast<char>(DoubleArg));
+            m_buffer.append(reinterpret_cast<const char*>(bytes), 8);
+            break;
+        }
+        case LogArg::Type::String: {
+            // append() interned it ahead of the event header if it qualified
+            auto it = arg.text.size() <= BinaryLogFormat::MaxInternedLength
+                ? m_strings.constFind(arg.text) : m_strings.constEnd();
+            if (it != m_strings.constEnd()) {
+                m_buffer.append(static_cast<char>(StringRefArg));
+                putVarint(m_buffer, it.value());
+            } else {
+                m_buffer.append(static_cast<char>(StringArg));
+                putText(m_buffer, arg.text);
+            }
+            break;
+        }
+    }
+}
+
+void BinaryLogWriter::append(qint64 steadyNs, LogLevel level, const char* category, const QString& controller,
+                             const char* format, const LogArg* args, qsizetype count)
+{
+    if (!m_file.isOpen()) return;
+    count = qMin<qsizetype>(count, 255);
+
+    // Definitions go out before the event that first uses them, never
+    // inside it
+    const quint32 id = templateId(category, format);
+    for (qsizetype i = 0; i < count; ++i) {
+        const LogArg& arg = args[i];
+        if (arg.type == LogArg::Type::String && arg.text.size() <= BinaryLogFormat::MaxInternedLength
+            && m_strings.size() < BinaryLogFormat::MaxInternedStrings) {
+            stringId(arg.text);
+        }
+    }
+    if (!controller.isEmpty()) {
+        stringId(controller);
+    }
+
+    writeEventHeader(steadyNs, level, id, controller, count);
+    for (qsizetype i = 0; i < count; ++i) {
+        writeArg(args[i]);
+    }
+
+    if (m_buffer.size() >= FlushThreshold) {
+        flush();
+    }
+}
+
+void BinaryLogWriter::appendMessage(qint64 steadyNs, LogLevel level, const char* category, const QString& controller,
+                                    const QString& message)
+{
+    if (!m_file.isOpen()) return;
+
+    // Free text is rarely repeated; keep it out of the string table
+    const quint32 id = templateId(category, MessageTemplate);
+    if (!controller.isEmpty()) {
+        stringId(controller);
+    }
+    writeEventHeader(steadyNs, level, id, controller, 1);
+    m_buffer.append(static_cast<char>(StringArg));
+    putText(m_buffer, message);
+
+    if (m_buffer.size() >= FlushThreshold) {
+        flush();
+    }
+}
+
+// ---------------------------------------------------------------------------
+// BinaryLogReader
+// ---------------------------------------------------------------------------
+
+bool BinaryLogReader::open(const QString& path, QString& errorMessage)
+{
+    QByteArray data;
+    if (!LogCompression::readFile(path, data, errorMessage)) {
+        return false;
+    }
+    return openData(data, errorMessage);
+}
+
+bool BinaryLogReader::openData(const QByteArray& data, QString& errorMessage)
+{
+    m_data = data;
+    m_pos = reinterpret_cast<const uchar*>(m_data.constData());
+    m_end = m_pos + m_data.size();
+    m_validLength = m_data.size();
+    m_error.clear();
+    m_strings.clear();
+    m_templates.clear();
+
+    if (m_data.size() < 4 || qFromLittleEndian<quint32>(m_pos) != BinaryLogFormat::Magic) {
+        errorMessage = "Not a binary log";
+        m_pos = m_end;
+        return false;
+    }
+    m_pos += 4;
+    return true;
+}
+
+bool BinaryLogReader::next(LogEvent& event)
+{
+    while (m_pos < m_end) {
+        const uchar tag = *m_pos;
+        bool ok = false;
+        switch (tag) {
+            case SectionTag:  ok = readSection(); break;
+            case StringTag:   ok = readString(); break;
+            case TemplateTag: ok = readTemplate(); break;
+            case EventTag:
+                if (readEvent(event)) return true;
+                break;
+            default:
+                m_error = QString("Unknown entry 0x%1 at offset %2")
+                          .arg(tag, 2, 16, QChar('0'))
+                          .arg(m_pos - reinterpret_cast<const uchar*>(m_data.constData()));
+                break;
+        }
+
+        // A read that fails without an error hit the end of the data: the
+        // last entry of a log cut short by a crash
+        if (!ok) {
+            m_validLength = m_pos - reinterpret_cast<const uchar*>(m_data.constData());
+            m_pos = m_end;
+            return false;
+        }
+    }
+    return false;
+}
+
+bool BinaryLogReader::readSection()
+{
+    const uchar* pos = m_pos + 1;
+    quint64 version = 0;
+    qint64 wallMs = 0;
+    qint64 steadyNs = 0;
+    if (!getVarint(pos, m_end, version) || !getZigzag(pos, m_end, wallMs) || !getZigzag(pos, m_end, steadyNs)) {
+        return false;
+    }
+    if (version != quint64(BinaryLogFormat::Version)) {
+        m_error = QString("Unsupported binary log version %1").arg(version);
+        return false;
+    }
+
+    m_pos = pos;
+    m_wallAnchorMs = wallMs;
+    m_steadyAnchorUs = steadyNs / 1000;
+    m_steadyUs = m_steadyAnchorUs;
+    m_strings.clear();
+    m_templates.clear();
+    return true;
+}
+
+bool BinaryLogReader::readString()
+{
+    const uchar* pos = m_pos + 1;
+    quint64 id = 0;
+    QString text;
+    if (!getVarint(pos, m_end, id) || !getText(pos, m_end, text)) return false;
+    m_pos = pos;
+    m_strings.insert(quint32(id), text);
+    return true;
+}
+
+bool BinaryLogReader::readTemplate()
+{
+    const uchar* pos = m_pos + 1;
+    quint64 id = 0;
+    quint64 categoryRef = 0;
+    Template entry;
+    if (!getVarint(pos, m_end, id) || !getVarint(pos, m_end, categoryRef) || !getText(pos, m_end, entry.format)) {
+        return false;
+    }
+    if (categoryRef) {
+        entry.category = m_strings.value(quint32(categoryRef - 1));
+    }
+    m_pos = pos;
+    m_templates.insert(quint32(id), entry);
+    return true;
+}
+
+bool BinaryLogReader::readEvent(LogEvent& event)
+{
+    const uchar* pos = m_pos + 1;
+    qint64 delta = 0;
+    quint64 templateId = 0;
+    quint64 controllerRef = 0;
+    if (!getZigzag(pos, m_end, delta) || pos >= m_end) return false;
+    const uchar level = *pos++;
+    if (!getVarint(pos, m_end, templateId) || !getVarint(pos, m_end, controllerRef) || pos >= m_end) return false;
+    const int count = *pos++;
+
+    auto tmpl = m_templates.constFind(quint32(templateId));
+    if (tmpl == m_templates.constEnd() || level > uchar(LogLevel::Critical)) {
+        m_error = "Event refers to an undefined template";
+        return false;
+    }
+
+    LogArgs args;
+    for (int i = 0; i < count; ++i) {
+        if (pos >= m_end) return false;
+        LogArg arg;
+        const uchar type = *pos++;
+        bool ok = true;
+        switch (type) {
+            case IntArg:
+                arg.type = LogArg::Type::Int;
+                ok = getZigzag(pos, m_end, arg.integer);
+                break;
+            case DoubleArg: {
+                if (m_end - pos < 8) {
+                    ok = false;
+                    break;
+                }
+                quint64 bits = qFromLittleEndian<quint64>(pos);
+                std::memcpy(&arg.real, &bits, sizeof(bits));
+                arg.type = LogArg::Type::Double;
+                pos += 8;
+                break;
+            }
+            case StringArg:
+                arg.type = LogArg::Type::String;
+                ok = getText(pos, m_end, arg.text);
+                break;
+            case StringRefArg: {
+                quint64 id = 0;
+                arg.type = LogArg::Type::String;
+                ok = getVarint(pos, m_end, id);
+                arg.text = m_strings.value(quint32(id));
+                break;
+            }
+            default:
+                m_error = QString("Unknown argument type %1").arg(type);
+                return false;
+        }
+        if (!ok) return false;
+        args.append(std::move(arg));
+    }
+
+    m_pos = pos;
+    m_steadyUs += delta;
+    event.timestampMs = m_wallAnchorMs + (m_steadyUs - m_steadyAnchorUs) / 1000;
+    event.level = static_cast<LogLevel>(level);
+    event.category = tmpl->category;
+    event.controller = controllerRef ? m_strings.value(quint32(controllerRef - 1)) : QString();
+    event.format = tmpl->format;
+    event.args = args;
+    return true;
+}
+
+} // namespace ObservatoryMonitor
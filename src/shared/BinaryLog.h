@@ -0,0 +1,136 @@
+#ifndef BINARYLOG_H
+#define BINARYLOG_H
+
+#include <QString>
+#include <QStringList>
+#include <QByteArray>
+#include <QHash>
+#include <QPair>
+#include <QFile>
+#include "LogEvent.h"
+
+namespace ObservatoryMonitor {
+
+// Structured binary log, used for the debug log when logging.debug_format
+// is "binary". A record is a template id plus its typed arguments; template
+// text, categories, controller names and short repeated string arguments are
+// written once per section and referenced by id afterwards.
+//
+// File layout:
+//
+//   magic "OMBL"
+//   entries, each starting with a tag byte:
+//     0x00 section   version, wall clock ms, steady clock ns (at open);
+//                    forgets every id defined before it
+//     0x01 string    id, text
+//     0x02 template  id, category string id + 1 (0 = none), format text
+//     0x03 event     steady clock delta in us (zigzag), level byte,
+//                    template id, controller string id + 1 (0 = none),
+//                    argument count byte, then per argument a type byte:
+//                      0 int     zigzag varint
+//                      1 double  8 bytes little-endian
+//                      2 string  text
+//                      3 string  id of a string entry
+//
+// Integers are LEB128 varints and text is a varint byte length followed by
+// UTF-8. Each open() starts a new section, so a restarted process appends to
+// the day's file without knowing the ids already in it. A crash can only
+// leave the last entry partly written; readers stop there, and open() cuts
+// it off before appending so the new section stays readable.
+namespace BinaryLogFormat {
+    constexpr quint32 Magic = 0x4c424d4f;   // "OMBL"
+    constexpr int Version = 1;
+    const char* const Extension = ".omlog";
+
+    // Strings up to this many UTF-16 units are interned
+    constexpr int MaxInternedLength = 48;
+    // Per section; later strings are written inline
+    constexpr int MaxInternedStrings = 4096;
+}
+
+class BinaryLogWriter
+{
+public:
+    BinaryLogWriter() = default;
+    ~BinaryLogWriter();
+
+    BinaryLogWriter(const BinaryLogWriter&) = delete;
+    BinaryLogWriter& operator=(const BinaryLogWriter&) = delete;
+
+    // Appends to path, starting a new section. Fails on a file that is not
+    // a binary log or has a corrupt entry before its end.
+    bool open(const QString& path, QString& errorMessage);
+    void close();
+    bool isOpen() const { return m_file.isOpen(); }
+    QString fileName() const { return m_file.fileName(); }
+    // Bytes in the file, buffered entries included
+    qint64 size() const { return m_file.isOpen() ? m_file.pos() + m_buffer.size() : 0; }
+
+    // category and format must have static storage duration; they are
+    // cached by address
+    void append(qint64 steadyNs, LogLevel level, const char* category, const QString& controller,
+                const char* format, const LogArg* args, qsizetype count);
+    // An unstructured message, stored as a "%1" template
+    void appendMessage(qint64 steadyNs, LogLevel level, const char* category, const QString& controller,
+                       const QString& message);
+
+    // Writes buffered entries to the file
+    void flush();
+
+private:
+    quint32 stringId(const QString& text);
+    quint32 templateId(const char* category, const char* format);
+    void writeEventHeader(qint64 steadyNs, LogLevel level, quint32 templateId,
+                          const QString& controller, qsizetype count);
+    void writeArg(const LogArg& arg);
+
+    QFile m_file;
+    QByteArray m_buffer;
+    qint64 m_lastSteadyUs = 0;
+    QHash<QString, quint32> m_strings;
+    QHash<QPair<const char*, const char*>, quint32> m_templates;
+};
+
+// Decodes a binary log front to back
+class BinaryLogReader
+{
+public:
+    // Also reads segments compressed by the Logger (.omlog.qz)
+    bool open(const QString& path, QString& errorMessage);
+    // Decodes an in-memory copy of a log file
+    bool openData(const QByteArray& data, QString& errorMessage);
+
+    // False at the end of the log, at a truncated last entry, or on a
+    // corrupt entry (then errorString() is set)
+    bool next(LogEvent& event);
+    QString errorString() const { return m_error; }
+    // Bytes up to the end of the last complete entry; short of the data size
+    // once next() has stopped at a partial or corrupt entry
+    qint64 validLength() const { return m_validLength; }
+
+private:
+    bool readSection();
+    bool readString();
+    bool readTemplate();
+    bool readEvent(LogEvent& event);
+
+    QByteArray m_data;
+    const uchar* m_pos = nullptr;
+    const uchar* m_end = nullptr;
+    qint64 m_validLength = 0;
+    QString m_error;
+
+    qint64 m_wallAnchorMs = 0;
+    qint64 m_steadyAnchorUs = 0;
+    qint64 m_steadyUs = 0;
+    QHash<quint32, QString> m_strings;
+    struct Template {
+        QString category;
+        QString format;
+    };
+    QHash<quint32, Template> m_templates;
+};
+
+} // namespace ObservatoryMonitor
+
+#endif // BINARYLOG_H
@@ -1,6 +1,7 @@
 #include "CapabilityRegistry.h"
 #include <yaml-cpp/yaml.h>
 #include <QFile>
+#include <QDataStream>
 #include <QDebug>
 #include <QVariant>
 
@@ -15,7 +16,7 @@ CapabilityRegistry::CapabilityRegistry(QObject* parent)
 void CapabilityRegistry::registerProperties(const QString& controllerType, const QList<PropertyDefinition>& properties)
 {
     m_capabilities[controllerType] = properties;
-    emit capabilitiesChanged();
+    rebuildIndex();
 }
 
 QList<PropertyDefinition> CapabilityRegistry::getProperties(const QString& controllerType) const
@@ -32,32 +33,71 @@ QStringList CapabilityRegistry::getPropertyNames(const QString& controllerType)
     return names;
 }
 
-QStringList CapabilityRegistry::allPropertyLinks() const
+bool CapabilityRegistry::hasPropertyLink(const QString& link) const
 {
-    QStringList links;
-    for (auto it = m_capabilities.begin(); it != m_capabilities.end(); ++it) {
-        for (const auto& prop : it.value()) {
-            links << it.key() + "." + prop.name;
-        }
-    }
-    links.sort();
-    return links;
+    return findPropertyLink(link) != nullptr;
 }
 
-QVariantMap CapabilityRegistry::getProperty(const QString& controllerType, const QString& propertyName) const
+const PropertyDefinition* CapabilityRegistry::findPropertyLink(const QString& link) const
 {
-    for (const auto& prop : m_capabilities.value(controllerType)) {
-        if (prop.name == propertyName) {
-            QVariantMap map;
-            map["name"] = prop.name;
-            map["command"] = prop.command;
-            map["description"] = prop.description;
-            map["unit"] = prop.unit;
-            map["type"] = prop.type;
-            return map;
+    qsizetype dot = link.indexOf('.');
+    if (dot < 0) return nullptr;
+    return findProperty(link.left(dot), link.mid(dot + 1));
+}
+
+const PropertyDefinition* CapabilityRegistry::findProperty(const QString& controllerType, const QString& propertyName) const
+{
+    auto type = m_index.constFind(controllerType);
+    if (type == m_index.constEnd()) return nullptr;
+    auto it = type->byName.constFind(propertyName);
+    if (it == type->byName.constEnd()) return nullptr;
+    return &m_capabilities.constFind(controllerType)->at(it.value());
+}
+
+const PropertyDefinition* CapabilityRegistry::findByCommand(const QString& controllerType, const QString& command) const
+{
+    auto type = m_index.constFind(controllerType);
+    if (type == m_index.constEnd()) return nullptr;
+    auto it = type->byCommand.constFind(command);
+    if (it == type->byCommand.constEnd()) return nullptr;
+    return &m_capabilities.constFind(controllerType)->at(it.value());
+}
+
+PropertyDefinition CapabilityRegistry::getProperty(const QString& controllerType, const QString& propertyName) const
+{
+    const PropertyDefinition* prop = findProperty(controllerType, propertyName);
+    return prop ? *prop : PropertyDefinition();
+}
+
+PropertyDefinition CapabilityRegistry::getPropertyForCommand(const QString& controllerType, const QString& command) const
+{
+    const PropertyDefinition* prop = findByCommand(controllerType, command);
+    return prop ? *prop : PropertyDefinition();
+}
+
+void CapabilityRegistry::rebuildIndex()
+{
+    m_index.clear();
+    m_links.clear();
+    for (auto it = m_capabilities.cbegin(); it != m_capabilities.cend(); ++it) {
+        TypeIndex& index = m_index[it.key()];
+        const QList<PropertyDefinition>& props = it.value();
+        index.byName.reserve(props.size());
+        index.byCommand.reserve(props.size());
+        for (qsizetype i = 0; i < props.size(); ++i) {
+            // First definition wins, as the old linear scan did
+            const PropertyDefinition& prop = props[i];
+            if (!prop.name.isEmpty() && !index.byName.contains(prop.name)) {
+                index.byName.insert(prop.name, i);
+            }
+            if (!prop.command.isEmpty() && !index.byCommand.contains(prop.command)) {
+                index.byCommand.insert(prop.command, i);
+            }
+            m_links << it.key() + "." + prop.name;
         }
     }
-    return QVariantMap();
+    m_links.sort();
+    emit capabilitiesChanged();
 }
 
 void CapabilityRegistry::setDefaults()
@@ -80,7 +120,7 @@ void CapabilityRegistry::setDefaults()
     telProps << PropertyDefinition{"PierSide", ":GS#", "Side of Pier", "", "binary"};
     m_capabilities["Telescope"] = telProps;
     
-    emit capabilitiesChanged();
+    rebuildIndex();
 }
 
 bool CapabilityRegistry::loadFromFile(const QString& filePath, QString& errorMessage)
@@ -109,7 +149,7 @@ bool CapabilityRegistry::loadFromFile(const QString& filePath, QString& errorMes
             }
             m_capabilities[type] = propList;
         }
-        emit capabilitiesChanged();
+        rebuildIndex();
         return true;
     } catch (const std::exception& e) {
         errorMessage = QString::fromStdString(e.what());
@@ -153,4 +193,39 @@ bool CapabilityRegistry::saveToFile(const QString& filePath, QString& errorMessa
     }
 }
 
+void CapabilityRegistry::saveToStream(QDataStream& out) const
+{
+    out << quint32(m_capabilities.size());
+    for (auto it = m_capabilities.cbegin(); it != m_capabilities.cend(); ++it) {
+        out << it.key() << quint32(it.value().size());
+        for (const auto& prop : it.value()) {
+            out << prop.name << prop.command << prop.description << prop.unit << prop.type;
+        }
+    }
+}
+
+bool CapabilityRegistry::loadFromStream(QDataStream& in)
+{
+    QHash<QString, QList<PropertyDefinition>> capabilities;
+    quint32 typeCount = 0;
+    in >> typeCount;
+    for (quint32 t = 0; t < typeCount && in.status() == QDataStream::Ok; ++t) {
+        QString type;
+        quint32 propCount = 0;
+        in >> type >> propCount;
+        QList<PropertyDefinition> propList;
+        for (quint32 i = 0; i < propCount && in.status() == QDataStream::Ok; ++i) {
+            PropertyDefinition def;
+            in >> def.name >> def.command >> def.description >> def.unit >> def.type;
+            propList << def;
+        }
+        capabilities[type] = propList;
+    }
+    if (in.status() != QDataStream::Ok) return false;
+
+    m_capabilities = capabilities;
+    rebuildIndex();
+    return true;
+}
+
 } // namespace ObservatoryMonitor
@@ -6,9 +6,22 @@
 #include <QHash>
 #include <QObject>
 
+class QDataStream;
+
 namespace ObservatoryMonitor {
 
+// One capability of a controller type. A plain value type; QML gets it
+// by value from the registry's lookups.
 struct PropertyDefinition {
+    Q_GADGET
+    Q_PROPERTY(QString name MEMBER name)
+    Q_PROPERTY(QString command MEMBER command)
+    Q_PROPERTY(QString description MEMBER description)
+    Q_PROPERTY(QString unit MEMBER unit)
+    Q_PROPERTY(QString type MEMBER type)
+    Q_PROPERTY(bool valid READ isValid)
+
+public:
     QString name;
     QString command;
     QString description;
@@ -16,6 +29,9 @@ struct PropertyDefinition {
     
     // Hint for UI: "numeric", "string", "binary"
     QString type;
+
+    // Lookups that find nothing return a default (invalid) definition
+    bool isValid() const { return !name.isEmpty(); }
 };
 
 class CapabilityRegistry : public QObject
@@ -34,15 +50,29 @@ public:
     // Get property names for a controller type (for UI selection)
     QStringList getPropertyNames(const QString& controllerType) const;
     
-    // Get all property links (e.g. "Telescope.Azimuth")
-    QStringList allPropertyLinks() const;
+    // Get all property links (e.g. "Telescope.Azimuth"), sorted. Built once
+    // per capabilitiesChanged, so reading it from QML is cheap.
+    QStringList allPropertyLinks() const { return m_links; }
+    bool hasPropertyLink(const QString& link) const;
+    // Resolves "Type.Name"; null when either part is unknown
+    const PropertyDefinition* findPropertyLink(const QString& link) const;
 
-    // Find property by name
-    Q_INVOKABLE QVariantMap getProperty(const QString& controllerType, const QString& propertyName) const;
+    // Hash lookups; null when absent. Pointers stay valid until the next
+    // capabilitiesChanged.
+    const PropertyDefinition* findProperty(const QString& controllerType, const QString& propertyName) const;
+    const PropertyDefinition* findByCommand(const QString& controllerType, const QString& command) const;
+
+    // Find property by name, or by the command that reads it
+    Q_INVOKABLE PropertyDefinition getProperty(const QString& controllerType, const QString& propertyName) const;
+    Q_INVOKABLE PropertyDefinition getPropertyForCommand(const QString& controllerType, const QString& command) const;
 
     // Load/Save to YAML
     bool loadFromFile(const QString& filePath, QString& errorMessage);
     bool saveToFile(const QString& filePath, QString& errorMessage);
+
+    // Compact binary form for LayoutCache; on a stream error nothing is changed
+    void saveToStream(QDataStream& out) const;
+    bool loadFromStream(QDataStream& in);
     
     void setDefaults();
 
@@ -50,7 +80,17 @@ signals:
     void capabilitiesChanged();
 
 private:
+    struct TypeIndex {
+        QHash<QString, qsizetype> byName;     // -> position in m_capabilities[type]
+        QHash<QString, qsizetype> byCommand;
+    };
+
+    // Rebuilds the indexes and link list, then emits capabilitiesChanged
+    void rebuildIndex();
+
     QHash<QString, QList<PropertyDefinition>> m_capabilities;
+    QHash<QString, TypeIndex> m_index;
+    QStringList m_links;
 };
 
 } // namespace ObservatoryMonitor
@@ -30,6 +30,17 @@ void Config::setDefaults()
     m_logging = LoggingConfig();
     m_logging.debugEnabled = false;
     m_logging.maxTotalSizeMB = 100;
+    m_logging.maxFileSizeMB = 0;
+    m_logging.compress = true;
+    m_logging.async = true;
+    m_logging.overflowPolicy = "drop";
+    m_logging.debugFormat = "text";
+    
+    // Telemetry defaults
+    m_telemetry = TelemetryConfig();
+    
+    // Startup defaults
+    m_startup = StartupConfig();
     
     // GUI defaults
     m_gui = GuiConfig();
@@ -38,6 +49,7 @@ void Config::setDefaults()
     m_gui.show3DView = true;
     m_gui.sidebarWidth = 280;
     m_gui.sidebarPosition = "Left";
+    m_gui.maxUpdateRate = 60;
     
     // Default controllers
     m_controllers.clear();
@@ -112,6 +124,9 @@ bool Config::loadFromFile(const QString& filePath, QString& errorMessage)
                 if (ctrl["type"]) controller.type = QString::fromStdString(ctrl["type"].as<std::string>());
                 if (ctrl["prefix"]) controller.prefix = QString::fromStdString(ctrl["prefix"].as<std::string>());
                 if (ctrl["enabled"]) controller.enabled = ctrl["enabled"].as<bool>();
+                if (ctrl["transport"]) controller.transport = QString::fromStdString(ctrl["transport"].as<std::string>()).toLower();
+                if (ctrl["host"]) controller.host = QString::fromStdString(ctrl["host"].as<std::string>());
+                if (ctrl["port"]) controller.port = ctrl["port"].as<int>();
                 
                 m_controllers.append(controller);
             }
@@ -146,6 +161,26 @@ bool Config::loadFromFile(const QString& filePath, QString& errorMessage)
             YAML::Node logging = config["logging"];
             if (logging["debug_enabled"]) m_logging.debugEnabled = logging["debug_enabled"].as<bool>();
             if (logging["max_total_size_mb"]) m_logging.maxTotalSizeMB = logging["max_total_size_mb"].as<int>();
+            if (logging["max_file_size_mb"]) m_logging.maxFileSizeMB = logging["max_file_size_mb"].as<int>();
+            if (logging["compress"]) m_logging.compress = logging["compress"].as<bool>();
+            if (logging["async"]) m_logging.async = logging["async"].as<bool>();
+            if (logging["overflow"]) m_logging.overflowPolicy = QString::fromStdString(logging["overflow"].as<std::string>());
+            if (logging["debug_format"]) m_logging.debugFormat = QString::fromStdString(logging["debug_format"].as<std::string>());
+        }
+        
+        // Parse telemetry settings
+        if (config["telemetry"]) {
+            YAML::Node telemetry = config["telemetry"];
+            if (telemetry["enabled"]) m_telemetry.enabled = telemetry["enabled"].as<bool>();
+            if (telemetry["raw_retention_days"]) m_telemetry.rawRetentionDays = telemetry["raw_retention_days"].as<int>();
+            if (telemetry["minute_retention_days"]) m_telemetry.minuteRetentionDays = telemetry["minute_retention_days"].as<int>();
+        }
+        
+        // Parse startup settings
+        if (config["startup"]) {
+            YAML::Node startup = config["startup"];
+            if (startup["max_concurrent_connects"]) m_startup.maxConcurrentConnects = startup["max_concurrent_connects"].as<int>();
+            if (startup["ready_timeout"]) m_startup.readyTimeout = startup["ready_timeout"].as<int>();
         }
         
         // Parse GUI settings
@@ -156,6 +191,7 @@ bool Config::loadFromFile(const QString& filePath, QString& errorMessage)
             if (gui["show_3d_view"]) m_gui.show3DView = gui["show_3d_view"].as<bool>();
             if (gui["sidebar_width"]) m_gui.sidebarWidth = gui["sidebar_width"].as<int>();
             if (gui["sidebar_position"]) m_gui.sidebarPosition = QString::fromStdString(gui["sidebar_position"].as<std::string>());
+            if (gui["max_update_rate"]) m_gui.maxUpdateRate = gui["max_update_rate"].as<int>();
         }
         
         return true;
@@ -224,6 +260,11 @@ bool Config::saveToFile(const QString& filePath, QString& errorMessage)
             out << YAML::Key << "type" << YAML::Value << ctrl.type.toStdString();
             out << YAML::Key << "prefix" << YAML::Value << ctrl.prefix.toStdString();
             out << YAML::Key << "enabled" << YAML::Value << ctrl.enabled;
+            if (ctrl.transport != "mqtt") {
+                out << YAML::Key << "transport" << YAML::Value << ctrl.transport.toStdString();
+                out << YAML::Key << "host" << YAML::Value << ctrl.host.toStdString();
+                out << YAML::Key << "port" << YAML::Value << ctrl.port;
+            }
             out << YAML::EndMap;
         }
         out << YAML::EndSeq;
@@ -248,6 +289,26 @@ bool Config::saveToFile(const QString& filePath, QString& errorMessage)
         out << YAML::Value << YAML::BeginMap;
         out << YAML::Key << "debug_enabled" << YAML::Value << m_logging.debugEnabled;
         out << YAML::Key << "max_total_size_mb" << YAML::Value << m_logging.maxTotalSizeMB;
+        out << YAML::Key << "max_file_size_mb" << YAML::Value << m_logging.maxFileSizeMB;
+        out << YAML::Key << "compress" << YAML::Value << m_logging.compress;
+        out << YAML::Key << "async" << YAML::Value << m_logging.async;
+        out << YAML::Key << "overflow" << YAML::Value << m_logging.overflowPolicy.toStdString();
+        out << YAML::Key << "debug_format" << YAML::Value << m_logging.debugFormat.toStdString();
+        out << YAML::EndMap;
+        
+        // Telemetry section
+        out << YAML::Key << "telemetry";
+        out << YAML::Value << YAML::BeginMap;
+        out << YAML::Key << "enabled" << YAML::Value << m_telemetry.enabled;
+        out << YAML::Key << "raw_retention_days" << YAML::Value << m_telemetry.rawRetentionDays;
+        out << YAML::Key << "minute_retention_days" << YAML::Value << m_telemetry.minuteRetentionDays;
+        out << YAML::EndMap;
+        
+        // Startup section
+        out << YAML::Key << "startup";
+        out << YAML::Value << YAML::BeginMap;
+        out << YAML::Key << "max_concurrent_connects" << YAML::Value << m_startup.maxConcurrentConnects;
+        out << YAML::Key << "ready_timeout" << YAML::Value << m_startup.readyTimeout;
         out << YAML::EndMap;
         
         // GUI section
@@ -258,6 +319,7 @@ bool Config::saveToFile(const QString& filePath, QString& errorMessage)
         out << YAML::Key << "show_3d_view" << YAML::Value << m_gui.show3DView;
         out << YAML::Key << "sidebar_width" << YAML::Value << m_gui.sidebarWidth;
         out << YAML::Key << "sidebar_position" << YAML::Value << m_gui.sidebarPosition.toStdString();
+        out << YAML::Key << "max_update_rate" << YAML::Value << m_gui.maxUpdateRate;
         out << YAML::EndMap;
         
         out << YAML::EndMap;
@@ -309,6 +371,16 @@ bool Config::validate(QString& errorMessage) const
         errors << logError;
     }
     
+    QString telemetryError;
+    if (!validateTelemetry(telemetryError)) {
+        errors << telemetryError;
+    }
+    
+    QString startupError;
+    if (!validateStartup(startupError)) {
+        errors << startupError;
+    }
+    
     QString guiError;
     if (!validateGui(guiError)) {
         errors << guiError;
@@ -380,7 +452,22 @@ for (int i = 0; i < m_controllers.size(); i++) {
         errors << QString("%1: type is empty (controllers[%2].type)").arg(prefix).arg(i);
     }
     
-    if (ctrl.prefix.isEmpty()) {
+    if (ctrl.transport == "tcp") {
+        if (ctrl.host.isEmpty()) {
+            errors << QString("%1: host is empty for TCP transport (controllers[%2].host)").arg(prefix).arg(i);
+        }
+        if (ctrl.port < 1 || ctrl.port > 65535) {
+            errors << QString("%1: port is invalid: %2 (controllers[%3].port)\n"
+                             "Valid range: 1-65535")
+                             .arg(prefix)
+                             .arg(ctrl.port)
+                             .arg(i);
+        }
+    } else if (ctrl.transport != "mqtt") {
+        errors << QString("%1: unknown transport '%2' (controllers[%3].transport). Valid options: mqtt, tcp")
+                         .arg(prefix, ctrl.transport)
+                         .arg(i);
+    } else if (ctrl.prefix.isEmpty()) {
         errors << QString("%1: MQTT prefix is empty (controllers[%2].prefix)").arg(prefix).arg(i);
     }
     
@@ -450,6 +537,25 @@ if (m_logging.maxTotalSizeMB < 1 || m_logging.maxTotalSizeMB > 10000) {
                      .arg(m_logging.maxTotalSizeMB);
 }
 
+// 0 leaves the segment size to the Logger: a tenth of the total
+if (m_logging.maxFileSizeMB < 0 || m_logging.maxFileSizeMB > m_logging.maxTotalSizeMB) {
+    errors << QString("Logging max file size is out of range: %1 MB (logging.max_file_size_mb)\n"
+                     "Valid range: 0 (a tenth of the total) up to logging.max_total_size_mb")
+                     .arg(m_logging.maxFileSizeMB);
+}
+
+if (m_logging.overflowPolicy != "drop" && m_logging.overflowPolicy != "block") {
+    errors << QString("Invalid logging overflow policy: %1 (logging.overflow)\n"
+                     "Valid values: drop, block")
+                     .arg(m_logging.overflowPolicy);
+}
+
+if (m_logging.debugFormat != "text" && m_logging.debugFormat != "binary") {
+    errors << QString("Invalid debug log format: %1 (logging.debug_format)\n"
+                     "Valid values: text, binary")
+                     .arg(m_logging.debugFormat);
+}
+
 if (!errors.isEmpty()) {
     errorMessage = "Logging configuration errors:\n" + errors.join("\n");
     return false;
@@ -457,6 +563,54 @@ if (!errors.isEmpty()) {
 
 return true;
 }
+bool Config::validateTelemetry(QString& errorMessage) const
+{
+    QStringList errors;
+    
+    if (m_telemetry.rawRetentionDays < 1 || m_telemetry.rawRetentionDays > 366) {
+        errors << QString("Telemetry raw retention is out of range: %1 days (telemetry.raw_retention_days)\n"
+                         "Valid range: 1-366 days")
+                         .arg(m_telemetry.rawRetentionDays);
+    }
+    
+    if (m_telemetry.minuteRetentionDays < m_telemetry.rawRetentionDays || m_telemetry.minuteRetentionDays > 3660) {
+        errors << QString("Telemetry minute retention is out of range: %1 days (telemetry.minute_retention_days)\n"
+                         "Valid range: raw_retention_days-3660 days")
+                         .arg(m_telemetry.minuteRetentionDays);
+    }
+    
+    if (!errors.isEmpty()) {
+        errorMessage = "Telemetry configuration errors:\n" + errors.join("\n");
+        return false;
+    }
+    
+    return true;
+}
+
+bool Config::validateStartup(QString& errorMessage) const
+{
+    QStringList errors;
+    
+    if (m_startup.maxConcurrentConnects < 0 || m_startup.maxConcurrentConnects > 64) {
+        errors << QString("Startup connect limit is out of range: %1 (startup.max_concurrent_connects)\n"
+                         "Valid range: 0-64 (0 = all at once)")
+                         .arg(m_startup.maxConcurrentConnects);
+    }
+    
+    if (m_startup.readyTimeout < 1 || m_startup.readyTimeout > 300) {
+        errors << QString("Startup ready timeout is out of range: %1 seconds (startup.ready_timeout)\n"
+                         "Valid range: 1-300 seconds")
+                         .arg(m_startup.readyTimeout);
+    }
+    
+    if (!errors.isEmpty()) {
+        errorMessage = "Startup configuration errors:\n" + errors.join("\n");
+        return false;
+    }
+    
+    return true;
+}
+
 bool Config::validateGui(QString& errorMessage) const
 {
     QStringList errors;
@@ -471,6 +625,11 @@ bool Config::validateGui(QString& errorMessage) const
                          .arg(m_gui.sidebarWidth);
     }
     
+    if (m_gui.maxUpdateRate < 0 || m_gui.maxUpdateRate > 240) {
+        errors << QString("GUI update rate is out of range: %1 (gui.max_update_rate). Valid range: 0-240")
+                         .arg(m_gui.maxUpdateRate);
+    }
+    
     if (!errors.isEmpty()) {
         errorMessage = "GUI configuration errors:\n" + errors.join("\n");
         return false;
@@ -23,8 +23,11 @@ struct ControllerConfig {
     QString type;
     QString prefix;
     bool enabled;
+    QString transport;  // "mqtt" (through the broker) or "tcp" (LX200 direct)
+    QString host;       // tcp only
+    int port;           // tcp only
     
-    ControllerConfig() : enabled(true) {}
+    ControllerConfig() : enabled(true), transport("mqtt"), port(9999) {}
 };
 
 // Structure for equipment type configuration
@@ -37,8 +40,31 @@ struct EquipmentType {
 struct LoggingConfig {
     bool debugEnabled;
     int maxTotalSizeMB;
+    int maxFileSizeMB;          // a log file past this starts a new segment; 0 = a tenth of the total
+    bool compress;              // compress closed segments in the background
+    bool async;                 // queue records for a writer thread
+    QString overflowPolicy;     // "drop" or "block" when the queue is full
+    QString debugFormat;        // "text" or "binary" (.omlog, see observatory-logdump)
     
-    LoggingConfig() : debugEnabled(false), maxTotalSizeMB(100) {}
+    LoggingConfig() : debugEnabled(false), maxTotalSizeMB(100), maxFileSizeMB(0), compress(true),
+                      async(true), overflowPolicy("drop"), debugFormat("text") {}
+};
+
+// Structure for telemetry recording configuration
+struct TelemetryConfig {
+    bool enabled;
+    int rawRetentionDays;      // 1 s samples
+    int minuteRetentionDays;   // 1 min aggregates
+    
+    TelemetryConfig() : enabled(true), rawRetentionDays(7), minuteRetentionDays(365) {}
+};
+
+// Structure for startup connection configuration
+struct StartupConfig {
+    int maxConcurrentConnects;  // controllers connecting at once; 0 = all
+    int readyTimeout;           // seconds to wait for a controller before moving on
+    
+    StartupConfig() : maxConcurrentConnects(4), readyTimeout(10) {}
 };
 
 // Structure for GUI configuration
@@ -48,6 +74,7 @@ struct GuiConfig {
     bool show3DView;
     int sidebarWidth;
     QString sidebarPosition;
+    int maxUpdateRate;  // Hz, controller updates coalesced per UI frame; 0 = unbatched
     
     GuiConfig() 
         : theme("Dark")
@@ -55,6 +82,7 @@ struct GuiConfig {
         , show3DView(true)
         , sidebarWidth(280)
         , sidebarPosition("Left")
+        , maxUpdateRate(60)
     {}
 };
 
@@ -81,13 +109,15 @@ public:
     bool validate(QString& errorMessage) const;
     
     // Getters
-    BrokerConfig broker() const { return m_broker; }
+    const BrokerConfig& broker() const { return m_broker; }
     double mqttTimeout() const { return m_mqttTimeout; }
     int reconnectInterval() const { return m_reconnectInterval; }
     QList<ControllerConfig> controllers() const { return m_controllers; }
     QList<EquipmentType> equipmentTypes() const { return m_equipmentTypes; }
     LoggingConfig logging() const { return m_logging; }
-    GuiConfig gui() const { return m_gui; }
+    TelemetryConfig telemetry() const { return m_telemetry; }
+    StartupConfig startup() const { return m_startup; }
+    const GuiConfig& gui() const { return m_gui; }
     
     // Setters (for testing)
     void setBroker(const BrokerConfig& broker) { m_broker = broker; }
@@ -97,6 +127,8 @@ public:
     void addController(const ControllerConfig& controller) { m_controllers.append(controller); }
     void addEquipmentType(const EquipmentType& type) { m_equipmentTypes.append(type); }
     void setLogging(const LoggingConfig& logging) { m_logging = logging; }
+    void setTelemetry(const TelemetryConfig& telemetry) { m_telemetry = telemetry; }
+    void setStartup(const StartupConfig& startup) { m_startup = startup; }
     void setGui(const GuiConfig& gui) { m_gui = gui; }
     
 private:
@@ -106,6 +138,8 @@ private:
     QList<ControllerConfig> m_controllers;
     QList<EquipmentType> m_equipmentTypes;
     LoggingConfig m_logging;
+    TelemetryConfig m_telemetry;
+    StartupConfig m_startup;
     GuiConfig m_gui;
     
     // Helper methods
@@ -113,6 +147,8 @@ private:
     bool validateControllers(QString& errorMessage) const;
     bool validateEquipmentTypes(QString& errorMessage) const;
     bool validateLogging(QString& errorMessage) const;
+    bool validateTelemetry(QString& errorMessage) const;
+    bool validateStartup(QString& errorMessage) const;
     bool validateGui(QString& errorMessage) const;
 };
 
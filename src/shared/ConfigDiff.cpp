@@ -0,0 +1,73 @@
+#include "ConfigDiff.h"
+#include <QHash>
+
+namespace ObservatoryMonitor {
+
+bool ConfigDiff::isEmpty() const
+{
+    return added.isEmpty() && removed.isEmpty() && recreated.isEmpty()
+        && enableChanged.isEmpty() && !brokerChanged && !timingChanged;
+}
+
+QString ConfigDiff::summary() const
+{
+    if (isEmpty()) {
+        return "no changes";
+    }
+
+    QStringList parts;
+    if (!added.isEmpty()) parts << QString("%1 added").arg(added.size());
+    if (!removed.isEmpty()) parts << QString("%1 removed").arg(removed.size());
+    if (!recreated.isEmpty()) parts << QString("%1 reconfigured").arg(recreated.size());
+    if (!enableChanged.isEmpty()) parts << QString("%1 enabled/disabled").arg(enableChanged.size());
+    if (!unchanged.isEmpty()) parts << QString("%1 unchanged").arg(unchanged.size());
+    if (brokerChanged) parts << "broker connection changed";
+    if (timingChanged) parts << "broker timing changed";
+    return parts.join(", ");
+}
+
+ConfigDiff ConfigDiff::compute(const QList<ControllerConfig>& before, const QList<ControllerConfig>& after)
+{
+    ConfigDiff diff;
+
+    QHash<QString, const ControllerConfig*> previous;
+    for (const auto& ctrl : before) {
+        previous.insert(ctrl.name, &ctrl);
+    }
+
+    for (const auto& ctrl : after) {
+        const ControllerConfig* old = previous.take(ctrl.name);
+        if (!old) {
+            diff.added << ctrl;
+        } else if (old->type != ctrl.type || old->prefix != ctrl.prefix || !sameEndpoint(*old, ctrl)) {
+            diff.recreated << ctrl;
+        } else if (old->enabled != ctrl.enabled) {
+            diff.enableChanged << ctrl;
+        } else {
+            diff.unchanged << ctrl.name;
+        }
+    }
+
+    // Whatever was not matched by name is gone; keep the original order
+    for (const auto& ctrl : before) {
+        if (previous.contains(ctrl.name)) {
+            diff.removed << ctrl.name;
+        }
+    }
+
+    return diff;
+}
+
+bool ConfigDiff::sameEndpoint(const ControllerConfig& a, const ControllerConfig& b)
+{
+    if (a.transport != b.transport) return false;
+    return a.transport != "tcp" || (a.host == b.host && a.port == b.port);
+}
+
+bool ConfigDiff::sameConnection(const BrokerConfig& a, const BrokerConfig& b)
+{
+    return a.host == b.host && a.port == b.port
+        && a.username == b.username && a.password == b.password;
+}
+
+} // namespace ObservatoryMonitor
@@ -0,0 +1,34 @@
+#ifndef CONFIGDIFF_H
+#define CONFIGDIFF_H
+
+#include <QString>
+#include <QStringList>
+#include <QList>
+#include "Config.h"
+
+namespace ObservatoryMonitor {
+
+// Difference between the applied controller/broker configuration and a new
+// one, so a reload only touches what actually changed
+struct ConfigDiff {
+    QList<ControllerConfig> added;
+    QStringList removed;
+    QList<ControllerConfig> recreated;      // type, prefix or endpoint changed: a different device
+    QList<ControllerConfig> enableChanged;  // only the enabled flag changed
+    QStringList unchanged;
+
+    bool brokerChanged = false;   // host, port or credentials: connections must be rebuilt
+    bool timingChanged = false;   // timeout / reconnect interval: applied in place
+
+    bool isEmpty() const;
+    QString summary() const;
+
+    static ConfigDiff compute(const QList<ControllerConfig>& before, const QList<ControllerConfig>& after);
+    static bool sameConnection(const BrokerConfig& a, const BrokerConfig& b);
+    // Same transport and, for direct TCP, the same host and port
+    static bool sameEndpoint(const ControllerConfig& a, const ControllerConfig& b);
+};
+
+} // namespace ObservatoryMonitor
+
+#endif // CONFIGDIFF_H
@@ -1,16 +1,27 @@
 #include "ControllerManager.h"
 #include "MqttController.h"
+#include "TcpLx200Controller.h"
 #include "Logger.h"
+#include "ConfigDiff.h"
+#include <QMetaMethod>
 
 namespace ObservatoryMonitor {
 
+static LogCategory lcControllerManager("ControllerManager");
+
 ControllerManager::ControllerManager(QObject* parent)
     : QObject(parent)
     , m_systemStatus(SystemStatus::Disconnected)
     , m_fastPollInterval(1000)
     , m_slowPollInterval(10000)
     , m_isPolling(false)
+    , m_isActive(false)
+    , m_mqttTimeout(0.0)
+    , m_reconnectInterval(0)
+    , m_batcher(new UpdateBatcher(this))
 {
+    connect(m_batcher, &UpdateBatcher::flushed, this, &ControllerManager::onBatchFlushed);
+    publishSnapshot();
 }
 
 ControllerManager::~ControllerManager()
@@ -23,32 +34,120 @@ ControllerManager::~ControllerManager()
 
 void ControllerManager::loadControllersFromConfig(const Config& config)
 {
-    Logger::instance().info("ControllerManager: Loading controllers from configuration");
-    
-    stopPolling();
-    disconnectAll();
-    
-    for (auto& info : m_controllers) {
-        delete info.controller;
+    // Diff against what is running so untouched controllers keep their
+    // connections and cached values
+    ConfigDiff diff = ConfigDiff::compute(controllerConfigs(), config.controllers());
+    diff.brokerChanged = !ConfigDiff::sameConnection(m_broker, config.broker());
+    diff.timingChanged = m_mqttTimeout != config.mqttTimeout() || m_reconnectInterval != config.reconnectInterval();
+
+    OM_INFO(lcControllerManager, QString("Applying configuration (%1)").arg(diff.summary()));
+
+    for (const QString& name : diff.removed) {
+        removeController(name);
     }
-    m_controllers.clear();
-    
-    for (const auto& ctrl : config.controllers()) {
+    for (const auto& ctrl : diff.recreated) {
+        removeController(ctrl.name);
+    }
+
+    // Existing controllers pick up broker changes; new ones are created with them
+    updateBrokerConfig(config.broker(), config.mqttTimeout(), config.reconnectInterval());
+    setEquipmentTypes(config.equipmentTypes());
+
+    for (const auto& ctrl : diff.recreated + diff.added) {
         addController(ctrl, config.broker(), config.mqttTimeout(), config.reconnectInterval());
+        if (ctrl.enabled && m_isActive) {
+            connectController(ctrl.name);
+            if (m_isPolling) startControllerPolling(ctrl.name);
+        }
+    }
+
+    for (const auto& ctrl : diff.enableChanged) {
+        enableController(ctrl.name, ctrl.enabled);
     }
 }
 
+QList<ControllerConfig> ControllerManager::controllerConfigs() const
+{
+    QList<ControllerConfig> configs;
+    for (const auto& info : m_controllers) {
+        ControllerConfig config;
+        config.name = info.name;
+        config.type = info.type;
+        config.prefix = info.prefix;
+        config.enabled = info.enabled;
+        config.transport = info.transport;
+        config.host = info.host;
+        config.port = info.port;
+        configs << config;
+    }
+    return configs;
+}
+
 void ControllerManager::updateBrokerConfig(const BrokerConfig& broker, double timeout, int reconnectInterval)
 {
-    Logger::instance().info("ControllerManager: Updating broker configuration for all controllers");
+    if (ConfigDiff::sameConnection(m_broker, broker) && m_mqttTimeout == timeout && m_reconnectInterval == reconnectInterval) {
+        return;
+    }
+
+    m_broker = broker;
+    m_mqttTimeout = timeout;
+    m_reconnectInterval = reconnectInterval;
+
+    // Controllers only reconnect when host, port or credentials changed
+    OM_INFO(lcControllerManager, "Updating broker configuration for all controllers");
     for (auto it = m_controllers.begin(); it != m_controllers.end(); ++it) {
-        MqttController* mqttCtrl = qobject_cast<MqttController*>(it.value().controller);
-        if (mqttCtrl) {
+        if (MqttController* mqttCtrl = qobject_cast<MqttController*>(it.value().controller)) {
             mqttCtrl->updateConfig(broker, timeout, reconnectInterval);
+        } else if (TcpLx200Controller* tcpCtrl = qobject_cast<TcpLx200Controller*>(it.value().controller)) {
+            // Direct controllers share the timing settings but not the broker
+            tcpCtrl->updateConfig(timeout, reconnectInterval);
         }
     }
 }
 
+void ControllerManager::setEquipmentTypes(const QList<EquipmentType>& types)
+{
+    for (auto& info : m_controllers) {
+        account(info, -1);
+    }
+
+    QStringList previous = m_equipmentNames;
+    m_equipmentTypes = types;
+    m_equipmentNames.clear();
+    m_equipment.clear();
+    for (const auto& type : types) {
+        m_equipmentNames << type.name;
+        m_equipment.insert(type.name, StatusAggregate());
+    }
+
+    for (auto& info : m_controllers) {
+        info.equipment = equipmentFor(info);
+        account(info, +1);
+    }
+
+    // Drop statuses of types that no longer exist without notifying
+    for (const QString& name : previous) {
+        if (!m_equipment.contains(name)) m_equipmentStatus.remove(name);
+    }
+    updateEquipmentStatus(m_equipmentNames);
+}
+
+QStringList ControllerManager::equipmentFor(const ControllerInfo& info) const
+{
+    QStringList result;
+    for (const auto& type : m_equipmentTypes) {
+        bool member = type.name.compare(info.type, Qt::CaseInsensitive) == 0;
+        for (const QString& entry : type.controllers) {
+            if (member) break;
+            member = entry.compare(info.type, Qt::CaseInsensitive) == 0
+                  || entry.compare(info.prefix, Qt::CaseInsensitive) == 0
+                  || entry.compare(info.name, Qt::CaseInsensitive) == 0;
+        }
+        if (member) result << type.name;
+    }
+    return result;
+}
+
 void ControllerManager::addController(const ControllerConfig& config, const BrokerConfig& broker, double timeout, int reconnectInterval)
 {
     if (m_controllers.contains(config.name)) {
@@ -57,28 +156,41 @@ void ControllerManager::addController(const ControllerConfig& config, const Brok
     
     ControllerInfo info;
     info.name = config.name;
+    info.type = config.type;
+    info.prefix = config.prefix;
     info.enabled = config.enabled;
+    info.transport = config.transport;
+    info.host = config.host;
+    info.port = config.port;
     
-    // Create MQTT controller
-    MqttController* mqttCtrl = new MqttController(config, broker, timeout, reconnectInterval, this);
-    info.controller = mqttCtrl;
-    info.status = mqttCtrl->status();
+    // Create the controller for its transport
+    AbstractController* ctrl = nullptr;
+    if (config.transport == "tcp") {
+        ctrl = new TcpLx200Controller(config, timeout, reconnectInterval, this);
+    } else {
+        ctrl = new MqttController(config, broker, timeout, reconnectInterval, this);
+    }
+    info.controller = ctrl;
+    info.status = ctrl->status();
     
     // Connect signals
-    connect(mqttCtrl, &AbstractController::statusChanged, this, [this, name = config.name](ControllerStatus status) {
+    connect(ctrl, &AbstractController::statusChanged, this, [this, name = config.name](ControllerStatus status) {
         updateControllerStatus(name, status);
     });
     
-    connect(mqttCtrl, &AbstractController::dataUpdated, this, [this, name = config.name](const QString& command, const QString& value) {
-        emit controllerDataUpdated(name, command, value);
-    });
+    connect(ctrl, &AbstractController::dataUpdated, this, &ControllerManager::onControllerDataUpdated);
     
-    connect(mqttCtrl, &AbstractController::errorOccurred, this, [this, name = config.name](const QString& error) {
+    connect(ctrl, &AbstractController::errorOccurred, this, [this, name = config.name](const QString& error) {
         emit controllerError(name, error);
     });
     
+    info.equipment = equipmentFor(info);
     m_controllers.insert(config.name, info);
+    account(info, +1);
+    setSnapshotController(info.name, info.status, info.enabled);
+    publishSnapshot();
     updateSystemStatus();
+    updateEquipmentStatus(info.equipment);
 }
 
 void ControllerManager::removeController(const QString& name)
@@ -86,9 +198,14 @@ void ControllerManager::removeController(const QString& name)
     if (!m_controllers.contains(name)) return;
     
     ControllerInfo info = m_controllers.take(name);
+    account(info, -1);
     delete info.controller;
     
+    setSnapshotController(name, ControllerStatus::Disconnected, false);
+    invalidateSnapshotValues(name);
+    publishSnapshot();
     updateSystemStatus();
+    updateEquipmentStatus(info.equipment);
 }
 
 void ControllerManager::enableController(const QString& name, bool enable)
@@ -98,24 +215,31 @@ void ControllerManager::enableController(const QString& name, bool enable)
     ControllerInfo& info = m_controllers[name];
     if (info.enabled == enable) return;
     
+    account(info, -1);
     info.enabled = enable;
+    account(info, +1);
     
     if (enable) {
         info.controller->connect();
         if (m_isPolling) {
-            static_cast<MqttController*>(info.controller)->startPolling(m_fastPollInterval, m_slowPollInterval);
+            info.controller->startPolling(m_fastPollInterval, m_slowPollInterval);
         }
     } else {
-        static_cast<MqttController*>(info.controller)->stopPolling();
+        info.controller->stopPolling();
         info.controller->disconnect();
     }
     
+    QStringList equipment = info.equipment;
+    setSnapshotController(name, info.status, enable);
+    publishSnapshot();
     emit controllerEnabledChanged(name, enable);
     updateSystemStatus();
+    updateEquipmentStatus(equipment);
 }
 
 void ControllerManager::connectAll()
 {
+    m_isActive = true;
     for (auto& info : m_controllers) {
         if (info.enabled) {
             info.controller->connect();
@@ -125,6 +249,7 @@ void ControllerManager::connectAll()
 
 void ControllerManager::disconnectAll()
 {
+    m_isActive = false;
     for (auto& info : m_controllers) {
         info.controller->disconnect();
     }
@@ -152,7 +277,7 @@ void ControllerManager::startPolling(int fastPollMs, int slowPollMs)
     
     for (auto& info : m_controllers) {
         if (info.enabled) {
-            static_cast<MqttController*>(info.controller)->startPolling(fastPollMs, slowPollMs);
+            info.controller->startPolling(fastPollMs, slowPollMs);
         }
     }
 }
@@ -161,21 +286,21 @@ void ControllerManager::stopPolling()
 {
     m_isPolling = false;
     for (auto& info : m_controllers) {
-        static_cast<MqttController*>(info.controller)->stopPolling();
+        info.controller->stopPolling();
     }
 }
 
 void ControllerManager::startControllerPolling(const QString& name)
 {
     if (m_controllers.contains(name) && m_controllers[name].enabled) {
-        static_cast<MqttController*>(m_controllers[name].controller)->startPolling(m_fastPollInterval, m_slowPollInterval);
+        m_controllers[name].controller->startPolling(m_fastPollInterval, m_slowPollInterval);
     }
 }
 
 void ControllerManager::stopControllerPolling(const QString& name)
 {
     if (m_controllers.contains(name)) {
-        static_cast<MqttController*>(m_controllers[name].controller)->stopPolling();
+        m_controllers[name].controller->stopPolling();
     }
 }
 
@@ -207,93 +332,208 @@ QStringList ControllerManager::getControllerNames() const
     return m_controllers.keys();
 }
 
-QStringList ControllerManager::getConnectedControllers() const
+CachedValue ControllerManager::getControllerValue(PropertyId id) const
 {
-    QStringList connected;
-    for (auto it = m_controllers.begin(); it != m_controllers.end(); ++it) {
-        if (it->enabled && it->status == ControllerStatus::Connected) {
-            connected.append(it.key());
-        }
-    }
-    return connected;
+    QString controllerName = PropertyInterner::instance().controller(id);
+    if (!m_controllers.contains(controllerName)) return CachedValue();
+    return m_controllers[controllerName].controller->getCachedValue(id);
 }
 
-QStringList ControllerManager::getDisconnectedControllers() const
+CachedValue ControllerManager::getControllerValue(const QString& controllerName, const QString& command) const
 {
-    QStringList disconnected;
-    for (auto it = m_controllers.begin(); it != m_controllers.end(); ++it) {
-        if (it->enabled && it->status != ControllerStatus::Connected) {
-            disconnected.append(it.key());
-        }
-    }
-    return disconnected;
+    if (!m_controllers.contains(controllerName)) return CachedValue();
+    return m_controllers[controllerName].controller->getCachedValue(command);
 }
 
-int ControllerManager::getEnabledControllerCount() const
+QHash<QString, CachedValue> ControllerManager::getAllControllerValues(const QString& controllerName) const
 {
-    int count = 0;
-    for (const auto& info : m_controllers) {
-        if (info.enabled) count++;
-    }
-    return count;
+    if (!m_controllers.contains(controllerName)) return QHash<QString, CachedValue>();
+    return m_controllers[controllerName].controller->getAllCachedValues();
 }
 
-int ControllerManager::getConnectedControllerCount() const
+ControllerChannel* ControllerManager::channel(const QString& controllerName)
 {
-    int count = 0;
-    for (const auto& info : m_controllers) {
-        if (info.enabled && info.status == ControllerStatus::Connected) count++;
+    int index = PropertyInterner::instance().internController(controllerName);
+    if (index >= m_channels.size()) {
+        m_channels.resize(index + 1, nullptr);
+    }
+
+    ControllerChannel*& channel = m_channels[index];
+    if (!channel) {
+        channel = new ControllerChannel(controllerName, this);
     }
-    return count;
+    return channel;
 }
 
-CachedValue ControllerManager::getControllerValue(const QString& controllerName, const QString& command) const
+void ControllerManager::dispatchData(PropertyId id, const QString& value)
 {
-    if (!m_controllers.contains(controllerName)) return CachedValue();
-    return static_cast<MqttController*>(m_controllers[controllerName].controller)->getCachedValue(command);
+    const PropertyInterner& interner = PropertyInterner::instance();
+
+    int index = interner.controllerIndex(id);
+    if (index >= 0 && index < m_channels.size() && m_channels[index]) {
+        emit m_channels[index]->dataUpdated(id, value);
+    }
+    // Every update goes through the batcher: it feeds the snapshot as well as the UI
+    m_batcher->post(id, value);
+
+    // Names are only resolved for the string consumers (logging, telemetry)
+    static const QMetaMethod dataSignal = QMetaMethod::fromSignal(&ControllerManager::controllerDataUpdated);
+    if (isSignalConnected(dataSignal)) {
+        emit controllerDataUpdated(interner.controller(id), interner.command(id), value);
+    }
 }
 
-QHash<QString, CachedValue> ControllerManager::getAllControllerValues(const QString& controllerName) const
+void ControllerManager::dispatchData(const QString& controllerName, const QString& command, const QString& value)
 {
-    if (!m_controllers.contains(controllerName)) return QHash<QString, CachedValue>();
-    return static_cast<MqttController*>(m_controllers[controllerName].controller)->getAllCachedValues();
+    dispatchData(PropertyInterner::instance().intern(controllerName, command), value);
 }
 
 void ControllerManager::updateControllerStatus(const QString& name, ControllerStatus status)
 {
-    if (m_controllers.contains(name)) {
-        m_controllers[name].status = status;
+    auto it = m_controllers.find(name);
+    if (it != m_controllers.end()) {
+        if (it->status == status) return;
+
+        account(*it, -1);
+        it->status = status;
+        account(*it, +1);
+
+        QStringList equipment = it->equipment;
+        setSnapshotController(name, status, it->enabled);
+        if (status == ControllerStatus::Disconnected) {
+            invalidateSnapshotValues(name);
+        }
+        publishSnapshot();
+
+        int index = PropertyInterner::instance().findController(name);
+        if (index >= 0 && index < m_channels.size() && m_channels[index]) {
+            emit m_channels[index]->statusChanged(status);
+        }
         emit controllerStatusChanged(name, status);
         updateSystemStatus();
+        updateEquipmentStatus(equipment);
     }
 }
 
 void ControllerManager::updateSystemStatus()
 {
-    int enabledCount = getEnabledControllerCount();
-    int connectedCount = getConnectedControllerCount();
-    
-    SystemStatus newStatus;
-    if (enabledCount == 0) {
-        newStatus = SystemStatus::Disconnected;
-    } else if (connectedCount == enabledCount) {
-        newStatus = SystemStatus::AllConnected;
-    } else if (connectedCount > 0) {
-        newStatus = SystemStatus::PartiallyConnected;
-    } else {
-        newStatus = SystemStatus::Disconnected;
-    }
-    
+    SystemStatus newStatus = m_totals.status();
     if (m_systemStatus != newStatus) {
         m_systemStatus = newStatus;
         emit systemStatusChanged(m_systemStatus);
     }
 }
 
+void ControllerManager::account(const ControllerInfo& info, int sign)
+{
+    // Add (sign = +1) or remove (sign = -1) one controller's contribution
+    bool connected = info.enabled && info.status == ControllerStatus::Connected;
+
+    auto apply = [&](StatusAggregate& aggregate) {
+        aggregate.total += sign;
+        if (info.enabled) aggregate.enabled += sign;
+        if (connected) aggregate.connected += sign;
+    };
+
+    apply(m_totals);
+    for (const QString& type : info.equipment) {
+        apply(m_equipment[type]);
+    }
+
+    if (!info.enabled) return;
+    QSet<QString>& members = connected ? m_connected : m_disconnected;
+    if (sign > 0) {
+        members.insert(info.name);
+    } else {
+        members.remove(info.name);
+    }
+}
+
+void ControllerManager::updateEquipmentStatus(const QStringList& equipmentTypes)
+{
+    for (const QString& type : equipmentTypes) {
+        auto it = m_equipment.constFind(type);
+        if (it == m_equipment.constEnd()) continue;
+
+        SystemStatus newStatus = it->status();
+        auto current = m_equipmentStatus.find(type);
+        if (current == m_equipmentStatus.end()) {
+            m_equipmentStatus.insert(type, newStatus);
+            emit equipmentStatusChanged(type, newStatus);
+        } else if (*current != newStatus) {
+            *current = newStatus;
+            emit equipmentStatusChanged(type, newStatus);
+        }
+    }
+}
+
 void ControllerManager::onControllerConnected() {}
 void ControllerManager::onControllerDisconnected() {}
 void ControllerManager::onControllerError(const QString& error) {}
-void ControllerManager::onControllerDataUpdated(const QString& command, const QString& value) {}
+void ControllerManager::onBatchFlushed(const PropertyBatch& batch)
+{
+    // Snapshot first, so readers woken by the signals below see this batch
+    if (m_state.values.size() < PropertyInterner::instance().count()) {
+        m_state.values.resize(PropertyInterner::instance().count());
+    }
+    for (const PropertyUpdate& update : batch) {
+        m_state.values[update.id] = CachedValue(update.value);
+    }
+    publishSnapshot();
+
+    // Split the frame's updates by controller, one signal per channel
+    const PropertyInterner& interner = PropertyInterner::instance();
+    m_channelBatches.resize(m_channels.size());
+
+    for (const PropertyUpdate& update : batch) {
+        int index = interner.controllerIndex(update.id);
+        if (index >= 0 && index < m_channelBatches.size()) {
+            m_channelBatches[index].append(update);
+        }
+    }
+
+    for (int i = 0; i < m_channelBatches.size(); ++i) {
+        if (m_channelBatches[i].isEmpty()) continue;
+        if (m_channels[i]) {
+            emit m_channels[i]->batchUpdated(m_channelBatches[i]);
+        }
+        m_channelBatches[i].clear();
+    }
+}
+
+void ControllerManager::setSnapshotController(const QString& name, ControllerStatus status, bool enabled)
+{
+    int index = PropertyInterner::instance().internController(name);
+    if (index >= m_state.statuses.size()) {
+        m_state.statuses.resize(index + 1, ControllerStatus::Disconnected);
+        m_state.enabled.resize(index + 1, false);
+    }
+    m_state.statuses[index] = status;
+    m_state.enabled[index] = enabled;
+}
+
+void ControllerManager::invalidateSnapshotValues(const QString& name)
+{
+    const QVector<PropertyId> ids = PropertyInterner::instance().properties(name);
+    for (PropertyId id : ids) {
+        if (id < m_state.values.size()) {
+            m_state.values[id].valid = false;
+        }
+    }
+}
+
+void ControllerManager::publishSnapshot()
+{
+    m_state.version++;
+    m_state.timestamp = QDateTime::currentMSecsSinceEpoch();
+    m_snapshot.publish(std::make_unique<const ControllerSnapshot>(m_state));
+    emit snapshotPublished(m_state.version);
+}
+
+void ControllerManager::onControllerDataUpdated(PropertyId id, const QString& value)
+{
+    dispatchData(id, value);
+}
 void ControllerManager::onControllerPollError(const QString& command, const QString& error) {}
 
 QString ControllerManager::getControllerNameFromSender() const { return QString(); }
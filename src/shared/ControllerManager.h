@@ -1,25 +1,73 @@
 #ifndef CONTROLLERMANAGER_H
 #define CONTROLLERMANAGER_H
 
+#include <QSet>
 #include "AbstractController.h"
 #include "Config.h"
+#include "UpdateBatcher.h"
+#include "ControllerSnapshot.h"
+#include "RcuCell.h"
 
 namespace ObservatoryMonitor {
 
 // Structure to track a single controller
 struct ControllerInfo {
     QString name;
+    QString type;
+    QString prefix;
     bool enabled;
+    QString transport;
+    QString host;
+    int port;
     AbstractController* controller;
     ControllerStatus status;
+    QStringList equipment;   // equipment types this controller counts towards
     
     ControllerInfo() 
         : enabled(false)
+        , port(0)
         , controller(nullptr)
         , status(ControllerStatus::Disconnected) 
     {}
 };
 
+// Running totals for one equipment type (or the whole system)
+struct StatusAggregate {
+    int total = 0;
+    int enabled = 0;
+    int connected = 0;   // enabled and connected
+
+    SystemStatus status() const
+    {
+        if (enabled == 0 || connected == 0) return SystemStatus::Disconnected;
+        return connected == enabled ? SystemStatus::AllConnected : SystemStatus::PartiallyConnected;
+    }
+};
+
+// Per-controller update channel. Subscribers interested in a single
+// controller connect here instead of to the manager-wide signals, so an
+// update is delivered only to the proxies of the controller that produced it.
+// dataUpdated fires for every update; batchUpdated carries the same updates
+// coalesced per UI frame (last value wins) and is what the UI should use.
+class ControllerChannel : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit ControllerChannel(const QString& name, QObject* parent = nullptr)
+        : QObject(parent), m_name(name) {}
+
+    QString name() const { return m_name; }
+
+signals:
+    void dataUpdated(PropertyId id, const QString& value);
+    void batchUpdated(const PropertyBatch& batch);
+    void statusChanged(ControllerStatus status);
+
+private:
+    QString m_name;
+};
+
 class ControllerManager : public QObject
 {
     Q_OBJECT
@@ -28,9 +76,15 @@ public:
     explicit ControllerManager(QObject* parent = nullptr);
     ~ControllerManager();
     
-    // Configuration
+    // Configuration. Applies the difference to what is already loaded:
+    // unchanged controllers keep their connections and cached values.
     void loadControllersFromConfig(const Config& config);
+    QList<ControllerConfig> controllerConfigs() const;
     void updateBrokerConfig(const BrokerConfig& broker, double timeout, int reconnectInterval);
+
+    // A controller belongs to an equipment type when the type's name or one
+    // of its listed controllers matches the controller's type, prefix or name
+    void setEquipmentTypes(const QList<EquipmentType>& types);
     
     // Controller management
     void addController(const ControllerConfig& config, const BrokerConfig& broker, double timeout, int reconnectInterval);
@@ -42,6 +96,11 @@ public:
     void disconnectAll();
     void connectController(const QString& name);
     void disconnectController(const QString& name);
+    // Marks the system as connected without connecting anything, for callers
+    // that bring controllers up themselves (StartupOrchestrator). Controllers
+    // added by a later configuration reload connect straight away when active.
+    bool isActive() const { return m_isActive; }
+    void setActive(bool active) { m_isActive = active; }
     
     // Polling management
     void startPolling(int fastPollMs = 1000, int slowPollMs = 10000);
@@ -55,40 +114,97 @@ public:
     QString getControllerType(const QString& name) const;
     SystemStatus getSystemStatus() const;
     QStringList getControllerNames() const;
-    QStringList getConnectedControllers() const;
-    QStringList getDisconnectedControllers() const;
-    int getEnabledControllerCount() const;
-    int getConnectedControllerCount() const;
+    const QSet<QString>& getConnectedControllers() const { return m_connected; }
+    const QSet<QString>& getDisconnectedControllers() const { return m_disconnected; }
+    int getEnabledControllerCount() const { return m_totals.enabled; }
+    int getConnectedControllerCount() const { return m_totals.connected; }
+    QStringList getEquipmentTypeNames() const { return m_equipmentNames; }
+    StatusAggregate getEquipmentAggregate(const QString& equipmentType) const { return m_equipment.value(equipmentType); }
+    SystemStatus getEquipmentStatus(const QString& equipmentType) const { return getEquipmentAggregate(equipmentType).status(); }
+    AbstractController* controller(const QString& name) const { return m_controllers.value(name).controller; }
     
     // Data access
+    CachedValue getControllerValue(PropertyId id) const;
     CachedValue getControllerValue(const QString& controllerName, const QString& command) const;
     QHash<QString, CachedValue> getAllControllerValues(const QString& controllerName) const;
+
+    // Targeted subscription. Channels are created on first use (a proxy may
+    // subscribe before its controller is loaded) and live as long as the manager.
+    ControllerChannel* channel(const QString& controllerName);
+
+    // Route an update to the controller's channel and the manager-wide signal
+    void dispatchData(PropertyId id, const QString& value);
+    void dispatchData(const QString& controllerName, const QString& command, const QString& value);
+
+    // Consistent view of all values and statuses, safe to read from any
+    // thread. Hold the guard only as long as the data is needed.
+    using SnapshotGuard = RcuCell<ControllerSnapshot>::ReadGuard;
+    SnapshotGuard snapshot() const { return m_snapshot.read(); }
+
+    // UI batching: channels' batchUpdated fires at most updateRate times per
+    // second, or whenever flushUpdates() is called (once per rendered frame)
+    int updateRate() const { return m_batcher->maxRate(); }
+    void setUpdateRate(int hz) { m_batcher->setMaxRate(hz); }
+    void flushUpdates() { m_batcher->flush(); }
     
 signals:
     void controllerStatusChanged(const QString& name, ControllerStatus status);
     void controllerEnabledChanged(const QString& name, bool enabled);
     void systemStatusChanged(SystemStatus status);
+    void equipmentStatusChanged(const QString& equipmentType, SystemStatus status);
     void controllerDataUpdated(const QString& controllerName, const QString& command, const QString& value);
     void controllerError(const QString& controllerName, const QString& error);
+    void snapshotPublished(quint64 version);
     
 private slots:
     void onControllerConnected();
     void onControllerDisconnected();
     void onControllerError(const QString& error);
-    void onControllerDataUpdated(const QString& command, const QString& value);
+    void onControllerDataUpdated(PropertyId id, const QString& value);
     void onControllerPollError(const QString& command, const QString& error);
+    void onBatchFlushed(const PropertyBatch& batch);
     
 private:
     void updateControllerStatus(const QString& name, ControllerStatus status);
     void updateSystemStatus();
+    void account(const ControllerInfo& info, int sign);
+    void updateEquipmentStatus(const QStringList& equipmentTypes);
+    QStringList equipmentFor(const ControllerInfo& info) const;
     QString getControllerNameFromSender() const;
+    void setSnapshotController(const QString& name, ControllerStatus status, bool enabled);
+    void invalidateSnapshotValues(const QString& name);
+    void publishSnapshot();
     
     QHash<QString, ControllerInfo> m_controllers;
+    QVector<ControllerChannel*> m_channels;   // indexed by interned controller index
+    QVector<PropertyBatch> m_channelBatches;  // scratch space for onBatchFlushed
     SystemStatus m_systemStatus;
+
+    // Maintained incrementally by account() on every enable/status change
+    StatusAggregate m_totals;
+    QSet<QString> m_connected;
+    QSet<QString> m_disconnected;
+    QList<EquipmentType> m_equipmentTypes;
+    QStringList m_equipmentNames;
+    QHash<QString, StatusAggregate> m_equipment;
+    QHash<QString, SystemStatus> m_equipmentStatus;
     
     int m_fastPollInterval;
     int m_slowPollInterval;
     bool m_isPolling;
+    bool m_isActive;   // connectAll() called and not undone
+
+    // Broker settings currently applied to the controllers
+    BrokerConfig m_broker;
+    double m_mqttTimeout;
+    int m_reconnectInterval;
+
+    UpdateBatcher* m_batcher;
+
+    // Working copy of the state; published copies share its data until the
+    // next change detaches it
+    ControllerSnapshot m_state;
+    RcuCell<ControllerSnapshot> m_snapshot;
 };
 
 } // namespace ObservatoryMonitor
@@ -4,9 +4,11 @@
 
 namespace ObservatoryMonitor {
 
-ControllerPoller::ControllerPoller(const QString& name, const QString& type, MqttClient* mqttClient, QObject* parent)
+static LogCategory lcPoller("Poller");
+
+ControllerPoller::ControllerPoller(const QString& name, const QString& type, AbstractController* controller, QObject* parent)
     : QObject(parent)
-    , m_mqttClient(mqttClient)
+    , m_controller(controller)
     , m_controllerName(name)
     , m_controllerType(type)
     , m_fastPollTimer(new QTimer(this))
@@ -33,10 +35,13 @@ ControllerPoller::ControllerPoller(const QString& name, const QString& type, Mqt
     m_staleCheckTimer->setInterval(5000);
     connect(m_staleCheckTimer, &QTimer::timeout, this, &ControllerPoller::checkStaleData);
     
-    // Connect to MQTT client signals
-    connect(m_mqttClient, &MqttClient::connected, this, &ControllerPoller::onMqttConnected);
-    connect(m_mqttClient, &MqttClient::disconnected, this, &ControllerPoller::onMqttDisconnected);
-    connect(m_mqttClient, &MqttClient::responseReceived, this, &ControllerPoller::onResponseReceived);
+    // Connect to controller signals
+    // Polls only start once the controller is ready (for MQTT, the echo
+    // subscription is acknowledged); commands sent before that would have
+    // their responses lost and time out
+    connect(m_controller, &AbstractController::ready, this, &ControllerPoller::onControllerReady);
+    connect(m_controller, &AbstractController::statusChanged, this, &ControllerPoller::onControllerStatusChanged);
+    connect(m_controller, &AbstractController::unsolicitedResponse, this, &ControllerPoller::onUnsolicitedResponse);
 }
 
 ControllerPoller::~ControllerPoller()
@@ -46,7 +51,12 @@ ControllerPoller::~ControllerPoller()
 
 void ControllerPoller::setControllerName(const QString& name)
 {
+    if (m_controllerName == name) return;
+
+    // IDs belong to the controller name, so the cache starts over
     m_controllerName = name;
+    m_cache.clear();
+    internCommands();
 }
 
 void ControllerPoller::setControllerType(const QString& type)
@@ -68,6 +78,22 @@ void ControllerPoller::setControllerType(const QString& type)
         m_fastPollCommands << ":DZ#";
         m_slowPollCommands << ":RS#";
     }
+
+    internCommands();
+}
+
+void ControllerPoller::internCommands()
+{
+    PropertyInterner& interner = PropertyInterner::instance();
+
+    m_fastPollIds.clear();
+    for (const QString& command : m_fastPollCommands) {
+        m_fastPollIds << interner.intern(m_controllerName, command);
+    }
+    m_slowPollIds.clear();
+    for (const QString& command : m_slowPollCommands) {
+        m_slowPollIds << interner.intern(m_controllerName, command);
+    }
 }
 
 void ControllerPoller::setFastPollInterval(int intervalMs)
@@ -93,20 +119,12 @@ void ControllerPoller::startPolling()
         return;
     }
     
-    Logger::instance().info(QString("Poller[%1]: Starting polling (fast: %2ms, slow: %3ms)")
-                           .arg(m_controllerName)
-                           .arg(m_fastPollInterval)
-                           .arg(m_slowPollInterval));
+    OM_INFOF(lcPoller, m_controllerName, "Starting polling (fast: %1ms, slow: %2ms)", m_fastPollInterval, m_slowPollInterval);
     
     m_isPolling = true;
     
-    if (m_mqttClient->isConnected()) {
-        pollFastCommands();
-        pollSlowCommands();
-        
-        m_fastPollTimer->start();
-        m_slowPollTimer->start();
-        m_staleCheckTimer->start();
+    if (m_controller->isReady()) {
+        beginPolling();
     }
 }
 
@@ -116,7 +134,7 @@ void ControllerPoller::stopPolling()
         return;
     }
     
-    Logger::instance().info(QString("Poller[%1]: Stopping polling").arg(m_controllerName));
+    OM_INFOF(lcPoller, m_controllerName, "Stopping polling");
     
     m_fastPollTimer->stop();
     m_slowPollTimer->stop();
@@ -130,32 +148,51 @@ bool ControllerPoller::isPolling() const
     return m_isPolling;
 }
 
-CachedValue ControllerPoller::getCachedValue(const QString& command) const
+const CachedValue* ControllerPoller::cachedValue(PropertyId id) const
 {
-    if (m_cache.contains(command)) {
-        return m_cache[command];
+    int slot = PropertyInterner::instance().slot(id);
+    if (slot < 0 || slot >= m_cache.size()) {
+        return nullptr;
     }
-    return CachedValue();
+    return &m_cache[slot];
 }
 
-QHash<QString, CachedValue> ControllerPoller::getAllCachedValues() const
+CachedValue ControllerPoller::getCachedValue(PropertyId id) const
 {
-    return m_cache;
+    const CachedValue* cached = cachedValue(id);
+    return cached ? *cached : CachedValue();
 }
 
-bool ControllerPoller::isDataStale(const QString& command) const
+CachedValue ControllerPoller::getCachedValue(const QString& command) const
 {
-    if (!m_cache.contains(command)) {
-        return true;
+    return getCachedValue(PropertyInterner::instance().find(m_controllerName, command));
+}
+
+QHash<QString, CachedValue> ControllerPoller::getAllCachedValues() const
+{
+    // Names are resolved here, for callers at the UI edge
+    const PropertyInterner& interner = PropertyInterner::instance();
+    const QVector<PropertyId> ids = interner.properties(m_controllerName);
+
+    QHash<QString, CachedValue> values;
+    for (PropertyId id : ids) {
+        const CachedValue* cached = cachedValue(id);
+        if (cached && cached->timestamp.isValid()) {
+            values.insert(interner.command(id), *cached);
+        }
     }
-    
-    const CachedValue& cached = m_cache[command];
-    if (!cached.valid) {
+    return values;
+}
+
+bool ControllerPoller::isDataStale(PropertyId id) const
+{
+    const CachedValue* cached = cachedValue(id);
+    if (!cached || !cached->valid) {
         return true;
     }
     
-    int threshold = getStaleThreshold(command);
-    qint64 age = cached.timestamp.msecsTo(QDateTime::currentDateTime());
+    int threshold = getStaleThreshold(id);
+    qint64 age = cached->timestamp.msecsTo(QDateTime::currentDateTime());
     
     return age > threshold;
 }
@@ -170,67 +207,88 @@ void ControllerPoller::onSlowPollTimer()
     pollSlowCommands();
 }
 
-void ControllerPoller::onMqttConnected()
+void ControllerPoller::onControllerReady()
 {
     if (m_isPolling) {
-        pollFastCommands();
-        pollSlowCommands();
-        
-        m_fastPollTimer->start();
-        m_slowPollTimer->start();
-        m_staleCheckTimer->start();
+        beginPolling();
     }
 }
 
-void ControllerPoller::onMqttDisconnected()
+void ControllerPoller::beginPolling()
 {
+    pollFastCommands();
+    pollSlowCommands();
+    
+    m_fastPollTimer->start();
+    m_slowPollTimer->start();
+    m_staleCheckTimer->start();
+}
+
+void ControllerPoller::onControllerStatusChanged(ControllerStatus status)
+{
+    if (status == ControllerStatus::Connected) {
+        return;
+    }
+
     m_fastPollTimer->stop();
     m_slowPollTimer->stop();
     m_staleCheckTimer->stop();
     
-    for (auto it = m_cache.begin(); it != m_cache.end(); ++it) {
-        it->valid = false;
+    for (CachedValue& cached : m_cache) {
+        cached.valid = false;
     }
 }
 
-void ControllerPoller::onResponseReceived(const QString& command, const QString& response, bool isUnsolicited)
+void ControllerPoller::onUnsolicitedResponse(const QString& command, const QString& response)
 {
-    if (isUnsolicited) {
-        Logger::instance().debug(QString("Poller[%1]: Handling unsolicited update for %2: %3")
-                                .arg(m_controllerName, command, response));
-        m_cache[command] = CachedValue(response);
-        emit dataUpdated(command, response);
+    OM_DEBUGF(lcPoller, m_controllerName, "Handling unsolicited update for %1: %2", command, response);
+    // Unsolicited commands may not have been polled yet
+    PropertyId id = PropertyInterner::instance().intern(m_controllerName, command);
+    storeValue(id, response);
+    emit dataUpdated(id, response);
+}
+
+void ControllerPoller::storeValue(PropertyId id, const QString& value)
+{
+    int slot = PropertyInterner::instance().slot(id);
+    if (slot < 0) return;
+    if (slot >= m_cache.size()) {
+        m_cache.resize(slot + 1);
     }
+    m_cache[slot] = CachedValue(value);
 }
 
 void ControllerPoller::pollFastCommands()
 {
-    for (const QString& command : m_fastPollCommands) {
-        pollCommand(command, true);
+    for (PropertyId id : m_fastPollIds) {
+        pollCommand(id, true);
     }
 }
 
 void ControllerPoller::pollSlowCommands()
 {
-    for (const QString& command : m_slowPollCommands) {
-        pollCommand(command, false);
+    for (PropertyId id : m_slowPollIds) {
+        pollCommand(id, false);
     }
 }
 
-void ControllerPoller::pollCommand(const QString& command, bool isFastPoll)
+void ControllerPoller::pollCommand(PropertyId id, bool isFastPoll)
 {
-    m_mqttClient->sendCommand(command, [this, command](const QString& cmd, const QString& response, bool success, int errorCode) {
+    // The wire protocol still speaks command strings
+    QString command = PropertyInterner::instance().command(id);
+    m_controller->sendCommand(command, [this, id](const QString& cmd, const QString& response, bool success, int errorCode) {
         if (success) {
-            m_cache[command] = CachedValue(response);
+            storeValue(id, response);
             m_successfulPolls++;
-            emit dataUpdated(command, response);
+            emit dataUpdated(id, response);
         } else {
             m_failedPolls++;
             QString errorStr = errorCode > 0 ? QString("Error %1").arg(errorCode) : "Timeout";
-            Logger::instance().debug(QString("Poller[%1]: Poll failed for %2 - %3").arg(m_controllerName, command, errorStr));
-            emit pollError(command, errorStr);
-            if (m_cache.contains(command)) {
-                m_cache[command].valid = false;
+            OM_DEBUGF(lcPoller, m_controllerName, "Poll failed for %1 - %2", cmd, errorStr);
+            emit pollError(id, errorStr);
+            int slot = PropertyInterner::instance().slot(id);
+            if (slot >= 0 && slot < m_cache.size()) {
+                m_cache[slot].valid = false;
             }
         }
     });
@@ -238,16 +296,19 @@ void ControllerPoller::pollCommand(const QString& command, bool isFastPoll)
 
 void ControllerPoller::checkStaleData()
 {
-    for (auto it = m_cache.begin(); it != m_cache.end(); ++it) {
-        if (isDataStale(it.key())) {
-            emit dataStale(it.key());
+    const QVector<PropertyId> ids = PropertyInterner::instance().properties(m_controllerName);
+    for (PropertyId id : ids) {
+        const CachedValue* cached = cachedValue(id);
+        // Only values that have been received at least once can go stale
+        if (cached && cached->timestamp.isValid() && isDataStale(id)) {
+            emit dataStale(id);
         }
     }
 }
 
-int ControllerPoller::getStaleThreshold(const QString& command) const
+int ControllerPoller::getStaleThreshold(PropertyId id) const
 {
-    int pollInterval = m_fastPollCommands.contains(command) ? m_fastPollInterval : m_slowPollInterval;
+    int pollInterval = m_fastPollIds.contains(id) ? m_fastPollInterval : m_slowPollInterval;
     return pollInterval * m_staleDataMultiplier;
 }
 
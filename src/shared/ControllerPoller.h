@@ -6,8 +6,9 @@
 #include <QHash>
 #include <QDateTime>
 #include <QTimer>
-#include "MqttClient.h"
+#include "AbstractController.h"
 #include "Types.h"
+#include "PropertyInterner.h"
 
 namespace ObservatoryMonitor {
 
@@ -16,7 +17,8 @@ class ControllerPoller : public QObject
     Q_OBJECT
 
 public:
-    explicit ControllerPoller(const QString& name, const QString& type, MqttClient* mqttClient, QObject* parent = nullptr);
+    // Polls through the controller's transport; the controller must outlive the poller
+    explicit ControllerPoller(const QString& name, const QString& type, AbstractController* controller, QObject* parent = nullptr);
     ~ControllerPoller();
     
     // Configuration
@@ -32,34 +34,41 @@ public:
     bool isPolling() const;
     
     // Data access
+    CachedValue getCachedValue(PropertyId id) const;
     CachedValue getCachedValue(const QString& command) const;
     QHash<QString, CachedValue> getAllCachedValues() const;
-    bool isDataStale(const QString& command) const;
+    bool isDataStale(PropertyId id) const;
+    // The fast and slow poll lists
+    QVector<PropertyId> polledProperties() const { return m_fastPollIds + m_slowPollIds; }
     
     // Statistics
     int successfulPolls() const { return m_successfulPolls; }
     int failedPolls() const { return m_failedPolls; }
     
 signals:
-    void dataUpdated(const QString& command, const QString& value);
-    void dataStale(const QString& command);
-    void pollError(const QString& command, const QString& error);
+    void dataUpdated(PropertyId id, const QString& value);
+    void dataStale(PropertyId id);
+    void pollError(PropertyId id, const QString& error);
     
 private slots:
     void onFastPollTimer();
     void onSlowPollTimer();
-    void onMqttConnected();
-    void onMqttDisconnected();
-    void onResponseReceived(const QString& command, const QString& response, bool isUnsolicited);
+    void onControllerReady();
+    void onControllerStatusChanged(ControllerStatus status);
+    void onUnsolicitedResponse(const QString& command, const QString& response);
     
 private:
     void pollFastCommands();
     void pollSlowCommands();
-    void pollCommand(const QString& command, bool isFastPoll);
+    void pollCommand(PropertyId id, bool isFastPoll);
+    void beginPolling();
     void checkStaleData();
-    int getStaleThreshold(const QString& command) const;
+    int getStaleThreshold(PropertyId id) const;
+    void internCommands();
+    void storeValue(PropertyId id, const QString& value);
+    const CachedValue* cachedValue(PropertyId id) const;
     
-    MqttClient* m_mqttClient;
+    AbstractController* m_controller;
     QString m_controllerName;
     QString m_controllerType;
     
@@ -74,9 +83,11 @@ private:
     // Hardcoded command lists
     QStringList m_fastPollCommands;  // Movement parameters
     QStringList m_slowPollCommands;  // Status parameters
+    QVector<PropertyId> m_fastPollIds;
+    QVector<PropertyId> m_slowPollIds;
     
-    // Data cache
-    QHash<QString, CachedValue> m_cache;
+    // Data cache, indexed by the property's slot within this controller
+    QVector<CachedValue> m_cache;
     
     // Statistics
     int m_successfulPolls;
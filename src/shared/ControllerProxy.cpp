@@ -1,30 +1,65 @@
 #include "ControllerProxy.h"
-#include <QRegularExpression>
+#include "Lx200Codec.h"
+#include <QSet>
 
 namespace ObservatoryMonitor {
 
-ControllerProxy::ControllerProxy(const QString& name, ControllerManager* manager, QObject* parent)
+namespace {
+
+// Commands behind the dedicated Q_PROPERTYs; these decode the same way
+// whether or not the registry lists them
+struct BuiltInCommand {
+    const char* command;
+    int field;
+    ControllerProxy::Decoder decoder;
+};
+
+} // namespace
+
+ControllerProxy::ControllerProxy(const QString& name, ControllerManager* manager,
+                                 CapabilityRegistry* registry, QObject* parent)
     : QObject(parent)
     , m_name(name)
     , m_manager(manager)
-    , m_azimuth(0.0)
-    , m_altitude(0.0)
-    , m_ra(0.0)
-    , m_dec(0.0)
-    , m_shutterStatus("Unknown")
-    , m_sideOfPier("Unknown")
+    , m_registry(registry)
+    , m_values(new QQmlPropertyMap(this))
 {
+    rebuildDispatchTable();
+
+    if (m_registry) {
+        connect(m_registry, &CapabilityRegistry::capabilitiesChanged,
+                this, &ControllerProxy::rebuildDispatchTable);
+    }
+
     if (m_manager) {
-        connect(m_manager, &ControllerManager::controllerDataUpdated,
-                this, &ControllerProxy::onDataUpdated);
-        connect(m_manager, &ControllerManager::controllerStatusChanged,
-                this, &ControllerProxy::onStatusChanged);
+        // Subscribe to this controller only rather than filtering every update
+        ControllerChannel* channel = m_manager->channel(m_name);
+        connect(channel, &ControllerChannel::batchUpdated,
+                this, &ControllerProxy::onBatchUpdated);
+        connect(channel, &ControllerChannel::statusChanged,
+                this, &ControllerProxy::statusChanged);
     }
 }
 
 QVariant ControllerProxy::getProperty(const QString& name) const
 {
-    return m_properties.value(name);
+    return propertyValue(PropertyInterner::instance().find(m_name, name));
+}
+
+int ControllerProxy::propertyId(const QString& command) const
+{
+    return PropertyInterner::instance().intern(m_name, command);
+}
+
+QVariant ControllerProxy::propertyValue(int id) const
+{
+    int slot = PropertyInterner::instance().slot(id);
+    return slot >= 0 && slot < m_properties.size() ? m_properties[slot] : QVariant();
+}
+
+QString ControllerProxy::propertyName(int id) const
+{
+    return PropertyInterner::instance().command(id);
 }
 
 QString ControllerProxy::status() const
@@ -40,112 +75,220 @@ QString ControllerProxy::status() const
     }
 }
 
-void ControllerProxy::onDataUpdated(const QString& controllerName, const QString& command, const QString& value)
+void ControllerProxy::onBatchUpdated(const PropertyBatch& batch)
 {
-    if (controllerName != m_name) return;
+    // Bindings on several coordinates see the frame as one change
+    Qt::beginPropertyUpdateGroup();
+    for (const PropertyUpdate& update : batch) {
+        applyUpdate(update.id, update.value);
+    }
+    Qt::endPropertyUpdateGroup();
 
-    // Update generic property map
-    if (m_properties.value(command) != value) {
-        m_properties[command] = value;
-        emit propertyChanged(command, value);
+    // One notification per frame for everything that changed
+    if (!m_changedIds.isEmpty()) {
+        emit propertiesChanged(m_changedIds);
+        m_changedIds.clear();
     }
+}
+
+void ControllerProxy::rebuildDispatchTable()
+{
+    static const BuiltInCommand builtIns[] = {
+        {":DZ#", int(Field::Azimuth), Decoder::Degrees},
+        {":GZ#", int(Field::Azimuth), Decoder::Degrees},
+        {":GA#", int(Field::Altitude), Decoder::Degrees},
+        {":GR#", int(Field::Ra), Decoder::Hours},
+        {":GD#", int(Field::Dec), Decoder::Degrees},
+        {":RS#", int(Field::Shutter), Decoder::Shutter},
+        {":GS#", int(Field::SideOfPier), Decoder::PierSide},
+    };
 
-    if (command == ":DZ#" || command == ":GZ#") {
-        double val = parseDegrees(value);
-        if (val != m_azimuth) {
-            m_azimuth = val;
-            emit azimuthChanged();
+    PropertyInterner& interner = PropertyInterner::instance();
+    QVector<DispatchEntry> table;
+    auto entryFor = [&](const QString& command) -> DispatchEntry& {
+        int slot = interner.slot(interner.intern(m_name, command));
+        if (slot >= table.size()) {
+            table.resize(slot + 1);
         }
-    } else if (command == ":GA#") {
-        double val = parseDegrees(value);
-        if (val != m_altitude) {
-            m_altitude = val;
-            emit altitudeChanged();
+        return table[slot];
+    };
+
+    for (const BuiltInCommand& builtIn : builtIns) {
+        DispatchEntry& entry = entryFor(QString::fromLatin1(builtIn.command));
+        entry.field = static_cast<Field>(builtIn.field);
+        entry.decoder = builtIn.decoder;
+    }
+
+    QSet<QString> keys;
+    if (m_registry) {
+        // Capabilities are registered per controller type; fall back to the
+        // controller name, which is what layout links use
+        QString type = m_manager ? m_manager->getControllerType(m_name) : QString();
+        QList<PropertyDefinition> definitions = m_registry->getProperties(type);
+        if (definitions.isEmpty()) {
+            definitions = m_registry->getProperties(m_name);
         }
-    } else if (command == ":GR#") {
-        // RA is usually in HH:MM:SS format
-        // For now just store as a double if it's numeric, or we'll need a better parser
-        double val = parseDegrees(value);
-        if (val != m_ra) {
-            m_ra = val;
-            emit raChanged();
+        for (const PropertyDefinition& definition : std::as_const(definitions)) {
+            if (definition.name.isEmpty() || definition.command.isEmpty()) continue;
+            DispatchEntry& entry = entryFor(definition.command);
+            entry.key = definition.name;
+            if (entry.field == Field::None) {
+                entry.decoder = decoderFor(definition);
+            }
+            keys.insert(definition.name);
         }
-    } else if (command == ":GD#") {
-        double val = parseDegrees(value);
-        if (val != m_dec) {
-            m_dec = val;
-            emit decChanged();
+    }
+
+    const QStringList previousKeys = m_values->keys();
+    for (const QString& key : previousKeys) {
+        if (!keys.contains(key)) {
+            m_values->clear(key);
         }
-    } else if (command == ":RS#") {
-        QString status = "Unknown";
-        QString val = value.toUpper();
-        if (val.startsWith('0') || val.contains("OPEN")) status = "Open";
-        else if (val.startsWith('1') || val.contains("CLOSED")) status = "Closed";
-        else if (val.startsWith('2') || val.contains("OPENING")) status = "Opening";
-        else if (val.startsWith('3') || val.contains("CLOSING")) status = "Closing";
-        else if (val.startsWith('4') || val.contains("STOPPED")) status = "Stopped";
-        else if (val.startsWith('5') || val.contains("ERROR")) status = "Error";
-        
-        if (status != m_shutterStatus) {
-            m_shutterStatus = status;
-            emit shutterStatusChanged();
+    }
+    m_dispatch = table;
+
+    // Publish every capability up front so bindings resolve before the first
+    // poll, and decode whatever has already arrived
+    for (int slot = 0; slot < m_dispatch.size(); ++slot) {
+        const DispatchEntry& entry = m_dispatch[slot];
+        if (!entry.key.isEmpty() && !m_values->contains(entry.key)) {
+            m_values->insert(entry.key, QVariant());
         }
-    } else if (command == ":GS#") {
-        QString side = "Unknown";
-        QString val = value.toUpper();
-        if (val.contains('E') || val.startsWith('0')) side = "East";
-        else if (val.contains('W') || val.startsWith('1')) side = "West";
-        
-        if (side != m_sideOfPier) {
-            m_sideOfPier = side;
-            emit sideOfPierChanged();
+        if (slot < m_properties.size() && m_properties[slot].isValid()) {
+            dispatch(entry, m_properties[slot].toString());
         }
     }
 }
 
-void ControllerProxy::onStatusChanged(const QString& name, ControllerStatus status)
+ControllerProxy::DispatchEntry& ControllerProxy::entryForSlot(int slot)
 {
-    if (name == m_name) {
-        emit statusChanged();
+    // Commands first seen at runtime decode as text and have no key
+    if (slot >= m_dispatch.size()) {
+        m_dispatch.resize(slot + 1);
     }
+    return m_dispatch[slot];
 }
 
-double ControllerProxy::parseDegrees(const QString& value)
+void ControllerProxy::applyUpdate(PropertyId id, const QString& value)
 {
-    // Basic parser for LX200 formats: 
-    // sDD*MM'SS# or DD.DDDD# or HH:MM:SS#
-    
-    // Strip trailing #
-    QString clean = value;
-    if (clean.endsWith('#')) clean.chop(1);
-    
-    // Try simple numeric first
-    bool ok;
-    double d = clean.toDouble(&ok);
-    if (ok) return d;
-    
-    // Try DD*MM'SS format
-    QRegularExpression re("([-+]?\\d+)[*°](\\d+)['](\\d+)[\"]?");
-    QRegularExpressionMatch match = re.match(clean);
-    if (match.hasMatch()) {
-        double deg = match.captured(1).toDouble();
-        double min = match.captured(2).toDouble();
-        double sec = match.captured(3).toDouble();
-        double sign = deg < 0 ? -1.0 : 1.0;
-        return deg + sign * (min / 60.0 + sec / 3600.0);
-    }
-    
-    // Try HH:MM:SS format
-    QRegularExpression re2("(\\d+):(\\d+):(\\d+)");
-    QRegularExpressionMatch match2 = re2.match(clean);
-    if (match2.hasMatch()) {
-        double h = match2.captured(1).toDouble();
-        double m = match2.captured(2).toDouble();
-        double s = match2.captured(3).toDouble();
-        return h + m / 60.0 + s / 3600.0;
-    }
-
-    return 0.0;
+    int slot = PropertyInterner::instance().slot(id);
+    if (slot < 0) return;
+    if (slot >= m_properties.size()) {
+        m_properties.resize(slot + 1);
+    }
+    if (m_properties[slot] == value) return;
+
+    m_properties[slot] = value;
+    m_changedIds.append(id);
+    emit propertyChanged(id, value);
+
+    dispatch(entryForSlot(slot), value);
+}
+
+void ControllerProxy::dispatch(const DispatchEntry& entry, const QString& raw)
+{
+    if (entry.key.isEmpty() && entry.field == Field::None) return;
+
+    // Values that fail to decode keep their last good value
+    QVariant decoded;
+    if (!decode(entry.decoder, raw, decoded)) return;
+
+    if (!entry.key.isEmpty() && m_values->value(entry.key) != decoded) {
+        m_values->insert(entry.key, decoded);
+    }
+    if (entry.field != Field::None) {
+        setField(entry.field, decoded);
+    }
+}
+
+QString ControllerProxy::dedicatedProperty(const QString& capability) const
+{
+    for (const DispatchEntry& entry : m_dispatch) {
+        if (entry.key != capability) continue;
+        switch (entry.field) {
+            case Field::Azimuth:    return QStringLiteral("azimuth");
+            case Field::Altitude:   return QStringLiteral("altitude");
+            case Field::Ra:         return QStringLiteral("ra");
+            case Field::Dec:        return QStringLiteral("dec");
+            case Field::Shutter:    return QStringLiteral("shutterStatus");
+            case Field::SideOfPier: return QStringLiteral("sideOfPier");
+            case Field::None:       break;
+        }
+    }
+    return QString();
+}
+
+void ControllerProxy::setField(Field field, const QVariant& value)
+{
+    // Bindable properties compare and notify on their own
+    switch (field) {
+        case Field::Azimuth:    m_azimuth = value.toDouble(); break;
+        case Field::Altitude:   m_altitude = value.toDouble(); break;
+        case Field::Ra:         m_ra = value.toDouble(); break;
+        case Field::Dec:        m_dec = value.toDouble(); break;
+        case Field::Shutter:    m_shutterStatus = value.toString(); break;
+        case Field::SideOfPier: m_sideOfPier = value.toString(); break;
+        case Field::None:       break;
+    }
+}
+
+ControllerProxy::Decoder ControllerProxy::decoderFor(const PropertyDefinition& definition)
+{
+    if (definition.command == ":RS#") return Decoder::Shutter;
+    if (definition.command == ":GS#") return Decoder::PierSide;
+
+    if (definition.type == "numeric") {
+        QString unit = definition.unit.toLower();
+        if (unit == "deg") return Decoder::Degrees;
+        if (unit == "hrs" || unit == "h") return Decoder::Hours;
+        return Decoder::Number;
+    }
+    return Decoder::Text;
+}
+
+bool ControllerProxy::decode(Decoder decoder, const QString& raw, QVariant& value)
+{
+    double number = 0.0;
+    switch (decoder) {
+        case Decoder::Number:
+            if (!Lx200Codec::parseDecimal(QStringView(raw), number)) return false;
+            value = number;
+            return true;
+        case Decoder::Degrees:
+            if (!Lx200Codec::parseDegrees(QStringView(raw), number)) return false;
+            value = number;
+            return true;
+        case Decoder::Hours:
+            if (!Lx200Codec::parseHours(QStringView(raw), number)) return false;
+            value = number;
+            return true;
+        case Decoder::Shutter: {
+            QString status = "Unknown";
+            QString val = raw.toUpper();
+            if (val.startsWith('0') || val.contains("OPEN")) status = "Open";
+            else if (val.startsWith('1') || val.contains("CLOSED")) status = "Closed";
+            else if (val.startsWith('2') || val.contains("OPENING")) status = "Opening";
+            else if (val.startsWith('3') || val.contains("CLOSING")) status = "Closing";
+            else if (val.startsWith('4') || val.contains("STOPPED")) status = "Stopped";
+            else if (val.startsWith('5') || val.contains("ERROR")) status = "Error";
+            value = status;
+            return true;
+        }
+        case Decoder::PierSide: {
+            QString side = "Unknown";
+            QString val = raw.toUpper();
+            if (val.contains('E') || val.startsWith('0')) side = "East";
+            else if (val.contains('W') || val.startsWith('1')) side = "West";
+            value = side;
+            return true;
+        }
+        case Decoder::Text:
+            break;
+    }
+
+    // Text: the reply without its terminator
+    value = raw.endsWith('#') ? raw.chopped(1) : raw;
+    return true;
 }
 
 } // namespace ObservatoryMonitor
@@ -4,26 +4,63 @@
 #include <QObject>
 #include <QString>
 #include <QVariant>
+#include <QPointer>
+#include <QProperty>
+#include <QQmlPropertyMap>
 #include "ControllerManager.h"
+#include "CapabilityRegistry.h"
 
 namespace ObservatoryMonitor {
 
+// QML-facing view of one controller.
+//
+// Updates are dispatched through a table indexed by property slot, built
+// from the capability registry: each entry names the capability, the
+// decoder that turns the raw reply into a typed value and, for the handful
+// of commands with dedicated properties (azimuth, ra, ...), which one it
+// feeds. Every registered capability appears in values() under its name, so
+// QML can bind to controller.values.Azimuth directly.
+//
+// The dedicated properties are bindable: a batch of updates is applied as
+// one property update group, so dependent bindings see the whole frame at
+// once and only properties whose value actually changed notify.
 class ControllerProxy : public QObject
 {
     Q_OBJECT
     Q_PROPERTY(QString name READ name CONSTANT)
-    Q_PROPERTY(double azimuth READ azimuth NOTIFY azimuthChanged)
-    Q_PROPERTY(double altitude READ altitude NOTIFY altitudeChanged)
-    Q_PROPERTY(double ra READ ra NOTIFY raChanged)
-    Q_PROPERTY(double dec READ dec NOTIFY decChanged)
+    Q_PROPERTY(double azimuth READ azimuth NOTIFY azimuthChanged BINDABLE bindableAzimuth)
+    Q_PROPERTY(double altitude READ altitude NOTIFY altitudeChanged BINDABLE bindableAltitude)
+    Q_PROPERTY(double ra READ ra NOTIFY raChanged BINDABLE bindableRa)
+    Q_PROPERTY(double dec READ dec NOTIFY decChanged BINDABLE bindableDec)
     Q_PROPERTY(QString status READ status NOTIFY statusChanged)
-    Q_PROPERTY(QString shutterStatus READ shutterStatus NOTIFY shutterStatusChanged)
-    Q_PROPERTY(QString sideOfPier READ sideOfPier NOTIFY sideOfPierChanged)
+    Q_PROPERTY(QString shutterStatus READ shutterStatus NOTIFY shutterStatusChanged BINDABLE bindableShutterStatus)
+    Q_PROPERTY(QString sideOfPier READ sideOfPier NOTIFY sideOfPierChanged BINDABLE bindableSideOfPier)
+    Q_PROPERTY(QQmlPropertyMap* values READ values CONSTANT)
 
 public:
-    explicit ControllerProxy(const QString& name, ControllerManager* manager, QObject* parent = nullptr);
+    // How a raw reply becomes a typed value
+    enum class Decoder {
+        Text,       // raw string
+        Number,     // plain decimal
+        Degrees,    // decimal or sDD*MM:SS
+        Hours,      // decimal or HH:MM:SS
+        Shutter,    // OCS shutter state name
+        PierSide    // East / West / Unknown
+    };
+
+    explicit ControllerProxy(const QString& name, ControllerManager* manager,
+                             CapabilityRegistry* registry = nullptr, QObject* parent = nullptr);
 
     Q_INVOKABLE QVariant getProperty(const QString& name) const;
+
+    // ID-based access; QML resolves a command to an ID once and then
+    // compares integers in propertyChanged handlers
+    Q_INVOKABLE int propertyId(const QString& command) const;
+    Q_INVOKABLE QVariant propertyValue(int id) const;
+    Q_INVOKABLE QString propertyName(int id) const;
+    // The bindable property (azimuth, ra, ...) a capability feeds; empty
+    // when it has none and is only available through values()
+    Q_INVOKABLE QString dedicatedProperty(const QString& capability) const;
     QString name() const { return m_name; }
     double azimuth() const { return m_azimuth; }
     double altitude() const { return m_altitude; }
@@ -33,6 +70,21 @@ public:
     QString shutterStatus() const { return m_shutterStatus; }
     QString sideOfPier() const { return m_sideOfPier; }
 
+    QBindable<double> bindableAzimuth() { return &m_azimuth; }
+    QBindable<double> bindableAltitude() { return &m_altitude; }
+    QBindable<double> bindableRa() { return &m_ra; }
+    QBindable<double> bindableDec() { return &m_dec; }
+    QBindable<QString> bindableShutterStatus() { return &m_shutterStatus; }
+    QBindable<QString> bindableSideOfPier() { return &m_sideOfPier; }
+
+    // Decoded capability values keyed by capability name
+    QQmlPropertyMap* values() const { return m_values; }
+
+    // Decoder for a registry entry (command-specific ones win over the type)
+    static Decoder decoderFor(const PropertyDefinition& definition);
+    // False when the reply doesn't parse; value is left untouched then
+    static bool decode(Decoder decoder, const QString& raw, QVariant& value);
+
 signals:
     void azimuthChanged();
     void altitudeChanged();
@@ -41,25 +93,45 @@ signals:
     void statusChanged();
     void shutterStatusChanged();
     void sideOfPierChanged();
-    void propertyChanged(const QString& name, const QVariant& value);
+    void propertyChanged(int id, const QVariant& value);
+    // Emitted once per UI frame with the IDs whose values changed
+    void propertiesChanged(const QList<int>& ids);
 
 private slots:
-    void onDataUpdated(const QString& controllerName, const QString& command, const QString& value);
-    void onStatusChanged(const QString& name, ControllerStatus status);
+    void onBatchUpdated(const PropertyBatch& batch);
+    void rebuildDispatchTable();
 
 private:
-    double parseDegrees(const QString& value);
+    // Dedicated Q_PROPERTY a command feeds
+    enum class Field { None, Azimuth, Altitude, Ra, Dec, Shutter, SideOfPier };
+
+    struct DispatchEntry {
+        QString key;                      // name in values(), empty if unregistered
+        Decoder decoder = Decoder::Text;
+        Field field = Field::None;
+    };
+
+    void applyUpdate(PropertyId id, const QString& value);
+    void dispatch(const DispatchEntry& entry, const QString& raw);
+    void setField(Field field, const QVariant& value);
+    DispatchEntry& entryForSlot(int slot);
 
     QString m_name;
     ControllerManager* m_manager;
-    
-    double m_azimuth;
-    double m_altitude;
-    double m_ra;
-    double m_dec;
-    QString m_shutterStatus;
-    QString m_sideOfPier;
-    QHash<QString, QVariant> m_properties;
+    QPointer<CapabilityRegistry> m_registry;
+    QQmlPropertyMap* m_values;
+
+    Q_OBJECT_BINDABLE_PROPERTY(ControllerProxy, double, m_azimuth, &ControllerProxy::azimuthChanged)
+    Q_OBJECT_BINDABLE_PROPERTY(ControllerProxy, double, m_altitude, &ControllerProxy::altitudeChanged)
+    Q_OBJECT_BINDABLE_PROPERTY(ControllerProxy, double, m_ra, &ControllerProxy::raChanged)
+    Q_OBJECT_BINDABLE_PROPERTY(ControllerProxy, double, m_dec, &ControllerProxy::decChanged)
+    Q_OBJECT_BINDABLE_PROPERTY_WITH_ARGS(ControllerProxy, QString, m_shutterStatus,
+                                         QStringLiteral("Unknown"), &ControllerProxy::shutterStatusChanged)
+    Q_OBJECT_BINDABLE_PROPERTY_WITH_ARGS(ControllerProxy, QString, m_sideOfPier,
+                                         QStringLiteral("Unknown"), &ControllerProxy::sideOfPierChanged)
+    QVector<QVariant> m_properties;       // raw replies, indexed by property slot
+    QVector<DispatchEntry> m_dispatch;    // indexed by property slot
+    QList<int> m_changedIds;
 };
 
 } // namespace ObservatoryMonitor
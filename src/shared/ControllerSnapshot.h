@@ -0,0 +1,43 @@
+#ifndef CONTROLLERSNAPSHOT_H
+#define CONTROLLERSNAPSHOT_H
+
+#include <QVector>
+#include "AbstractController.h"
+#include "PropertyInterner.h"
+#include "Types.h"
+
+namespace ObservatoryMonitor {
+
+// Immutable, versioned view of every controller value and status.
+//
+// Published by ControllerManager after each update batch and status change;
+// read through ControllerManager::snapshot() from any thread without locks.
+// Values are indexed by PropertyId and statuses by interned controller index.
+struct ControllerSnapshot {
+    quint64 version = 0;
+    qint64 timestamp = 0;   // ms since epoch at publication
+
+    QVector<CachedValue> values;
+    QVector<ControllerStatus> statuses;
+    QVector<bool> enabled;
+
+    CachedValue value(PropertyId id) const
+    {
+        return id >= 0 && id < values.size() ? values[id] : CachedValue();
+    }
+
+    ControllerStatus status(int controllerIndex) const
+    {
+        return controllerIndex >= 0 && controllerIndex < statuses.size()
+             ? statuses[controllerIndex] : ControllerStatus::Disconnected;
+    }
+
+    bool isEnabled(int controllerIndex) const
+    {
+        return controllerIndex >= 0 && controllerIndex < enabled.size() && enabled[controllerIndex];
+    }
+};
+
+} // namespace ObservatoryMonitor
+
+#endif // CONTROLLERSNAPSHOT_H
@@ -0,0 +1,146 @@
+#include "LayoutCache.h"
+#include "LayoutConfig.h"
+#include "CapabilityRegistry.h"
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QtEndian>
+#include <cstring>
+
+namespace ObservatoryMonitor {
+
+namespace LayoutCache {
+
+static constexpr int HashSize = 32;
+static constexpr QDataStream::Version StreamVersion = QDataStream::Qt_6_8;
+
+QString pathFor(const QString& layoutPath)
+{
+    QFileInfo info(layoutPath);
+    return info.dir().filePath(info.completeBaseName() + ".cache");
+}
+
+QByteArray sourceHash(const QStringList& sourcePaths)
+{
+    QCryptographicHash hash(QCryptographicHash::Sha256);
+    for (const QString& path : sourcePaths) {
+        QFile file(path);
+        if (!file.open(QIODevice::ReadOnly)) return QByteArray();
+        // Length-prefixed so moving bytes between files changes the hash
+        hash.addData(QByteArray::number(file.size()) + '\n');
+        if (!hash.addData(&file)) return QByteArray();
+    }
+    return hash.result();
+}
+
+bool write(const QString& cachePath, const QByteArray& sourceHash,
+           const LayoutConfig& layout, const CapabilityRegistry& caps,
+           QString& errorMessage)
+{
+    if (sourceHash.size() != HashSize) {
+        errorMessage = "Invalid source hash";
+        return false;
+    }
+
+    QByteArray payload;
+    {
+        QDataStream out(&payload, QIODevice::WriteOnly);
+        out.setVersion(StreamVersion);
+        caps.saveToStream(out);
+        layout.saveToStream(out);
+    }
+
+    QByteArray header(HeaderSize, '\0');
+    uchar* h = reinterpret_cast<uchar*>(header.data());
+    qToLittleEndian<quint32>(Magic, h);
+    qToLittleEndian<quint32>(Version, h + 4);
+    qToLittleEndian<quint32>(StreamVersion, h + 8);
+    qToLittleEndian<quint32>(quint32(payload.size()), h + 12);
+    std::memcpy(h + 16, sourceHash.constData(), HashSize);
+    std::memcpy(h + 48, QCryptographicHash::hash(payload, QCryptographicHash::Sha256).constData(), HashSize);
+
+    // Written whole or not at all, so a crash never leaves a torn cache
+    QSaveFile file(cachePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        errorMessage = file.errorString();
+        return false;
+    }
+    file.write(header);
+    file.write(payload);
+    if (!file.commit()) {
+        errorMessage = file.errorString();
+        return false;
+    }
+    return true;
+}
+
+bool read(const QString& cachePath, const QByteArray& sourceHash,
+          LayoutConfig& layout, CapabilityRegistry& caps,
+          QString& errorMessage)
+{
+    if (sourceHash.size() != HashSize) {
+        errorMessage = "Invalid source hash";
+        return false;
+    }
+
+    QFile file(cachePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        errorMessage = file.errorString();
+        return false;
+    }
+    if (file.size() < HeaderSize) {
+        errorMessage = "Layout cache truncated";
+        return false;
+    }
+
+    const uchar* data = file.map(0, file.size());
+    if (!data) {
+        errorMessage = file.errorString();
+        return false;
+    }
+
+    if (qFromLittleEndian<quint32>(data) != Magic) {
+        errorMessage = "Not a layout cache";
+        return false;
+    }
+    if (qFromLittleEndian<quint32>(data + 4) != Version
+        || qFromLittleEndian<quint32>(data + 8) != quint32(StreamVersion)) {
+        errorMessage = "Layout cache from another version";
+        return false;
+    }
+    if (std::memcmp(data + 16, sourceHash.constData(), HashSize) != 0) {
+        errorMessage = "Layout cache is stale";
+        return false;
+    }
+
+    const quint32 payloadSize = qFromLittleEndian<quint32>(data + 12);
+    if (payloadSize != file.size() - HeaderSize) {
+        errorMessage = "Layout cache truncated";
+        return false;
+    }
+
+    // Decoded in place; every string is copied out, so the mapping can go
+    // when the file closes
+    QByteArray payload = QByteArray::fromRawData(reinterpret_cast<const char*>(data + HeaderSize), payloadSize);
+    if (std::memcmp(data + 48, QCryptographicHash::hash(payload, QCryptographicHash::Sha256).constData(), HashSize) != 0) {
+        errorMessage = "Layout cache checksum mismatch";
+        return false;
+    }
+
+    // The checksum has passed, so a decode error means a format bug; the
+    // caller's YAML fallback replaces whatever was restored
+    QDataStream in(payload);
+    in.setVersion(StreamVersion);
+    if (!caps.loadFromStream(in) || !layout.loadFromStream(in) || !in.atEnd()) {
+        errorMessage = "Layout cache payload is corrupt";
+        return false;
+    }
+    return true;
+}
+
+} // namespace LayoutCache
+
+} // namespace ObservatoryMonitor
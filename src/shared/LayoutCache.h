@@ -0,0 +1,57 @@
+#ifndef LAYOUTCACHE_H
+#define LAYOUTCACHE_H
+
+#include <QString>
+#include <QStringList>
+#include <QByteArray>
+
+namespace ObservatoryMonitor {
+
+class LayoutConfig;
+class CapabilityRegistry;
+
+// Binary snapshot of a validated layout together with the capabilities it
+// was validated against, so startup can skip the YAML parse and validation
+// while the sources are unchanged. The hash covers the two YAML files only;
+// callers re-check the scene's model files on a hit.
+//
+// File layout (little-endian):
+//
+//   0   magic "OMLC"
+//   4   format version
+//   8   QDataStream version of the payload
+//   12  payload size in bytes
+//   16  SHA-256 of the source YAML files
+//   48  SHA-256 of the payload
+//   80  payload: capabilities, then layout (QDataStream)
+//
+// The file is memory-mapped when read; the header is checked in place and
+// the payload is decoded straight from the mapping. Any mismatch (missing
+// file, other version, changed sources, corrupt payload) is a miss, and the
+// caller falls back to the YAML.
+namespace LayoutCache {
+    constexpr quint32 Magic = 0x434c4d4f;   // "OMLC"
+    constexpr quint32 Version = 2;
+    constexpr int HeaderSize = 80;
+
+    // layout.yaml -> layout.cache, next to it
+    QString pathFor(const QString& layoutPath);
+
+    // Hash over the contents of the given files, in order; empty if one of
+    // them cannot be read
+    QByteArray sourceHash(const QStringList& sourcePaths);
+
+    bool write(const QString& cachePath, const QByteArray& sourceHash,
+               const LayoutConfig& layout, const CapabilityRegistry& caps,
+               QString& errorMessage);
+
+    // Restores caps and layout from a cache built from the same sources.
+    // Neither is touched when the header or a hash does not match.
+    bool read(const QString& cachePath, const QByteArray& sourceHash,
+              LayoutConfig& layout, CapabilityRegistry& caps,
+              QString& errorMessage);
+}
+
+} // namespace ObservatoryMonitor
+
+#endif // LAYOUTCACHE_H
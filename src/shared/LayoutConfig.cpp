@@ -2,6 +2,7 @@
 #include "CapabilityRegistry.h"
 #include <yaml-cpp/yaml.h>
 #include <QFile>
+#include <QDataStream>
 #include <QSet>
 #include <QFileInfo>
 #include <QDebug>
@@ -10,6 +11,8 @@ namespace ObservatoryMonitor {
 
 LayoutConfig::LayoutConfig(QObject* parent)
     : QObject(parent)
+    , m_widgetModel(new WidgetListModel(m_widgets, this))
+    , m_sceneModel(new SceneNodeTreeModel(m_sceneNodes, this))
 {
     setDefaults();
 }
@@ -40,8 +43,8 @@ void LayoutConfig::setBackgroundColor(const QString& color)
 
 void LayoutConfig::setDefaultWidgets()
 {
-    m_widgets.clear();
-    
+    QList<WidgetConfig> widgets;
+
     WidgetConfig w1;
     w1.type = "Numeric";
     w1.id = "dome_az";
@@ -49,7 +52,7 @@ void LayoutConfig::setDefaultWidgets()
     w1.x = 50;
     w1.y = 50;
     w1.propertyLink = "Observatory.Azimuth";
-    m_widgets.append(w1);
+    widgets.append(w1);
     
     WidgetConfig w2;
     w2.type = "Numeric";
@@ -58,7 +61,7 @@ void LayoutConfig::setDefaultWidgets()
     w2.x = 200;
     w2.y = 50;
     w2.propertyLink = "Telescope.Azimuth";
-    m_widgets.append(w2);
+    widgets.append(w2);
     
     WidgetConfig w3;
     w3.type = "Numeric";
@@ -67,12 +70,22 @@ void LayoutConfig::setDefaultWidgets()
     w3.x = 50;
     w3.y = 150;
     w3.propertyLink = "Telescope.Altitude";
-    m_widgets.append(w3);
+    widgets.append(w3);
+
+    setWidgets(widgets);
+}
+
+void LayoutConfig::setWidgets(const QList<WidgetConfig>& widgets)
+{
+    m_widgetModel->beginResetModel();
+    m_widgets = widgets;
+    m_widgetModel->endResetModel();
+    emit widgetsChanged();
 }
 
 void LayoutConfig::setDefaultScene()
 {
-    m_sceneNodes.clear();
+    QList<SceneNodeConfig> nodes;
 
     // Default 3D Scene setup
     SceneNodeConfig dome;
@@ -81,17 +94,18 @@ void LayoutConfig::setDefaultScene()
     dome.motion.type = "rotation";
     dome.motion.axis = QVector3D(0, 1, 0);
     dome.motion.propertyLink = "Observatory.Azimuth";
-    dome.motion.mapping.type = "linear";
+    dome.motion.mapping.type = "angle";
     dome.motion.mapping.inMin = 0;
     dome.motion.mapping.inMax = 360;
     dome.motion.mapping.outMin = 0;
     dome.motion.mapping.outMax = -360;
-    m_sceneNodes.append(dome);
+    dome.motion.mapping.unwrap = true;
+    nodes.append(dome);
 
     SceneNodeConfig pier;
     pier.id = "pier";
     pier.model = "Pier.qml";
-    m_sceneNodes.append(pier);
+    nodes.append(pier);
 
     SceneNodeConfig mount;
     mount.id = "mount";
@@ -99,12 +113,13 @@ void LayoutConfig::setDefaultScene()
     mount.motion.type = "rotation";
     mount.motion.axis = QVector3D(0, 1, 0);
     mount.motion.propertyLink = "Telescope.Azimuth";
-    mount.motion.mapping.type = "linear";
+    mount.motion.mapping.type = "angle";
     mount.motion.mapping.inMin = 0;
     mount.motion.mapping.inMax = 360;
     mount.motion.mapping.outMin = 0;
     mount.motion.mapping.outMax = -360;
-    m_sceneNodes.append(mount);
+    mount.motion.mapping.unwrap = true;
+    nodes.append(mount);
 
     SceneNodeConfig tube;
     tube.id = "tube";
@@ -118,7 +133,18 @@ void LayoutConfig::setDefaultScene()
     tube.motion.mapping.inMax = 90;
     tube.motion.mapping.outMin = 0;
     tube.motion.mapping.outMax = -90;
-    m_sceneNodes.append(tube);
+    nodes.append(tube);
+
+    setSceneNodes(nodes);
+}
+
+void LayoutConfig::setSceneNodes(const QList<SceneNodeConfig>& nodes)
+{
+    m_sceneModel->beginResetModel();
+    m_sceneNodes = nodes;
+    m_sceneModel->rebuild();
+    m_sceneModel->endResetModel();
+    emit sceneNodesChanged();
 }
 
 static MappingDefinition parseMapping(const YAML::Node& node) {
@@ -129,6 +155,19 @@ static MappingDefinition parseMapping(const YAML::Node& node) {
     if (node["in_max"]) m.inMax = node["in_max"].as<double>();
     if (node["out_min"]) m.outMin = node["out_min"].as<double>();
     if (node["out_max"]) m.outMax = node["out_max"].as<double>();
+    if (node["period"]) m.period = node["period"].as<double>();
+    if (node["origin"]) m.wrapOrigin = node["origin"].as<double>();
+    if (node["unwrap"]) m.unwrap = node["unwrap"].as<bool>();
+    if (node["points"] && node["points"].IsSequence()) {
+        for (const auto& point : node["points"]) {
+            m.points.append(QPointF(point[0].as<double>(), point[1].as<double>()));
+        }
+    }
+    if (node["coefficients"] && node["coefficients"].IsSequence()) {
+        for (const auto& coefficient : node["coefficients"]) {
+            m.coefficients.append(coefficient.as<double>());
+        }
+    }
     if (node["true_pattern"]) m.truePattern = QString::fromStdString(node["true_pattern"].as<std::string>());
     return m;
 }
@@ -137,69 +176,100 @@ static void emitMapping(YAML::Emitter& out, const MappingDefinition& m) {
     if (m.type.isEmpty() || m.type == "none") return;
     out << YAML::Key << "mapping" << YAML::Value << YAML::BeginMap;
     out << YAML::Key << "type" << YAML::Value << m.type.toStdString();
-    if (m.type == "linear") {
+    if (m.type == "linear" || m.type == "clamped" || m.type == "angle") {
         out << YAML::Key << "in_min" << YAML::Value << m.inMin;
         out << YAML::Key << "in_max" << YAML::Value << m.inMax;
         out << YAML::Key << "out_min" << YAML::Value << m.outMin;
         out << YAML::Key << "out_max" << YAML::Value << m.outMax;
+        if (m.type == "angle") {
+            out << YAML::Key << "period" << YAML::Value << m.period;
+            out << YAML::Key << "origin" << YAML::Value << m.wrapOrigin;
+            out << YAML::Key << "unwrap" << YAML::Value << m.unwrap;
+        }
+    } else if (m.type == "lut") {
+        out << YAML::Key << "points" << YAML::Value << YAML::BeginSeq;
+        for (const QPointF& point : m.points) {
+            out << YAML::Flow << YAML::BeginSeq << point.x() << point.y() << YAML::EndSeq;
+        }
+        out << YAML::EndSeq;
+    } else if (m.type == "polynomial") {
+        out << YAML::Key << "coefficients" << YAML::Value << YAML::Flow << YAML::BeginSeq;
+        for (double coefficient : m.coefficients) out << coefficient;
+        out << YAML::EndSeq;
     } else if (m.type == "binary") {
         if (!m.truePattern.isEmpty()) out << YAML::Key << "true_pattern" << YAML::Value << m.truePattern.toStdString();
     }
     out << YAML::EndMap;
 }
 
+// Empty when the mapping can be compiled as declared
+static QString mappingError(const MappingDefinition& m) {
+    if (m.type == "angle" && m.period <= 0.0) {
+        return QString("angle mapping needs a positive period");
+    }
+    if (m.type == "lut" && m.points.size() < 2) {
+        return QString("lut mapping needs at least two points");
+    }
+    if (m.type == "polynomial" && m.coefficients.isEmpty()) {
+        return QString("polynomial mapping needs coefficients");
+    }
+    return QString();
+}
+
+// Applies the keys present in a (possibly partial) variant mapping
+static void updateMapping(MappingDefinition& m, const QVariantMap& changes) {
+    QVariantMap merged = ValueMappingEngine::definitionToVariant(m);
+    for (auto it = changes.cbegin(); it != changes.cend(); ++it) {
+        merged.insert(it.key(), it.value());
+    }
+    m = ValueMappingEngine::definitionFromVariant(merged);
+}
+
+QVariantMap LayoutConfig::widgetToVariant(const WidgetConfig& w)
+{
+    QVariantMap map;
+    map["type"] = w.type;
+    map["id"] = w.id;
+    map["label"] = w.label;
+    map["x"] = w.x;
+    map["y"] = w.y;
+    map["property"] = w.propertyLink;
+    map["mapping"] = ValueMappingEngine::definitionToVariant(w.mapping);
+    return map;
+}
+
 QVariantList LayoutConfig::widgetsVariant() const
 {
     QVariantList list;
     for (const auto& w : m_widgets) {
-        QVariantMap map;
-        map["type"] = w.type;
-        map["id"] = w.id;
-        map["label"] = w.label;
-        map["x"] = w.x;
-        map["y"] = w.y;
-        map["property"] = w.propertyLink;
-        
-        QVariantMap mapping;
-        mapping["type"] = w.mapping.type;
-        mapping["in_min"] = w.mapping.inMin;
-        mapping["in_max"] = w.mapping.inMax;
-        mapping["out_min"] = w.mapping.outMin;
-        mapping["out_max"] = w.mapping.outMax;
-        mapping["true_pattern"] = w.mapping.truePattern;
-        map["mapping"] = mapping;
-        
-        list << map;
+        list << widgetToVariant(w);
     }
     return list;
 }
 
+QVariantMap LayoutConfig::sceneNodeToVariant(const SceneNodeConfig& s)
+{
+    QVariantMap map;
+    map["model"] = s.model;
+    map["id"] = s.id;
+    map["parent"] = s.parentId;
+    map["offset"] = s.offset;
+
+    QVariantMap motion;
+    motion["type"] = s.motion.type;
+    motion["axis"] = s.motion.axis;
+    motion["property"] = s.motion.propertyLink;
+    motion["mapping"] = ValueMappingEngine::definitionToVariant(s.motion.mapping);
+
+    map["motion"] = motion;
+    return map;
+}
+
 QVariantList LayoutConfig::sceneNodesVariant() const
 {
     QVariantList list;
     for (const auto& s : m_sceneNodes) {
-        QVariantMap map;
-        map["model"] = s.model;
-        map["id"] = s.id;
-        map["parent"] = s.parentId;
-        map["offset"] = s.offset;
-        
-        QVariantMap motion;
-        motion["type"] = s.motion.type;
-        motion["axis"] = s.motion.axis;
-        motion["property"] = s.motion.propertyLink;
-        
-        QVariantMap mapping;
-        mapping["type"] = s.motion.mapping.type;
-        mapping["in_min"] = s.motion.mapping.inMin;
-        mapping["in_max"] = s.motion.mapping.inMax;
-        mapping["out_min"] = s.motion.mapping.outMin;
-        mapping["out_max"] = s.motion.mapping.outMax;
-        mapping["true_pattern"] = s.motion.mapping.truePattern;
-        motion["mapping"] = mapping;
-        
-        map["motion"] = motion;
-        list << map;
+        list << sceneNodeToVariant(s);
     }
     return list;
 }
@@ -215,16 +285,13 @@ void LayoutConfig::addWidget(const QVariantMap& config)
     w.propertyLink = config["property"].toString();
     
     if (config.contains("mapping")) {
-        QVariantMap m = config["mapping"].toMap();
-        w.mapping.type = m["type"].toString();
-        w.mapping.inMin = m["in_min"].toDouble();
-        w.mapping.inMax = m["in_max"].toDouble();
-        w.mapping.outMin = m["out_min"].toDouble();
-        w.mapping.outMax = m["out_max"].toDouble();
-        w.mapping.truePattern = m["true_pattern"].toString();
+        w.mapping = ValueMappingEngine::definitionFromVariant(config["mapping"].toMap());
     }
     
+    const int row = m_widgets.size();
+    m_widgetModel->beginInsertRows(QModelIndex(), row, row);
     m_widgets.append(w);
+    m_widgetModel->endInsertRows();
     emit widgetsChanged();
 }
 
@@ -232,7 +299,9 @@ void LayoutConfig::removeWidget(const QString& id)
 {
     for (int i = 0; i < m_widgets.size(); ++i) {
         if (m_widgets[i].id == id) {
+            m_widgetModel->beginRemoveRows(QModelIndex(), i, i);
             m_widgets.removeAt(i);
+            m_widgetModel->endRemoveRows();
             emit widgetsChanged();
             return;
         }
@@ -243,21 +312,23 @@ void LayoutConfig::updateWidget(const QString& id, const QVariantMap& config)
 {
     for (int i = 0; i < m_widgets.size(); ++i) {
         if (m_widgets[i].id == id) {
-            if (config.contains("type")) m_widgets[i].type = config["type"].toString();
-            if (config.contains("label")) m_widgets[i].label = config["label"].toString();
-            if (config.contains("x")) m_widgets[i].x = config["x"].toDouble();
-            if (config.contains("y")) m_widgets[i].y = config["y"].toDouble();
-            if (config.contains("property")) m_widgets[i].propertyLink = config["property"].toString();
+            WidgetConfig w = m_widgets[i];
+            if (config.contains("type")) w.type = config["type"].toString();
+            if (config.contains("label")) w.label = config["label"].toString();
+            if (config.contains("x")) w.x = config["x"].toDouble();
+            if (config.contains("y")) w.y = config["y"].toDouble();
+            if (config.contains("property")) w.propertyLink = config["property"].toString();
             
             if (config.contains("mapping")) {
-                QVariantMap m = config["mapping"].toMap();
-                if (m.contains("type")) m_widgets[i].mapping.type = m["type"].toString();
-                if (m.contains("in_min")) m_widgets[i].mapping.inMin = m["in_min"].toDouble();
-                if (m.contains("in_max")) m_widgets[i].mapping.inMax = m["in_max"].toDouble();
-                if (m.contains("out_min")) m_widgets[i].mapping.outMin = m["out_min"].toDouble();
-                if (m.contains("out_max")) m_widgets[i].mapping.outMax = m["out_max"].toDouble();
-                if (m.contains("true_pattern")) m_widgets[i].mapping.truePattern = m["true_pattern"].toString();
+                updateMapping(w.mapping, config["mapping"].toMap());
             }
+
+            // Only the edited roles of this row notify; delegates stay put
+            const QList<int> roles = WidgetListModel::changedRoles(m_widgets[i], w);
+            if (roles.isEmpty()) return;
+            m_widgets[i] = w;
+            QModelIndex index = m_widgetModel->index(i);
+            emit m_widgetModel->dataChanged(index, index, roles);
             emit widgetsChanged();
             return;
         }
@@ -279,16 +350,12 @@ void LayoutConfig::addSceneNode(const QVariantMap& config)
         s.motion.propertyLink = m["property"].toString();
         
         if (m.contains("mapping")) {
-            QVariantMap map = m["mapping"].toMap();
-            s.motion.mapping.type = map["type"].toString();
-            s.motion.mapping.inMin = map["in_min"].toDouble();
-            s.motion.mapping.inMax = map["in_max"].toDouble();
-            s.motion.mapping.outMin = map["out_min"].toDouble();
-            s.motion.mapping.outMax = map["out_max"].toDouble();
+            s.motion.mapping = ValueMappingEngine::definitionFromVariant(m["mapping"].toMap());
         }
     }
     
     m_sceneNodes.append(s);
+    m_sceneModel->appendNode();
     emit sceneNodesChanged();
 }
 
@@ -296,7 +363,9 @@ void LayoutConfig::removeSceneNode(const QString& id)
 {
     for (int i = 0; i < m_sceneNodes.size(); ++i) {
         if (m_sceneNodes[i].id == id) {
+            m_sceneModel->beginRemoveNode(i);
             m_sceneNodes.removeAt(i);
+            m_sceneModel->endRemoveNode(i);
             emit sceneNodesChanged();
             return;
         }
@@ -307,25 +376,27 @@ void LayoutConfig::updateSceneNode(const QString& id, const QVariantMap& config)
 {
     for (int i = 0; i < m_sceneNodes.size(); ++i) {
         if (m_sceneNodes[i].id == id) {
-            if (config.contains("model")) m_sceneNodes[i].model = config["model"].toString();
-            if (config.contains("parent")) m_sceneNodes[i].parentId = config["parent"].toString();
-            if (config.contains("offset")) m_sceneNodes[i].offset = config["offset"].value<QVector3D>();
+            SceneNodeConfig s = m_sceneNodes[i];
+            if (config.contains("model")) s.model = config["model"].toString();
+            if (config.contains("parent")) s.parentId = config["parent"].toString();
+            if (config.contains("offset")) s.offset = config["offset"].value<QVector3D>();
             
             if (config.contains("motion")) {
                 QVariantMap m = config["motion"].toMap();
-                if (m.contains("type")) m_sceneNodes[i].motion.type = m["type"].toString();
-                if (m.contains("axis")) m_sceneNodes[i].motion.axis = m["axis"].value<QVector3D>();
-                if (m.contains("property")) m_sceneNodes[i].motion.propertyLink = m["property"].toString();
+                if (m.contains("type")) s.motion.type = m["type"].toString();
+                if (m.contains("axis")) s.motion.axis = m["axis"].value<QVector3D>();
+                if (m.contains("property")) s.motion.propertyLink = m["property"].toString();
                 
                 if (m.contains("mapping")) {
-                    QVariantMap map = m["mapping"].toMap();
-                    if (map.contains("type")) m_sceneNodes[i].motion.mapping.type = map["type"].toString();
-                    if (map.contains("in_min")) m_sceneNodes[i].motion.mapping.inMin = map["in_min"].toDouble();
-                    if (map.contains("in_max")) m_sceneNodes[i].motion.mapping.inMax = map["in_max"].toDouble();
-                    if (map.contains("out_min")) m_sceneNodes[i].motion.mapping.outMin = map["out_min"].toDouble();
-                    if (map.contains("out_max")) m_sceneNodes[i].motion.mapping.outMax = map["out_max"].toDouble();
+                    updateMapping(s.motion.mapping, m["mapping"].toMap());
                 }
             }
+
+            // Only this node's delegate in the scene sees the edit
+            const QList<int> roles = SceneNodeTreeModel::changedRoles(m_sceneNodes[i], s);
+            if (roles.isEmpty()) return;
+            m_sceneNodes[i] = s;
+            m_sceneModel->updateNode(i, roles);
             emit sceneNodesChanged();
             return;
         }
@@ -334,10 +405,8 @@ void LayoutConfig::updateSceneNode(const QString& id, const QVariantMap& config)
 
 void LayoutConfig::clear()
 {
-    m_widgets.clear();
-    m_sceneNodes.clear();
-    emit widgetsChanged();
-    emit sceneNodesChanged();
+    setWidgets({});
+    setSceneNodes({});
 }
 
 bool LayoutConfig::loadFromFile(const QString& filePath, QString& errorMessage)
@@ -354,8 +423,8 @@ bool LayoutConfig::loadFromFile(const QString& filePath, QString& errorMessage)
         emit backgroundSourceChanged();
         emit backgroundColorChanged();
 
-        m_widgets.clear();
         if (config["widgets"] && config["widgets"].IsSequence() && config["widgets"].size() > 0) {
+            QList<WidgetConfig> widgets;
             for (const auto& wNode : config["widgets"]) {
                 WidgetConfig w;
                 if (wNode["type"]) w.type = QString::fromStdString(wNode["type"].as<std::string>());
@@ -365,14 +434,15 @@ bool LayoutConfig::loadFromFile(const QString& filePath, QString& errorMessage)
                 if (wNode["y"]) w.y = wNode["y"].as<double>();
                 if (wNode["property"]) w.propertyLink = QString::fromStdString(wNode["property"].as<std::string>());
                 w.mapping = parseMapping(wNode["mapping"]);
-                m_widgets.append(w);
+                widgets.append(w);
             }
+            setWidgets(widgets);
         } else {
             setDefaultWidgets();
         }
         
-        m_sceneNodes.clear();
         if (config["scene"] && config["scene"].IsSequence() && config["scene"].size() > 0) {
+            QList<SceneNodeConfig> nodes;
             for (const auto& sNode : config["scene"]) {
                 SceneNodeConfig s;
                 if (sNode["model"]) s.model = QString::fromStdString(sNode["model"].as<std::string>());
@@ -395,13 +465,13 @@ bool LayoutConfig::loadFromFile(const QString& filePath, QString& errorMessage)
                     if (mNode["property"]) s.motion.propertyLink = QString::fromStdString(mNode["property"].as<std::string>());
                     s.motion.mapping = parseMapping(mNode["mapping"]);
                 }
-                m_sceneNodes.append(s);
+                nodes.append(s);
             }
+            setSceneNodes(nodes);
         } else {
             // Re-inject defaults if scene is missing or empty
             setDefaultScene();
         }
-        emit sceneNodesChanged();
         return true;
     } catch (const std::exception& e) {
         errorMessage = QString::fromStdString(e.what());
@@ -466,6 +536,20 @@ bool LayoutConfig::saveToFile(const QString& filePath, QString& errorMessage)
     }
 }
 
+static bool modelExists(const QString& model)
+{
+    if (model.isEmpty() || model.startsWith("#")) {
+        return true;    // primitive
+    }
+    if (model.startsWith("qrc:")) {
+        return QFile::exists(model.mid(3)); // mid(3) skips "qrc" but keeps ":/"
+    }
+    // Try as relative to known resource paths or absolute
+    return QFile::exists(model) || 
+           QFile::exists(":/qt/resources/qml/" + model) || 
+           QFile::exists(":/qt/qml/ObservatoryMonitor/" + model);
+}
+
 bool LayoutConfig::validate(const CapabilityRegistry* caps, QString& errorMessage)
 {
     m_isValid = true;
@@ -479,11 +563,6 @@ bool LayoutConfig::validate(const CapabilityRegistry* caps, QString& errorMessag
         return false;
     };
 
-    QStringList validProps;
-    if (caps) {
-        validProps = caps->allPropertyLinks();
-    }
-
     // Check for duplicate widget IDs and valid properties
     QSet<QString> widgetIds;
     for (const auto& w : m_widgets) {
@@ -492,9 +571,14 @@ bool LayoutConfig::validate(const CapabilityRegistry* caps, QString& errorMessag
         }
         widgetIds.insert(w.id);
 
-        if (caps && !w.propertyLink.isEmpty() && !validProps.contains(w.propertyLink)) {
+        if (caps && !w.propertyLink.isEmpty() && !caps->hasPropertyLink(w.propertyLink)) {
             return fail(QString("Widget '%1' references non-existent property: %2").arg(w.id, w.propertyLink));
         }
+
+        QString mappingProblem = mappingError(w.mapping);
+        if (!mappingProblem.isEmpty()) {
+            return fail(QString("Widget '%1': %2").arg(w.id, mappingProblem));
+        }
     }
 
     // Check for duplicate scene node IDs, valid properties, and file existence
@@ -505,25 +589,18 @@ bool LayoutConfig::validate(const CapabilityRegistry* caps, QString& errorMessag
         }
         nodeIds.insert(s.id);
 
-        if (caps && s.motion.type != "none" && !s.motion.propertyLink.isEmpty() && !validProps.contains(s.motion.propertyLink)) {
+        if (caps && s.motion.type != "none" && !s.motion.propertyLink.isEmpty() && !caps->hasPropertyLink(s.motion.propertyLink)) {
             return fail(QString("Scene node '%1' references non-existent property: %2").arg(s.id, s.motion.propertyLink));
         }
 
+        QString mappingProblem = mappingError(s.motion.mapping);
+        if (!mappingProblem.isEmpty()) {
+            return fail(QString("Scene node '%1': %2").arg(s.id, mappingProblem));
+        }
+
         // Validate model file existence (if not a primitive)
-        if (!s.model.isEmpty() && !s.model.startsWith("#")) {
-            bool exists = false;
-            if (s.model.startsWith("qrc:")) {
-                exists = QFile::exists(s.model.mid(3)); // mid(3) skips "qrc" but keeps ":/"
-            } else {
-                // Try as relative to known resource paths or absolute
-                exists = QFile::exists(s.model) || 
-                         QFile::exists(":/qt/resources/qml/" + s.model) || 
-                         QFile::exists(":/qt/qml/ObservatoryMonitor/" + s.model);
-            }
-            
-            if (!exists) {
-                return fail(QString("Scene node '%1' references missing model file: %2").arg(s.id, s.model));
-            }
+        if (!modelExists(s.model)) {
+            return fail(QString("Scene node '%1' references missing model file: %2").arg(s.id, s.model));
         }
     }
 
@@ -556,4 +633,86 @@ bool LayoutConfig::validate(const CapabilityRegistry* caps, QString& errorMessag
     return true;
 }
 
+bool LayoutConfig::validateModelFiles(QString& errorMessage)
+{
+    for (const auto& s : m_sceneNodes) {
+        if (!modelExists(s.model)) {
+            m_isValid = false;
+            m_validationError = QString("Scene node '%1' references missing model file: %2").arg(s.id, s.model);
+            errorMessage = m_validationError;
+            emit validationChanged();
+            return false;
+        }
+    }
+    return true;
+}
+
+static void writeMapping(QDataStream& out, const MappingDefinition& m) {
+    out << m.type << m.inMin << m.inMax << m.outMin << m.outMax
+        << m.period << m.wrapOrigin << m.unwrap << m.points << m.coefficients
+        << m.trueValue << m.falseValue << m.truePattern;
+}
+
+static void readMapping(QDataStream& in, MappingDefinition& m) {
+    in >> m.type >> m.inMin >> m.inMax >> m.outMin >> m.outMax
+       >> m.period >> m.wrapOrigin >> m.unwrap >> m.points >> m.coefficients
+       >> m.trueValue >> m.falseValue >> m.truePattern;
+}
+
+void LayoutConfig::saveToStream(QDataStream& out) const
+{
+    out << m_backgroundSource << m_backgroundColor;
+
+    out << quint32(m_widgets.size());
+    for (const auto& w : m_widgets) {
+        out << w.type << w.id << w.label << w.x << w.y << w.propertyLink;
+        writeMapping(out, w.mapping);
+    }
+
+    out << quint32(m_sceneNodes.size());
+    for (const auto& s : m_sceneNodes) {
+        out << s.model << s.id << s.parentId << s.offset
+            << s.motion.type << s.motion.axis << s.motion.propertyLink;
+        writeMapping(out, s.motion.mapping);
+    }
+}
+
+bool LayoutConfig::loadFromStream(QDataStream& in)
+{
+    QString backgroundSource;
+    QString backgroundColor;
+    in >> backgroundSource >> backgroundColor;
+
+    quint32 count = 0;
+    in >> count;
+    QList<WidgetConfig> widgets;
+    for (quint32 i = 0; i < count && in.status() == QDataStream::Ok; ++i) {
+        WidgetConfig w;
+        in >> w.type >> w.id >> w.label >> w.x >> w.y >> w.propertyLink;
+        readMapping(in, w.mapping);
+        widgets.append(w);
+    }
+
+    in >> count;
+    QList<SceneNodeConfig> nodes;
+    for (quint32 i = 0; i < count && in.status() == QDataStream::Ok; ++i) {
+        SceneNodeConfig s;
+        in >> s.model >> s.id >> s.parentId >> s.offset
+           >> s.motion.type >> s.motion.axis >> s.motion.propertyLink;
+        readMapping(in, s.motion.mapping);
+        nodes.append(s);
+    }
+
+    if (in.status() != QDataStream::Ok) return false;
+
+    setBackgroundSource(backgroundSource);
+    setBackgroundColor(backgroundColor);
+    setWidgets(widgets);
+    setSceneNodes(nodes);
+    m_isValid = true;
+    m_validationError = "";
+    emit validationChanged();
+    return true;
+}
+
 } // namespace ObservatoryMonitor
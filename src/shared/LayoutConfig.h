@@ -6,6 +6,10 @@
 #include <QVector3D>
 #include <QObject>
 #include "ValueMappingEngine.h"
+#include "WidgetListModel.h"
+#include "SceneNodeTreeModel.h"
+
+class QDataStream;
 
 namespace ObservatoryMonitor {
 
@@ -39,7 +43,9 @@ class LayoutConfig : public QObject
 {
     Q_OBJECT
     Q_PROPERTY(QVariantList widgets READ widgetsVariant NOTIFY widgetsChanged)
+    Q_PROPERTY(WidgetListModel* widgetModel READ widgetModel CONSTANT)
     Q_PROPERTY(QVariantList sceneNodes READ sceneNodesVariant NOTIFY sceneNodesChanged)
+    Q_PROPERTY(SceneNodeTreeModel* sceneModel READ sceneModel CONSTANT)
     Q_PROPERTY(QString backgroundSource READ backgroundSource WRITE setBackgroundSource NOTIFY backgroundSourceChanged)
     Q_PROPERTY(QString backgroundColor READ backgroundColor WRITE setBackgroundColor NOTIFY backgroundColorChanged)
     Q_PROPERTY(bool isValid READ isValid NOTIFY validationChanged)
@@ -51,6 +57,14 @@ public:
     bool loadFromFile(const QString& filePath, QString& errorMessage);
     bool saveToFile(const QString& filePath, QString& errorMessage);
     bool validate(const CapabilityRegistry* caps, QString& errorMessage);
+    // The model file checks of validate() alone, for a layout loaded from
+    // LayoutCache: its source hash does not cover the model files
+    bool validateModelFiles(QString& errorMessage);
+
+    // Compact binary form of a validated layout, for LayoutCache. Loading
+    // marks the layout valid; on a stream error nothing is changed.
+    void saveToStream(QDataStream& out) const;
+    bool loadFromStream(QDataStream& in);
     
     void setDefaults();
     void setDefaultWidgets();
@@ -66,10 +80,18 @@ public:
     QString validationError() const { return m_validationError; }
 
     QList<WidgetConfig> widgets() const { return m_widgets; }
+    // Snapshot of every widget; the Dashboard uses widgetModel instead so
+    // edits only touch the affected row
     QVariantList widgetsVariant() const;
+    WidgetListModel* widgetModel() const { return m_widgetModel; }
+    static QVariantMap widgetToVariant(const WidgetConfig& widget);
     
     QList<SceneNodeConfig> sceneNodes() const { return m_sceneNodes; }
+    // Flat snapshot for lists and the inspector; the 3D scene is built from
+    // sceneModel, which nests nodes under their parents
     QVariantList sceneNodesVariant() const;
+    SceneNodeTreeModel* sceneModel() const { return m_sceneModel; }
+    static QVariantMap sceneNodeToVariant(const SceneNodeConfig& node);
     
     Q_INVOKABLE void addWidget(const QVariantMap& config);
     Q_INVOKABLE void removeWidget(const QString& id);
@@ -88,8 +110,14 @@ signals:
     void validationChanged();
 
 private:
+    // Replaces every widget as one model reset
+    void setWidgets(const QList<WidgetConfig>& widgets);
+    void setSceneNodes(const QList<SceneNodeConfig>& nodes);
+
     QList<WidgetConfig> m_widgets;
+    WidgetListModel* m_widgetModel;
     QList<SceneNodeConfig> m_sceneNodes;
+    SceneNodeTreeModel* m_sceneModel;
     QString m_backgroundSource;
     QString m_backgroundColor;
     bool m_isValid = true;
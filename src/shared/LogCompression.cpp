@@ -0,0 +1,74 @@
+#include "LogCompression.h"
+#include <QFile>
+#include <QDateTime>
+#include <QtEndian>
+
+namespace ObservatoryMonitor {
+
+namespace LogCompression {
+
+bool isCompressed(const QString& path)
+{
+    return path.endsWith(QLatin1String(Extension));
+}
+
+bool compressFile(const QString& source, const QString& target, QString& errorMessage)
+{
+    QFile in(source);
+    if (!in.open(QIODevice::ReadOnly)) {
+        errorMessage = QString("Cannot open '%1': %2").arg(source, in.errorString());
+        return false;
+    }
+    const QDateTime modified = in.fileTime(QFileDevice::FileModificationTime);
+    const QByteArray compressed = qCompress(in.readAll());
+    in.close();
+
+    if (compressed.isEmpty()) {
+        errorMessage = QString("Cannot compress '%1'").arg(source);
+        return false;
+    }
+
+    QFile out(target);
+    if (!out.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        errorMessage = QString("Cannot write '%1': %2").arg(target, out.errorString());
+        return false;
+    }
+    if (out.write(compressed) != compressed.size() || !out.flush()) {
+        errorMessage = QString("Cannot write '%1': %2").arg(target, out.errorString());
+        out.close();
+        QFile::remove(target);
+        return false;
+    }
+    // After the flush, so closing does not touch it again
+    out.setFileTime(modified, QFileDevice::FileModificationTime);
+    out.close();
+    return true;
+}
+
+bool readFile(const QString& path, QByteArray& data, QString& errorMessage)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        errorMessage = QString("Cannot open '%1': %2").arg(path, file.errorString());
+        return false;
+    }
+
+    if (!isCompressed(path)) {
+        data = file.readAll();
+        return true;
+    }
+
+    const QByteArray compressed = file.readAll();
+    data = qUncompress(compressed);
+    // An empty result is only valid for an empty original
+    if (data.isEmpty() && (compressed.size() < 4
+                           || qFromBigEndian<quint32>(compressed.constData()) != 0)) {
+        errorMessage = QString("Corrupt compressed log '%1'").arg(path);
+        return false;
+    }
+    return true;
+}
+
+} // namespace LogCompression
+
+} // namespace ObservatoryMonitor
@@ -0,0 +1,28 @@
+#ifndef LOGCOMPRESSION_H
+#define LOGCOMPRESSION_H
+
+#include <QString>
+#include <QByteArray>
+
+namespace ObservatoryMonitor {
+
+// Whole-file compression of closed log segments. A compressed segment keeps
+// its name with ".qz" appended and holds qCompress() output: a 4-byte
+// big-endian uncompressed length followed by a zlib stream. Text logs
+// compress 10-20x; observatory-logdump and BinaryLogReader read either form.
+namespace LogCompression {
+    const char* const Extension = ".qz";
+
+    bool isCompressed(const QString& path);
+
+    // Writes the compressed contents of source to target, keeping the
+    // source's modification time so segments still order by age
+    bool compressFile(const QString& source, const QString& target, QString& errorMessage);
+
+    // Reads a log file, decompressing it when its name ends in Extension
+    bool readFile(const QString& path, QByteArray& data, QString& errorMessage);
+}
+
+} // namespace ObservatoryMonitor
+
+#endif // LOGCOMPRESSION_H
@@ -0,0 +1,89 @@
+#include "LogEvent.h"
+
+namespace ObservatoryMonitor {
+
+QString LogEvent::message() const
+{
+    return LogText::render(format, args.constData(), args.size());
+}
+
+namespace LogText {
+
+QString levelName(LogLevel level)
+{
+    switch (level) {
+        case LogLevel::Debug:    return "DEBUG";
+        case LogLevel::Info:     return "INFO ";
+        case LogLevel::Warning:  return "WARN ";
+        case LogLevel::Error:    return "ERROR";
+        case LogLevel::Critical: return "CRIT ";
+        default:                 return "?????";
+    }
+}
+
+bool parseLevel(const QString& name, LogLevel& level)
+{
+    const QString lower = name.trimmed().toLower();
+    if (lower == "debug") level = LogLevel::Debug;
+    else if (lower == "info") level = LogLevel::Info;
+    else if (lower == "warning" || lower == "warn") level = LogLevel::Warning;
+    else if (lower == "error") level = LogLevel::Error;
+    else if (lower == "critical" || lower == "crit") level = LogLevel::Critical;
+    else return false;
+    return true;
+}
+
+static void appendArg(QString& out, const LogArg& arg)
+{
+    switch (arg.type) {
+        case LogArg::Type::Int:    out += QString::number(arg.integer); break;
+        case LogArg::Type::Double: out += QString::number(arg.real); break;
+        case LogArg::Type::String: out += arg.text; break;
+    }
+}
+
+QString render(QStringView format, const LogArg* args, qsizetype count)
+{
+    QString out;
+    out.reserve(format.size() + 16 * count);
+
+    const qsizetype size = format.size();
+    qsizetype i = 0;
+    while (i < size) {
+        const QChar c = format[i];
+        if (c == u'%' && i + 1 < size && format[i + 1].isDigit()) {
+            int number = format[i + 1].digitValue();
+            qsizetype next = i + 2;
+            if (next < size && format[next].isDigit()) {
+                number = number * 10 + format[next].digitValue();
+                ++next;
+            }
+            if (number >= 1 && number <= count) {
+                appendArg(out, args[number - 1]);
+                i = next;
+                continue;
+            }
+        }
+        out += c;
+        ++i;
+    }
+    return out;
+}
+
+QString formatLine(const QDateTime& when, LogLevel level, const QString& message,
+                   const QString& category, const QString& controller)
+{
+    QString line = QString("[%1] [%2] ").arg(when.toString("yyyy-MM-dd HH:mm:ss.zzz"), levelName(level));
+    if (!category.isEmpty()) {
+        line += '[' + category + "] ";
+    }
+    if (!controller.isEmpty()) {
+        line += '[' + controller + "] ";
+    }
+    line += message;
+    return line;
+}
+
+} // namespace LogText
+
+} // namespace ObservatoryMonitor
@@ -0,0 +1,90 @@
+#ifndef LOGEVENT_H
+#define LOGEVENT_H
+
+#include <QString>
+#include <QStringView>
+#include <QByteArray>
+#include <QDateTime>
+#include <QVarLengthArray>
+#include <type_traits>
+
+namespace ObservatoryMonitor {
+
+// Log levels
+enum class LogLevel {
+    Debug,    // Verbose debug information (only when debug logging enabled)
+    Info,     // General information
+    Warning,  // Warning messages
+    Error,    // Error messages
+    Critical  // Critical errors
+};
+
+// One argument of a structured log statement. Kept typed until the record
+// is written, so the producer never formats and the binary log can store
+// the value as is.
+struct LogArg {
+    enum class Type : quint8 {
+        Int,
+        Double,
+        String
+    };
+
+    Type type = Type::Int;
+    qint64 integer = 0;
+    double real = 0.0;
+    QString text;
+};
+
+using LogArgs = QVarLengthArray<LogArg, 4>;
+
+template <typename T>
+LogArg toLogArg(const T& value)
+{
+    LogArg arg;
+    if constexpr (std::is_integral_v<T> || std::is_enum_v<T>) {
+        arg.type = LogArg::Type::Int;
+        arg.integer = static_cast<qint64>(value);
+    } else if constexpr (std::is_floating_point_v<T>) {
+        arg.type = LogArg::Type::Double;
+        arg.real = static_cast<double>(value);
+    } else if constexpr (std::is_same_v<T, QByteArray>) {
+        arg.type = LogArg::Type::String;
+        arg.text = QString::fromUtf8(value);
+    } else {
+        arg.type = LogArg::Type::String;
+        arg.text = QString(value);
+    }
+    return arg;
+}
+
+// A log record as read back from a binary log
+struct LogEvent {
+    qint64 timestampMs = 0;     // wall clock, ms since epoch
+    LogLevel level = LogLevel::Info;
+    QString category;           // empty when the record had none
+    QString controller;
+    QString format;             // "%1"-style template
+    LogArgs args;
+
+    QString message() const;
+};
+
+// The text log format, shared by the Logger and observatory-logdump so a
+// decoded binary log reads exactly like a text one.
+namespace LogText {
+    QString levelName(LogLevel level);
+    // Parses "debug", "info", "warning"/"warn", "error", "critical"/"crit"
+    bool parseLevel(const QString& name, LogLevel& level);
+
+    // Substitutes %1..%99 in one pass; argument text is never rescanned
+    QString render(QStringView format, const LogArg* args, qsizetype count);
+
+    // "[yyyy-MM-dd HH:mm:ss.zzz] [LEVEL] [category] [controller] message",
+    // leaving out the parts that are empty
+    QString formatLine(const QDateTime& when, LogLevel level, const QString& message,
+                       const QString& category = QString(), const QString& controller = QString());
+}
+
+} // namespace ObservatoryMonitor
+
+#endif // LOGEVENT_H
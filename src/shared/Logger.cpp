@@ -1,11 +1,28 @@
 #include "Logger.h"
+#include "LogCompression.h"
 #include <QDir>
 #include <QFileInfo>
 #include <QDateTime>
+#include <chrono>
 #include <iostream>
+#include <vector>
 
 namespace ObservatoryMonitor {
 
+// Records the writer drains per lock/write/flush cycle
+static constexpr qsizetype WriterBatchSize = 256;
+
+// Set while a thread is inside writeRecords() or is the writer thread. A Qt
+// warning raised while writing would otherwise re-enter the logger and
+// deadlock on m_mutex or wait on itself; it goes to stderr instead.
+static thread_local bool t_inLogger = false;
+
+static qint64 steadyNowNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
 Logger::Logger()
     : m_debugEnabled(false)
     , m_consoleEnabled(true)
@@ -39,6 +56,8 @@ bool Logger::initialize(const QString& logDir, bool enableDebug, bool enableCons
         m_debugEnabled = enableDebug;
         m_consoleEnabled = enableConsole;
         m_maxTotalSizeMB = maxTotalSizeMB;
+        m_maxFileBytes = static_cast<qint64>(m_maxFileSizeMB > 0 ? m_maxFileSizeMB
+                                                                  : qMax(1, maxTotalSizeMB / 10)) * 1024 * 1024;
         
         // Create log directory if it doesn't exist
         QDir dir;
@@ -58,9 +77,41 @@ bool Logger::initialize(const QString& logDir, bool enableDebug, bool enableCons
             return false;
         }
         
-        // Enforce size limits
+        // Enforce size limits; this also seeds the running byte count
         enforceMaxTotalSize();
         
+        if (m_asyncRequested) {
+            // Reused while large enough: a producer that raced the last
+            // shutdown() may still be pushing into it
+            if (!m_queue || m_queue->capacity() < m_queueCapacity) {
+                m_queue.reset(new MpscRing<LogRecord>(m_queueCapacity));
+                m_written = 0;
+            }
+            m_dropped = 0;
+            m_stopping = false;
+            m_writer.reset(new std::thread(&Logger::writerLoop, this));
+            m_async = true;
+        }
+        
+        if (m_compressionRequested) {
+            m_compressStopping = false;
+            m_compressor.reset(new std::thread(&Logger::compressorLoop, this));
+            
+            // Segments an earlier run closed but did not get to compress
+            const QStringList openFiles = openLogFileNames();
+            for (const QFileInfo& info : getLogFiles()) {
+                if (!LogCompression::isCompressed(info.fileName())
+                    && !openFiles.contains(info.absoluteFilePath())) {
+                    queueCompression(info.absoluteFilePath());
+                }
+            }
+            const QStringList partial = QDir(m_logDir).entryList(
+                QStringList() << QString("observatory-monitor_*") + LogCompression::Extension + ".part", QDir::Files);
+            for (const QString& name : partial) {
+                QFile::remove(m_logDir + "/" + name);
+            }
+        }
+        
         m_initialized = true;
     } // Release mutex before installing message handler
     
@@ -82,15 +133,148 @@ void Logger::shutdown()
     // Restore default Qt message handler FIRST, outside mutex
     qInstallMessageHandler(nullptr);
     
+    if (!m_initialized.exchange(false)) {
+        return;
+    }
+    
+    // The writer drains the queue before it exits; it needs m_mutex to do so
+    stopWriter();
+    // Likewise for a compression in progress
+    stopCompressor();
+    
     QMutexLocker locker(&m_mutex);
     
-    if (!m_initialized) {
-        return;
+    // Pushes that raced the writer's exit
+    if (m_queue) {
+        LogRecord record;
+        while (m_queue->tryPop(record)) {
+            writeRecords(&record, 1);
+            m_written.fetch_add(1, std::memory_order_release);
+        }
     }
     
     closeLogFiles();
+}
+
+void Logger::setAsync(bool enabled, LogOverflowPolicy policy, int queueCapacity)
+{
+    QMutexLocker locker(&m_mutex);
+    m_asyncRequested = enabled;
+    m_overflowPolicy = policy;
+    m_queueCapacity = qMax(queueCapacity, 2);
+}
+
+void Logger::setMaxFileSize(int maxFileSizeMB)
+{
+    QMutexLocker locker(&m_mutex);
+    m_maxFileSizeMB = qMax(maxFileSizeMB, 0);
+}
+
+void Logger::setCompression(bool enabled)
+{
+    QMutexLocker locker(&m_mutex);
+    m_compressionRequested = enabled;
+}
+
+void Logger::stopWriter()
+{
+    if (!m_writer) {
+        return;
+    }
+    
+    // From here on log() takes the synchronous path, which sees
+    // m_initialized == false and drops the record
+    m_async = false;
+    m_stopping = true;
+    wakeWriter();
+    m_writer->join();
+    m_writer.reset();
     
-    m_initialized = false;
+    // Release producers still waiting for room under the Block policy
+    m_drained.notify_all();
+}
+
+void Logger::wakeWriter()
+{
+    // Pairs with the fence in writerLoop(): either the writer sees the new
+    // record before it sleeps, or we see it idle and notify
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (m_writerIdle.load(std::memory_order_relaxed)) {
+        std::lock_guard<std::mutex> lock(m_wakeMutex);
+        m_wake.notify_one();
+    }
+}
+
+void Logger::enqueue(LogRecord&& record)
+{
+    while (!m_queue->tryPush(std::move(record))) {
+        if (m_overflowPolicy == LogOverflowPolicy::Drop
+            || m_stopping.load(std::memory_order_relaxed)) {
+            m_dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        
+        // Block: wait for the writer to free a batch of cells
+        wakeWriter();
+        std::unique_lock<std::mutex> lock(m_wakeMutex);
+        m_drained.wait_for(lock, std::chrono::milliseconds(10));
+    }
+    wakeWriter();
+}
+
+void Logger::writerLoop()
+{
+    t_inLogger = true;
+    
+    std::vector<LogRecord> batch;
+    batch.reserve(WriterBatchSize);
+    LogRecord record;
+    
+    for (;;) {
+        while (qsizetype(batch.size()) < WriterBatchSize && m_queue->tryPop(record)) {
+            batch.push_back(std::move(record));
+        }
+        
+        if (!batch.empty()) {
+            {
+                QMutexLocker locker(&m_mutex);
+                writeRecords(batch.data(), qsizetype(batch.size()));
+            }
+            m_written.fetch_add(batch.size(), std::memory_order_release);
+            batch.clear();
+            m_drained.notify_all();
+            continue;
+        }
+        
+        if (m_stopping.load()) {
+            break;
+        }
+        
+        std::unique_lock<std::mutex> lock(m_wakeMutex);
+        m_writerIdle.store(true, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (m_queue->isEmpty() && !m_stopping.load()) {
+            // The timeout only bounds a missed wakeup
+            m_wake.wait_for(lock, std::chrono::milliseconds(100));
+        }
+        m_writerIdle.store(false, std::memory_order_relaxed);
+    }
+}
+
+void Logger::flush()
+{
+    if (!m_async.load() || t_inLogger) {
+        // Synchronous writes are flushed as they happen
+        return;
+    }
+    
+    const quint64 target = m_queue->pushedCount();
+    wakeWriter();
+    
+    std::unique_lock<std::mutex> lock(m_wakeMutex);
+    while (m_written.load(std::memory_order_acquire) < target && m_async.load()) {
+        m_drained.wait_for(lock, std::chrono::milliseconds(10));
+    }
 }
 
 bool Logger::openLogFiles()
@@ -98,30 +282,19 @@ bool Logger::openLogFiles()
     // Close any existing files
     closeLogFiles();
     
-    // Generate filename with date
-    QString dateStr = m_currentDate.toString("yyyy-MM-dd");
-    
-    // User log file
-    QString userLogPath = m_logDir + "/observatory-monitor_" + dateStr + ".log";
-    m_userLogFile.setFileName(userLogPath);
-    if (!m_userLogFile.open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Text)) {
-        std::cerr << "Failed to open user log file: " 
-                 << userLogPath.toStdString() << std::endl;
+    // User log file; a restart continues the day's last segment
+    m_userSegment = lastSegment(LogFile::User);
+    if (!openLogFile(LogFile::User)) {
         return false;
     }
-    m_userLogStream.setDevice(&m_userLogFile);
     
     // Debug log file (if enabled)
     if (m_debugEnabled) {
-        QString debugLogPath = m_logDir + "/observatory-monitor_" + dateStr + "_debug.log";
-        m_debugLogFile.setFileName(debugLogPath);
-        if (!m_debugLogFile.open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Text)) {
-            std::cerr << "Failed to open debug log file: " 
-                     << debugLogPath.toStdString() << std::endl;
-            m_userLogFile.close();
+        m_debugSegment = lastSegment(LogFile::Debug);
+        if (!openLogFile(LogFile::Debug)) {
+            closeLogFile(LogFile::User);
             return false;
         }
-        m_debugLogStream.setDevice(&m_debugLogFile);
     }
     
     return true;
@@ -129,173 +302,460 @@ bool Logger::openLogFiles()
 
 void Logger::closeLogFiles()
 {
-    if (m_userLogFile.isOpen()) {
-        m_userLogStream.flush();
-        m_userLogFile.close();
+    closeLogFile(LogFile::User);
+    closeLogFile(LogFile::Debug);
+}
+
+bool Logger::openLogFile(LogFile file)
+{
+    const QString path = logFilePath(file, file == LogFile::User ? m_userSegment : m_debugSegment);
+    // Counted again as the open file's bytes
+    const qint64 existing = QFileInfo(path).size();
+    
+    if (file == LogFile::Debug && m_binaryDebug) {
+        QString errorMessage;
+        if (!m_binaryDebugLog.open(path, errorMessage)) {
+            std::cerr << "Failed to open debug log file: "
+                     << errorMessage.toStdString() << std::endl;
+            return false;
+        }
+        m_closedBytes -= existing;
+        return true;
     }
     
-    if (m_debugLogFile.isOpen()) {
-        m_debugLogStream.flush();
-        m_debugLogFile.close();
+    QFile& logFile = file == LogFile::User ? m_userLogFile : m_debugLogFile;
+    logFile.setFileName(path);
+    if (!logFile.open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Text)) {
+        std::cerr << "Failed to open " << (file == LogFile::User ? "user" : "debug") << " log file: "
+                 << path.toStdString() << std::endl;
+        return false;
     }
+    (file == LogFile::User ? m_userLogStream : m_debugLogStream).setDevice(&logFile);
+    m_closedBytes -= existing;
+    return true;
 }
 
-void Logger::rotateLogsIfNeeded()
+void Logger::closeLogFile(LogFile file)
 {
-    QDate today = QDate::currentDate();
-    if (today != m_currentDate) {
-        // Date has changed, rotate logs
-        log(LogLevel::Info, "Daily log rotation");
-        closeLogFiles();
-        m_currentDate = today;
-        openLogFiles();
-        log(LogLevel::Info, "Log rotation complete");
+    if (file == LogFile::User) {
+        if (m_userLogFile.isOpen()) {
+            m_userLogStream.flush();
+            m_closedBytes += m_userLogFile.pos();
+            m_userLogFile.close();
+        }
+    } else {
+        if (m_debugLogFile.isOpen()) {
+            m_debugLogStream.flush();
+            m_closedBytes += m_debugLogFile.pos();
+            m_debugLogFile.close();
+        }
+        if (m_binaryDebugLog.isOpen()) {
+            m_closedBytes += m_binaryDebugLog.size();
+            m_binaryDebugLog.close();
+        }
     }
+    
+    // The closed file may be deleted now
+    m_retentionExhausted = false;
 }
 
-void Logger::enforceMaxTotalSize()
+QString Logger::logFilePath(LogFile file, int segment) const
 {
-    qint64 totalSize = getTotalLogSize();
-    qint64 maxSize = static_cast<qint64>(m_maxTotalSizeMB) * 1024 * 1024;
-    
-    if (totalSize <= maxSize) {
+    QString path = m_logDir + "/observatory-monitor_" + m_currentDate.toString("yyyy-MM-dd");
+    if (file == LogFile::Debug) {
+        path += "_debug";
+    }
+    if (segment > 0) {
+        path += '.' + QString::number(segment);
+    }
+    if (file == LogFile::Debug && m_binaryDebug) {
+        return path + BinaryLogFormat::Extension;
+    }
+    return path + ".log";
+}
+
+int Logger::lastSegment(LogFile file) const
+{
+    // Retention may have deleted the first segments already, so look for
+    // the highest number rather than the first gap
+    const QString first = QFileInfo(logFilePath(file, 0)).fileName();
+    const qsizetype dot = first.lastIndexOf('.');
+    const QString prefix = first.left(dot + 1);     // observatory-monitor_<date>[_debug].
+    const QString extension = first.mid(dot);
+    
+    // The first segment has no number
+    int segment = QFileInfo::exists(logFilePath(file, 0) + LogCompression::Extension) ? 1 : 0;
+    const QStringList names = QDir(m_logDir).entryList(
+        QStringList() << prefix + "*" + extension << prefix + "*" + extension + LogCompression::Extension,
+        QDir::Files);
+    for (QString name : names) {
+        // A compressed segment is finished; continue with the next one
+        int next = 0;
+        if (LogCompression::isCompressed(name)) {
+            name.chop(qstrlen(LogCompression::Extension));
+            next = 1;
+        }
+        bool ok = false;
+        const int number = name.mid(prefix.size(), name.size() - prefix.size() - extension.size()).toInt(&ok);
+        if (ok) {
+            segment = qMax(segment, number + next);
+        }
+    }
+    return segment;
+}
+
+void Logger::rotateLogsIfNeeded(const QDate& date)
+{
+    // Queued records can be older than the files already open; they never
+    // rotate back
+    if (date <= m_currentDate) {
         return;
     }
     
-    // Get all log files sorted by modification time (oldest first)
-    QList<QString> userLogs = getLogFiles("observatory-monitor_*[0-9].log");
-    QList<QString> debugLogs = getLogFiles("observatory-monitor_*_debug.log");
+    // Written directly: m_mutex is held and log() would take it again
+    auto note = [this](const QString& message) {
+        const QString line = LogText::formatLine(QDateTime::currentDateTime(), LogLevel::Info, message);
+        m_userLogStream << line << "\n";
+        m_userLogStream.flush();
+        if (m_debugLogFile.isOpen()) {
+            m_debugLogStream << line << "\n";
+            m_debugLogStream.flush();
+        }
+        m_binaryDebugLog.appendMessage(steadyNowNs(), LogLevel::Info, nullptr, QString(), message);
+        m_binaryDebugLog.flush();
+    };
     
-    QList<QPair<QString, QDateTime>> allLogs;
+    note("Daily log rotation");
+    const QStringList closed = openLogFileNames();
+    closeLogFiles();
+    m_currentDate = date;
+    openLogFiles();
+    note("Log rotation complete");
     
-    for (const QString& logPath : userLogs) {
-        QFileInfo info(logPath);
-        allLogs.append(qMakePair(logPath, info.lastModified()));
+    for (const QString& path : closed) {
+        queueCompression(path);
+    }
+}
+
+void Logger::startNextSegment(LogFile file)
+{
+    const QString closed = file == LogFile::User ? m_userLogFile.fileName()
+                         : m_debugLogFile.isOpen() ? m_debugLogFile.fileName()
+                                                   : m_binaryDebugLog.fileName();
+    closeLogFile(file);
+    ++(file == LogFile::User ? m_userSegment : m_debugSegment);
+    openLogFile(file);
+    queueCompression(closed);
+}
+
+qint64 Logger::openLogBytes() const
+{
+    qint64 bytes = m_binaryDebugLog.size();
+    if (m_userLogFile.isOpen()) {
+        bytes += m_userLogFile.pos();
+    }
+    if (m_debugLogFile.isOpen()) {
+        bytes += m_debugLogFile.pos();
+    }
+    return bytes;
+}
+
+QStringList Logger::openLogFileNames() const
+{
+    QStringList names;
+    if (m_userLogFile.isOpen()) {
+        names << QFileInfo(m_userLogFile.fileName()).absoluteFilePath();
+    }
+    if (m_debugLogFile.isOpen()) {
+        names << QFileInfo(m_debugLogFile.fileName()).absoluteFilePath();
+    }
+    if (m_binaryDebugLog.isOpen()) {
+        names << QFileInfo(m_binaryDebugLog.fileName()).absoluteFilePath();
+    }
+    return names;
+}
+
+void Logger::checkLogLimits()
+{
+    if (m_userLogFile.isOpen() && m_userLogFile.pos() >= m_maxFileBytes) {
+        startNextSegment(LogFile::User);
     }
     
-    for (const QString& logPath : debugLogs) {
-        QFileInfo info(logPath);
-        allLogs.append(qMakePair(logPath, info.lastModified()));
+    const qint64 debugBytes = m_debugLogFile.isOpen() ? m_debugLogFile.pos() : m_binaryDebugLog.size();
+    if (debugBytes >= m_maxFileBytes) {
+        startNextSegment(LogFile::Debug);
     }
     
-    // Sort by modification time (oldest first)
-    std::sort(allLogs.begin(), allLogs.end(), 
-              [](const QPair<QString, QDateTime>& a, const QPair<QString, QDateTime>& b) {
-                  return a.second < b.second;
-              });
+    const qint64 maxSize = static_cast<qint64>(m_maxTotalSizeMB) * 1024 * 1024;
+    if (!m_retentionExhausted && m_closedBytes + openLogBytes() > maxSize) {
+        enforceMaxTotalSize();
+    }
+}
+
+void Logger::enforceMaxTotalSize()
+{
+    qint64 maxSize = static_cast<qint64>(m_maxTotalSizeMB) * 1024 * 1024;
+    
+    // One listing gives both the total and the deletion order
+    const QFileInfoList logs = getLogFiles();
+    qint64 totalSize = 0;
+    for (const QFileInfo& info : logs) {
+        totalSize += info.size();
+    }
+    
+    const QStringList openFiles = openLogFileNames();
     
     // Delete oldest files until under size limit
-    int deletedCount = 0;
-    for (const auto& logPair : allLogs) {
+    for (const QFileInfo& info : logs) {
         if (totalSize <= maxSize) {
             break;
         }
         
-        QString logPath = logPair.first;
-        
         // Don't delete current log files
-        if (logPath == userLogPath() || logPath == debugLogPath()) {
+        if (openFiles.contains(info.absoluteFilePath())) {
             continue;
         }
         
-        QFileInfo info(logPath);
-        qint64 fileSize = info.size();
-        
-        if (QFile::remove(logPath)) {
-            totalSize -= fileSize;
-            deletedCount++;
+        if (QFile::remove(info.absoluteFilePath())) {
+            totalSize -= info.size();
         }
     }
+    
+    // Resynchronise the running count with the directory
+    m_closedBytes = totalSize - openLogBytes();
+    m_retentionExhausted = totalSize > maxSize;
 }
 
-QString Logger::formatMessage(LogLevel level, const QString& message)
+QFileInfoList Logger::getLogFiles() const
 {
-    QString timestamp = QDateTime::currentDateTime().toString("yyyy-MM-dd HH:mm:ss.zzz");
-    QString levelStr = levelToString(level);
-    return QString("[%1] [%2] %3").arg(timestamp, levelStr, message);
+    // Every segment of both logs, text and binary, compressed or not, each
+    // listed once, oldest first
+    QDir dir(m_logDir);
+    QStringList filters;
+    filters << "observatory-monitor_*.log"
+            << QString("observatory-monitor_*") + BinaryLogFormat::Extension
+            << QString("observatory-monitor_*") + LogCompression::Extension;
+    
+    return dir.entryInfoList(filters, QDir::Files, QDir::Time | QDir::Reversed);
 }
 
-QString Logger::levelToString(LogLevel level)
+void Logger::queueCompression(const QString& path)
 {
-    switch (level) {
-        case LogLevel::Debug:    return "DEBUG";
-        case LogLevel::Info:     return "INFO ";
-        case LogLevel::Warning:  return "WARN ";
-        case LogLevel::Error:    return "ERROR";
-        case LogLevel::Critical: return "CRIT ";
-        default:                 return "?????";
+    if (!m_compressor) {
+        return;
+    }
+    
+    {
+        std::lock_guard<std::mutex> lock(m_compressMutex);
+        m_compressQueue.push_back(path);
     }
+    m_compressWake.notify_one();
 }
 
-QList<QString> Logger::getLogFiles(const QString& pattern)
+void Logger::stopCompressor()
 {
-    QDir dir(m_logDir);
-    QStringList filters;
-    filters << pattern;
+    if (!m_compressor) {
+        return;
+    }
     
-    QFileInfoList fileList = dir.entryInfoList(filters, QDir::Files, QDir::Time);
+    {
+        std::lock_guard<std::mutex> lock(m_compressMutex);
+        m_compressStopping = true;
+        // The next initialize() picks up what is left
+        m_compressQueue.clear();
+    }
+    m_compressWake.notify_one();
+    m_compressor->join();
+    m_compressor.reset();
+}
+
+void Logger::compressorLoop()
+{
+    // Qt warnings from file operations go to stderr, as on the writer
+    t_inLogger = true;
+    
+    for (;;) {
+        QString path;
+        {
+            std::unique_lock<std::mutex> lock(m_compressMutex);
+            m_compressWake.wait(lock, [this] { return m_compressStopping || !m_compressQueue.empty(); });
+            if (m_compressStopping) {
+                return;
+            }
+            path = m_compressQueue.front();
+            m_compressQueue.pop_front();
+        }
+        compressLogFile(path);
+    }
+}
+
+void Logger::compressLogFile(const QString& path)
+{
+    const QString target = path + LogCompression::Extension;
+    const QString partial = target + ".part";
+    
+    // The slow part runs without m_mutex
+    QString errorMessage;
+    if (!LogCompression::compressFile(path, partial, errorMessage)) {
+        std::cerr << "Failed to compress log file: " << errorMessage.toStdString() << std::endl;
+        QFile::remove(partial);
+        return;
+    }
     
-    QList<QString> result;
-    for (const QFileInfo& info : fileList) {
-        result.append(info.absoluteFilePath());
+    // Swapped in under the lock, so retention and the running count see
+    // either the original or the compressed file
+    QMutexLocker locker(&m_mutex);
+    const QFileInfo original(path);
+    if (!original.exists()
+        || original.lastModified() != QFileInfo(partial).lastModified()
+        || openLogFileNames().contains(original.absoluteFilePath())) {
+        // Deleted by retention, or reopened and written to, meanwhile
+        QFile::remove(partial);
+        return;
     }
     
-    return result;
+    QFile::remove(target);
+    if (!QFile::rename(partial, target)) {
+        std::cerr << "Failed to rename compressed log file: " << target.toStdString() << std::endl;
+        QFile::remove(partial);
+        return;
+    }
+    m_closedBytes -= original.size() - QFileInfo(target).size();
+    QFile::remove(path);
 }
 
-qint64 Logger::getTotalLogSize()
+void Logger::writeRecords(const LogRecord* records, qsizetype count)
 {
-    QList<QString> userLogs = getLogFiles("observatory-monitor_*.log");
-    QList<QString> debugLogs = getLogFiles("observatory-monitor_*_debug.log");
-    
-    qint64 total = 0;
+    const bool outer = !t_inLogger;
+    t_inLogger = true;
     
-    for (const QString& logPath : userLogs) {
-        QFileInfo info(logPath);
-        total += info.size();
+    std::string console;
+    for (qsizetype i = 0; i < count; ++i) {
+        const LogRecord& record = records[i];
+        
+        // Debug may have been switched off since the record was queued
+        if (record.level == LogLevel::Debug && !m_debugEnabled) {
+            continue;
+        }
+        
+        QDateTime when = QDateTime::fromMSecsSinceEpoch(record.timestampMs);
+        
+        // Check if we need to rotate logs
+        rotateLogsIfNeeded(when.date());
+        
+        // The binary debug log stores the record as is
+        if (m_binaryDebugLog.isOpen()) {
+            if (record.format) {
+                m_binaryDebugLog.append(record.steadyNs, record.level, record.category, record.controller,
+                                        record.format, record.args.constData(), record.args.size());
+            } else {
+                m_binaryDebugLog.appendMessage(record.steadyNs, record.level, record.category,
+                                               record.controller, record.message);
+            }
+        }
+        
+        const bool toDebugText = m_debugEnabled && m_debugLogFile.isOpen();
+        if (!m_consoleEnabled && record.level == LogLevel::Debug && !toDebugText) {
+            // Only the binary log wanted it; never rendered as text
+            continue;
+        }
+        
+        const QString message = record.format
+            ? LogText::render(QString::fromUtf8(record.format), record.args.constData(), record.args.size())
+            : record.message;
+        QString formattedMsg = LogText::formatLine(when, record.level, message,
+                                                   record.category ? QString::fromLatin1(record.category) : QString(),
+                                                   record.controller);
+        
+        // Console output
+        if (m_consoleEnabled) {
+            console += formattedMsg.toStdString();
+            console += '\n';
+        }
+        
+        // Always write to user log (except debug messages)
+        if (record.level != LogLevel::Debug) {
+            m_userLogStream << formattedMsg << "\n";
+        }
+        
+        // Write to debug log if enabled
+        if (toDebugText) {
+            m_debugLogStream << formattedMsg << "\n";
+        }
     }
     
-    for (const QString& logPath : debugLogs) {
-        QFileInfo info(logPath);
-        total += info.size();
+    // One flush per batch rather than per line
+    m_userLogStream.flush();
+    if (m_debugLogFile.isOpen()) {
+        m_debugLogStream.flush();
+    }
+    m_binaryDebugLog.flush();
+    if (!console.empty()) {
+        std::cout << console << std::flush;
     }
     
-    return total;
+    checkLogLimits();
+    
+    if (outer) {
+        t_inLogger = false;
+    }
 }
 
 void Logger::log(LogLevel level, const QString& message)
 {
-    QMutexLocker locker(&m_mutex);
+    submit(level, nullptr, message);
+}
+
+void Logger::log(LogLevel level, const LogCategory& category, const QString& message)
+{
+    if (category.isEnabled(level)) {
+        submit(level, category.name(), message);
+    }
+}
+
+void Logger::submit(LogLevel level, const char* category, const QString& message)
+{
+    LogRecord record;
+    record.level = level;
+    record.category = category;
+    record.message = message;
+    submit(std::move(record));
+}
+
+void Logger::submit(LogRecord&& record)
+{
+    if (!m_initialized.load(std::memory_order_acquire)) {
+        return;
+    }
     
-    if (!m_initialized) {
+    // Filtered before anything is formatted or queued
+    if (record.level == LogLevel::Debug && !m_debugEnabled.load(std::memory_order_relaxed)) {
         return;
     }
     
-    // Check if we need to rotate logs
-    rotateLogsIfNeeded();
+    if (t_inLogger) {
+        const QString message = record.format
+            ? LogText::render(QString::fromUtf8(record.format), record.args.constData(), record.args.size())
+            : record.message;
+        std::cerr << message.toStdString() << std::endl;
+        return;
+    }
     
-    QString formattedMsg = formatMessage(level, message);
+    record.timestampMs = QDateTime::currentMSecsSinceEpoch();
+    record.steadyNs = steadyNowNs();
     
-    // Console output
-    if (m_consoleEnabled) {
-        if (level == LogLevel::Debug && !m_debugEnabled) {
-            // Don't output debug to console if debug disabled
-        } else {
-            std::cout << formattedMsg.toStdString() << std::endl;
-        }
+    if (m_async.load(std::memory_order_acquire)) {
+        enqueue(std::move(record));
+        return;
     }
     
-    // Always write to user log (except debug messages)
-    if (level != LogLevel::Debug) {
-        m_userLogStream << formattedMsg << "\n";
-        m_userLogStream.flush();
-    }
+    QMutexLocker locker(&m_mutex);
     
-    // Write to debug log if enabled
-    if (m_debugEnabled && m_debugLogFile.isOpen()) {
-        m_debugLogStream << formattedMsg << "\n";
-        m_debugLogStream.flush();
+    if (!m_initialized) {
+        return;
     }
+    
+    writeRecords(&record, 1);
 }
 
 void Logger::log(LogLevel level, const QString& category, const QString& message)
@@ -344,22 +804,68 @@ void Logger::setDebugEnabled(bool enabled)
         closeLogFiles();
         openLogFiles();
         
-        if (enabled) {
-            log(LogLevel::Info, "Debug logging enabled");
-        } else {
-            log(LogLevel::Info, "Debug logging disabled");
+        // Written directly: log() would take m_mutex again
+        LogRecord record;
+        record.timestampMs = QDateTime::currentMSecsSinceEpoch();
+        record.steadyNs = steadyNowNs();
+        record.message = enabled ? "Debug logging enabled" : "Debug logging disabled";
+        writeRecords(&record, 1);
+    }
+}
+
+void Logger::setBinaryDebugLog(bool enabled)
+{
+    QMutexLocker locker(&m_mutex);
+    m_binaryDebug = enabled;
+}
+
+void Logger::setCategoryLevel(const QString& category, LogLevel minimum)
+{
+    QMutexLocker locker(&m_mutex);
+    m_categoryLevels.insert(category, minimum);
+    for (LogCategory* registered : m_categories) {
+        if (category == QLatin1String(registered->name())) {
+            registered->m_minimumLevel.store(minimum, std::memory_order_relaxed);
         }
     }
 }
 
+void Logger::registerCategory(LogCategory* category)
+{
+    QMutexLocker locker(&m_mutex);
+    m_categories.append(category);
+    auto it = m_categoryLevels.constFind(QString::fromLatin1(category->name()));
+    if (it != m_categoryLevels.constEnd()) {
+        category->m_minimumLevel.store(it.value(), std::memory_order_relaxed);
+    }
+}
+
+void Logger::unregisterCategory(LogCategory* category)
+{
+    QMutexLocker locker(&m_mutex);
+    m_categories.removeOne(category);
+}
+
+LogCategory::LogCategory(const char* name)
+    : m_name(name)
+{
+    Logger::instance().registerCategory(this);
+}
+
+LogCategory::~LogCategory()
+{
+    // The Logger singleton finishes constructing before any category does,
+    // so it is destroyed after them all
+    Logger::instance().unregisterCategory(this);
+}
+
 QString Logger::userLogPath() const
 {
     if (!m_initialized) {
         return QString();
     }
     
-    QString dateStr = m_currentDate.toString("yyyy-MM-dd");
-    return m_logDir + "/observatory-monitor_" + dateStr + ".log";
+    return logFilePath(LogFile::User, m_userSegment);
 }
 
 QString Logger::debugLogPath() const
@@ -368,8 +874,7 @@ QString Logger::debugLogPath() const
         return QString();
     }
     
-    QString dateStr = m_currentDate.toString("yyyy-MM-dd");
-    return m_logDir + "/observatory-monitor_" + dateStr + "_debug.log";
+    return logFilePath(LogFile::Debug, m_debugSegment);
 }
 
 void Logger::messageHandler(QtMsgType type, const QMessageLogContext& context, const QString& msg)
@@ -419,6 +924,7 @@ void Logger::messageHandler(QtMsgType type, const QMessageLogContext& context, c
     
     // For fatal messages, abort after logging
     if (type == QtFatalMsg) {
+        logger.flush();
         abort();
     }
 }
@@ -3,23 +3,47 @@
 
 #include <QString>
 #include <QFile>
+#include <QFileInfo>
 #include <QTextStream>
 #include <QMutex>
 #include <QDateTime>
+#include <QHash>
+#include <QList>
 #include <QtMessageHandler>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include "MpscRing.h"
+#include "LogEvent.h"
+#include "BinaryLog.h"
 
 namespace ObservatoryMonitor {
 
-// Log levels
-enum class LogLevel {
-    Debug,    // Verbose debug information (only when debug logging enabled)
-    Info,     // General information
-    Warning,  // Warning messages
-    Error,    // Error messages
-    Critical  // Critical errors
+class LogCategory;
+
+// What an asynchronous Logger does when its queue is full
+enum class LogOverflowPolicy {
+    Drop,   // discard the record and count it; callers never stall
+    Block   // wait until the writer has made room
 };
 
 // Logger class - singleton
+//
+// Synchronous by default: log() formats and writes on the calling thread.
+// In asynchronous mode log() only timestamps the message and pushes it into
+// a bounded lock-free queue; a writer thread formats the records and writes
+// and flushes the files and console once per batch.
+//
+// Log files rotate daily and whenever one grows past the maximum file size;
+// a day's further segments are numbered (observatory-monitor_<date>.1.log,
+// ..._debug.2.log). Bytes written are counted as they are written, and the
+// directory is only scanned to delete the oldest files once the running
+// total passes maxTotalSizeMB. With compression on, a background thread
+// compresses each closed segment (see LogCompression.h) and retention counts
+// the compressed size.
 class Logger {
 public:
     // Get singleton instance
@@ -35,12 +59,40 @@ public:
                    bool enableConsole = true,
                    int maxTotalSizeMB = 100);
     
-    // Shutdown logger (flush and close files)
+    // Shutdown logger (drain the queue, flush and close files)
     void shutdown();
+
+    // Selects asynchronous mode for the next initialize(). queueCapacity is
+    // rounded up to a power of two.
+    void setAsync(bool enabled,
+                  LogOverflowPolicy policy = LogOverflowPolicy::Drop,
+                  int queueCapacity = 8192);
+    bool isAsync() const { return m_async.load(std::memory_order_relaxed); }
+
+    // Size at which a log file is closed and the next segment started, for
+    // the next initialize(). 0 uses a tenth of maxTotalSizeMB.
+    void setMaxFileSize(int maxFileSizeMB);
+    // Compress closed segments in the background, from the next
+    // initialize() on. Off by default.
+    void setCompression(bool enabled);
+    // Records discarded by the Drop policy since initialize()
+    quint64 droppedCount() const { return m_dropped.load(std::memory_order_relaxed); }
+
+    // Returns once everything logged before the call has been written
+    void flush();
     
     // Log a message
     void log(LogLevel level, const QString& message);
     void log(LogLevel level, const QString& category, const QString& message);
+    // Prefer the OM_* macros below, which skip building the message when
+    // the record would be filtered
+    void log(LogLevel level, const LogCategory& category, const QString& message);
+    // Structured form behind the OM_*F macros: format is a string literal
+    // with %1..%n placeholders, and the arguments stay typed until the
+    // writer renders them or stores them in the binary debug log
+    template <typename... Args>
+    void logf(LogLevel level, const LogCategory& category, const QString& controller,
+              const char* format, const Args&... args);
     
     // Convenience methods
     void debug(const QString& message);
@@ -51,7 +103,16 @@ public:
     
     // Enable/disable debug logging at runtime
     void setDebugEnabled(bool enabled);
-    bool isDebugEnabled() const { return m_debugEnabled; }
+    bool isDebugEnabled() const { return m_debugEnabled.load(std::memory_order_relaxed); }
+    
+    // Lowest level a category passes; also applies to categories created
+    // later. Categories start at Debug.
+    void setCategoryLevel(const QString& category, LogLevel minimum);
+    
+    // Writes the debug log as a structured binary file (.omlog, decoded by
+    // observatory-logdump) instead of text. Takes effect when the log files
+    // are next opened.
+    void setBinaryDebugLog(bool enabled);
     
     // Get current log file paths
     QString userLogPath() const;
@@ -68,32 +129,201 @@ private:
     Logger(const Logger&) = delete;
     Logger& operator=(const Logger&) = delete;
     
+    friend class LogCategory;
+    void registerCategory(LogCategory* category);
+    void unregisterCategory(LogCategory* category);
+    
+    struct LogRecord {
+        qint64 timestampMs = 0;
+        qint64 steadyNs = 0;                // monotonic, for the binary log
+        LogLevel level = LogLevel::Info;
+        const char* category = nullptr;     // a LogCategory name; static storage
+        QString controller;
+        const char* format = nullptr;       // structured records only
+        LogArgs args;
+        QString message;                    // unstructured records only
+    };
+    
+    void submit(LogRecord&& record);
+    void submit(LogLevel level, const char* category, const QString& message);
+
+    enum class LogFile { User, Debug };
+    
     // Helper methods
+    // Opens the latest segment of each file for the current date
     bool openLogFiles();
     void closeLogFiles();
-    void rotateLogsIfNeeded();
+    bool openLogFile(LogFile file);
+    void closeLogFile(LogFile file);
+    QString logFilePath(LogFile file, int segment) const;
+    int lastSegment(LogFile file) const;
+    void rotateLogsIfNeeded(const QDate& date);
+    void startNextSegment(LogFile file);
+    // Bytes in the open files, and their absolute paths
+    qint64 openLogBytes() const;
+    QStringList openLogFileNames() const;
+    // After each batch: rotates oversized files and enforces the total
+    void checkLogLimits();
     void enforceMaxTotalSize();
-    QString formatMessage(LogLevel level, const QString& message);
-    QString levelToString(LogLevel level);
-    QList<QString> getLogFiles(const QString& pattern);
-    qint64 getTotalLogSize();
+    // Writes and flushes a batch; m_mutex must be held
+    void writeRecords(const LogRecord* records, qsizetype count);
+    void enqueue(LogRecord&& record);
+    void wakeWriter();
+    void writerLoop();
+    void stopWriter();
+    QFileInfoList getLogFiles() const;
+    void queueCompression(const QString& path);
+    void compressorLoop();
+    void stopCompressor();
+    void compressLogFile(const QString& path);
     
     // Member variables
     QString m_logDir;
-    bool m_debugEnabled;
+    std::atomic<bool> m_debugEnabled;
     bool m_consoleEnabled;
     int m_maxTotalSizeMB;
+    int m_maxFileSizeMB = 0;
+    qint64 m_maxFileBytes = 0;
     
     QFile m_userLogFile;
     QFile m_debugLogFile;
     QTextStream m_userLogStream;
     QTextStream m_debugLogStream;
+    BinaryLogWriter m_binaryDebugLog;
+    bool m_binaryDebug = false;
     
     QDate m_currentDate;
-    QMutex m_mutex;
-    bool m_initialized;
+    int m_userSegment = 0;
+    int m_debugSegment = 0;
+    // Bytes in closed log files; the total is this plus openLogBytes()
+    qint64 m_closedBytes = 0;
+    // Nothing left to delete until another file is closed
+    bool m_retentionExhausted = false;
+    QMutex m_mutex;             // guards the files and streams
+    std::atomic<bool> m_initialized;
+
+    // Asynchronous mode
+    bool m_asyncRequested = false;
+    LogOverflowPolicy m_overflowPolicy = LogOverflowPolicy::Drop;
+    int m_queueCapacity = 8192;
+    std::unique_ptr<MpscRing<LogRecord>> m_queue;
+    std::unique_ptr<std::thread> m_writer;
+    std::mutex m_wakeMutex;
+    std::condition_variable m_wake;         // records queued, or stopping
+    std::condition_variable m_drained;      // a batch was written
+    std::atomic<bool> m_async{false};
+    std::atomic<bool> m_writerIdle{false};
+    std::atomic<bool> m_stopping{false};
+    std::atomic<quint64> m_written{0};
+    std::atomic<quint64> m_dropped{0};
+    
+    // Compression of closed segments
+    bool m_compressionRequested = false;
+    std::unique_ptr<std::thread> m_compressor;
+    std::mutex m_compressMutex;
+    std::condition_variable m_compressWake;
+    std::deque<QString> m_compressQueue;    // guarded by m_compressMutex
+    bool m_compressStopping = false;        // guarded by m_compressMutex
+    
+    // Guarded by m_mutex
+    QList<LogCategory*> m_categories;
+    QHash<QString, LogLevel> m_categoryLevels;
 };
 
+// A named source of log records, e.g. "MQTT". Declared once per module with
+// static storage duration:
+//
+//     static LogCategory lcMqtt("MQTT");
+//     OM_DEBUG(lcMqtt, QString("Received on %1: %2").arg(topic, payload));
+//
+// Checking a category is one relaxed atomic load, so a filtered statement
+// costs a branch and never evaluates its message.
+class LogCategory {
+public:
+    explicit LogCategory(const char* name);
+    ~LogCategory();
+    
+    LogCategory(const LogCategory&) = delete;
+    LogCategory& operator=(const LogCategory&) = delete;
+    
+    const char* name() const { return m_name; }
+    
+    bool isEnabled(LogLevel level) const
+    {
+        if (level < m_minimumLevel.load(std::memory_order_relaxed)) {
+            return false;
+        }
+        return level != LogLevel::Debug || Logger::instance().isDebugEnabled();
+    }
+    
+private:
+    friend class Logger;
+    const char* m_name;
+    std::atomic<LogLevel> m_minimumLevel{LogLevel::Debug};
+};
+
+template <typename... Args>
+void Logger::logf(LogLevel level, const LogCategory& category, const QString& controller,
+                  const char* format, const Args&... args)
+{
+    if (!category.isEnabled(level)) {
+        return;
+    }
+    
+    LogRecord record;
+    record.level = level;
+    record.category = category.name();
+    record.controller = controller;
+    record.format = format;
+    (record.args.append(toLogArg(args)), ...);
+    submit(std::move(record));
+}
+
 } // namespace ObservatoryMonitor
 
+// Lazy logging: the message expression is only evaluated when the category
+// passes the level. Configuring with OBSERVATORY_STRIP_DEBUG_LOGS compiles
+// OM_DEBUG out of release builds; the statement is still type-checked.
+#define OM_LOG(category, level, message) \
+    do { \
+        if ((category).isEnabled(level)) \
+            ::ObservatoryMonitor::Logger::instance().log((level), (category), (message)); \
+    } while (false)
+
+#ifdef OBSERVATORY_STRIP_DEBUG_LOGS
+#define OM_DEBUG(category, message) \
+    do { \
+        if (false) \
+            ::ObservatoryMonitor::Logger::instance().log(::ObservatoryMonitor::LogLevel::Debug, (category), (message)); \
+    } while (false)
+#else
+#define OM_DEBUG(category, message) OM_LOG(category, ::ObservatoryMonitor::LogLevel::Debug, message)
+#endif
+#define OM_INFO(category, message) OM_LOG(category, ::ObservatoryMonitor::LogLevel::Info, message)
+#define OM_WARNING(category, message) OM_LOG(category, ::ObservatoryMonitor::LogLevel::Warning, message)
+#define OM_ERROR(category, message) OM_LOG(category, ::ObservatoryMonitor::LogLevel::Error, message)
+#define OM_CRITICAL(category, message) OM_LOG(category, ::ObservatoryMonitor::LogLevel::Critical, message)
+
+// Structured variants: a controller name (may be empty), a format literal
+// and its arguments, e.g.
+//     OM_DEBUGF(lcMqtt, m_controllerName, "Received on %1: %2", topic, payload);
+#define OM_LOGF(category, level, controller, ...) \
+    do { \
+        if ((category).isEnabled(level)) \
+            ::ObservatoryMonitor::Logger::instance().logf((level), (category), (controller), __VA_ARGS__); \
+    } while (false)
+
+#ifdef OBSERVATORY_STRIP_DEBUG_LOGS
+#define OM_DEBUGF(category, controller, ...) \
+    do { \
+        if (false) \
+            ::ObservatoryMonitor::Logger::instance().logf(::ObservatoryMonitor::LogLevel::Debug, (category), (controller), __VA_ARGS__); \
+    } while (false)
+#else
+#define OM_DEBUGF(category, controller, ...) OM_LOGF(category, ::ObservatoryMonitor::LogLevel::Debug, controller, __VA_ARGS__)
+#endif
+#define OM_INFOF(category, controller, ...) OM_LOGF(category, ::ObservatoryMonitor::LogLevel::Info, controller, __VA_ARGS__)
+#define OM_WARNINGF(category, controller, ...) OM_LOGF(category, ::ObservatoryMonitor::LogLevel::Warning, controller, __VA_ARGS__)
+#define OM_ERRORF(category, controller, ...) OM_LOGF(category, ::ObservatoryMonitor::LogLevel::Error, controller, __VA_ARGS__)
+
 #endif // LOGGER_H
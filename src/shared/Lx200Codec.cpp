@@ -0,0 +1,335 @@
+#include "Lx200Codec.h"
+#include <cmath>
+
+namespace ObservatoryMonitor {
+
+namespace {
+
+constexpr double Pow10[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9,
+    1e10, 1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18
+};
+constexpr int MaxMantissaDigits = 18;
+
+inline uint code(char c) { return uchar(c); }
+inline uint code(QChar c) { return c.unicode(); }
+inline bool isDigit(uint c) { return c >= '0' && c <= '9'; }
+
+// Drop surrounding spaces and one '#' terminator
+template <typename Char>
+void trim(const Char*& begin, const Char*& end)
+{
+    while (begin < end && code(*begin) == ' ') ++begin;
+    while (end > begin && code(end[-1]) == ' ') --end;
+    if (end > begin && code(end[-1]) == '#') --end;
+    while (end > begin && code(end[-1]) == ' ') --end;
+}
+
+// Reads digits[.digits] as one mantissa and scales once, so values with up
+// to 15 significant digits come out exactly as strtod would produce them.
+template <typename Char>
+bool readNumber(const Char*& p, const Char* end, int maxIntDigits, double& value, bool& fractional)
+{
+    quint64 mantissa = 0;
+    int digits = 0;
+    int intDigits = 0;
+    while (p < end && isDigit(code(*p))) {
+        if (++intDigits > maxIntDigits) return false;
+        mantissa = mantissa * 10 + (code(*p) - '0');
+        ++digits;
+        ++p;
+    }
+    if (intDigits == 0) return false;
+
+    int scale = 0;
+    fractional = p < end && code(*p) == '.';
+    if (fractional) {
+        ++p;
+        int fracDigits = 0;
+        while (p < end && isDigit(code(*p))) {
+            // Digits past what a double can hold are dropped
+            if (digits < MaxMantissaDigits) {
+                mantissa = mantissa * 10 + (code(*p) - '0');
+                ++digits;
+                ++scale;
+            }
+            ++fracDigits;
+            ++p;
+        }
+        if (fracDigits == 0) return false;
+    }
+
+    value = double(mantissa) / Pow10[scale];
+    return true;
+}
+
+// '*', ':', the LX200 degree glyph 0xDF (which a UTF-8 decode turns into
+// U+FFFD) or a degree sign, as one Latin-1/UTF-16 unit or the UTF-8 pair
+template <typename Char>
+bool skipDegreeSeparator(const Char*& p, const Char* end)
+{
+    if (p >= end) return false;
+    uint c = code(*p);
+    if (c == '*' || c == ':' || c == 0xDF || c == 0xB0 || c == 0xFFFD) {
+        ++p;
+        return true;
+    }
+    if (c == 0xC2 && p + 1 < end && code(p[1]) == 0xB0) {
+        p += 2;
+        return true;
+    }
+    return false;
+}
+
+// [sign] A [sep B[.b] [sep C[.c]]] or [sign] A.a, in units of A
+template <typename Char>
+bool parseSexagesimal(const Char* p, const Char* end, bool allowNegative, double& value)
+{
+    trim(p, end);
+
+    bool negative = false;
+    if (p < end && (code(*p) == '+' || code(*p) == '-')) {
+        negative = code(*p) == '-';
+        if (negative && !allowNegative) return false;
+        ++p;
+    }
+
+    double result = 0.0;
+    bool fractional = false;
+    if (!readNumber(p, end, 15, result, fractional)) return false;
+
+    if (p < end) {
+        if (fractional || !skipDegreeSeparator(p, end)) return false;
+
+        double minutes = 0.0;
+        if (!readNumber(p, end, 2, minutes, fractional) || minutes >= 60.0) return false;
+
+        double seconds = 0.0;
+        if (p < end && !fractional) {
+            uint separator = code(*p);
+            if (separator != ':' && separator != '\'') return false;
+            ++p;
+            if (!readNumber(p, end, 2, seconds, fractional) || seconds >= 60.0) return false;
+            if (p < end && code(*p) == '"') ++p;
+        } else if (p < end && code(*p) == '\'') {
+            ++p;   // sDD*MM.m'
+        }
+        if (p != end) return false;
+
+        result += (minutes + seconds / 60.0) / 60.0;
+    }
+
+    value = negative ? -result : result;
+    return true;
+}
+
+template <typename Char>
+bool parseHoursImpl(const Char* begin, const Char* end, double& hours)
+{
+    double value = 0.0;
+    if (!parseSexagesimal(begin, end, false, value) || value >= 24.0) return false;
+    hours = value;
+    return true;
+}
+
+template <typename Char>
+bool parseDegreesImpl(const Char* begin, const Char* end, double& degrees)
+{
+    double value = 0.0;
+    if (!parseSexagesimal(begin, end, true, value) || std::abs(value) > 360.0) return false;
+    degrees = value;
+    return true;
+}
+
+template <typename Char>
+bool parseDecimalImpl(const Char* p, const Char* end, double& value)
+{
+    trim(p, end);
+
+    bool negative = false;
+    if (p < end && (code(*p) == '+' || code(*p) == '-')) {
+        negative = code(*p) == '-';
+        ++p;
+    }
+
+    double result = 0.0;
+    bool fractional = false;
+    if (!readNumber(p, end, 15, result, fractional) || p != end) return false;
+
+    value = negative ? -result : result;
+    return true;
+}
+
+// Zero-padded to width
+char* putDigits(char* out, quint64 value, int width)
+{
+    for (int i = width - 1; i >= 0; --i) {
+        out[i] = char('0' + value % 10);
+        value /= 10;
+    }
+    return out + width;
+}
+
+// Writes "A<sep>MM[:SS[.f]]" or "A<sep>MM.m" from a whole number of the
+// smallest unit shown. fractionDigits applies to seconds, or to minutes
+// when withSeconds is false.
+char* putSexagesimal(char* out, quint64 total, int firstWidth, char separator,
+                     bool withSeconds, int fractionDigits)
+{
+    quint64 fraction = 0;
+    quint64 unit = static_cast<quint64>(Pow10[fractionDigits]);
+    fraction = total % unit;
+    total /= unit;
+
+    quint64 seconds = 0;
+    if (withSeconds) {
+        seconds = total % 60;
+        total /= 60;
+    }
+    quint64 minutes = total % 60;
+    quint64 first = total / 60;
+
+    out = putDigits(out, first, firstWidth);
+    *out++ = separator;
+    out = putDigits(out, minutes, 2);
+    if (withSeconds) {
+        *out++ = ':';
+        out = putDigits(out, seconds, 2);
+    }
+    if (fractionDigits > 0) {
+        *out++ = '.';
+        out = putDigits(out, fraction, fractionDigits);
+    }
+    return out;
+}
+
+// Smallest unit per whole hour/degree, and its shape
+struct Resolution {
+    quint64 perWhole;
+    bool withSeconds;
+    int fractionDigits;
+};
+
+Resolution hoursResolution(Lx200Codec::Precision precision)
+{
+    switch (precision) {
+        case Lx200Codec::Precision::Low:  return {600, false, 1};           // tenths of a minute
+        case Lx200Codec::Precision::High: return {36000000, true, 4};       // 1e-4 s
+        default:                          return {3600, true, 0};
+    }
+}
+
+Resolution degreesResolution(Lx200Codec::Precision precision)
+{
+    switch (precision) {
+        case Lx200Codec::Precision::Low:  return {60, false, 0};            // whole minutes
+        case Lx200Codec::Precision::High: return {3600000, true, 3};        // 1e-3 arcsec
+        default:                          return {3600, true, 0};
+    }
+}
+
+int finish(char* buffer, char* out)
+{
+    *out = '\0';
+    return static_cast<int>(out - buffer);
+}
+
+} // namespace
+
+namespace Lx200Codec {
+
+bool parseHours(QByteArrayView text, double& hours)
+{
+    return parseHoursImpl(text.data(), text.data() + text.size(), hours);
+}
+
+bool parseHours(QStringView text, double& hours)
+{
+    return parseHoursImpl(text.data(), text.data() + text.size(), hours);
+}
+
+bool parseDegrees(QByteArrayView text, double& degrees)
+{
+    return parseDegreesImpl(text.data(), text.data() + text.size(), degrees);
+}
+
+bool parseDegrees(QStringView text, double& degrees)
+{
+    return parseDegreesImpl(text.data(), text.data() + text.size(), degrees);
+}
+
+bool parseDecimal(QByteArrayView text, double& value)
+{
+    return parseDecimalImpl(text.data(), text.data() + text.size(), value);
+}
+
+bool parseDecimal(QStringView text, double& value)
+{
+    return parseDecimalImpl(text.data(), text.data() + text.size(), value);
+}
+
+int formatHours(double hours, Precision precision, char* buffer)
+{
+    Resolution res = hoursResolution(precision);
+    quint64 day = 24 * res.perWhole;
+
+    double wrapped = std::isfinite(hours) ? std::fmod(hours, 24.0) : 0.0;
+    if (wrapped < 0.0) wrapped += 24.0;
+    // Rounding can carry into the next day
+    quint64 total = static_cast<quint64>(std::llround(wrapped * res.perWhole)) % day;
+
+    return finish(buffer, putSexagesimal(buffer, total, 2, ':', res.withSeconds, res.fractionDigits));
+}
+
+int formatSignedDegrees(double degrees, Precision precision, char* buffer)
+{
+    Resolution res = degreesResolution(precision);
+
+    double clamped = std::isfinite(degrees) ? std::fmax(-90.0, std::fmin(90.0, degrees)) : 0.0;
+    quint64 total = static_cast<quint64>(std::llround(std::abs(clamped) * res.perWhole));
+
+    char* out = buffer;
+    *out++ = clamped < 0.0 && total > 0 ? '-' : '+';
+    return finish(buffer, putSexagesimal(out, total, 2, '*', res.withSeconds, res.fractionDigits));
+}
+
+int formatAzimuth(double degrees, Precision precision, char* buffer)
+{
+    Resolution res = degreesResolution(precision);
+    quint64 circle = 360 * res.perWhole;
+
+    double wrapped = std::isfinite(degrees) ? std::fmod(degrees, 360.0) : 0.0;
+    if (wrapped < 0.0) wrapped += 360.0;
+    quint64 total = static_cast<quint64>(std::llround(wrapped * res.perWhole)) % circle;
+
+    return finish(buffer, putSexagesimal(buffer, total, 3, '*', res.withSeconds, res.fractionDigits));
+}
+
+int formatDecimal(double value, int decimals, char* buffer)
+{
+    decimals = decimals < 0 ? 0 : (decimals > 9 ? 9 : decimals);
+
+    // Controller values are small; keep the scaled value inside 64 bits
+    double limit = 1e9;
+    double clamped = std::isfinite(value) ? std::fmax(-limit, std::fmin(limit, value)) : 0.0;
+
+    quint64 unit = static_cast<quint64>(Pow10[decimals]);
+    quint64 total = static_cast<quint64>(std::llround(std::abs(clamped) * Pow10[decimals]));
+    quint64 whole = total / unit;
+
+    char* out = buffer;
+    if (clamped < 0.0 && total > 0) *out++ = '-';
+
+    int width = 1;
+    for (quint64 v = whole; v >= 10; v /= 10) ++width;
+    out = putDigits(out, whole, width);
+    if (decimals > 0) {
+        *out++ = '.';
+        out = putDigits(out, total % unit, decimals);
+    }
+    return finish(buffer, out);
+}
+
+} // namespace Lx200Codec
+
+} // namespace ObservatoryMonitor
@@ -0,0 +1,56 @@
+#ifndef LX200CODEC_H
+#define LX200CODEC_H
+
+#include <QByteArrayView>
+#include <QStringView>
+
+namespace ObservatoryMonitor {
+
+// Parsers and formatters for the coordinate formats OnStepX (and the OCS
+// bridge) put on the wire. Everything works on views and caller-provided
+// buffers; nothing allocates.
+//
+// Accepted on input, with an optional trailing '#' and surrounding spaces:
+//   decimal          sDDD.ddddd          (:DZ#, OCS)
+//   low precision    HH:MM.T   sDD*MM    (:U toggled off)
+//   standard         HH:MM:SS  sDD*MM:SS / sDD*MM'SS
+//   high precision   HH:MM:SS.SSSS  sDD*MM:SS.SSS
+// The degree separator may be '*', ':', the LX200 glyph 0xDF, or a real
+// degree sign (Latin-1, UTF-8 or UTF-16).
+namespace Lx200Codec {
+    enum class Precision {
+        Low,        // HH:MM.T      sDD*MM
+        Standard,   // HH:MM:SS     sDD*MM:SS
+        High        // HH:MM:SS.SSSS sDD*MM:SS.SSS
+    };
+
+    // Large enough for any formatted value including the terminating NUL
+    constexpr int MaxFormattedLength = 24;
+
+    // Right ascension and hour angles, in hours [0, 24)
+    bool parseHours(QByteArrayView text, double& hours);
+    bool parseHours(QStringView text, double& hours);
+
+    // Declination, altitude, azimuth, in degrees [-360, 360]
+    bool parseDegrees(QByteArrayView text, double& degrees);
+    bool parseDegrees(QStringView text, double& degrees);
+
+    // Plain signed decimal without exponent
+    bool parseDecimal(QByteArrayView text, double& value);
+    bool parseDecimal(QStringView text, double& value);
+
+    // Each formatter writes a NUL-terminated string (no '#') to buffer, which
+    // must hold MaxFormattedLength bytes, and returns its length.
+    // Hours wrap into [0, 24).
+    int formatHours(double hours, Precision precision, char* buffer);
+    // sDD*MM:SS, clamped to [-90, 90] (declination, altitude)
+    int formatSignedDegrees(double degrees, Precision precision, char* buffer);
+    // DDD*MM:SS, wrapped into [0, 360) (azimuth)
+    int formatAzimuth(double degrees, Precision precision, char* buffer);
+    // sDDD.ddd with the given number of decimals (0-9)
+    int formatDecimal(double value, int decimals, char* buffer);
+}
+
+} // namespace ObservatoryMonitor
+
+#endif // LX200CODEC_H
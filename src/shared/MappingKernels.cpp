@@ -0,0 +1,322 @@
+#include "MappingKernels.h"
+#include <atomic>
+#include <cmath>
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define OBSERVATORY_KERNELS_AVX2 1
+#define OBSERVATORY_TARGET_AVX2 __attribute__((target("avx2")))
+#include <immintrin.h>
+#endif
+
+namespace ObservatoryMonitor {
+namespace MappingKernels {
+
+namespace {
+
+// The scalar loop bodies, kept branch-free (selects only) so the compiler
+// can vectorize them for the baseline target where it is able to.
+
+template <typename T>
+Q_ALWAYS_INLINE void linearLoop(const T* in, T* out, qsizetype n, T slope, T offset)
+{
+    for (qsizetype i = 0; i < n; ++i) {
+        out[i] = in[i] * slope + offset;
+    }
+}
+
+template <typename T>
+Q_ALWAYS_INLINE void clampLoop(const T* in, T* out, qsizetype n, T lower, T upper)
+{
+    for (qsizetype i = 0; i < n; ++i) {
+        T v = in[i] < lower ? lower : in[i];
+        out[i] = v > upper ? upper : v;
+    }
+}
+
+template <typename T>
+Q_ALWAYS_INLINE void wrapLoop(const T* in, T* out, qsizetype n, T origin, T period)
+{
+    const T end = origin + period;
+    for (qsizetype i = 0; i < n; ++i) {
+        T v = in[i] - std::floor((in[i] - origin) / period) * period;
+        // Rounding can land exactly on either edge; the range is half-open
+        v = v < origin ? origin : v;
+        out[i] = v >= end ? origin : v;
+    }
+}
+
+template <typename T>
+Q_ALWAYS_INLINE void lookupLoop(const T* in, T* out, qsizetype n,
+                                const T* table, qsizetype tableSize, T inMin, T step)
+{
+    const T last = T(tableSize - 1);
+    const int lastSegment = int(tableSize - 2);
+    for (qsizetype i = 0; i < n; ++i) {
+        T pos = (in[i] - inMin) / step;
+        // Written so NaN fails the first test and lands on the first entry
+        pos = pos > T(0) ? pos : T(0);
+        pos = pos < last ? pos : last;
+        int j = int(pos);
+        j = j < lastSegment ? j : lastSegment;
+        T frac = pos - T(j);
+        out[i] = table[j] + (table[j + 1] - table[j]) * frac;
+    }
+}
+
+template <typename T>
+struct KernelSet {
+    void (*linear)(const T*, T*, qsizetype, T, T);
+    void (*clamp)(const T*, T*, qsizetype, T, T);
+    void (*wrap)(const T*, T*, qsizetype, T, T);
+    void (*lookup)(const T*, T*, qsizetype, const T*, qsizetype, T, T);
+};
+
+template <typename T>
+void linearGeneric(const T* in, T* out, qsizetype n, T a, T b) { linearLoop(in, out, n, a, b); }
+template <typename T>
+void clampGeneric(const T* in, T* out, qsizetype n, T a, T b) { clampLoop(in, out, n, a, b); }
+template <typename T>
+void wrapGeneric(const T* in, T* out, qsizetype n, T a, T b) { wrapLoop(in, out, n, a, b); }
+template <typename T>
+void lookupGeneric(const T* in, T* out, qsizetype n, const T* table, qsizetype size, T a, T b)
+{
+    lookupLoop(in, out, n, table, size, a, b);
+}
+
+template <typename T>
+constexpr KernelSet<T> GenericKernels = {
+    &linearGeneric<T>, &clampGeneric<T>, &wrapGeneric<T>, &lookupGeneric<T>
+};
+
+#ifdef OBSERVATORY_KERNELS_AVX2
+// Hand-written AVX2 versions: GCC won't vectorize floor() or the table
+// gather without -fno-trapping-math, and we don't want to depend on the
+// build type for this. Each op mirrors the scalar loop exactly (max/min
+// operand order included, so NaN behaves the same); the tail goes through
+// the scalar loop.
+
+OBSERVATORY_TARGET_AVX2 void linearAvx2(const double* in, double* out, qsizetype n, double slope, double offset)
+{
+    const __m256d s = _mm256_set1_pd(slope);
+    const __m256d o = _mm256_set1_pd(offset);
+    qsizetype i = 0;
+    for (; i + 4 <= n; i += 4) {
+        _mm256_storeu_pd(out + i, _mm256_add_pd(_mm256_mul_pd(_mm256_loadu_pd(in + i), s), o));
+    }
+    linearLoop(in + i, out + i, n - i, slope, offset);
+}
+
+OBSERVATORY_TARGET_AVX2 void linearAvx2(const float* in, float* out, qsizetype n, float slope, float offset)
+{
+    const __m256 s = _mm256_set1_ps(slope);
+    const __m256 o = _mm256_set1_ps(offset);
+    qsizetype i = 0;
+    for (; i + 8 <= n; i += 8) {
+        _mm256_storeu_ps(out + i, _mm256_add_ps(_mm256_mul_ps(_mm256_loadu_ps(in + i), s), o));
+    }
+    linearLoop(in + i, out + i, n - i, slope, offset);
+}
+
+OBSERVATORY_TARGET_AVX2 void clampAvx2(const double* in, double* out, qsizetype n, double lower, double upper)
+{
+    const __m256d lo = _mm256_set1_pd(lower);
+    const __m256d hi = _mm256_set1_pd(upper);
+    qsizetype i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256d v = _mm256_max_pd(lo, _mm256_loadu_pd(in + i));
+        _mm256_storeu_pd(out + i, _mm256_min_pd(hi, v));
+    }
+    clampLoop(in + i, out + i, n - i, lower, upper);
+}
+
+OBSERVATORY_TARGET_AVX2 void clampAvx2(const float* in, float* out, qsizetype n, float lower, float upper)
+{
+    const __m256 lo = _mm256_set1_ps(lower);
+    const __m256 hi = _mm256_set1_ps(upper);
+    qsizetype i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256 v = _mm256_max_ps(lo, _mm256_loadu_ps(in + i));
+        _mm256_storeu_ps(out + i, _mm256_min_ps(hi, v));
+    }
+    clampLoop(in + i, out + i, n - i, lower, upper);
+}
+
+OBSERVATORY_TARGET_AVX2 void wrapAvx2(const double* in, double* out, qsizetype n, double origin, double period)
+{
+    const __m256d o = _mm256_set1_pd(origin);
+    const __m256d p = _mm256_set1_pd(period);
+    const __m256d e = _mm256_set1_pd(origin + period);
+    qsizetype i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256d x = _mm256_loadu_pd(in + i);
+        __m256d k = _mm256_floor_pd(_mm256_div_pd(_mm256_sub_pd(x, o), p));
+        __m256d v = _mm256_max_pd(o, _mm256_sub_pd(x, _mm256_mul_pd(k, p)));
+        v = _mm256_blendv_pd(v, o, _mm256_cmp_pd(v, e, _CMP_GE_OQ));
+        _mm256_storeu_pd(out + i, v);
+    }
+    wrapLoop(in + i, out + i, n - i, origin, period);
+}
+
+OBSERVATORY_TARGET_AVX2 void wrapAvx2(const float* in, float* out, qsizetype n, float origin, float period)
+{
+    const __m256 o = _mm256_set1_ps(origin);
+    const __m256 p = _mm256_set1_ps(period);
+    const __m256 e = _mm256_set1_ps(origin + period);
+    qsizetype i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256 x = _mm256_loadu_ps(in + i);
+        __m256 k = _mm256_floor_ps(_mm256_div_ps(_mm256_sub_ps(x, o), p));
+        __m256 v = _mm256_max_ps(o, _mm256_sub_ps(x, _mm256_mul_ps(k, p)));
+        v = _mm256_blendv_ps(v, o, _mm256_cmp_ps(v, e, _CMP_GE_OQ));
+        _mm256_storeu_ps(out + i, v);
+    }
+    wrapLoop(in + i, out + i, n - i, origin, period);
+}
+
+OBSERVATORY_TARGET_AVX2 void lookupAvx2(const double* in, double* out, qsizetype n,
+                                        const double* table, qsizetype tableSize, double inMin, double step)
+{
+    const __m256d m = _mm256_set1_pd(inMin);
+    const __m256d s = _mm256_set1_pd(step);
+    const __m256d zero = _mm256_setzero_pd();
+    const __m256d last = _mm256_set1_pd(double(tableSize - 1));
+    const __m128i lastSegment = _mm_set1_epi32(int(tableSize - 2));
+    const __m256d all = _mm256_castsi256_pd(_mm256_set1_epi64x(-1));
+    qsizetype i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256d pos = _mm256_div_pd(_mm256_sub_pd(_mm256_loadu_pd(in + i), m), s);
+        pos = _mm256_min_pd(_mm256_max_pd(pos, zero), last);
+        __m128i j = _mm_min_epi32(_mm256_cvttpd_epi32(pos), lastSegment);
+        __m256d frac = _mm256_sub_pd(pos, _mm256_cvtepi32_pd(j));
+        __m256d y0 = _mm256_mask_i32gather_pd(zero, table, j, all, sizeof(double));
+        __m256d y1 = _mm256_mask_i32gather_pd(zero, table + 1, j, all, sizeof(double));
+        _mm256_storeu_pd(out + i, _mm256_add_pd(y0, _mm256_mul_pd(_mm256_sub_pd(y1, y0), frac)));
+    }
+    lookupLoop(in + i, out + i, n - i, table, tableSize, inMin, step);
+}
+
+OBSERVATORY_TARGET_AVX2 void lookupAvx2(const float* in, float* out, qsizetype n,
+                                        const float* table, qsizetype tableSize, float inMin, float step)
+{
+    const __m256 m = _mm256_set1_ps(inMin);
+    const __m256 s = _mm256_set1_ps(step);
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 last = _mm256_set1_ps(float(tableSize - 1));
+    const __m256i lastSegment = _mm256_set1_epi32(int(tableSize - 2));
+    const __m256 all = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+    qsizetype i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256 pos = _mm256_div_ps(_mm256_sub_ps(_mm256_loadu_ps(in + i), m), s);
+        pos = _mm256_min_ps(_mm256_max_ps(pos, zero), last);
+        __m256i j = _mm256_min_epi32(_mm256_cvttps_epi32(pos), lastSegment);
+        __m256 frac = _mm256_sub_ps(pos, _mm256_cvtepi32_ps(j));
+        __m256 y0 = _mm256_mask_i32gather_ps(zero, table, j, all, sizeof(float));
+        __m256 y1 = _mm256_mask_i32gather_ps(zero, table + 1, j, all, sizeof(float));
+        _mm256_storeu_ps(out + i, _mm256_add_ps(y0, _mm256_mul_ps(_mm256_sub_ps(y1, y0), frac)));
+    }
+    lookupLoop(in + i, out + i, n - i, table, tableSize, inMin, step);
+}
+
+template <typename T>
+constexpr KernelSet<T> Avx2Kernels = {
+    &linearAvx2, &clampAvx2, &wrapAvx2, &lookupAvx2
+};
+#endif
+
+Isa detectIsa()
+{
+#ifdef OBSERVATORY_KERNELS_AVX2
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return Isa::Avx2;
+    }
+#endif
+    return Isa::Generic;
+}
+
+std::atomic<Isa> s_activeIsa{bestIsa()};
+
+template <typename T>
+const KernelSet<T>& kernels()
+{
+#ifdef OBSERVATORY_KERNELS_AVX2
+    if (s_activeIsa.load(std::memory_order_relaxed) == Isa::Avx2) {
+        return Avx2Kernels<T>;
+    }
+#endif
+    return GenericKernels<T>;
+}
+
+} // namespace
+
+Isa bestIsa()
+{
+    static const Isa best = detectIsa();
+    return best;
+}
+
+Isa activeIsa()
+{
+    return s_activeIsa.load(std::memory_order_relaxed);
+}
+
+void setActiveIsa(Isa isa)
+{
+    s_activeIsa.store(isa > bestIsa() ? bestIsa() : isa, std::memory_order_relaxed);
+}
+
+const char* isaName(Isa isa)
+{
+    switch (isa) {
+        case Isa::Avx2: return "AVX2";
+        case Isa::Generic: break;
+    }
+    return "generic";
+}
+
+void linear(const double* in, double* out, qsizetype n, double slope, double offset)
+{
+    kernels<double>().linear(in, out, n, slope, offset);
+}
+
+void linear(const float* in, float* out, qsizetype n, float slope, float offset)
+{
+    kernels<float>().linear(in, out, n, slope, offset);
+}
+
+void clamp(const double* in, double* out, qsizetype n, double lower, double upper)
+{
+    kernels<double>().clamp(in, out, n, lower, upper);
+}
+
+void clamp(const float* in, float* out, qsizetype n, float lower, float upper)
+{
+    kernels<float>().clamp(in, out, n, lower, upper);
+}
+
+void wrap(const double* in, double* out, qsizetype n, double origin, double period)
+{
+    kernels<double>().wrap(in, out, n, origin, period);
+}
+
+void wrap(const float* in, float* out, qsizetype n, float origin, float period)
+{
+    kernels<float>().wrap(in, out, n, origin, period);
+}
+
+void lookup(const double* in, double* out, qsizetype n,
+            const double* table, qsizetype tableSize, double inMin, double step)
+{
+    Q_ASSERT(tableSize >= 2);
+    kernels<double>().lookup(in, out, n, table, tableSize, inMin, step);
+}
+
+void lookup(const float* in, float* out, qsizetype n,
+            const float* table, qsizetype tableSize, float inMin, float step)
+{
+    Q_ASSERT(tableSize >= 2);
+    kernels<float>().lookup(in, out, n, table, tableSize, inMin, step);
+}
+
+} // namespace MappingKernels
+} // namespace ObservatoryMonitor
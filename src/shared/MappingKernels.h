@@ -0,0 +1,53 @@
+#ifndef MAPPINGKERNELS_H
+#define MAPPINGKERNELS_H
+
+#include <QtGlobal>
+
+namespace ObservatoryMonitor {
+
+// Batch kernels behind ValueMappingEngine's span API, for mapping whole
+// telemetry columns (trend charts) rather than one QVariant at a time.
+//
+// Every kernel maps n samples from in to out; in and out may be the same
+// buffer. The loops are written to auto-vectorize; on x86 with GCC or Clang
+// each one is additionally compiled for AVX2 and the widest set the CPU
+// supports is picked once at runtime. Both builds give bit-identical results
+// (no FMA contraction), so the choice is purely a speed one.
+namespace MappingKernels {
+    enum class Isa {
+        Generic,    // baseline build (SSE2 on x86-64, NEON on arm64)
+        Avx2
+    };
+
+    // Widest instruction set this CPU and build can use
+    Isa bestIsa();
+    // What the kernels currently dispatch to
+    Isa activeIsa();
+    // For tests and benchmarks; requests beyond bestIsa() are lowered to it
+    void setActiveIsa(Isa isa);
+    const char* isaName(Isa isa);
+
+    // out = in * slope + offset
+    void linear(const double* in, double* out, qsizetype n, double slope, double offset);
+    void linear(const float* in, float* out, qsizetype n, float slope, float offset);
+
+    // out = min(max(in, lower), upper)
+    void clamp(const double* in, double* out, qsizetype n, double lower, double upper);
+    void clamp(const float* in, float* out, qsizetype n, float lower, float upper);
+
+    // Wraps into [origin, origin + period), e.g. azimuth into [0, 360)
+    void wrap(const double* in, double* out, qsizetype n, double origin, double period);
+    void wrap(const float* in, float* out, qsizetype n, float origin, float period);
+
+    // Piecewise-linear lookup on a uniform grid: table[i] is the output at
+    // inMin + i * step. Inputs outside the grid (and NaN) take the nearest
+    // end value. table needs at least two entries.
+    void lookup(const double* in, double* out, qsizetype n,
+                const double* table, qsizetype tableSize, double inMin, double step);
+    void lookup(const float* in, float* out, qsizetype n,
+                const float* table, qsizetype tableSize, float inMin, float step);
+}
+
+} // namespace ObservatoryMonitor
+
+#endif // MAPPINGKERNELS_H
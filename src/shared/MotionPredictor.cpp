@@ -0,0 +1,175 @@
+#include "MotionPredictor.h"
+#include <cmath>
+#include <algorithm>
+
+namespace ObservatoryMonitor {
+
+MotionPredictor::MotionPredictor(QObject* parent)
+    : QObject(parent)
+    , m_wrapPeriod(0.0)
+    , m_alpha(0.6)                 // alpha/beta near critical damping for 1 Hz polls
+    , m_beta(0.2)
+    , m_settleThreshold(0.001)
+    , m_maxExtrapolationMs(1500)   // stop extrapolating if polls dry up
+    , m_initialized(false)
+    , m_estimate(0.0)
+    , m_velocity(0.0)
+    , m_lastMeasurement(0.0)
+    , m_lastSampleTime(0)
+    , m_value(0.0)
+    , m_moving(false)
+{
+    m_clock.start();
+}
+
+void MotionPredictor::setWrapPeriod(double period)
+{
+    if (m_wrapPeriod != period) {
+        m_wrapPeriod = std::max(0.0, period);
+        emit parametersChanged();
+    }
+}
+
+void MotionPredictor::setAlpha(double alpha)
+{
+    if (m_alpha != alpha) {
+        m_alpha = std::clamp(alpha, 0.0, 1.0);
+        emit parametersChanged();
+    }
+}
+
+void MotionPredictor::setBeta(double beta)
+{
+    if (m_beta != beta) {
+        m_beta = std::clamp(beta, 0.0, 2.0);
+        emit parametersChanged();
+    }
+}
+
+void MotionPredictor::setSettleThreshold(double threshold)
+{
+    if (m_settleThreshold != threshold) {
+        m_settleThreshold = std::max(0.0, threshold);
+        emit parametersChanged();
+    }
+}
+
+void MotionPredictor::setMaxExtrapolationMs(int ms)
+{
+    if (m_maxExtrapolationMs != ms) {
+        m_maxExtrapolationMs = std::max(0, ms);
+        emit parametersChanged();
+    }
+}
+
+void MotionPredictor::addSample(double measurement)
+{
+    addSample(measurement, m_clock.elapsed());
+}
+
+void MotionPredictor::advance()
+{
+    advanceTo(m_clock.elapsed());
+}
+
+void MotionPredictor::reset()
+{
+    m_initialized = false;
+    m_estimate = 0.0;
+    m_lastMeasurement = 0.0;
+    m_lastSampleTime = 0;
+    setVelocity(0.0);
+    setMoving(false);
+}
+
+void MotionPredictor::addSample(double measurement, qint64 timestampMs)
+{
+    if (!std::isfinite(measurement)) {
+        return;
+    }
+
+    if (!m_initialized) {
+        m_initialized = true;
+        m_estimate = measurement;
+        m_lastMeasurement = measurement;
+        m_lastSampleTime = timestampMs;
+        setVelocity(0.0);
+        advanceTo(timestampMs);
+        return;
+    }
+
+    double step = shortestDelta(measurement - m_lastMeasurement);
+    double dt = (timestampMs - m_lastSampleTime) / 1000.0;
+
+    if (dt <= 0.0) {
+        // Duplicate timestamp: position correction only
+        m_estimate += m_alpha * shortestDelta(measurement - m_estimate);
+    } else {
+        double predicted = m_estimate + m_velocity * dt;
+        double residual = shortestDelta(measurement - predicted);
+
+        if (std::abs(step) <= m_settleThreshold) {
+            // Motion stopped: settle exactly on the measurement
+            m_estimate = predicted + residual;
+            setVelocity(0.0);
+        } else {
+            m_estimate = predicted + m_alpha * residual;
+            setVelocity(m_velocity + m_beta * residual / dt);
+        }
+        m_lastSampleTime = timestampMs;
+    }
+
+    m_lastMeasurement = measurement;
+    setMoving(m_velocity != 0.0);
+    advanceTo(timestampMs);
+}
+
+double MotionPredictor::predictAt(qint64 timestampMs) const
+{
+    if (!m_initialized) {
+        return 0.0;
+    }
+
+    qint64 ahead = std::clamp<qint64>(timestampMs - m_lastSampleTime, 0, m_maxExtrapolationMs);
+    return m_estimate + m_velocity * (ahead / 1000.0);
+}
+
+void MotionPredictor::advanceTo(qint64 timestampMs)
+{
+    double predicted = predictAt(timestampMs);
+    if (predicted != m_value) {
+        m_value = predicted;
+        emit valueChanged();
+    }
+}
+
+double MotionPredictor::shortestDelta(double delta) const
+{
+    if (m_wrapPeriod <= 0.0) {
+        return delta;
+    }
+
+    double half = m_wrapPeriod / 2.0;
+    delta = std::fmod(delta, m_wrapPeriod);
+    if (delta > half) delta -= m_wrapPeriod;
+    else if (delta < -half) delta += m_wrapPeriod;
+    return delta;
+}
+
+void MotionPredictor::setMoving(bool moving)
+{
+    if (m_moving != moving) {
+        m_moving = moving;
+        emit movingChanged();
+    }
+}
+
+void MotionPredictor::setVelocity(double velocity)
+{
+    if (m_velocity != velocity) {
+        m_velocity = velocity;
+        emit velocityChanged();
+    }
+}
+
+} // namespace ObservatoryMonitor
@@ -0,0 +1,97 @@
+#ifndef MOTIONPREDICTOR_H
+#define MOTIONPREDICTOR_H
+
+#include <QObject>
+#include <QElapsedTimer>
+
+namespace ObservatoryMonitor {
+
+// Per-axis alpha-beta (constant velocity) estimator.
+//
+// Polled samples (typically 1 Hz) are fed with addSample(); advance() is called
+// once per rendered frame and extrapolates the estimate to "now" so the 3D
+// scene moves smoothly between polls. With wrapPeriod set (e.g. 360 for
+// azimuth), residuals are taken the short way round and the published value
+// is continuous (it may leave [0, period) rather than jump back across it).
+// When consecutive measurements stop changing the estimate snaps to the
+// measured value and velocity drops to zero.
+class MotionPredictor : public QObject
+{
+    Q_OBJECT
+    Q_PROPERTY(double value READ value NOTIFY valueChanged)
+    Q_PROPERTY(double velocity READ velocity NOTIFY velocityChanged)
+    Q_PROPERTY(bool moving READ isMoving NOTIFY movingChanged)
+    Q_PROPERTY(double wrapPeriod READ wrapPeriod WRITE setWrapPeriod NOTIFY parametersChanged)
+    Q_PROPERTY(double alpha READ alpha WRITE setAlpha NOTIFY parametersChanged)
+    Q_PROPERTY(double beta READ beta WRITE setBeta NOTIFY parametersChanged)
+    Q_PROPERTY(double settleThreshold READ settleThreshold WRITE setSettleThreshold NOTIFY parametersChanged)
+    Q_PROPERTY(int maxExtrapolationMs READ maxExtrapolationMs WRITE setMaxExtrapolationMs NOTIFY parametersChanged)
+
+public:
+    explicit MotionPredictor(QObject* parent = nullptr);
+
+    double value() const { return m_value; }
+    double velocity() const { return m_velocity; }   // units per second
+    bool isMoving() const { return m_moving; }
+
+    double wrapPeriod() const { return m_wrapPeriod; }
+    void setWrapPeriod(double period);
+
+    double alpha() const { return m_alpha; }
+    void setAlpha(double alpha);
+
+    double beta() const { return m_beta; }
+    void setBeta(double beta);
+
+    double settleThreshold() const { return m_settleThreshold; }
+    void setSettleThreshold(double threshold);
+
+    int maxExtrapolationMs() const { return m_maxExtrapolationMs; }
+    void setMaxExtrapolationMs(int ms);
+
+    // Feed a measurement stamped with the internal monotonic clock
+    Q_INVOKABLE void addSample(double measurement);
+    // Re-evaluate the prediction for the current frame
+    Q_INVOKABLE void advance();
+    Q_INVOKABLE void reset();
+
+    // Explicit-time variants (monotonic milliseconds), used by tests
+    void addSample(double measurement, qint64 timestampMs);
+    double predictAt(qint64 timestampMs) const;
+    void advanceTo(qint64 timestampMs);
+
+signals:
+    void valueChanged();
+    void velocityChanged();
+    void movingChanged();
+    void parametersChanged();
+
+private:
+    double shortestDelta(double delta) const;
+    void setMoving(bool moving);
+    void setVelocity(double velocity);
+
+    QElapsedTimer m_clock;
+
+    // Filter parameters
+    double m_wrapPeriod;
+    double m_alpha;
+    double m_beta;
+    double m_settleThreshold;
+    int m_maxExtrapolationMs;
+
+    // Filter state (unwrapped)
+    bool m_initialized;
+    double m_estimate;
+    double m_velocity;
+    double m_lastMeasurement;
+    qint64 m_lastSampleTime;
+
+    // Published per-frame state
+    double m_value;
+    bool m_moving;
+};
+
+} // namespace ObservatoryMonitor
+
+#endif // MOTIONPREDICTOR_H
@@ -0,0 +1,100 @@
+#ifndef MPSCRING_H
+#define MPSCRING_H
+
+#include <QtGlobal>
+#include <atomic>
+#include <memory>
+#include <utility>
+
+namespace ObservatoryMonitor {
+
+// Bounded multi-producer, single-consumer queue.
+//
+// Each cell carries a sequence number (Vyukov's bounded queue): a producer
+// claims the cell at the tail with one CAS, moves its value in and publishes
+// it with a release store of the sequence; the consumer takes cells in order
+// once their sequence says they are filled and hands them back by advancing
+// the sequence one lap. Neither side takes a lock or allocates, and a full
+// ring makes tryPush() fail rather than wait, leaving the overflow policy to
+// the caller.
+//
+// tryPop() and isEmpty() must only be called from the consumer thread.
+template <typename T>
+class MpscRing
+{
+public:
+    // Capacity is rounded up to a power of two
+    explicit MpscRing(qsizetype capacity)
+    {
+        qsizetype size = 2;
+        while (size < capacity) size *= 2;
+        m_mask = quint64(size - 1);
+        m_cells.reset(new Cell[size]);
+        for (qsizetype i = 0; i < size; ++i)
+            m_cells[i].sequence.store(quint64(i), std::memory_order_relaxed);
+    }
+
+    MpscRing(const MpscRing&) = delete;
+    MpscRing& operator=(const MpscRing&) = delete;
+
+    qsizetype capacity() const { return qsizetype(m_mask + 1); }
+
+    // Number of successful pushes so far, counting ones still being written.
+    // Once the consumer has popped this many, all of them have been taken.
+    quint64 pushedCount() const { return m_tail.load(std::memory_order_acquire); }
+
+    // value is only moved from when the push succeeds
+    bool tryPush(T&& value)
+    {
+        quint64 pos = m_tail.load(std::memory_order_relaxed);
+        for (;;) {
+            Cell& cell = m_cells[pos & m_mask];
+            const quint64 seq = cell.sequence.load(std::memory_order_acquire);
+            const qint64 lag = qint64(seq - pos);
+            if (lag == 0) {
+                if (m_tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    cell.value = std::move(value);
+                    cell.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (lag < 0) {
+                return false;   // the consumer has not freed this cell yet
+            } else {
+                pos = m_tail.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    bool tryPop(T& value)
+    {
+        Cell& cell = m_cells[m_head & m_mask];
+        if (cell.sequence.load(std::memory_order_acquire) != m_head + 1)
+            return false;   // empty, or the producer is still writing it
+        value = std::move(cell.value);
+        cell.value = T();
+        cell.sequence.store(m_head + m_mask + 1, std::memory_order_release);
+        ++m_head;
+        return true;
+    }
+
+    bool isEmpty() const
+    {
+        return m_cells[m_head & m_mask].sequence.load(std::memory_order_acquire) != m_head + 1;
+    }
+
+private:
+    struct Cell {
+        std::atomic<quint64> sequence;
+        T value;
+    };
+
+    // Producers and the consumer each get their own cache line
+    alignas(64) std::atomic<quint64> m_tail{0};
+    alignas(64) quint64 m_head = 0;
+    quint64 m_mask = 0;
+    std::unique_ptr<Cell[]> m_cells;
+};
+
+} // namespace ObservatoryMonitor
+
+#endif // MPSCRING_H
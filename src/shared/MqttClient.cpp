@@ -6,6 +6,8 @@
 
 namespace ObservatoryMonitor {
 
+static LogCategory lcMqtt("MQTT");
+
 MqttClient::MqttClient(QObject* parent)
     : QObject(parent)
     , m_client(new QMqttClient(this))
@@ -76,6 +78,11 @@ void MqttClient::setTopicPrefix(const QString& prefix)
     m_topicPrefix = prefix;
 }
 
+void MqttClient::setControllerName(const QString& name)
+{
+    m_controllerName = name;
+}
+
 void MqttClient::setCommandTimeout(int timeoutMs)
 {
     m_commandTimeout = timeoutMs;
@@ -100,16 +107,12 @@ void MqttClient::setMaxQueueSize(int maxSize)
 void MqttClient::connectToHost()
 {
     if (m_client->state() == QMqttClient::Connected) {
-        Logger::instance().warning(QString("MQTT: Already connected to %1:%2")
-                                  .arg(m_client->hostname())
-                                  .arg(m_client->port()));
+        OM_WARNINGF(lcMqtt, m_controllerName, "Already connected to %1:%2", m_client->hostname(), m_client->port());
         return;
     }
     
-    Logger::instance().info(QString("MQTT: Connecting to %1:%2 (prefix: %3)")
-                           .arg(m_client->hostname())
-                           .arg(m_client->port())
-                           .arg(m_topicPrefix));
+    OM_INFOF(lcMqtt, m_controllerName, "Connecting to %1:%2 (prefix: %3)",
+             m_client->hostname(), m_client->port(), m_topicPrefix);
     
     m_client->connectToHost();
 }
@@ -121,7 +124,7 @@ void MqttClient::disconnectFromHost()
     m_queueProcessTimer->stop();
     
     if (m_client->state() != QMqttClient::Disconnected) {
-        Logger::instance().info("MQTT: Disconnecting...");
+        OM_INFOF(lcMqtt, m_controllerName, "Disconnecting...");
         m_client->disconnectFromHost();
     }
 }
@@ -131,10 +134,16 @@ bool MqttClient::isConnected() const
     return m_client->state() == QMqttClient::Connected;
 }
 
+bool MqttClient::isSubscribed() const
+{
+    return isConnected() && m_echoSubscription
+        && m_echoSubscription->state() == QMqttSubscription::Subscribed;
+}
+
 void MqttClient::sendCommand(const QString& command, ResponseCallback callback)
 {
     if (!isConnected()) {
-        Logger::instance().error(QString("MQTT: Cannot queue command '%1' - not connected").arg(command));
+        OM_ERRORF(lcMqtt, m_controllerName, "Cannot queue command '%1' - not connected", command);
         if (callback) {
             callback(command, "", false, -1);
         }
@@ -143,7 +152,7 @@ void MqttClient::sendCommand(const QString& command, ResponseCallback callback)
     
     // Check queue size
     if (m_commandQueue.size() >= m_maxQueueSize) {
-        Logger::instance().error(QString("MQTT: Queue overflow - dropping command '%1'").arg(command));
+        OM_ERRORF(lcMqtt, m_controllerName, "Queue overflow - dropping command '%1'", command);
         emit queueOverflow(command);
         if (callback) {
             callback(command, "", false, -1);
@@ -167,7 +176,7 @@ void MqttClient::sendCommand(const QString& command, ResponseCallback callback)
     
     m_pendingCommands.insert(commandKey, pending);
     
-    Logger::instance().debug(QString("MQTT: Queued command '%1' (queue size: %2)").arg(command).arg(m_commandQueue.size()));
+    OM_DEBUGF(lcMqtt, m_controllerName, "Queued command '%1' (queue size: %2)", command, m_commandQueue.size());
     
     // Start queue processor if not running
     if (!m_queueProcessTimer->isActive()) {
@@ -193,7 +202,7 @@ int MqttClient::pendingCommandCount() const
 
 void MqttClient::clearQueue()
 {
-    Logger::instance().info(QString("MQTT: Clearing command queue (%1 commands)").arg(m_commandQueue.size()));
+    OM_INFOF(lcMqtt, m_controllerName, "Clearing command queue (%1 commands)", m_commandQueue.size());
     
     // Clear queue
     while (!m_commandQueue.isEmpty()) {
@@ -216,9 +225,7 @@ QMqttClient::ClientState MqttClient::state() const
 
 void MqttClient::onConnected()
 {
-    Logger::instance().info(QString("MQTT: Connected to %1:%2")
-                           .arg(m_client->hostname())
-                           .arg(m_client->port()));
+    OM_INFOF(lcMqtt, m_controllerName, "Connected to %1:%2", m_client->hostname(), m_client->port());
     
     m_reconnectTimer->stop();
     
@@ -235,7 +242,7 @@ void MqttClient::onConnected()
 
 void MqttClient::onDisconnected()
 {
-    Logger::instance().warning("MQTT: Disconnected");
+    OM_WARNINGF(lcMqtt, m_controllerName, "Disconnected");
     
     // Stop queue processor
     m_queueProcessTimer->stop();
@@ -260,7 +267,7 @@ void MqttClient::onDisconnected()
     
     // Schedule reconnect
     if (m_autoReconnect) {
-        Logger::instance().info(QString("MQTT: Reconnecting in %1 seconds...").arg(m_reconnectInterval / 1000));
+        OM_INFOF(lcMqtt, m_controllerName, "Reconnecting in %1 seconds...", m_reconnectInterval / 1000);
         m_reconnectTimer->start(m_reconnectInterval);
     }
 }
@@ -275,7 +282,7 @@ void MqttClient::onStateChanged(QMqttClient::ClientState state)
         default:                        stateStr = "Unknown"; break;
     }
     
-    Logger::instance().debug(QString("MQTT: State changed to %1").arg(stateStr));
+    OM_DEBUGF(lcMqtt, m_controllerName, "State changed to %1", stateStr);
     emit stateChanged(state);
 }
 
@@ -316,7 +323,7 @@ void MqttClient::onErrorChanged(QMqttClient::ClientError error)
             break;
     }
     
-    Logger::instance().error(QString("MQTT: Error - %1").arg(errorStr));
+    OM_ERRORF(lcMqtt, m_controllerName, "Error - %1", errorStr);
     emit errorOccurred(errorStr);
 }
 
@@ -325,11 +332,11 @@ void MqttClient::onMessageReceived(const QMqttMessage& msg)
     QString topicStr = msg.topic().name();
     QString messageStr = QString::fromUtf8(msg.payload());
     
-    Logger::instance().debug(QString("MQTT: Received on %1: %2").arg(topicStr, messageStr));
+    OM_DEBUGF(lcMqtt, m_controllerName, "Received on %1: %2", topicStr, messageStr);
     
     // Should be on echo topic
     if (!topicStr.endsWith("/echo")) {
-        Logger::instance().warning(QString("MQTT: Unexpected topic: %1").arg(topicStr));
+        OM_WARNINGF(lcMqtt, m_controllerName, "Unexpected topic: %1", topicStr);
         return;
     }
     
@@ -338,7 +345,7 @@ void MqttClient::onMessageReceived(const QMqttMessage& msg)
 
 void MqttClient::onReconnectTimer()
 {
-    Logger::instance().info("MQTT: Attempting reconnect...");
+    OM_INFOF(lcMqtt, m_controllerName, "Attempting reconnect...");
     connectToHost();
 }
 
@@ -351,17 +358,37 @@ void MqttClient::setupSubscription()
 {
     QString echoTopic = m_topicPrefix + "/echo";
     
-    Logger::instance().info(QString("MQTT: Subscribing to %1").arg(echoTopic));
+    OM_INFOF(lcMqtt, m_controllerName, "Subscribing to %1", echoTopic);
     
     m_echoSubscription = m_client->subscribe(echoTopic, 0);  // QoS 0 for echo
     
     if (!m_echoSubscription) {
-        Logger::instance().error(QString("MQTT: Failed to subscribe to %1").arg(echoTopic));
+        OM_ERRORF(lcMqtt, m_controllerName, "Failed to subscribe to %1", echoTopic);
         return;
     }
     
-    connect(m_echoSubscription, &QMqttSubscription::messageReceived, 
-            this, &MqttClient::onMessageReceived);
+    // subscribe() hands back the existing object when re-subscribing after a reconnect
+    connect(m_echoSubscription, &QMqttSubscription::messageReceived,
+            this, &MqttClient::onMessageReceived, Qt::UniqueConnection);
+    connect(m_echoSubscription, &QMqttSubscription::stateChanged,
+            this, &MqttClient::onSubscriptionStateChanged, Qt::UniqueConnection);
+
+    if (m_echoSubscription->state() == QMqttSubscription::Subscribed) {
+        onSubscriptionStateChanged(QMqttSubscription::Subscribed);
+    }
+}
+
+void MqttClient::onSubscriptionStateChanged(QMqttSubscription::SubscriptionState state)
+{
+    QString echoTopic = m_topicPrefix + "/echo";
+
+    if (state == QMqttSubscription::Subscribed) {
+        OM_INFOF(lcMqtt, m_controllerName, "Subscription to %1 acknowledged", echoTopic);
+        emit subscribed();
+    } else if (state == QMqttSubscription::Error) {
+        OM_ERRORF(lcMqtt, m_controllerName, "Broker rejected subscription to %1", echoTopic);
+        emit errorOccurred(QString("Subscription to %1 rejected").arg(echoTopic));
+    }
 }
 
 void MqttClient::processQueue()
@@ -384,7 +411,7 @@ void MqttClient::processQueue()
 void MqttClient::sendQueuedCommand(const QString& commandKey)
 {
     if (!m_pendingCommands.contains(commandKey)) {
-        Logger::instance().warning(QString("MQTT: Command key '%1' not found in pending commands").arg(commandKey));
+        OM_WARNINGF(lcMqtt, m_controllerName, "Command key '%1' not found in pending commands", commandKey);
         return;
     }
     
@@ -395,12 +422,12 @@ void MqttClient::sendQueuedCommand(const QString& commandKey)
     QString cmdTopic = m_topicPrefix + "/cmd";
     QByteArray message = command.toUtf8();
     
-    Logger::instance().debug(QString("MQTT: Publishing to %1: %2").arg(cmdTopic, command));
+    OM_DEBUGF(lcMqtt, m_controllerName, "Publishing to %1: %2", cmdTopic, command);
     
     qint64 msgId = m_client->publish(cmdTopic, message, 1);  // QoS 1
     
     if (msgId == -1) {
-        Logger::instance().error(QString("MQTT: Failed to publish command '%1'").arg(command));
+        OM_ERRORF(lcMqtt, m_controllerName, "Failed to publish command '%1'", command);
         
         PendingCommand failedPending = m_pendingCommands.take(commandKey);
         if (failedPending.callback) {
@@ -425,7 +452,7 @@ void MqttClient::sendQueuedCommand(const QString& commandKey)
     pending.timeoutTimer->start();
     
     qint64 queueTime = pending.sentTime - pending.queuedTime;
-    Logger::instance().debug(QString("MQTT: Command '%1' sent (queued for %2 ms)").arg(command).arg(queueTime));
+    OM_DEBUGF(lcMqtt, m_controllerName, "Command '%1' sent (queued for %2 ms)", command, queueTime);
 }
 
 void MqttClient::parseResponse(const QString& response)
@@ -437,7 +464,7 @@ void MqttClient::parseResponse(const QString& response)
     QRegularExpressionMatch cmdMatch = cmdRegex.match(response);
     
     if (!cmdMatch.hasMatch()) {
-        Logger::instance().warning(QString("MQTT: Could not parse command from response: %1").arg(response));
+        OM_WARNINGF(lcMqtt, m_controllerName, "Could not parse command from response: %1", response);
         return;
     }
     
@@ -445,8 +472,8 @@ void MqttClient::parseResponse(const QString& response)
     QString responseValue = extractResponseValue(response);
     int errorCode = extractErrorCode(responseValue);
     
-    Logger::instance().debug(QString("MQTT: Parsed command='%1', response='%2', errorCode=%3")
-                            .arg(command, responseValue).arg(errorCode));
+    OM_DEBUGF(lcMqtt, m_controllerName, "Parsed command='%1', response='%2', errorCode=%3",
+              command, responseValue, errorCode);
     
     // Find the oldest pending command matching this command string
     QString matchingKey;
@@ -462,7 +489,7 @@ void MqttClient::parseResponse(const QString& response)
     }
     
     if (matchingKey.isEmpty()) {
-        Logger::instance().debug(QString("MQTT: Received response for non-pending command: %1").arg(command));
+        OM_DEBUGF(lcMqtt, m_controllerName, "Received response for non-pending command: %1", command);
         emit responseReceived(command, responseValue, true);
         return;
     }
@@ -479,14 +506,13 @@ void MqttClient::parseResponse(const QString& response)
     
     // Calculate response time
     qint64 responseTime = QDateTime::currentMSecsSinceEpoch() - pending.sentTime;
-    Logger::instance().debug(QString("MQTT: Command '%1' completed in %2 ms").arg(command).arg(responseTime));
+    OM_DEBUGF(lcMqtt, m_controllerName, "Command '%1' completed in %2 ms", command, responseTime);
     
     // Interpret error code if present
     bool success = (errorCode == -1 || errorCode == 0);  // -1 = no error code, 0 = success
     if (errorCode > 0) {
         QString errorMsg = interpretErrorCode(errorCode, command);
-        Logger::instance().warning(QString("MQTT: Command '%1' returned error %2: %3")
-                                  .arg(command).arg(errorCode).arg(errorMsg));
+        OM_WARNINGF(lcMqtt, m_controllerName, "Command '%1' returned error %2: %3", command, errorCode, errorMsg);
     }
     
     // Call callback
@@ -526,7 +552,7 @@ void MqttClient::handleCommandTimeout(const QString& commandKey)
     
     PendingCommand pending = m_pendingCommands.take(commandKey);
     
-    Logger::instance().debug(QString("MQTT: Command '%1' timed out after %2 ms").arg(pending.command).arg(m_commandTimeout));
+    OM_DEBUGF(lcMqtt, m_controllerName, "Command '%1' timed out after %2 ms", pending.command, m_commandTimeout);
     
     // Timer will be deleted automatically when command is removed
     if (pending.timeoutTimer) {
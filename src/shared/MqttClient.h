@@ -54,6 +54,8 @@ public:
     void setUsername(const QString& username);
     void setPassword(const QString& password);
     void setTopicPrefix(const QString& prefix);
+    // Tags this client's log records
+    void setControllerName(const QString& name);
     void setCommandTimeout(int timeoutMs);
     void setReconnectInterval(int intervalMs);
     void setQueueProcessInterval(int intervalMs);  // Rate limiting
@@ -63,6 +65,9 @@ public:
     void connectToHost();
     void disconnectFromHost();
     bool isConnected() const;
+    // Connected and the echo subscription acknowledged by the broker:
+    // responses to commands sent from now on will be seen
+    bool isSubscribed() const;
     
     // Send command (adds to queue)
     void sendCommand(const QString& command, ResponseCallback callback);
@@ -80,6 +85,7 @@ public:
     
 signals:
     void connected();
+    void subscribed();
     void disconnected();
     void errorOccurred(const QString& error);
     void stateChanged(QMqttClient::ClientState state);
@@ -92,6 +98,7 @@ private slots:
     void onStateChanged(QMqttClient::ClientState state);
     void onErrorChanged(QMqttClient::ClientError error);
     void onMessageReceived(const QMqttMessage& msg);
+    void onSubscriptionStateChanged(QMqttSubscription::SubscriptionState state);
     void onReconnectTimer();
     void onQueueProcessTimer();
     
@@ -107,12 +114,13 @@ private:
     
     QMqttClient* m_client;
     QString m_topicPrefix;
+    QString m_controllerName;
     int m_commandTimeout;
     int m_reconnectInterval;
     int m_queueProcessInterval;
     int m_maxQueueSize;
     
-    QMqttSubscription* m_echoSubscription;
+    QPointer<QMqttSubscription> m_echoSubscription;
     QTimer* m_reconnectTimer;
     QTimer* m_queueProcessTimer;
     
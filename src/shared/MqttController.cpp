@@ -1,5 +1,6 @@
 #include "MqttController.h"
 #include "Logger.h"
+#include "ConfigDiff.h"
 
 namespace ObservatoryMonitor {
 
@@ -7,7 +8,8 @@ MqttController::MqttController(const ControllerConfig& config, const BrokerConfi
                                double timeout, int reconnectInterval, QObject* parent)
     : AbstractController(config.name, config.type, parent)
     , m_mqttClient(new MqttClient(this))
-    , m_poller(new ControllerPoller(config.name, config.type, m_mqttClient, this))
+    , m_poller(new ControllerPoller(config.name, config.type, this, this))
+    , m_broker(broker)
     , m_status(ControllerStatus::Disconnected)
 {
     m_mqttClient->setHostname(broker.host);
@@ -17,6 +19,7 @@ MqttController::MqttController(const ControllerConfig& config, const BrokerConfi
         m_mqttClient->setPassword(broker.password);
     }
     m_mqttClient->setTopicPrefix(config.prefix);
+    m_mqttClient->setControllerName(config.name);
     m_mqttClient->setCommandTimeout(static_cast<int>(timeout * 1000));
     m_mqttClient->setReconnectInterval(reconnectInterval * 1000);
 
@@ -24,8 +27,10 @@ MqttController::MqttController(const ControllerConfig& config, const BrokerConfi
 
     // Connect signals
     QObject::connect(m_mqttClient, &MqttClient::connected, this, &MqttController::onMqttConnected);
+    QObject::connect(m_mqttClient, &MqttClient::subscribed, this, &AbstractController::ready);
     QObject::connect(m_mqttClient, &MqttClient::disconnected, this, &MqttController::onMqttDisconnected);
     QObject::connect(m_mqttClient, &MqttClient::errorOccurred, this, &MqttController::onMqttError);
+    QObject::connect(m_mqttClient, &MqttClient::responseReceived, this, &MqttController::onResponseReceived);
     QObject::connect(m_poller, &ControllerPoller::dataUpdated, this, &MqttController::onDataUpdated);
 }
 
@@ -53,12 +58,19 @@ void MqttController::sendCommand(const QString& command, ResponseCallback callba
 
 void MqttController::updateConfig(const BrokerConfig& broker, double timeout, int reconnectInterval)
 {
+    // Timing changes apply to the live connection
+    m_mqttClient->setCommandTimeout(static_cast<int>(timeout * 1000));
+    m_mqttClient->setReconnectInterval(reconnectInterval * 1000);
+
+    if (ConfigDiff::sameConnection(m_broker, broker)) {
+        return;
+    }
+
+    m_broker = broker;
     m_mqttClient->setHostname(broker.host);
     m_mqttClient->setPort(static_cast<quint16>(broker.port));
     m_mqttClient->setUsername(broker.username);
     m_mqttClient->setPassword(broker.password);
-    m_mqttClient->setCommandTimeout(static_cast<int>(timeout * 1000));
-    m_mqttClient->setReconnectInterval(reconnectInterval * 1000);
 
     // If we are currently connected or connecting, we should reconnect with new settings
     if (m_status == ControllerStatus::Connected || m_status == ControllerStatus::Connecting) {
@@ -79,6 +91,11 @@ void MqttController::stopPolling()
     m_poller->stopPolling();
 }
 
+CachedValue MqttController::getCachedValue(PropertyId id) const
+{
+    return m_poller->getCachedValue(id);
+}
+
 CachedValue MqttController::getCachedValue(const QString& command) const
 {
     return m_poller->getCachedValue(command);
@@ -89,6 +106,11 @@ QHash<QString, CachedValue> MqttController::getAllCachedValues() const
     return m_poller->getAllCachedValues();
 }
 
+QVector<PropertyId> MqttController::polledProperties() const
+{
+    return m_poller->polledProperties();
+}
+
 void MqttController::onMqttConnected()
 {
     updateStatus(ControllerStatus::Connected);
@@ -104,9 +126,16 @@ void MqttController::onMqttError(const QString& error)
     emit errorOccurred(error);
 }
 
-void MqttController::onDataUpdated(const QString& command, const QString& value)
+void MqttController::onDataUpdated(PropertyId id, const QString& value)
 {
-    emit dataUpdated(command, value);
+    emit dataUpdated(id, value);
+}
+
+void MqttController::onResponseReceived(const QString& command, const QString& response, bool isUnsolicited)
+{
+    if (isUnsolicited) {
+        emit unsolicitedResponse(command, response);
+    }
 }
 
 void MqttController::updateStatus(ControllerStatus status)
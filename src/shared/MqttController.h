@@ -18,6 +18,7 @@ public:
     ~MqttController() override;
 
     ControllerStatus status() const override { return m_status; }
+    bool isReady() const override { return m_mqttClient->isSubscribed(); }
 
     void connect() override;
     void disconnect() override;
@@ -26,24 +27,28 @@ public:
 
     void updateConfig(const BrokerConfig& broker, double timeout, int reconnectInterval);
 
-    void startPolling(int fastPollMs, int slowPollMs);
-    void stopPolling();
+    void startPolling(int fastPollMs, int slowPollMs) override;
+    void stopPolling() override;
 
     // Accessors for polling data
-    CachedValue getCachedValue(const QString& command) const;
-    QHash<QString, CachedValue> getAllCachedValues() const;
+    CachedValue getCachedValue(PropertyId id) const override;
+    CachedValue getCachedValue(const QString& command) const override;
+    QHash<QString, CachedValue> getAllCachedValues() const override;
+    QVector<PropertyId> polledProperties() const override;
 
 private slots:
     void onMqttConnected();
     void onMqttDisconnected();
     void onMqttError(const QString& error);
-    void onDataUpdated(const QString& command, const QString& value);
+    void onDataUpdated(PropertyId id, const QString& value);
+    void onResponseReceived(const QString& command, const QString& response, bool isUnsolicited);
 
 private:
     void updateStatus(ControllerStatus status);
 
     MqttClient* m_mqttClient;
     ControllerPoller* m_poller;
+    BrokerConfig m_broker;
     ControllerStatus m_status;
 };
 
@@ -0,0 +1,125 @@
+#include "PropertyInterner.h"
+
+namespace ObservatoryMonitor {
+
+PropertyInterner& PropertyInterner::instance()
+{
+    static PropertyInterner instance;
+    return instance;
+}
+
+int PropertyInterner::internController(const QString& controller)
+{
+    {
+        QReadLocker locker(&m_lock);
+        auto it = m_controllerIndex.constFind(controller);
+        if (it != m_controllerIndex.constEnd()) return it.value();
+    }
+
+    QWriteLocker locker(&m_lock);
+    return internControllerLocked(controller);
+}
+
+int PropertyInterner::findController(const QString& controller) const
+{
+    QReadLocker locker(&m_lock);
+    return m_controllerIndex.value(controller, -1);
+}
+
+PropertyId PropertyInterner::intern(const QString& controller, const QString& command)
+{
+    PropertyId id = find(controller, command);
+    if (id != InvalidPropertyId) return id;
+
+    QWriteLocker locker(&m_lock);
+    int index = internControllerLocked(controller);
+    ControllerEntry& entry = m_controllers[index];
+
+    // Another thread may have interned it between the two locks
+    auto it = entry.ids.constFind(command);
+    if (it != entry.ids.constEnd()) return it.value();
+
+    id = m_commands.size();
+    if (id >= MaxChunks * ChunkSize) return InvalidPropertyId;
+
+    std::unique_ptr<Location[]>& chunk = m_locations[id >> ChunkBits];
+    if (!chunk) chunk.reset(new Location[ChunkSize]);
+    chunk[id & (ChunkSize - 1)] = Location{index, static_cast<int>(entry.properties.size())};
+    m_published.store(id + 1, std::memory_order_release);
+
+    m_commands.append(command);
+    entry.ids.insert(command, id);
+    entry.properties.append(id);
+    return id;
+}
+
+PropertyId PropertyInterner::find(const QString& controller, const QString& command) const
+{
+    QReadLocker locker(&m_lock);
+    int index = m_controllerIndex.value(controller, -1);
+    if (index < 0) return InvalidPropertyId;
+    return m_controllers[index].ids.value(command, InvalidPropertyId);
+}
+
+QString PropertyInterner::controller(PropertyId id) const
+{
+    QReadLocker locker(&m_lock);
+    if (id < 0 || id >= m_commands.size()) return QString();
+    return m_controllers[m_locations[id >> ChunkBits][id & (ChunkSize - 1)].controller].name;
+}
+
+QString PropertyInterner::command(PropertyId id) const
+{
+    QReadLocker locker(&m_lock);
+    if (id < 0 || id >= m_commands.size()) return QString();
+    return m_commands[id];
+}
+
+int PropertyInterner::controllerIndex(PropertyId id) const
+{
+    // The acquire pairs with intern()'s release: the chunk and its entry
+    // are written before the ID is published
+    if (id < 0 || id >= m_published.load(std::memory_order_acquire)) return -1;
+    return m_locations[id >> ChunkBits][id & (ChunkSize - 1)].controller;
+}
+
+int PropertyInterner::slot(PropertyId id) const
+{
+    if (id < 0 || id >= m_published.load(std::memory_order_acquire)) return -1;
+    return m_locations[id >> ChunkBits][id & (ChunkSize - 1)].slot;
+}
+
+int PropertyInterner::slotCount(const QString& controller) const
+{
+    QReadLocker locker(&m_lock);
+    int index = m_controllerIndex.value(controller, -1);
+    return index < 0 ? 0 : m_controllers[index].properties.size();
+}
+
+QVector<PropertyId> PropertyInterner::properties(const QString& controller) const
+{
+    QReadLocker locker(&m_lock);
+    int index = m_controllerIndex.value(controller, -1);
+    return index < 0 ? QVector<PropertyId>() : m_controllers[index].properties;
+}
+
+int PropertyInterner::count() const
+{
+    QReadLocker locker(&m_lock);
+    return m_commands.size();
+}
+
+int PropertyInterner::internControllerLocked(const QString& controller)
+{
+    auto it = m_controllerIndex.constFind(controller);
+    if (it != m_controllerIndex.constEnd()) return it.value();
+
+    int index = m_controllers.size();
+    ControllerEntry entry;
+    entry.name = controller;
+    m_controllers.append(entry);
+    m_controllerIndex.insert(controller, index);
+    return index;
+}
+
+} // namespace ObservatoryMonitor
@@ -0,0 +1,87 @@
+#ifndef PROPERTYINTERNER_H
+#define PROPERTYINTERNER_H
+
+#include <QString>
+#include <QHash>
+#include <QVector>
+#include <QReadWriteLock>
+#include <array>
+#include <atomic>
+#include <memory>
+
+namespace ObservatoryMonitor {
+
+// Dense integer handle for a (controller, command) pair
+using PropertyId = int;
+constexpr PropertyId InvalidPropertyId = -1;
+
+// Process-wide property interner - singleton
+//
+// Every (controller, command) pair gets a dense PropertyId when the
+// controller is loaded; commands that only show up later (unsolicited
+// updates) are appended on first sight. IDs are never reused, so caches can
+// be flat vectors. Besides the global ID each property has a slot, dense
+// within its controller, for per-controller storage. Strings are only needed
+// at the edges (wire protocol, UI, logs, telemetry).
+//
+// controllerIndex() and slot() sit on the per-update path and take no lock;
+// everything else goes through a read/write lock.
+class PropertyInterner {
+public:
+    static PropertyInterner& instance();
+
+    // Controller handles, dense in order of first use
+    int internController(const QString& controller);
+    int findController(const QString& controller) const;
+
+    PropertyId intern(const QString& controller, const QString& command);
+    PropertyId find(const QString& controller, const QString& command) const;
+
+    // Resolve an ID; invalid IDs yield empty strings / -1
+    QString controller(PropertyId id) const;
+    QString command(PropertyId id) const;
+    int controllerIndex(PropertyId id) const;
+    int slot(PropertyId id) const;
+
+    // Number of properties interned for a controller (upper bound of slots)
+    int slotCount(const QString& controller) const;
+    QVector<PropertyId> properties(const QString& controller) const;
+
+    int count() const;
+
+private:
+    PropertyInterner() = default;
+    PropertyInterner(const PropertyInterner&) = delete;
+    PropertyInterner& operator=(const PropertyInterner&) = delete;
+
+    // Fixed once interned, so published to lock-free readers
+    struct Location {
+        int controller;
+        int slot;
+    };
+
+    // Append-only: chunks are allocated on demand and never moved or freed
+    static constexpr int ChunkBits = 10;
+    static constexpr int ChunkSize = 1 << ChunkBits;
+    static constexpr int MaxChunks = 1024;
+
+    struct ControllerEntry {
+        QString name;
+        QHash<QString, PropertyId> ids;
+        QVector<PropertyId> properties;   // indexed by slot
+    };
+
+    int internControllerLocked(const QString& controller);
+
+    mutable QReadWriteLock m_lock;
+    QVector<QString> m_commands;           // indexed by PropertyId
+    std::array<std::unique_ptr<Location[]>, MaxChunks> m_locations;
+    // IDs below this are fully written to m_locations (release/acquire)
+    std::atomic<int> m_published{0};
+    QVector<ControllerEntry> m_controllers;
+    QHash<QString, int> m_controllerIndex;
+};
+
+} // namespace ObservatoryMonitor
+
+#endif // PROPERTYINTERNER_H
@@ -0,0 +1,137 @@
+#ifndef RCUCELL_H
+#define RCUCELL_H
+
+#include <QtGlobal>
+#include <atomic>
+#include <array>
+#include <memory>
+#include <vector>
+#include <thread>
+
+namespace ObservatoryMonitor {
+
+// Single-writer, many-reader cell holding an immutable object (RCU style).
+//
+// The writer publishes a new object with an atomic pointer swap; readers
+// never block and never copy. Replaced objects are retired and deleted only
+// once no reader that could still see them is active (epoch-based deferred
+// reclamation): a reader announces the current epoch in one of MaxReaders
+// slots for the duration of a ReadGuard, and a retired object is freed when
+// every announced epoch is newer than the epoch it was retired in.
+//
+// publish() and reclaim() must be called from one thread. Readers may live
+// on any thread; more than MaxReaders simultaneous guards spin until a slot
+// frees up.
+template <typename T>
+class RcuCell
+{
+public:
+    static constexpr int MaxReaders = 64;
+
+    class ReadGuard
+    {
+    public:
+        ReadGuard(ReadGuard&& other) noexcept
+            : m_slot(other.m_slot), m_value(other.m_value)
+        {
+            other.m_slot = nullptr;
+            other.m_value = nullptr;
+        }
+        ReadGuard(const ReadGuard&) = delete;
+        ReadGuard& operator=(const ReadGuard&) = delete;
+        ReadGuard& operator=(ReadGuard&&) = delete;
+
+        ~ReadGuard()
+        {
+            if (m_slot) m_slot->store(0, std::memory_order_release);
+        }
+
+        const T* get() const { return m_value; }
+        const T* operator->() const { return m_value; }
+        const T& operator*() const { return *m_value; }
+        explicit operator bool() const { return m_value != nullptr; }
+
+    private:
+        friend class RcuCell;
+        ReadGuard(std::atomic<quint64>* slot, const T* value) : m_slot(slot), m_value(value) {}
+
+        std::atomic<quint64>* m_slot;
+        const T* m_value;
+    };
+
+    RcuCell() = default;
+    RcuCell(const RcuCell&) = delete;
+    RcuCell& operator=(const RcuCell&) = delete;
+
+    ~RcuCell()
+    {
+        // No readers may outlive the cell
+        delete m_current.load();
+        for (const Retired& retired : m_retired) delete retired.value;
+    }
+
+    ReadGuard read() const
+    {
+        for (;;) {
+            for (auto& slot : m_slots) {
+                quint64 expected = 0;
+                quint64 epoch = m_epoch.load();
+                if (slot.compare_exchange_strong(expected, epoch)) {
+                    return ReadGuard(&slot, m_current.load());
+                }
+            }
+            std::this_thread::yield();
+        }
+    }
+
+    // Writer side: swap in a new object and retire the previous one
+    void publish(std::unique_ptr<const T> value)
+    {
+        const T* previous = m_current.exchange(value.release());
+        if (previous) {
+            m_retired.push_back(Retired{previous, m_epoch.load()});
+        }
+        m_epoch.fetch_add(1);
+        reclaim();
+    }
+
+    // Writer side: free retired objects no reader can still hold
+    void reclaim()
+    {
+        if (m_retired.empty()) return;
+
+        quint64 oldestActive = ~quint64(0);
+        for (const auto& slot : m_slots) {
+            quint64 epoch = slot.load();
+            if (epoch != 0 && epoch < oldestActive) oldestActive = epoch;
+        }
+
+        auto it = m_retired.begin();
+        while (it != m_retired.end()) {
+            if (it->epoch < oldestActive) {
+                delete it->value;
+                it = m_retired.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    int retiredCount() const { return static_cast<int>(m_retired.size()); }
+
+private:
+    struct Retired {
+        const T* value;
+        quint64 epoch;
+    };
+
+    // Epochs start at 1 so that 0 can mark a free reader slot
+    std::atomic<quint64> m_epoch{1};
+    std::atomic<const T*> m_current{nullptr};
+    mutable std::array<std::atomic<quint64>, MaxReaders> m_slots{};
+    std::vector<Retired> m_retired;
+};
+
+} // namespace ObservatoryMonitor
+
+#endif // RCUCELL_H
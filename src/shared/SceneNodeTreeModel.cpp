@@ -0,0 +1,243 @@
+#include "SceneNodeTreeModel.h"
+#include "LayoutConfig.h"
+
+namespace ObservatoryMonitor {
+
+SceneNodeTreeModel::SceneNodeTreeModel(const QList<SceneNodeConfig>& nodes, QObject* parent)
+    : QAbstractItemModel(parent)
+    , m_nodes(nodes)
+{
+}
+
+SceneNodeTreeModel::~SceneNodeTreeModel()
+{
+    qDeleteAll(m_sources);
+}
+
+QModelIndex SceneNodeTreeModel::index(int row, int column, const QModelIndex& parent) const
+{
+    if (column != 0)
+        return QModelIndex();
+
+    const Node* p = parent.isValid() ? static_cast<const Node*>(parent.internalPointer()) : &m_root;
+    if (row < 0 || row >= p->children.count())
+        return QModelIndex();
+    return createIndex(row, 0, p->children.at(row));
+}
+
+QModelIndex SceneNodeTreeModel::parent(const QModelIndex& child) const
+{
+    if (!child.isValid())
+        return QModelIndex();
+    return indexFor(static_cast<const Node*>(child.internalPointer())->parent);
+}
+
+int SceneNodeTreeModel::rowCount(const QModelIndex& parent) const
+{
+    if (parent.column() > 0)
+        return 0;
+    const Node* p = parent.isValid() ? static_cast<const Node*>(parent.internalPointer()) : &m_root;
+    return p->children.count();
+}
+
+int SceneNodeTreeModel::columnCount(const QModelIndex& parent) const
+{
+    Q_UNUSED(parent);
+    return 1;
+}
+
+QVariant SceneNodeTreeModel::data(const QModelIndex& index, int role) const
+{
+    if (!index.isValid())
+        return QVariant();
+
+    const SceneNodeConfig& s = m_nodes.at(static_cast<const Node*>(index.internalPointer())->source);
+
+    switch (role) {
+    case NodeIdRole:
+        return s.id;
+    case ModelRole:
+        return s.model;
+    case ParentIdRole:
+        return s.parentId;
+    case OffsetRole:
+        return s.offset;
+    case MotionRole:
+        return LayoutConfig::sceneNodeToVariant(s).value("motion");
+    case ConfigRole:
+        return LayoutConfig::sceneNodeToVariant(s);
+    default:
+        return QVariant();
+    }
+}
+
+QHash<int, QByteArray> SceneNodeTreeModel::roleNames() const
+{
+    QHash<int, QByteArray> roles;
+    roles[NodeIdRole] = "nodeId";
+    roles[ModelRole] = "model";
+    roles[ParentIdRole] = "parentId";
+    roles[OffsetRole] = "offset";
+    roles[MotionRole] = "motion";
+    roles[ConfigRole] = "config";
+    return roles;
+}
+
+QModelIndex SceneNodeTreeModel::indexOf(const QString& nodeId) const
+{
+    return indexFor(m_byId.value(nodeId));
+}
+
+void SceneNodeTreeModel::rebuild()
+{
+    qDeleteAll(m_sources);
+    m_sources.clear();
+    m_root.children.clear();
+
+    for (int i = 0; i < m_nodes.count(); ++i) {
+        Node* node = new Node;
+        node->source = i;
+        node->parent = &m_root;
+        m_root.children.append(node);
+        m_sources.append(node);
+    }
+    rebuildIdIndex();
+
+    // Same placement as reattach(), without notifications inside a reset
+    for (Node* node : std::as_const(m_sources)) {
+        Node* target = attachTarget(node);
+        if (target != node->parent) {
+            node->parent->children.removeOne(node);
+            target->children.append(node);
+            node->parent = target;
+        }
+    }
+}
+
+void SceneNodeTreeModel::appendNode()
+{
+    Node* node = new Node;
+    node->source = m_sources.count();
+    m_sources.append(node);
+    rebuildIdIndex();
+
+    Node* target = attachTarget(node);
+    const int row = target->children.count();
+    beginInsertRows(indexFor(target), row, row);
+    target->children.append(node);
+    node->parent = target;
+    endInsertRows();
+
+    // Nodes that were waiting for this parent move under it
+    reattach();
+}
+
+void SceneNodeTreeModel::beginRemoveNode(int source)
+{
+    Node* node = m_sources.at(source);
+
+    // Children fall back to their next best parent before the node goes
+    rebuildIdIndex(node);
+    reattach(node);
+
+    const int row = node->parent->children.indexOf(node);
+    beginRemoveRows(indexFor(node->parent), row, row);
+}
+
+void SceneNodeTreeModel::endRemoveNode(int source)
+{
+    Node* node = m_sources.takeAt(source);
+    node->parent->children.removeOne(node);
+    delete node;
+
+    for (int i = source; i < m_sources.count(); ++i)
+        m_sources[i]->source = i;
+    endRemoveRows();
+}
+
+void SceneNodeTreeModel::updateNode(int source, const QList<int>& roles)
+{
+    QModelIndex index = indexFor(m_sources.at(source));
+    emit dataChanged(index, index, roles);
+
+    if (roles.contains(NodeIdRole) || roles.contains(ParentIdRole)) {
+        rebuildIdIndex();
+        reattach();
+    }
+}
+
+QList<int> SceneNodeTreeModel::changedRoles(const SceneNodeConfig& before, const SceneNodeConfig& after)
+{
+    QList<int> roles;
+    if (before.id != after.id) roles << NodeIdRole;
+    if (before.model != after.model) roles << ModelRole;
+    if (before.parentId != after.parentId) roles << ParentIdRole;
+    if (before.offset != after.offset) roles << OffsetRole;
+    if (before.motion.type != after.motion.type
+        || before.motion.axis != after.motion.axis
+        || before.motion.propertyLink != after.motion.propertyLink
+        || ValueMappingEngine::definitionToVariant(before.motion.mapping)
+               != ValueMappingEngine::definitionToVariant(after.motion.mapping)) {
+        roles << MotionRole;
+    }
+    if (!roles.isEmpty()) roles << ConfigRole;
+    return roles;
+}
+
+QModelIndex SceneNodeTreeModel::indexFor(const Node* node) const
+{
+    if (!node || node == &m_root)
+        return QModelIndex();
+    return createIndex(node->parent->children.indexOf(node), 0, node);
+}
+
+SceneNodeTreeModel::Node* SceneNodeTreeModel::attachTarget(const Node* node, const Node* removed) const
+{
+    const QString& parentId = m_nodes.at(node->source).parentId;
+    Node* target = parentId.isEmpty() ? nullptr : m_byId.value(parentId);
+    if (!target || target == removed)
+        return const_cast<Node*>(&m_root);
+
+    // Attaching below one of its own descendants would detach the branch
+    for (const Node* n = target; n && n != &m_root; n = n->parent) {
+        if (n == node)
+            return const_cast<Node*>(&m_root);
+    }
+    return target;
+}
+
+void SceneNodeTreeModel::moveNode(Node* node, Node* target)
+{
+    Node* from = node->parent;
+    const int row = from->children.indexOf(node);
+    beginMoveRows(indexFor(from), row, row, indexFor(target), target->children.count());
+    from->children.removeAt(row);
+    target->children.append(node);
+    node->parent = target;
+    endMoveRows();
+}
+
+void SceneNodeTreeModel::reattach(const Node* removed)
+{
+    for (Node* node : std::as_const(m_sources)) {
+        if (node == removed || !node->parent)
+            continue;
+        Node* target = attachTarget(node, removed);
+        if (target != node->parent)
+            moveNode(node, target);
+    }
+}
+
+void SceneNodeTreeModel::rebuildIdIndex(const Node* removed)
+{
+    m_byId.clear();
+    for (Node* node : std::as_const(m_sources)) {
+        if (node == removed)
+            continue;
+        const QString& id = m_nodes.at(node->source).id;
+        if (!m_byId.contains(id))
+            m_byId.insert(id, node);
+    }
+}
+
+} // namespace ObservatoryMonitor
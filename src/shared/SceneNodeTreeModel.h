@@ -0,0 +1,78 @@
+#ifndef SCENENODETREEMODEL_H
+#define SCENENODETREEMODEL_H
+
+#include <QAbstractItemModel>
+#include <QHash>
+#include <QList>
+
+namespace ObservatoryMonitor {
+
+struct SceneNodeConfig;
+class LayoutConfig;
+
+// Tree view of LayoutConfig's scene nodes, arranged by their parent ids.
+// LayoutConfig keeps the flat list and tells the model about each edit, so
+// the 3D scene only instantiates, moves or updates the node that changed.
+// A node whose parent is missing, or would close a cycle, sits at the top
+// level so that every node in the layout is shown.
+class SceneNodeTreeModel : public QAbstractItemModel
+{
+    Q_OBJECT
+
+public:
+    enum SceneNodeRoles {
+        NodeIdRole = Qt::UserRole + 1,
+        ModelRole,
+        ParentIdRole,
+        OffsetRole,
+        MotionRole,
+        ConfigRole          // the whole entry, as in LayoutConfig::sceneNodes
+    };
+
+    ~SceneNodeTreeModel() override;
+
+    QModelIndex index(int row, int column, const QModelIndex& parent = QModelIndex()) const override;
+    QModelIndex parent(const QModelIndex& child) const override;
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+    QHash<int, QByteArray> roleNames() const override;
+
+    Q_INVOKABLE QModelIndex indexOf(const QString& nodeId) const;
+
+private:
+    friend class LayoutConfig;
+
+    struct Node {
+        int source = -1;            // position in LayoutConfig's list
+        Node* parent = nullptr;
+        QList<Node*> children;
+    };
+
+    explicit SceneNodeTreeModel(const QList<SceneNodeConfig>& nodes, QObject* parent);
+
+    // Edits, called by LayoutConfig around changes to its list
+    void rebuild();
+    void appendNode();
+    void beginRemoveNode(int source);
+    void endRemoveNode(int source);
+    void updateNode(int source, const QList<int>& roles);
+
+    // Roles that differ between two versions of the same node
+    static QList<int> changedRoles(const SceneNodeConfig& before, const SceneNodeConfig& after);
+
+    QModelIndex indexFor(const Node* node) const;
+    Node* attachTarget(const Node* node, const Node* removed = nullptr) const;
+    void moveNode(Node* node, Node* target);
+    void reattach(const Node* removed = nullptr);
+    void rebuildIdIndex(const Node* removed = nullptr);
+
+    const QList<SceneNodeConfig>& m_nodes;
+    Node m_root;
+    QList<Node*> m_sources;         // owns the nodes, in list order
+    QHash<QString, Node*> m_byId;   // first node with each id
+};
+
+} // namespace ObservatoryMonitor
+
+#endif // SCENENODETREEMODEL_H
@@ -0,0 +1,257 @@
+#include "StartupOrchestrator.h"
+#include "ControllerManager.h"
+#include "Logger.h"
+#include <algorithm>
+
+namespace ObservatoryMonitor {
+
+StartupOrchestrator::StartupOrchestrator(ControllerManager* manager, QObject* parent)
+    : QObject(parent)
+    , m_manager(manager)
+    , m_maxConcurrent(4)
+    , m_readyTimeout(10000)   // 10 seconds default
+    , m_running(false)
+    , m_connecting(0)
+    , m_timeoutTimer(new QTimer(this))
+{
+    m_timeoutTimer->setInterval(250);
+    connect(m_timeoutTimer, &QTimer::timeout, this, &StartupOrchestrator::checkTimeouts);
+}
+
+void StartupOrchestrator::setMaxConcurrent(int count)
+{
+    m_maxConcurrent = qMax(0, count);
+    if (m_running) {
+        launchNext();
+    }
+}
+
+void StartupOrchestrator::setReadyTimeout(int timeoutMs)
+{
+    m_readyTimeout = qMax(0, timeoutMs);
+}
+
+void StartupOrchestrator::start(int fastPollMs, int slowPollMs)
+{
+    if (m_running) {
+        return;
+    }
+
+    m_entries.clear();
+    m_order.clear();
+    m_queue.clear();
+    m_connecting = 0;
+
+    QStringList names = m_manager->getControllerNames();
+    std::sort(names.begin(), names.end());
+    for (const QString& name : names) {
+        if (!m_manager->isControllerEnabled(name)) continue;
+
+        Entry entry;
+        entry.metrics.name = name;
+        m_entries.insert(name, entry);
+        m_order << name;
+        m_queue.enqueue(name);
+    }
+
+    Logger::instance().info(QString("Startup: Connecting %1 controllers (%2 at a time)")
+                           .arg(m_order.size())
+                           .arg(m_maxConcurrent > 0 ? QString::number(m_maxConcurrent) : QString("all")));
+
+    // Pollers are armed now but hold off until their controller is ready
+    m_manager->startPolling(fastPollMs, slowPollMs);
+    m_manager->setActive(true);
+
+    m_running = true;
+    m_clock.start();
+    m_timeoutTimer->start();
+    launchNext();
+    checkFinished();
+}
+
+QList<StartupMetrics> StartupOrchestrator::metrics() const
+{
+    QList<StartupMetrics> result;
+    for (const QString& name : m_order) {
+        result << m_entries[name].metrics;
+    }
+    return result;
+}
+
+void StartupOrchestrator::launchNext()
+{
+    while (!m_queue.isEmpty() && (m_maxConcurrent == 0 || m_connecting < m_maxConcurrent)) {
+        launch(m_queue.dequeue());
+    }
+}
+
+void StartupOrchestrator::launch(const QString& name)
+{
+    AbstractController* controller = m_manager->controller(name);
+    if (!controller || !m_manager->isControllerEnabled(name)) {
+        abandon(m_entries[name], "removed or disabled before connecting");
+        return;
+    }
+
+    Entry& entry = m_entries[name];
+    entry.stage = Stage::Connecting;
+    entry.metrics.connectStartMs = m_clock.elapsed();
+    entry.connections << connect(controller, &AbstractController::ready, this, [this, name]() { onReady(name); });
+    entry.connections << connect(m_manager->channel(name), &ControllerChannel::dataUpdated, this,
+                                 [this, name](PropertyId id, const QString&) { onData(name, id); });
+    m_connecting++;
+
+    emit controllerStarted(name);
+    m_manager->connectController(name);
+
+    if (controller->isReady()) {
+        onReady(name);
+    }
+}
+
+void StartupOrchestrator::onReady(const QString& name)
+{
+    auto it = m_entries.find(name);
+    if (it == m_entries.end() || it->stage != Stage::Connecting) {
+        return;
+    }
+
+    it->stage = Stage::Loading;
+    it->metrics.readyMs = m_clock.elapsed();
+
+    // Full state: every property the controller polls has a value. Other
+    // interned properties, such as a ControllerProxy's dispatch table, may
+    // never be answered by this controller.
+    const QVector<PropertyId> ids = m_manager->controller(name)->polledProperties();
+    for (PropertyId id : ids) {
+        if (!m_manager->getControllerValue(id).valid) {
+            it->missing.insert(id);
+        }
+    }
+
+    Logger::instance().info(QString("Startup[%1]: Ready after %2 ms")
+                           .arg(name)
+                           .arg(it->metrics.readyMs - it->metrics.connectStartMs));
+    emit controllerReady(name);
+
+    bool loaded = it->missing.isEmpty();
+    releaseSlot();
+
+    if (loaded) {
+        complete(m_entries[name]);
+    }
+}
+
+void StartupOrchestrator::onData(const QString& name, PropertyId id)
+{
+    auto it = m_entries.find(name);
+    if (it == m_entries.end()) {
+        return;
+    }
+
+    if (it->metrics.firstValueMs < 0) {
+        it->metrics.firstValueMs = m_clock.elapsed();
+    }
+
+    if (it->stage == Stage::Loading && it->missing.remove(id) && it->missing.isEmpty()) {
+        complete(*it);
+    }
+}
+
+void StartupOrchestrator::complete(Entry& entry)
+{
+    for (const auto& connection : std::as_const(entry.connections)) {
+        disconnect(connection);
+    }
+    entry.connections.clear();
+    entry.stage = Stage::Complete;
+    entry.metrics.fullStateMs = m_clock.elapsed();
+    if (entry.metrics.firstValueMs < 0) {
+        // Everything was already cached when the controller became ready
+        entry.metrics.firstValueMs = entry.metrics.fullStateMs;
+    }
+
+    Logger::instance().info(QString("Startup[%1]: First value after %2 ms, full state after %3 ms")
+                           .arg(entry.metrics.name)
+                           .arg(entry.metrics.timeToFirstValue())
+                           .arg(entry.metrics.timeToFullState()));
+
+    StartupMetrics metrics = entry.metrics;
+    emit controllerComplete(metrics.name, metrics);
+    checkFinished();
+}
+
+void StartupOrchestrator::abandon(Entry& entry, const QString& reason)
+{
+    for (const auto& connection : std::as_const(entry.connections)) {
+        disconnect(connection);
+    }
+    entry.connections.clear();
+
+    bool wasConnecting = entry.stage == Stage::Connecting;
+    entry.stage = Stage::Abandoned;
+
+    // The controller keeps reconnecting on its own and polls once it is ready
+    Logger::instance().warning(QString("Startup[%1]: %2").arg(entry.metrics.name, reason));
+
+    if (wasConnecting) {
+        releaseSlot();
+    }
+    checkFinished();
+}
+
+void StartupOrchestrator::releaseSlot()
+{
+    m_connecting = qMax(0, m_connecting - 1);
+    launchNext();
+}
+
+void StartupOrchestrator::checkTimeouts()
+{
+    qint64 now = m_clock.elapsed();
+
+    for (const QString& name : std::as_const(m_order)) {
+        Entry& entry = m_entries[name];
+        if (entry.stage != Stage::Connecting && entry.stage != Stage::Loading) continue;
+
+        if (!m_manager->controller(name)) {
+            abandon(entry, "removed during startup");
+        } else if (entry.stage == Stage::Connecting && now - entry.metrics.connectStartMs > m_readyTimeout) {
+            abandon(entry, QString("Not ready after %1 ms, continuing without it").arg(now - entry.metrics.connectStartMs));
+        } else if (entry.stage == Stage::Loading && now - entry.metrics.readyMs > m_readyTimeout) {
+            abandon(entry, QString("Full state incomplete after %1 ms (%2 properties missing)")
+                               .arg(now - entry.metrics.connectStartMs)
+                               .arg(entry.missing.size()));
+        }
+    }
+}
+
+void StartupOrchestrator::checkFinished()
+{
+    if (!m_running || !m_queue.isEmpty()) {
+        return;
+    }
+
+    int complete = 0;
+    qint64 lastFullState = 0;
+    for (const auto& entry : std::as_const(m_entries)) {
+        if (entry.stage != Stage::Complete && entry.stage != Stage::Abandoned) {
+            return;
+        }
+        if (entry.stage == Stage::Complete) {
+            complete++;
+            lastFullState = qMax(lastFullState, entry.metrics.fullStateMs);
+        }
+    }
+
+    m_running = false;
+    m_timeoutTimer->stop();
+
+    Logger::instance().info(QString("Startup: %1 of %2 controllers reached full state in %3 ms")
+                           .arg(complete)
+                           .arg(m_entries.size())
+                           .arg(lastFullState));
+    emit finished();
+}
+
+} // namespace ObservatoryMonitor
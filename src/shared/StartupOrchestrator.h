@@ -0,0 +1,103 @@
+#ifndef STARTUPORCHESTRATOR_H
+#define STARTUPORCHESTRATOR_H
+
+#include <QObject>
+#include <QString>
+#include <QHash>
+#include <QSet>
+#include <QQueue>
+#include <QTimer>
+#include <QElapsedTimer>
+#include "PropertyInterner.h"
+
+namespace ObservatoryMonitor {
+
+class ControllerManager;
+
+// Startup timings for one controller, in ms since StartupOrchestrator::start().
+// -1 means the milestone was not reached.
+struct StartupMetrics {
+    QString name;
+    qint64 connectStartMs = -1;   // connect() issued (after waiting for a slot)
+    qint64 readyMs = -1;          // echo subscription acknowledged
+    qint64 firstValueMs = -1;     // first polled value received
+    qint64 fullStateMs = -1;      // every polled property has a value
+
+    qint64 timeToFirstValue() const { return firstValueMs < 0 ? -1 : firstValueMs - connectStartMs; }
+    qint64 timeToFullState() const { return fullStateMs < 0 ? -1 : fullStateMs - connectStartMs; }
+};
+
+// Brings the enabled controllers up at application start.
+//
+// At most maxConcurrent controllers are connecting at any time; a slot is
+// released once the controller is ready (its responses can be received) or
+// the ready timeout expires. Pollers are armed up front and only begin once
+// their controller is ready, so no poll is sent into a connection whose
+// responses would be lost. Each controller's time to first value and time to
+// full state are logged as it completes, and finished() fires when every
+// controller has completed or been given up on.
+class StartupOrchestrator : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit StartupOrchestrator(ControllerManager* manager, QObject* parent = nullptr);
+
+    int maxConcurrent() const { return m_maxConcurrent; }
+    void setMaxConcurrent(int count);   // 0 = no limit
+
+    // Applies separately to becoming ready and, after that, to reaching full state
+    int readyTimeout() const { return m_readyTimeout; }
+    void setReadyTimeout(int timeoutMs);
+
+    void start(int fastPollMs, int slowPollMs);
+    bool isRunning() const { return m_running; }
+
+    int connectingCount() const { return m_connecting; }
+    QList<StartupMetrics> metrics() const;
+    StartupMetrics metrics(const QString& name) const { return m_entries.value(name).metrics; }
+
+signals:
+    void controllerStarted(const QString& name);
+    void controllerReady(const QString& name);
+    void controllerComplete(const QString& name, const StartupMetrics& metrics);
+    void finished();
+
+private slots:
+    void checkTimeouts();
+
+private:
+    enum class Stage { Queued, Connecting, Loading, Complete, Abandoned };
+
+    struct Entry {
+        StartupMetrics metrics;
+        Stage stage = Stage::Queued;
+        QSet<PropertyId> missing;   // properties without a value yet, once ready
+        QList<QMetaObject::Connection> connections;
+    };
+
+    void launchNext();
+    void launch(const QString& name);
+    void onReady(const QString& name);
+    void onData(const QString& name, PropertyId id);
+    void complete(Entry& entry);
+    void abandon(Entry& entry, const QString& reason);
+    void releaseSlot();
+    void checkFinished();
+
+    ControllerManager* m_manager;
+    int m_maxConcurrent;
+    int m_readyTimeout;
+
+    bool m_running;
+    int m_connecting;
+    QElapsedTimer m_clock;
+    QTimer* m_timeoutTimer;
+    QQueue<QString> m_queue;
+    QHash<QString, Entry> m_entries;
+    QStringList m_order;
+};
+
+} // namespace ObservatoryMonitor
+
+#endif // STARTUPORCHESTRATOR_H
@@ -0,0 +1,333 @@
+#include "TcpLx200Controller.h"
+#include "Logger.h"
+
+namespace ObservatoryMonitor {
+
+TcpLx200Controller::TcpLx200Controller(const ControllerConfig& config, double timeout, int reconnectInterval, QObject* parent)
+    : AbstractController(config.name, config.type, parent)
+    , m_socket(new QTcpSocket(this))
+    , m_poller(new ControllerPoller(config.name, config.type, this, this))
+    , m_host(config.host)
+    , m_port(static_cast<quint16>(config.port))
+    , m_commandTimeout(static_cast<int>(timeout * 1000))
+    , m_reconnectInterval(reconnectInterval * 1000)
+    , m_pipelineDepth(8)
+    , m_maxQueueSize(100)
+    , m_timeoutTimer(new QTimer(this))
+    , m_reconnectTimer(new QTimer(this))
+    , m_autoReconnect(true)
+    , m_status(ControllerStatus::Disconnected)
+{
+    m_clock.start();
+
+    m_timeoutTimer->setSingleShot(true);
+    m_reconnectTimer->setSingleShot(true);
+
+    QObject::connect(m_socket, &QTcpSocket::connected, this, &TcpLx200Controller::onConnected);
+    QObject::connect(m_socket, &QTcpSocket::disconnected, this, &TcpLx200Controller::onDisconnected);
+    QObject::connect(m_socket, &QTcpSocket::readyRead, this, &TcpLx200Controller::onReadyRead);
+    QObject::connect(m_socket, &QTcpSocket::errorOccurred, this, &TcpLx200Controller::onSocketError);
+    QObject::connect(m_timeoutTimer, &QTimer::timeout, this, &TcpLx200Controller::onCommandTimeout);
+    QObject::connect(m_reconnectTimer, &QTimer::timeout, this, &TcpLx200Controller::onReconnectTimer);
+    QObject::connect(m_poller, &ControllerPoller::dataUpdated, this, &TcpLx200Controller::onDataUpdated);
+}
+
+TcpLx200Controller::~TcpLx200Controller()
+{
+    // Outstanding callbacks are dropped; nobody is left to receive them
+    QObject::disconnect(m_socket, nullptr, this, nullptr);
+    m_socket->abort();
+    m_queue.clear();
+    m_inFlight.clear();
+}
+
+void TcpLx200Controller::connect()
+{
+    m_autoReconnect = true;
+    if (m_socket->state() != QAbstractSocket::UnconnectedState) {
+        return;
+    }
+
+    Logger::instance().info(QString("LX200[%1]: Connecting to %2:%3").arg(m_name, m_host).arg(m_port));
+    updateStatus(ControllerStatus::Connecting);
+    m_socket->connectToHost(m_host, m_port);
+}
+
+void TcpLx200Controller::disconnect()
+{
+    m_autoReconnect = false;
+    m_reconnectTimer->stop();
+
+    m_socket->abort();
+
+    failAll();
+    updateStatus(ControllerStatus::Disconnected);
+}
+
+void TcpLx200Controller::sendCommand(const QString& command, ResponseCallback callback)
+{
+    if (m_status != ControllerStatus::Connected) {
+        Logger::instance().error(QString("LX200[%1]: Cannot send command '%2' - not connected").arg(m_name, command));
+        if (callback) {
+            callback(command, "", false, -1);
+        }
+        return;
+    }
+
+    if (m_queue.size() >= m_maxQueueSize) {
+        Logger::instance().error(QString("LX200[%1]: Queue overflow - dropping command '%2'").arg(m_name, command));
+        if (callback) {
+            callback(command, "", false, -1);
+        }
+        return;
+    }
+
+    Command pending;
+    pending.command = command;
+    pending.callback = callback;
+    pending.kind = replyKind(command);
+    m_queue.enqueue(pending);
+
+    writeQueued();
+}
+
+void TcpLx200Controller::updateConfig(double timeout, int reconnectInterval)
+{
+    m_commandTimeout = static_cast<int>(timeout * 1000);
+    m_reconnectInterval = reconnectInterval * 1000;
+}
+
+void TcpLx200Controller::startPolling(int fastPollMs, int slowPollMs)
+{
+    m_poller->setFastPollInterval(fastPollMs);
+    m_poller->setSlowPollInterval(slowPollMs);
+    m_poller->startPolling();
+}
+
+void TcpLx200Controller::stopPolling()
+{
+    m_poller->stopPolling();
+}
+
+CachedValue TcpLx200Controller::getCachedValue(PropertyId id) const
+{
+    return m_poller->getCachedValue(id);
+}
+
+CachedValue TcpLx200Controller::getCachedValue(const QString& command) const
+{
+    return m_poller->getCachedValue(command);
+}
+
+QHash<QString, CachedValue> TcpLx200Controller::getAllCachedValues() const
+{
+    return m_poller->getAllCachedValues();
+}
+
+QVector<PropertyId> TcpLx200Controller::polledProperties() const
+{
+    return m_poller->polledProperties();
+}
+
+void TcpLx200Controller::setPipelineDepth(int depth)
+{
+    m_pipelineDepth = qMax(1, depth);
+    writeQueued();
+}
+
+TcpLx200Controller::ReplyKind TcpLx200Controller::replyKind(const QString& command)
+{
+    // Stop and manual-move commands are fire and forget. Note that :Ms#
+    // (move south) and :MS# (goto) differ only in case.
+    if (command.startsWith(":Q") || command == ":Mn#" || command == ":Ms#"
+        || command == ":Me#" || command == ":Mw#") {
+        return ReplyKind::None;
+    }
+    // Set commands answer a bare '0' or '1'
+    if (command.startsWith(":S")) {
+        return ReplyKind::SingleChar;
+    }
+    // Everything else is assumed '#'-terminated; a command that is not will
+    // stall the pipeline until the timeout resynchronizes the connection
+    return ReplyKind::Terminated;
+}
+
+void TcpLx200Controller::onConnected()
+{
+    // Polls are small and latency-bound: don't let Nagle hold them back
+    m_socket->setSocketOption(QAbstractSocket::LowDelayOption, 1);
+    m_socket->setSocketOption(QAbstractSocket::KeepAliveOption, 1);
+    m_buffer.clear();
+
+    Logger::instance().info(QString("LX200[%1]: Connected to %2:%3").arg(m_name, m_host).arg(m_port));
+    updateStatus(ControllerStatus::Connected);
+    emit ready();
+}
+
+void TcpLx200Controller::onDisconnected()
+{
+    Logger::instance().warning(QString("LX200[%1]: Disconnected").arg(m_name));
+
+    failAll();
+    updateStatus(ControllerStatus::Disconnected);
+
+    if (m_autoReconnect) {
+        Logger::instance().info(QString("LX200[%1]: Reconnecting in %2 seconds...").arg(m_name).arg(m_reconnectInterval / 1000));
+        m_reconnectTimer->start(m_reconnectInterval);
+    }
+}
+
+void TcpLx200Controller::onReadyRead()
+{
+    m_buffer += m_socket->readAll();
+
+    while (!m_inFlight.isEmpty()) {
+        if (m_inFlight.head().kind == ReplyKind::SingleChar) {
+            if (m_buffer.isEmpty()) break;
+            char reply = m_buffer.at(0);
+            m_buffer.remove(0, 1);
+            completeHead(QString(QLatin1Char(reply)), reply != '0');
+        } else {
+            qsizetype end = m_buffer.indexOf('#');
+            if (end < 0) break;
+            QString reply = QString::fromLatin1(m_buffer.constData(), end);
+            m_buffer.remove(0, end + 1);
+            completeHead(reply, true);
+        }
+    }
+
+    if (m_inFlight.isEmpty() && !m_buffer.isEmpty()) {
+        Logger::instance().debug(QString("LX200[%1]: Discarding %2 unexpected bytes").arg(m_name).arg(m_buffer.size()));
+        m_buffer.clear();
+    }
+
+    writeQueued();
+    armTimeout();
+}
+
+void TcpLx200Controller::onSocketError(QAbstractSocket::SocketError error)
+{
+    Q_UNUSED(error);
+    QString message = m_socket->errorString();
+    Logger::instance().error(QString("LX200[%1]: Socket error - %2").arg(m_name, message));
+    emit errorOccurred(message);
+
+    // A failed connect attempt never emits disconnected()
+    if (m_status == ControllerStatus::Connecting && m_socket->state() == QAbstractSocket::UnconnectedState) {
+        updateStatus(ControllerStatus::Disconnected);
+        if (m_autoReconnect) {
+            m_reconnectTimer->start(m_reconnectInterval);
+        }
+    }
+}
+
+void TcpLx200Controller::onCommandTimeout()
+{
+    if (m_inFlight.isEmpty()) {
+        return;
+    }
+
+    // Replies carry no command echo, so after a missing one every later reply
+    // would be attributed to the wrong command. Start over on a fresh connection.
+    Logger::instance().warning(QString("LX200[%1]: Command '%2' timed out, resynchronizing connection")
+                              .arg(m_name, m_inFlight.head().command));
+    failAll();
+    m_socket->abort();
+    if (m_autoReconnect) {
+        m_reconnectTimer->start(0);
+    }
+}
+
+void TcpLx200Controller::onReconnectTimer()
+{
+    Logger::instance().info(QString("LX200[%1]: Attempting reconnect...").arg(m_name));
+    connect();
+}
+
+void TcpLx200Controller::onDataUpdated(PropertyId id, const QString& value)
+{
+    emit dataUpdated(id, value);
+}
+
+void TcpLx200Controller::writeQueued()
+{
+    if (m_status != ControllerStatus::Connected) {
+        return;
+    }
+
+    // Everything that fits in the pipeline goes out in a single write
+    QByteArray out;
+    while (!m_queue.isEmpty() && m_inFlight.size() < m_pipelineDepth) {
+        Command pending = m_queue.dequeue();
+        out += pending.command.toLatin1();
+        pending.sentMs = m_clock.elapsed();
+
+        if (pending.kind == ReplyKind::None) {
+            if (pending.callback) {
+                pending.callback(pending.command, "", true, -1);
+            }
+            continue;
+        }
+
+        m_inFlight.enqueue(pending);
+        Logger::instance().debug(QString("LX200[%1]: Sent '%2' (%3 in flight)")
+                                .arg(m_name, pending.command)
+                                .arg(m_inFlight.size()));
+    }
+
+    if (!out.isEmpty()) {
+        m_socket->write(out);
+        armTimeout();
+    }
+}
+
+void TcpLx200Controller::completeHead(const QString& response, bool success)
+{
+    Command done = m_inFlight.dequeue();
+    Logger::instance().debug(QString("LX200[%1]: Command '%2' completed in %3 ms")
+                            .arg(m_name, done.command)
+                            .arg(m_clock.elapsed() - done.sentMs));
+    if (done.callback) {
+        done.callback(done.command, response, success, -1);
+    }
+}
+
+void TcpLx200Controller::armTimeout()
+{
+    if (m_inFlight.isEmpty()) {
+        m_timeoutTimer->stop();
+        return;
+    }
+
+    // Replies arrive in order, so only the oldest command can be overdue
+    qint64 remaining = m_inFlight.head().sentMs + m_commandTimeout - m_clock.elapsed();
+    m_timeoutTimer->start(static_cast<int>(qMax<qint64>(0, remaining)));
+}
+
+void TcpLx200Controller::failAll()
+{
+    m_timeoutTimer->stop();
+    m_buffer.clear();
+
+    // Callbacks may queue new commands; fail only what was outstanding
+    QQueue<Command> failed = m_inFlight;
+    failed += m_queue;
+    m_inFlight.clear();
+    m_queue.clear();
+
+    for (const Command& pending : failed) {
+        if (pending.callback) {
+            pending.callback(pending.command, "", false, -1);
+        }
+    }
+}
+
+void TcpLx200Controller::updateStatus(ControllerStatus status)
+{
+    if (m_status != status) {
+        m_status = status;
+        emit statusChanged(m_status);
+    }
+}
+
+} // namespace ObservatoryMonitor
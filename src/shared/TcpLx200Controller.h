@@ -0,0 +1,105 @@
+#ifndef TCPLX200CONTROLLER_H
+#define TCPLX200CONTROLLER_H
+
+#include <QTcpSocket>
+#include <QTimer>
+#include <QQueue>
+#include <QElapsedTimer>
+#include "AbstractController.h"
+#include "ControllerPoller.h"
+#include "Config.h"
+
+namespace ObservatoryMonitor {
+
+// Talks LX200 directly to the controller (OnStepX listens on port 9999),
+// bypassing the MQTT broker and bridge.
+//
+// The socket stays open; commands are written back-to-back without waiting
+// for the previous reply (up to pipelineDepth in flight) and replies are
+// matched to commands in order. Polling and caching are the same
+// ControllerPoller the MQTT backend uses.
+class TcpLx200Controller : public AbstractController
+{
+    Q_OBJECT
+
+public:
+    // How a command's reply is framed on the wire
+    enum class ReplyKind {
+        Terminated,   // text ending in '#' (all get commands)
+        SingleChar,   // '0' or '1' without terminator (set commands)
+        None          // no reply at all (:Q stop commands)
+    };
+
+    TcpLx200Controller(const ControllerConfig& config, double timeout, int reconnectInterval, QObject* parent = nullptr);
+    ~TcpLx200Controller() override;
+
+    ControllerStatus status() const override { return m_status; }
+
+    void connect() override;
+    void disconnect() override;
+
+    void sendCommand(const QString& command, ResponseCallback callback) override;
+
+    void updateConfig(double timeout, int reconnectInterval);
+
+    void startPolling(int fastPollMs, int slowPollMs) override;
+    void stopPolling() override;
+
+    CachedValue getCachedValue(PropertyId id) const override;
+    CachedValue getCachedValue(const QString& command) const override;
+    QHash<QString, CachedValue> getAllCachedValues() const override;
+    QVector<PropertyId> polledProperties() const override;
+
+    int pipelineDepth() const { return m_pipelineDepth; }
+    void setPipelineDepth(int depth);
+    int inFlightCount() const { return m_inFlight.size(); }
+    int queueSize() const { return m_queue.size(); }
+
+    static ReplyKind replyKind(const QString& command);
+
+private slots:
+    void onConnected();
+    void onDisconnected();
+    void onReadyRead();
+    void onSocketError(QAbstractSocket::SocketError error);
+    void onCommandTimeout();
+    void onReconnectTimer();
+    void onDataUpdated(PropertyId id, const QString& value);
+
+private:
+    struct Command {
+        QString command;
+        ResponseCallback callback;
+        ReplyKind kind = ReplyKind::Terminated;
+        qint64 sentMs = 0;
+    };
+
+    void writeQueued();
+    void completeHead(const QString& response, bool success);
+    void armTimeout();
+    void failAll();
+    void updateStatus(ControllerStatus status);
+
+    QTcpSocket* m_socket;
+    ControllerPoller* m_poller;
+    QString m_host;
+    quint16 m_port;
+    int m_commandTimeout;      // milliseconds
+    int m_reconnectInterval;   // milliseconds
+    int m_pipelineDepth;
+    int m_maxQueueSize;
+
+    QQueue<Command> m_queue;      // not yet written
+    QQueue<Command> m_inFlight;   // written, awaiting replies in order
+    QByteArray m_buffer;          // received bytes not yet matched to a reply
+
+    QTimer* m_timeoutTimer;
+    QTimer* m_reconnectTimer;
+    QElapsedTimer m_clock;
+    bool m_autoReconnect;
+    ControllerStatus m_status;
+};
+
+} // namespace ObservatoryMonitor
+
+#endif // TCPLX200CONTROLLER_H
@@ -0,0 +1,158 @@
+#include "TelemetryReader.h"
+#include <QDir>
+#include <algorithm>
+
+namespace ObservatoryMonitor {
+
+TelemetryReader::TelemetryReader(const QString& directory)
+    : m_directory(directory)
+{
+}
+
+QStringList TelemetryReader::segmentPaths(TelemetryTier tier, qint64 fromMs, qint64 toMs) const
+{
+    // Segment names sort chronologically, so a string range check selects them
+    QString first = TelemetryFormat::segmentName(tier, fromMs);
+    QString last = TelemetryFormat::segmentName(tier, toMs);
+
+    QDir tierDir(m_directory + "/" + TelemetryFormat::tierDirectory(tier));
+    QStringList paths;
+    const QStringList names = tierDir.entryList(QDir::Dirs | QDir::NoDotAndDotDot, QDir::Name);
+    for (const QString& name : names) {
+        if (name >= first && name <= last) {
+            paths << tierDir.filePath(name);
+        }
+    }
+    return paths;
+}
+
+QList<TelemetrySeriesInfo> TelemetryReader::listSeries(TelemetryTier tier, qint64 fromMs, qint64 toMs) const
+{
+    QList<TelemetrySeriesInfo> result;
+    for (const QString& path : segmentPaths(tier, fromMs, toMs)) {
+        TelemetrySegmentReader segment;
+        QString errorMessage;
+        if (!segment.open(path, errorMessage)) continue;
+
+        for (const auto& info : segment.series()) {
+            bool known = std::any_of(result.begin(), result.end(), [&](const TelemetrySeriesInfo& s) {
+                return s.controller == info.controller && s.command == info.command && s.kind == info.kind;
+            });
+            if (!known) result << info;
+        }
+    }
+    return result;
+}
+
+QList<TelemetrySample> TelemetryReader::readRaw(const QString& controller, const QString& command,
+                                                qint64 fromMs, qint64 toMs) const
+{
+    QList<TelemetrySample> result;
+
+    for (const QString& path : segmentPaths(TelemetryTier::Raw, fromMs, toMs)) {
+        TelemetrySegmentReader segment;
+        QString errorMessage;
+        if (!segment.open(path, errorMessage)) continue;
+
+        // A command may have both numeric and text series (e.g. an error string)
+        for (TelemetryValueKind kind : {TelemetryValueKind::Numeric, TelemetryValueKind::Text}) {
+            int id = segment.findSeries(controller, command, kind);
+            if (id < 0) continue;
+
+            QVector<qint64> timestamps = segment.timestamps(id);
+            qint64 count = 0;
+            const double* values = nullptr;
+            const quint32* codes = nullptr;
+            if (kind == TelemetryValueKind::Numeric) {
+                values = segment.doubleColumn(id, TelemetryFormat::ValueColumn, count);
+            } else {
+                codes = segment.uint32Column(id, TelemetryFormat::TextColumn, count);
+            }
+
+            qint64 rows = std::min<qint64>(count, timestamps.size());
+            for (qint64 i = 0; i < rows; ++i) {
+                if (timestamps[i] < fromMs || timestamps[i] > toMs) continue;
+
+                TelemetrySample sample;
+                sample.timestamp = timestamps[i];
+                sample.numeric = kind == TelemetryValueKind::Numeric;
+                if (sample.numeric) {
+                    sample.value = values[i];
+                    sample.text = QString::number(values[i], 'g', 17);
+                } else {
+                    sample.text = segment.string(codes[i]);
+                }
+                result << sample;
+            }
+        }
+    }
+
+    std::stable_sort(result.begin(), result.end(), [](const TelemetrySample& a, const TelemetrySample& b) {
+        return a.timestamp < b.timestamp;
+    });
+    return result;
+}
+
+QList<TelemetryAggregate> TelemetryReader::readMinutes(const QString& controller, const QString& command,
+                                                       qint64 fromMs, qint64 toMs) const
+{
+    QList<TelemetryAggregate> result;
+
+    for (const QString& path : segmentPaths(TelemetryTier::Minute, fromMs, toMs)) {
+        TelemetrySegmentReader segment;
+        QString errorMessage;
+        if (!segment.open(path, errorMessage)) continue;
+
+        for (TelemetryValueKind kind : {TelemetryValueKind::Numeric, TelemetryValueKind::Text}) {
+            int id = segment.findSeries(controller, command, kind);
+            if (id < 0) continue;
+
+            QVector<qint64> timestamps = segment.timestamps(id);
+            qint64 rows = timestamps.size();
+
+            qint64 count = 0;
+            const quint32* counts = segment.uint32Column(id, TelemetryFormat::CountColumn, count);
+            rows = std::min(rows, count);
+
+            const double* mins = nullptr;
+            const double* maxs = nullptr;
+            const double* means = nullptr;
+            const quint32* codes = nullptr;
+            if (kind == TelemetryValueKind::Numeric) {
+                mins = segment.doubleColumn(id, TelemetryFormat::MinColumn, count);
+                rows = std::min(rows, count);
+                maxs = segment.doubleColumn(id, TelemetryFormat::MaxColumn, count);
+                rows = std::min(rows, count);
+                means = segment.doubleColumn(id, TelemetryFormat::MeanColumn, count);
+                rows = std::min(rows, count);
+            } else {
+                codes = segment.uint32Column(id, TelemetryFormat::TextColumn, count);
+                rows = std::min(rows, count);
+            }
+
+            for (qint64 i = 0; i < rows; ++i) {
+                if (timestamps[i] < fromMs || timestamps[i] > toMs) continue;
+
+                TelemetryAggregate aggregate;
+                aggregate.timestamp = timestamps[i];
+                aggregate.numeric = kind == TelemetryValueKind::Numeric;
+                aggregate.count = counts[i];
+                if (aggregate.numeric) {
+                    aggregate.min = mins[i];
+                    aggregate.max = maxs[i];
+                    aggregate.mean = means[i];
+                } else {
+                    aggregate.last = segment.string(codes[i]);
+                }
+                result << aggregate;
+            }
+        }
+    }
+
+    std::stable_sort(result.begin(), result.end(), [](const TelemetryAggregate& a, const TelemetryAggregate& b) {
+        return a.timestamp < b.timestamp;
+    });
+    return result;
+}
+
+} // namespace ObservatoryMonitor
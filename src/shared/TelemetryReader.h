@@ -0,0 +1,50 @@
+#ifndef TELEMETRYREADER_H
+#define TELEMETRYREADER_H
+
+#include <QString>
+#include <QList>
+#include "TelemetrySegment.h"
+
+namespace ObservatoryMonitor {
+
+struct TelemetrySample {
+    qint64 timestamp = 0;   // ms since epoch
+    bool numeric = true;
+    double value = 0.0;     // numeric series
+    QString text;           // text series, and the original string for numeric ones
+};
+
+struct TelemetryAggregate {
+    qint64 timestamp = 0;   // start of the minute, ms since epoch
+    bool numeric = true;
+    double min = 0.0;
+    double max = 0.0;
+    double mean = 0.0;
+    quint32 count = 0;
+    QString last;           // text series only
+};
+
+// Query API over the segments written by TelemetryStore. Segments are
+// memory-mapped on demand; results are sorted by timestamp.
+class TelemetryReader
+{
+public:
+    explicit TelemetryReader(const QString& directory);
+
+    // All series ("controller" / "command" pairs) present in [fromMs, toMs]
+    QList<TelemetrySeriesInfo> listSeries(TelemetryTier tier, qint64 fromMs, qint64 toMs) const;
+
+    QList<TelemetrySample> readRaw(const QString& controller, const QString& command,
+                                   qint64 fromMs, qint64 toMs) const;
+    QList<TelemetryAggregate> readMinutes(const QString& controller, const QString& command,
+                                          qint64 fromMs, qint64 toMs) const;
+
+private:
+    QStringList segmentPaths(TelemetryTier tier, qint64 fromMs, qint64 toMs) const;
+
+    QString m_directory;
+};
+
+} // namespace ObservatoryMonitor
+
+#endif // TELEMETRYREADER_H
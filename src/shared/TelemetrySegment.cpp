@@ -0,0 +1,465 @@
+#include "TelemetrySegment.h"
+#include <QDir>
+#include <QFileInfo>
+#include <QDateTime>
+#include <QtEndian>
+
+namespace ObservatoryMonitor {
+
+namespace TelemetryFormat {
+
+QByteArray encodeVarint(qint64 value)
+{
+    // Zigzag so small negative deltas (clock steps backwards) stay short
+    quint64 zigzag = (static_cast<quint64>(value) << 1) ^ static_cast<quint64>(value >> 63);
+
+    QByteArray out;
+    do {
+        uchar byte = zigzag & 0x7F;
+        zigzag >>= 7;
+        if (zigzag) byte |= 0x80;
+        out.append(static_cast<char>(byte));
+    } while (zigzag);
+    return out;
+}
+
+bool decodeVarint(const uchar*& pos, const uchar* end, qint64& value)
+{
+    quint64 zigzag = 0;
+    int shift = 0;
+    while (pos < end && shift < 64) {
+        uchar byte = *pos++;
+        zigzag |= static_cast<quint64>(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) {
+            value = static_cast<qint64>(zigzag >> 1) ^ -static_cast<qint64>(zigzag & 1);
+            return true;
+        }
+        shift += 7;
+    }
+    return false;
+}
+
+int columnWidth(const QString& column)
+{
+    if (column == QLatin1String(TextColumn) || column == QLatin1String(CountColumn)) {
+        return sizeof(quint32);
+    }
+    if (column == QLatin1String(ValueColumn) || column == QLatin1String(MinColumn)
+        || column == QLatin1String(MaxColumn) || column == QLatin1String(MeanColumn)) {
+        return sizeof(double);
+    }
+    return 0;
+}
+
+QString segmentName(TelemetryTier tier, qint64 timestampMs)
+{
+    QDate date = QDateTime::fromMSecsSinceEpoch(timestampMs).toUTC().date();
+    return tier == TelemetryTier::Raw ? date.toString("yyyy-MM-dd") : date.toString("yyyy-MM");
+}
+
+QString tierDirectory(TelemetryTier tier)
+{
+    return tier == TelemetryTier::Raw ? "raw" : "minute";
+}
+
+} // namespace TelemetryFormat
+
+static QString kindToString(TelemetryValueKind kind)
+{
+    return kind == TelemetryValueKind::Numeric ? "numeric" : "text";
+}
+
+static QString seriesKey(const QString& controller, const QString& command, TelemetryValueKind kind)
+{
+    return controller + '\t' + command + '\t' + kindToString(kind);
+}
+
+static QString columnPath(const QString& dirPath, int seriesId, const char* column)
+{
+    return QString("%1/%2.%3").arg(dirPath).arg(seriesId).arg(QLatin1String(column));
+}
+
+// ---------------------------------------------------------------------------
+// TelemetrySegmentWriter
+// ---------------------------------------------------------------------------
+
+TelemetrySegmentWriter::~TelemetrySegmentWriter()
+{
+    close();
+}
+
+bool TelemetrySegmentWriter::open(const QString& dirPath, QString& errorMessage)
+{
+    close();
+
+    QDir dir;
+    if (!dir.mkpath(dirPath)) {
+        errorMessage = QString("Cannot create telemetry segment directory '%1'").arg(dirPath);
+        return false;
+    }
+
+    m_dirPath = dirPath;
+    loadIndex();
+    loadDictionary();
+
+    m_indexFile.setFileName(dirPath + "/" + TelemetryFormat::IndexFile);
+    if (!m_indexFile.open(QIODevice::WriteOnly | QIODevice::Append)) {
+        errorMessage = QString("Cannot open '%1': %2").arg(m_indexFile.fileName(), m_indexFile.errorString());
+        return false;
+    }
+    if (m_indexFile.size() == 0) {
+        m_indexFile.write(QString("# observatory-telemetry v%1\n").arg(TelemetryFormat::Version).toUtf8());
+    }
+
+    m_dictFile.setFileName(dirPath + "/" + TelemetryFormat::DictFile);
+    if (!m_dictFile.open(QIODevice::WriteOnly | QIODevice::Append)) {
+        errorMessage = QString("Cannot open '%1': %2").arg(m_dictFile.fileName(), m_dictFile.errorString());
+        m_indexFile.close();
+        return false;
+    }
+
+    m_open = true;
+    return true;
+}
+
+void TelemetrySegmentWriter::flush()
+{
+    if (!m_open) return;
+    m_indexFile.flush();
+    m_dictFile.flush();
+    for (QFile* file : m_columns) {
+        file->flush();
+    }
+}
+
+void TelemetrySegmentWriter::close()
+{
+    flush();
+    qDeleteAll(m_columns);
+    m_columns.clear();
+    m_indexFile.close();
+    m_dictFile.close();
+    m_seriesIds.clear();
+    m_stringCodes.clear();
+    m_lastTimestamps.clear();
+    m_repairedSeries.clear();
+    m_open = false;
+}
+
+int TelemetrySegmentWriter::seriesId(const QString& controller, const QString& command, TelemetryValueKind kind)
+{
+    QString key = seriesKey(controller, command, kind);
+    auto it = m_seriesIds.constFind(key);
+    if (it != m_seriesIds.constEnd()) {
+        return it.value();
+    }
+
+    int id = m_seriesIds.size();
+    m_seriesIds.insert(key, id);
+
+    QByteArray line = QByteArray::number(id) + '\t'
+                    + controller.toUtf8().toPercentEncoding() + '\t'
+                    + command.toUtf8().toPercentEncoding() + '\t'
+                    + kindToString(kind).toUtf8() + '\n';
+    m_indexFile.write(line);
+    return id;
+}
+
+quint32 TelemetrySegmentWriter::stringCode(const QString& text)
+{
+    auto it = m_stringCodes.constFind(text);
+    if (it != m_stringCodes.constEnd()) {
+        return it.value();
+    }
+
+    quint32 code = static_cast<quint32>(m_stringCodes.size());
+    m_stringCodes.insert(text, code);
+    m_dictFile.write(text.toUtf8().toPercentEncoding() + '\n');
+    return code;
+}
+
+void TelemetrySegmentWriter::appendTimestamp(int seriesId, qint64 timestampMs)
+{
+    QFile* file = columnFile(seriesId, TelemetryFormat::TimestampColumn);
+    if (!file) return;
+
+    qint64 last = m_lastTimestamps.value(seriesId, 0);
+    file->write(TelemetryFormat::encodeVarint(timestampMs - last));
+    m_lastTimestamps[seriesId] = timestampMs;
+}
+
+void TelemetrySegmentWriter::appendDouble(int seriesId, const char* column, double value)
+{
+    QFile* file = columnFile(seriesId, column);
+    if (!file) return;
+
+    quint64 bits;
+    memcpy(&bits, &value, sizeof(bits));
+    bits = qToLittleEndian(bits);
+    file->write(reinterpret_cast<const char*>(&bits), sizeof(bits));
+}
+
+void TelemetrySegmentWriter::appendUInt32(int seriesId, const char* column, quint32 value)
+{
+    QFile* file = columnFile(seriesId, column);
+    if (!file) return;
+
+    quint32 le = qToLittleEndian(value);
+    file->write(reinterpret_cast<const char*>(&le), sizeof(le));
+}
+
+QFile* TelemetrySegmentWriter::columnFile(int seriesId, const char* column)
+{
+    QString key = QString("%1.%2").arg(seriesId).arg(QLatin1String(column));
+    auto it = m_columns.constFind(key);
+    if (it != m_columns.constEnd()) {
+        return it.value();
+    }
+
+    // Re-opening an existing segment (e.g. restart on the same day)
+    if (!m_repairedSeries.contains(seriesId)) {
+        repairSeries(seriesId);
+        m_repairedSeries.insert(seriesId);
+    }
+
+    QFile* file = new QFile(columnPath(m_dirPath, seriesId, column));
+    if (!file->open(QIODevice::WriteOnly | QIODevice::Append)) {
+        delete file;
+        return nullptr;
+    }
+
+    m_columns.insert(key, file);
+    return file;
+}
+
+void TelemetrySegmentWriter::loadIndex()
+{
+    QFile file(m_dirPath + "/" + TelemetryFormat::IndexFile);
+    if (!file.open(QIODevice::ReadOnly)) return;
+
+    qint64 complete = 0;
+    while (!file.atEnd()) {
+        QByteArray line = file.readLine();
+        // Unterminated: cut short by a crash, like the dictionary's last line
+        if (!line.endsWith('\n')) break;
+        complete = file.pos();
+        line = line.trimmed();
+        if (line.isEmpty() || line.startsWith('#')) continue;
+
+        QList<QByteArray> fields = line.split('\t');
+        if (fields.size() != 4) continue;
+
+        TelemetryValueKind kind = fields[3] == "text" ? TelemetryValueKind::Text : TelemetryValueKind::Numeric;
+        QString controller = QString::fromUtf8(QByteArray::fromPercentEncoding(fields[1]));
+        QString command = QString::fromUtf8(QByteArray::fromPercentEncoding(fields[2]));
+        m_seriesIds.insert(seriesKey(controller, command, kind), fields[0].toInt());
+    }
+
+    if (complete < file.size()) {
+        file.close();
+        QFile::resize(m_dirPath + "/" + TelemetryFormat::IndexFile, complete);
+    }
+}
+
+void TelemetrySegmentWriter::loadDictionary()
+{
+    QFile file(m_dirPath + "/" + TelemetryFormat::DictFile);
+    if (!file.open(QIODevice::ReadOnly)) return;
+
+    quint32 code = 0;
+    qint64 complete = 0;
+    while (!file.atEnd()) {
+        QByteArray line = file.readLine();
+        // An unterminated last line is a string cut short by a crash
+        if (!line.endsWith('\n')) break;
+        complete = file.pos();
+        line.chop(1);
+        m_stringCodes.insert(QString::fromUtf8(QByteArray::fromPercentEncoding(line)), code++);
+    }
+
+    // Drop it, so the next string starts on a line of its own and keeps the
+    // code its line number gives it
+    if (complete < file.size()) {
+        file.close();
+        QFile::resize(m_dirPath + "/" + TelemetryFormat::DictFile, complete);
+    }
+}
+
+void TelemetrySegmentWriter::repairSeries(int seriesId)
+{
+    const QString tsPath = columnPath(m_dirPath, seriesId, TelemetryFormat::TimestampColumn);
+    const QStringList valueColumns = QDir(m_dirPath).entryList({QString("%1.*").arg(seriesId)}, QDir::Files);
+
+    // Where each complete timestamp ends, and its value
+    QVector<qint64> rowEnds;
+    QVector<qint64> timestamps;
+    QFile tsFile(tsPath);
+    if (tsFile.open(QIODevice::ReadOnly)) {
+        const QByteArray data = tsFile.readAll();
+        const uchar* begin = reinterpret_cast<const uchar*>(data.constData());
+        const uchar* pos = begin;
+        const uchar* end = begin + data.size();
+        qint64 timestamp = 0;
+        qint64 delta = 0;
+        while (TelemetryFormat::decodeVarint(pos, end, delta)) {
+            timestamp += delta;
+            timestamps.append(timestamp);
+            rowEnds.append(pos - begin);
+        }
+        tsFile.close();
+    }
+
+    qint64 rows = rowEnds.size();
+    for (const QString& name : valueColumns) {
+        const int width = TelemetryFormat::columnWidth(name.section('.', 1));
+        if (width > 0) {
+            rows = qMin(rows, QFileInfo(QDir(m_dirPath).filePath(name)).size() / width);
+        }
+    }
+
+    const qint64 tsLength = rows > 0 ? rowEnds[rows - 1] : 0;
+    if (QFileInfo(tsPath).size() > tsLength) {
+        QFile::resize(tsPath, tsLength);
+    }
+    for (const QString& name : valueColumns) {
+        const int width = TelemetryFormat::columnWidth(name.section('.', 1));
+        const QString path = QDir(m_dirPath).filePath(name);
+        if (width > 0 && QFileInfo(path).size() > rows * width) {
+            QFile::resize(path, rows * width);
+        }
+    }
+
+    // The next delta is relative to the last timestamp kept on disk
+    if (rows > 0) {
+        m_lastTimestamps[seriesId] = timestamps[rows - 1];
+    }
+}
+
+// ---------------------------------------------------------------------------
+// TelemetrySegmentReader
+// ---------------------------------------------------------------------------
+
+TelemetrySegmentReader::~TelemetrySegmentReader()
+{
+    close();
+}
+
+bool TelemetrySegmentReader::open(const QString& dirPath, QString& errorMessage)
+{
+    close();
+
+    QFile index(dirPath + "/" + TelemetryFormat::IndexFile);
+    if (!index.open(QIODevice::ReadOnly)) {
+        errorMessage = QString("Cannot open telemetry index '%1': %2").arg(index.fileName(), index.errorString());
+        return false;
+    }
+
+    m_dirPath = dirPath;
+
+    while (!index.atEnd()) {
+        QByteArray line = index.readLine().trimmed();
+        if (line.isEmpty() || line.startsWith('#')) continue;
+
+        QList<QByteArray> fields = line.split('\t');
+        if (fields.size() != 4) continue;
+
+        TelemetrySeriesInfo info;
+        info.id = fields[0].toInt();
+        info.controller = QString::fromUtf8(QByteArray::fromPercentEncoding(fields[1]));
+        info.command = QString::fromUtf8(QByteArray::fromPercentEncoding(fields[2]));
+        info.kind = fields[3] == "text" ? TelemetryValueKind::Text : TelemetryValueKind::Numeric;
+        m_series.append(info);
+    }
+
+    QFile dict(dirPath + "/" + TelemetryFormat::DictFile);
+    if (dict.open(QIODevice::ReadOnly)) {
+        while (!dict.atEnd()) {
+            QByteArray line = dict.readLine();
+            if (line.endsWith('\n')) line.chop(1);
+            m_strings.append(QString::fromUtf8(QByteArray::fromPercentEncoding(line)));
+        }
+    }
+
+    return true;
+}
+
+void TelemetrySegmentReader::close()
+{
+    // QFile unmaps on destruction
+    m_mapped.clear();
+    m_series.clear();
+    m_strings.clear();
+    m_dirPath.clear();
+}
+
+int TelemetrySegmentReader::findSeries(const QString& controller, const QString& command, TelemetryValueKind kind) const
+{
+    for (const auto& info : m_series) {
+        if (info.kind == kind && info.controller == controller && info.command == command) {
+            return info.id;
+        }
+    }
+    return -1;
+}
+
+QString TelemetrySegmentReader::string(quint32 code) const
+{
+    return code < static_cast<quint32>(m_strings.size()) ? m_strings.at(code) : QString();
+}
+
+QVector<qint64> TelemetrySegmentReader::timestamps(int seriesId) const
+{
+    QVector<qint64> result;
+    qint64 size = 0;
+    const uchar* data = mapColumn(seriesId, TelemetryFormat::TimestampColumn, size);
+    if (!data) return result;
+
+    const uchar* pos = data;
+    const uchar* end = data + size;
+    qint64 timestamp = 0;
+    qint64 delta = 0;
+    while (TelemetryFormat::decodeVarint(pos, end, delta)) {
+        timestamp += delta;
+        result.append(timestamp);
+    }
+    return result;
+}
+
+const double* TelemetrySegmentReader::doubleColumn(int seriesId, const char* column, qint64& count) const
+{
+    qint64 size = 0;
+    const uchar* data = mapColumn(seriesId, column, size);
+    count = size / static_cast<qint64>(sizeof(double));
+    // Columns are little-endian; every supported target (x86, ARM Pi) reads them in place
+    return reinterpret_cast<const double*>(data);
+}
+
+const quint32* TelemetrySegmentReader::uint32Column(int seriesId, const char* column, qint64& count) const
+{
+    qint64 size = 0;
+    const uchar* data = mapColumn(seriesId, column, size);
+    count = size / static_cast<qint64>(sizeof(quint32));
+    return reinterpret_cast<const quint32*>(data);
+}
+
+const uchar* TelemetrySegmentReader::mapColumn(int seriesId, const char* column, qint64& size) const
+{
+    QString path = columnPath(m_dirPath, seriesId, column);
+
+    auto it = m_mapped.constFind(path);
+    if (it == m_mapped.constEnd()) {
+        MappedColumn mapped;
+        mapped.file = std::make_shared<QFile>(path);
+        if (mapped.file->open(QIODevice::ReadOnly) && mapped.file->size() > 0) {
+            mapped.size = mapped.file->size();
+            mapped.data = mapped.file->map(0, mapped.size);
+            if (!mapped.data) mapped.size = 0;
+        }
+        it = m_mapped.insert(path, mapped);
+    }
+
+    size = it->size;
+    return it->data;
+}
+
+} // namespace ObservatoryMonitor
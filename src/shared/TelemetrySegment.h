@@ -0,0 +1,148 @@
+#ifndef TELEMETRYSEGMENT_H
+#define TELEMETRYSEGMENT_H
+
+#include <QString>
+#include <QStringList>
+#include <QHash>
+#include <QSet>
+#include <QVector>
+#include <QFile>
+#include <memory>
+
+namespace ObservatoryMonitor {
+
+// On-disk layout of one telemetry segment (one directory per day or month):
+//
+//   series.idx        text, one line per series: id, controller, command, kind
+//   strings.dict      text, one percent-encoded string per line (line number = code)
+//   <id>.ts           zigzag varint timestamp deltas (ms since epoch, first delta from 0)
+//   <id>.<column>     fixed-width little-endian values, one per timestamp
+//
+// Every file is append-only. Readers take the shortest column length as the
+// row count, which covers a crash that leaves the last row short. Before the
+// writer first appends to a series it cuts the series back to its last
+// complete row (a half-written timestamp varint, a value without its
+// timestamp), so a restart never appends after torn bytes and shifts rows.
+
+enum class TelemetryValueKind {
+    Numeric,  // float64 values
+    Text      // dictionary-coded strings (u32 codes)
+};
+
+enum class TelemetryTier {
+    Raw,     // 1 s resolution, daily segments
+    Minute   // 1 min aggregates, monthly segments
+};
+
+struct TelemetrySeriesInfo {
+    int id = -1;
+    QString controller;
+    QString command;
+    TelemetryValueKind kind = TelemetryValueKind::Numeric;
+};
+
+namespace TelemetryFormat {
+    constexpr int Version = 1;
+    const char* const IndexFile = "series.idx";
+    const char* const DictFile = "strings.dict";
+    const char* const TimestampColumn = "ts";
+
+    // Raw tier columns
+    const char* const ValueColumn = "f64";
+    const char* const TextColumn = "str";
+
+    // Minute tier columns
+    const char* const MinColumn = "min";
+    const char* const MaxColumn = "max";
+    const char* const MeanColumn = "avg";
+    const char* const CountColumn = "cnt";
+
+    QByteArray encodeVarint(qint64 value);
+    // Decodes one zigzag varint from [*pos, end). Returns false on truncation.
+    bool decodeVarint(const uchar*& pos, const uchar* end, qint64& value);
+
+    // Bytes per value in a fixed-width column; 0 for the timestamp column
+    // and unknown names
+    int columnWidth(const QString& column);
+
+    QString segmentName(TelemetryTier tier, qint64 timestampMs);
+    QString tierDirectory(TelemetryTier tier);
+}
+
+// Appends rows to one segment directory. Files are opened lazily and kept
+// open until close(); QFile buffering batches the small appends.
+class TelemetrySegmentWriter
+{
+public:
+    TelemetrySegmentWriter() = default;
+    ~TelemetrySegmentWriter();
+
+    bool open(const QString& dirPath, QString& errorMessage);
+    void flush();
+    void close();
+    bool isOpen() const { return m_open; }
+    QString path() const { return m_dirPath; }
+
+    int seriesId(const QString& controller, const QString& command, TelemetryValueKind kind);
+    quint32 stringCode(const QString& text);
+
+    void appendTimestamp(int seriesId, qint64 timestampMs);
+    void appendDouble(int seriesId, const char* column, double value);
+    void appendUInt32(int seriesId, const char* column, quint32 value);
+
+private:
+    QFile* columnFile(int seriesId, const char* column);
+    void loadIndex();
+    void loadDictionary();
+    // Truncates a series' files to the rows complete in all of them and
+    // recovers its last timestamp
+    void repairSeries(int seriesId);
+
+    QString m_dirPath;
+    bool m_open = false;
+
+    QFile m_indexFile;
+    QFile m_dictFile;
+    QHash<QString, int> m_seriesIds;          // "controller\tcommand\tkind" -> id
+    QHash<QString, quint32> m_stringCodes;
+    QHash<QString, QFile*> m_columns;         // "<id>.<column>" -> open file
+    QHash<int, qint64> m_lastTimestamps;
+    QSet<int> m_repairedSeries;
+};
+
+// Read-only, memory-mapped view of one segment directory.
+class TelemetrySegmentReader
+{
+public:
+    TelemetrySegmentReader() = default;
+    ~TelemetrySegmentReader();
+
+    bool open(const QString& dirPath, QString& errorMessage);
+    void close();
+
+    QList<TelemetrySeriesInfo> series() const { return m_series; }
+    int findSeries(const QString& controller, const QString& command, TelemetryValueKind kind) const;
+    QString string(quint32 code) const;
+
+    QVector<qint64> timestamps(int seriesId) const;
+    // Returns a pointer into the mapped column (nullptr if missing); count is in elements
+    const double* doubleColumn(int seriesId, const char* column, qint64& count) const;
+    const quint32* uint32Column(int seriesId, const char* column, qint64& count) const;
+
+private:
+    const uchar* mapColumn(int seriesId, const char* column, qint64& size) const;
+
+    QString m_dirPath;
+    QList<TelemetrySeriesInfo> m_series;
+    QStringList m_strings;
+    struct MappedColumn {
+        std::shared_ptr<QFile> file;
+        const uchar* data = nullptr;
+        qint64 size = 0;
+    };
+    mutable QHash<QString, MappedColumn> m_mapped;
+};
+
+} // namespace ObservatoryMonitor
+
+#endif // TELEMETRYSEGMENT_H
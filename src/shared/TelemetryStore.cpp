@@ -0,0 +1,247 @@
+#include "TelemetryStore.h"
+#include "Logger.h"
+#include <QDir>
+#include <QDateTime>
+#include <algorithm>
+
+namespace ObservatoryMonitor {
+
+TelemetryStore::TelemetryStore(QObject* parent)
+    : QObject(parent)
+    , m_flushTimer(new QTimer(this))
+{
+    // Completed seconds/minutes are written out and buffers flushed every 5 seconds
+    m_flushTimer->setInterval(5000);
+    connect(m_flushTimer, &QTimer::timeout, this, &TelemetryStore::flush);
+}
+
+TelemetryStore::~TelemetryStore()
+{
+    close();
+}
+
+bool TelemetryStore::open(const QString& directory, int rawRetentionDays, int minuteRetentionDays)
+{
+    close();
+
+    QDir dir;
+    if (!dir.mkpath(directory)) {
+        Logger::instance().error(QString("Telemetry: Cannot create directory %1").arg(directory));
+        return false;
+    }
+
+    m_directory = directory;
+    m_rawRetentionDays = rawRetentionDays;
+    m_minuteRetentionDays = minuteRetentionDays;
+    m_open = true;
+    m_flushTimer->start();
+
+    Logger::instance().info(QString("Telemetry: Recording to %1 (raw: %2 days, minute: %3 days)")
+                           .arg(directory)
+                           .arg(rawRetentionDays)
+                           .arg(minuteRetentionDays));
+    return true;
+}
+
+void TelemetryStore::close()
+{
+    if (!m_open) {
+        return;
+    }
+
+    m_flushTimer->stop();
+
+    // Partial seconds and minutes are written as-is on shutdown
+    for (auto it = m_series.begin(); it != m_series.end(); ++it) {
+        if (it->pending.second != -1) writeRaw(*it);
+        if (it->bucket.minute != -1) writeMinute(*it);
+    }
+
+    m_rawSegment.close();
+    m_minuteSegment.close();
+    m_rawSegmentName.clear();
+    m_minuteSegmentName.clear();
+    m_series.clear();
+    m_open = false;
+}
+
+void TelemetryStore::flush()
+{
+    if (!m_open) {
+        return;
+    }
+
+    qint64 now = QDateTime::currentMSecsSinceEpoch();
+    qint64 currentSecond = now / 1000;
+    qint64 currentMinute = now / 60000;
+
+    for (auto it = m_series.begin(); it != m_series.end(); ++it) {
+        if (it->pending.second != -1 && it->pending.second < currentSecond) {
+            writeRaw(*it);
+        }
+        if (it->bucket.minute != -1 && it->bucket.minute < currentMinute) {
+            writeMinute(*it);
+        }
+    }
+
+    m_rawSegment.flush();
+    m_minuteSegment.flush();
+}
+
+void TelemetryStore::record(const QString& controller, const QString& command, const QString& value)
+{
+    record(controller, command, value, QDateTime::currentMSecsSinceEpoch());
+}
+
+void TelemetryStore::record(const QString& controller, const QString& command, const QString& value, qint64 timestampMs)
+{
+    if (!m_open) {
+        return;
+    }
+
+    double numeric = 0.0;
+    TelemetryValueKind kind = parseNumeric(value, numeric) ? TelemetryValueKind::Numeric : TelemetryValueKind::Text;
+    SeriesState& state = series(controller, command, kind);
+
+    // Raw tier: last value wins within a second
+    qint64 second = timestampMs / 1000;
+    if (state.pending.second != -1 && state.pending.second != second) {
+        writeRaw(state);
+    }
+    state.pending.second = second;
+    state.pending.timestamp = timestampMs;
+    state.pending.value = numeric;
+    state.pending.text = value;
+
+    // Minute tier: running aggregate, written when the minute closes
+    qint64 minute = timestampMs / 60000;
+    if (state.bucket.minute != -1 && state.bucket.minute != minute) {
+        writeMinute(state);
+    }
+
+    MinuteBucket& bucket = state.bucket;
+    if (bucket.minute == -1) {
+        bucket.minute = minute;
+        bucket.min = numeric;
+        bucket.max = numeric;
+        bucket.sum = 0.0;
+        bucket.count = 0;
+    }
+    bucket.min = std::min(bucket.min, numeric);
+    bucket.max = std::max(bucket.max, numeric);
+    bucket.sum += numeric;
+    bucket.count++;
+    bucket.lastText = value;
+}
+
+TelemetryStore::SeriesState& TelemetryStore::series(const QString& controller, const QString& command, TelemetryValueKind kind)
+{
+    QString key = controller + '\t' + command + '\t' + QString::number(static_cast<int>(kind));
+    auto it = m_series.find(key);
+    if (it == m_series.end()) {
+        SeriesState state;
+        state.controller = controller;
+        state.command = command;
+        state.kind = kind;
+        it = m_series.insert(key, state);
+    }
+    return it.value();
+}
+
+void TelemetryStore::writeRaw(SeriesState& state)
+{
+    if (ensureSegment(TelemetryTier::Raw, state.pending.timestamp)) {
+        int id = m_rawSegment.seriesId(state.controller, state.command, state.kind);
+        m_rawSegment.appendTimestamp(id, state.pending.timestamp);
+        if (state.kind == TelemetryValueKind::Numeric) {
+            m_rawSegment.appendDouble(id, TelemetryFormat::ValueColumn, state.pending.value);
+        } else {
+            m_rawSegment.appendUInt32(id, TelemetryFormat::TextColumn, m_rawSegment.stringCode(state.pending.text));
+        }
+    }
+    state.pending = PendingSample();
+}
+
+void TelemetryStore::writeMinute(SeriesState& state)
+{
+    MinuteBucket& bucket = state.bucket;
+    qint64 minuteStart = bucket.minute * 60000;
+
+    if (ensureSegment(TelemetryTier::Minute, minuteStart)) {
+        int id = m_minuteSegment.seriesId(state.controller, state.command, state.kind);
+        m_minuteSegment.appendTimestamp(id, minuteStart);
+        if (state.kind == TelemetryValueKind::Numeric) {
+            m_minuteSegment.appendDouble(id, TelemetryFormat::MinColumn, bucket.min);
+            m_minuteSegment.appendDouble(id, TelemetryFormat::MaxColumn, bucket.max);
+            m_minuteSegment.appendDouble(id, TelemetryFormat::MeanColumn, bucket.sum / bucket.count);
+        } else {
+            m_minuteSegment.appendUInt32(id, TelemetryFormat::TextColumn, m_minuteSegment.stringCode(bucket.lastText));
+        }
+        m_minuteSegment.appendUInt32(id, TelemetryFormat::CountColumn, bucket.count);
+    }
+    state.bucket = MinuteBucket();
+}
+
+bool TelemetryStore::ensureSegment(TelemetryTier tier, qint64 timestampMs)
+{
+    TelemetrySegmentWriter& segment = tier == TelemetryTier::Raw ? m_rawSegment : m_minuteSegment;
+    QString& currentName = tier == TelemetryTier::Raw ? m_rawSegmentName : m_minuteSegmentName;
+
+    QString name = TelemetryFormat::segmentName(tier, timestampMs);
+    if (name == currentName && segment.isOpen()) {
+        return true;
+    }
+
+    QString path = m_directory + "/" + TelemetryFormat::tierDirectory(tier) + "/" + name;
+    QString errorMessage;
+    if (!segment.open(path, errorMessage)) {
+        Logger::instance().error(QString("Telemetry: %1").arg(errorMessage));
+        currentName.clear();
+        return false;
+    }
+
+    bool rolled = !currentName.isEmpty();
+    currentName = name;
+    if (rolled) {
+        Logger::instance().info(QString("Telemetry: Rolled %1 segment to %2")
+                               .arg(TelemetryFormat::tierDirectory(tier), name));
+    }
+    enforceRetention(tier, timestampMs);
+    return true;
+}
+
+void TelemetryStore::enforceRetention(TelemetryTier tier, qint64 nowMs)
+{
+    QDate today = QDateTime::fromMSecsSinceEpoch(nowMs).toUTC().date();
+    int retentionDays = tier == TelemetryTier::Raw ? m_rawRetentionDays : m_minuteRetentionDays;
+    QDate cutoff = today.addDays(-retentionDays);
+
+    QDir tierDir(m_directory + "/" + TelemetryFormat::tierDirectory(tier));
+    const QStringList segments = tierDir.entryList(QDir::Dirs | QDir::NoDotAndDotDot);
+    for (const QString& name : segments) {
+        // Monthly segments expire once their last day is past the cutoff
+        QDate lastDay = tier == TelemetryTier::Raw
+                      ? QDate::fromString(name, "yyyy-MM-dd")
+                      : QDate::fromString(name + "-01", "yyyy-MM-dd").addMonths(1).addDays(-1);
+        if (!lastDay.isValid() || lastDay >= cutoff) {
+            continue;
+        }
+
+        if (QDir(tierDir.filePath(name)).removeRecursively()) {
+            Logger::instance().info(QString("Telemetry: Removed expired %1 segment %2")
+                                   .arg(TelemetryFormat::tierDirectory(tier), name));
+        }
+    }
+}
+
+bool TelemetryStore::parseNumeric(const QString& value, double& result)
+{
+    QStringView view(value);
+    if (view.endsWith('#')) view.chop(1);
+
+    bool ok = false;
+    result = view.toDouble(&ok);
+    return ok;
+}
+
+} // namespace ObservatoryMonitor
@@ -0,0 +1,91 @@
+#ifndef TELEMETRYSTORE_H
+#define TELEMETRYSTORE_H
+
+#include <QObject>
+#include <QString>
+#include <QHash>
+#include <QTimer>
+#include "TelemetrySegment.h"
+
+namespace ObservatoryMonitor {
+
+// Persistent telemetry recorder fed from ControllerManager::controllerDataUpdated.
+//
+// Two tiers are maintained incrementally as samples arrive:
+//   raw/<yyyy-MM-dd>/   last value per series per second, rolled daily
+//   minute/<yyyy-MM>/   per-minute min/max/mean/count (last string for text series)
+// Old segments are deleted on roll according to the configured retention.
+class TelemetryStore : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit TelemetryStore(QObject* parent = nullptr);
+    ~TelemetryStore();
+
+    // rawRetentionDays: keep raw 1 s segments this many days
+    // minuteRetentionDays: keep 1 min aggregate segments this many days
+    bool open(const QString& directory, int rawRetentionDays = 7, int minuteRetentionDays = 365);
+    void close();
+    bool isOpen() const { return m_open; }
+    QString directory() const { return m_directory; }
+
+    // Write out every completed second and flush file buffers
+    void flush();
+
+    // Record with an explicit timestamp (ms since epoch); used by tests and replays
+    void record(const QString& controller, const QString& command, const QString& value, qint64 timestampMs);
+
+public slots:
+    void record(const QString& controller, const QString& command, const QString& value);
+
+private:
+    struct PendingSample {
+        qint64 second = -1;     // timestamp / 1000 of the pending sample
+        qint64 timestamp = 0;
+        double value = 0.0;
+        QString text;
+    };
+
+    struct MinuteBucket {
+        qint64 minute = -1;     // timestamp / 60000
+        double min = 0.0;
+        double max = 0.0;
+        double sum = 0.0;
+        quint32 count = 0;
+        QString lastText;
+    };
+
+    struct SeriesState {
+        QString controller;
+        QString command;
+        TelemetryValueKind kind = TelemetryValueKind::Numeric;
+        PendingSample pending;
+        MinuteBucket bucket;
+    };
+
+    SeriesState& series(const QString& controller, const QString& command, TelemetryValueKind kind);
+    void writeRaw(SeriesState& state);
+    void writeMinute(SeriesState& state);
+    bool ensureSegment(TelemetryTier tier, qint64 timestampMs);
+    void enforceRetention(TelemetryTier tier, qint64 nowMs);
+
+    static bool parseNumeric(const QString& value, double& result);
+
+    QString m_directory;
+    bool m_open = false;
+    int m_rawRetentionDays = 7;
+    int m_minuteRetentionDays = 365;
+
+    TelemetrySegmentWriter m_rawSegment;
+    TelemetrySegmentWriter m_minuteSegment;
+    QString m_rawSegmentName;
+    QString m_minuteSegmentName;
+
+    QHash<QString, SeriesState> m_series;
+    QTimer* m_flushTimer;
+};
+
+} // namespace ObservatoryMonitor
+
+#endif // TELEMETRYSTORE_H
@@ -0,0 +1,70 @@
+#include "UpdateBatcher.h"
+
+namespace ObservatoryMonitor {
+
+UpdateBatcher::UpdateBatcher(QObject* parent)
+    : QObject(parent)
+    , m_maxRate(0)
+    , m_timer(new QTimer(this))
+{
+    m_timer->setSingleShot(true);
+    m_timer->setTimerType(Qt::PreciseTimer);
+    connect(m_timer, &QTimer::timeout, this, &UpdateBatcher::flush);
+    setMaxRate(60);
+}
+
+void UpdateBatcher::setMaxRate(int hz)
+{
+    m_maxRate = qMax(0, hz);
+    if (m_maxRate > 0) {
+        m_timer->setInterval(1000 / m_maxRate);
+    } else {
+        flush();
+    }
+}
+
+void UpdateBatcher::post(PropertyId id, const QString& value)
+{
+    if (id < 0) return;
+
+    if (m_maxRate == 0) {
+        emit flushed(PropertyBatch{PropertyUpdate{id, value}});
+        return;
+    }
+
+    if (id >= m_values.size()) {
+        m_values.resize(id + 1);
+        m_isDirty.resize(id + 1, false);
+    }
+
+    m_values[id] = value;
+    if (!m_isDirty[id]) {
+        m_isDirty[id] = true;
+        m_dirty.append(id);
+    }
+
+    // The timer bounds latency when no frame flush happens
+    if (!m_timer->isActive()) {
+        m_timer->start();
+    }
+}
+
+void UpdateBatcher::flush()
+{
+    m_timer->stop();
+    if (m_dirty.isEmpty()) {
+        return;
+    }
+
+    PropertyBatch batch;
+    batch.reserve(m_dirty.size());
+    for (PropertyId id : std::as_const(m_dirty)) {
+        batch.append(PropertyUpdate{id, std::move(m_values[id])});
+        m_isDirty[id] = false;
+    }
+    m_dirty.clear();
+
+    emit flushed(batch);
+}
+
+} // namespace ObservatoryMonitor
@@ -0,0 +1,57 @@
+#ifndef UPDATEBATCHER_H
+#define UPDATEBATCHER_H
+
+#include <QObject>
+#include <QString>
+#include <QVector>
+#include <QTimer>
+#include "PropertyInterner.h"
+
+namespace ObservatoryMonitor {
+
+struct PropertyUpdate {
+    PropertyId id;
+    QString value;
+};
+
+using PropertyBatch = QVector<PropertyUpdate>;
+
+// Coalesces property updates between UI frames.
+//
+// Posted updates are held per PropertyId (last value wins) and delivered as
+// one batch, either when flush() is called - the application does this once
+// per rendered frame - or at most maxRate times per second from an internal
+// timer, so updates still arrive while nothing on screen is animating.
+// A maxRate of 0 delivers every update immediately.
+class UpdateBatcher : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit UpdateBatcher(QObject* parent = nullptr);
+
+    int maxRate() const { return m_maxRate; }
+    void setMaxRate(int hz);
+
+    void post(PropertyId id, const QString& value);
+    bool hasPending() const { return !m_dirty.isEmpty(); }
+
+public slots:
+    void flush();
+
+signals:
+    // Updates in order of first change since the last flush
+    void flushed(const PropertyBatch& batch);
+
+private:
+    int m_maxRate;
+    QTimer* m_timer;
+
+    QVector<QString> m_values;     // indexed by PropertyId
+    QVector<bool> m_isDirty;       // indexed by PropertyId
+    QVector<PropertyId> m_dirty;
+};
+
+} // namespace ObservatoryMonitor
+
+#endif // UPDATEBATCHER_H
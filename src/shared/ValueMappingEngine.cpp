@@ -1,15 +1,312 @@
 #include "ValueMappingEngine.h"
-#include <QRegularExpression>
+#include "MappingKernels.h"
+#include <QtNumeric>
 #include <algorithm>
+#include <cmath>
+#include <type_traits>
 
 namespace ObservatoryMonitor {
 
+CompiledMapping::CompiledMapping(const MappingDefinition& definition)
+    : m_trueValue(definition.trueValue)
+    , m_falseValue(definition.falseValue)
+{
+    const QString& type = definition.type;
+    if (type == "linear" || type == "clamped" || type == "angle") {
+        double span = definition.inMax - definition.inMin;
+        if (std::abs(span) < 1e-9) {
+            // Degenerate input range: everything maps to outMin
+            m_slope = 0.0;
+            m_offset = definition.outMin;
+        } else {
+            // Inverse mappings (e.g. 0-360 -> 0- -360) just get a negative slope
+            m_slope = (definition.outMax - definition.outMin) / span;
+            m_offset = definition.outMin - m_slope * definition.inMin;
+        }
+
+        m_kind = Kind::Linear;
+        if (type == "clamped") {
+            m_kind = Kind::Clamped;
+            m_lower = std::min(definition.outMin, definition.outMax);
+            m_upper = std::max(definition.outMin, definition.outMax);
+        } else if (type == "angle" && definition.period > 0.0) {
+            m_kind = Kind::Angle;
+            m_period = definition.period;
+            m_wrapOrigin = definition.wrapOrigin;
+            m_unwrap = definition.unwrap;
+        }
+    } else if (type == "lut") {
+        QVector<QPointF> points = definition.points;
+        std::stable_sort(points.begin(), points.end(),
+                         [](const QPointF& a, const QPointF& b) { return a.x() < b.x(); });
+        for (const QPointF& point : points) {
+            // A repeated input keeps its first output
+            if (!m_xs.isEmpty() && point.x() <= m_xs.last()) continue;
+            m_xs.append(point.x());
+            m_ys.append(point.y());
+        }
+
+        if (m_xs.size() >= 2) {
+            m_kind = Kind::Lookup;
+            m_step = (m_xs.last() - m_xs.first()) / (m_xs.size() - 1);
+            m_uniform = true;
+            for (qsizetype i = 1; i < m_xs.size() - 1; ++i) {
+                if (std::abs(m_xs[i] - (m_xs.first() + i * m_step)) > 1e-9 * m_step) {
+                    m_uniform = false;
+                    break;
+                }
+            }
+            if (m_uniform) {
+                m_ysFloat.reserve(m_ys.size());
+                for (double y : m_ys) m_ysFloat.append(float(y));
+            }
+        }
+    } else if (type == "polynomial") {
+        if (!definition.coefficients.isEmpty()) {
+            m_kind = Kind::Polynomial;
+            m_coefficients = definition.coefficients;
+        }
+    } else if (type == "binary") {
+        m_kind = Kind::Binary;
+        if (!definition.truePattern.isEmpty()) {
+            m_pattern = QRegularExpression(definition.truePattern, QRegularExpression::CaseInsensitiveOption);
+            m_pattern.optimize();
+            m_hasPattern = true;
+        }
+    }
+}
+
+QVariant CompiledMapping::map(const QVariant& input) const
+{
+    return map(input, QVariant());
+}
+
+QVariant CompiledMapping::map(const QVariant& input, const QVariant& previous) const
+{
+    switch (m_kind) {
+        case Kind::Linear:
+        case Kind::Clamped:
+        case Kind::Angle:
+        case Kind::Lookup:
+        case Kind::Polynomial: {
+            bool ok;
+            double val = input.toDouble(&ok);
+            if (!ok) return input;
+            double last = previous.toDouble(&ok);
+            return mapNumber(val, ok ? last : qQNaN());
+        }
+        case Kind::Binary:
+            return mapBoolean(input.toString()) ? m_trueValue : m_falseValue;
+        case Kind::Identity:
+            break;
+    }
+    return input;
+}
+
+double CompiledMapping::mapNumber(double value) const
+{
+    switch (m_kind) {
+        case Kind::Linear:
+            return value * m_slope + m_offset;
+        case Kind::Clamped: {
+            // Same comparisons as the batch kernel, so NaN passes through
+            double v = value * m_slope + m_offset;
+            v = v < m_lower ? m_lower : v;
+            return v > m_upper ? m_upper : v;
+        }
+        case Kind::Angle: {
+            double v = value * m_slope + m_offset;
+            MappingKernels::wrap(&v, &v, 1, m_wrapOrigin, m_period);
+            return v;
+        }
+        case Kind::Lookup:
+            return lookup(value);
+        case Kind::Polynomial:
+            return polynomial(value);
+        case Kind::Binary:
+        case Kind::Identity:
+            break;
+    }
+    return value;
+}
+
+double CompiledMapping::mapNumber(double value, double previous) const
+{
+    double mapped = mapNumber(value);
+    if (m_kind == Kind::Angle && m_unwrap) {
+        return nearestTurn(mapped, previous);
+    }
+    return mapped;
+}
+
+double CompiledMapping::lookup(double value) const
+{
+    if (m_uniform) {
+        double out;
+        MappingKernels::lookup(&value, &out, 1, m_ys.constData(), m_ys.size(), m_xs.first(), m_step);
+        return out;
+    }
+
+    // Written so NaN lands on the first entry, as in the uniform kernel
+    if (!(value > m_xs.first())) return m_ys.first();
+    if (value >= m_xs.last()) return m_ys.last();
+
+    qsizetype j = std::upper_bound(m_xs.cbegin(), m_xs.cend(), value) - m_xs.cbegin() - 1;
+    double t = (value - m_xs[j]) / (m_xs[j + 1] - m_xs[j]);
+    return m_ys[j] + (m_ys[j + 1] - m_ys[j]) * t;
+}
+
+double CompiledMapping::polynomial(double value) const
+{
+    double result = 0.0;
+    for (qsizetype i = m_coefficients.size() - 1; i >= 0; --i) {
+        result = result * value + m_coefficients[i];
+    }
+    return result;
+}
+
+double CompiledMapping::nearestTurn(double wrapped, double previous) const
+{
+    if (!std::isfinite(previous) || !std::isfinite(wrapped)) {
+        return wrapped;
+    }
+    return wrapped + m_period * std::round((previous - wrapped) / m_period);
+}
+
+bool CompiledMapping::mapBoolean(const QString& input) const
+{
+    if (m_hasPattern) {
+        return m_pattern.match(input).hasMatch();
+    }
+
+    // Default binary detection: 1, true, open, yes
+    static const QStringList truthy = {"1", "true", "open", "yes", "on", "connected"};
+    return truthy.contains(input, Qt::CaseInsensitive);
+}
+
+template <typename T>
+void CompiledMapping::mapSamplesImpl(const T* in, T* out, qsizetype n) const
+{
+    switch (m_kind) {
+        case Kind::Linear:
+            MappingKernels::linear(in, out, n, T(m_slope), T(m_offset));
+            return;
+        case Kind::Clamped:
+            MappingKernels::linear(in, out, n, T(m_slope), T(m_offset));
+            MappingKernels::clamp(out, out, n, T(m_lower), T(m_upper));
+            return;
+        case Kind::Angle:
+            MappingKernels::linear(in, out, n, T(m_slope), T(m_offset));
+            MappingKernels::wrap(out, out, n, T(m_wrapOrigin), T(m_period));
+            if (m_unwrap) {
+                // Inherently sequential; each sample continues from the last
+                for (qsizetype i = 1; i < n; ++i) {
+                    out[i] = T(nearestTurn(out[i], out[i - 1]));
+                }
+            }
+            return;
+        case Kind::Lookup:
+            if (m_uniform) {
+                const T* table;
+                if constexpr (std::is_same_v<T, float>) {
+                    table = m_ysFloat.constData();
+                } else {
+                    table = m_ys.constData();
+                }
+                MappingKernels::lookup(in, out, n, table, m_ys.size(), T(m_xs.first()), T(m_step));
+            } else {
+                for (qsizetype i = 0; i < n; ++i) {
+                    out[i] = T(lookup(in[i]));
+                }
+            }
+            return;
+        case Kind::Polynomial:
+            for (qsizetype i = 0; i < n; ++i) {
+                out[i] = T(polynomial(in[i]));
+            }
+            return;
+        case Kind::Binary:
+        case Kind::Identity:
+            break;
+    }
+    if (in != out) {
+        std::copy_n(in, n, out);
+    }
+}
+
+void CompiledMapping::mapSamples(const double* in, double* out, qsizetype n) const
+{
+    mapSamplesImpl(in, out, n);
+}
+
+void CompiledMapping::mapSamples(const float* in, float* out, qsizetype n) const
+{
+    mapSamplesImpl(in, out, n);
+}
+
 ValueMappingEngine::ValueMappingEngine(QObject* parent)
     : QObject(parent)
 {
+    // Handle 0 is the identity mapping
+    m_compiled.append(CompiledMapping());
+    m_handles.insert(mappingKey(MappingDefinition()), 0);
+}
+
+int ValueMappingEngine::compile(const QVariantMap& mapping)
+{
+    MappingDefinition definition = definitionFromVariant(mapping);
+    QString key = mappingKey(definition);
+
+    auto it = m_handles.constFind(key);
+    if (it != m_handles.constEnd()) {
+        return it.value();
+    }
+
+    int handle = m_compiled.size();
+    m_compiled.append(CompiledMapping(definition));
+    m_handles.insert(key, handle);
+    return handle;
+}
+
+QVariant ValueMappingEngine::mapWith(int handle, const QVariant& input) const
+{
+    return mapping(handle).map(input);
+}
+
+QVariant ValueMappingEngine::mapFrom(int handle, const QVariant& input, const QVariant& previous) const
+{
+    return mapping(handle).map(input, previous);
+}
+
+const CompiledMapping& ValueMappingEngine::mapping(int handle) const
+{
+    if (handle < 0 || handle >= m_compiled.size()) {
+        return m_compiled.first();
+    }
+    return m_compiled[handle];
+}
+
+void ValueMappingEngine::mapSamples(int handle, const double* in, double* out, qsizetype n) const
+{
+    mapping(handle).mapSamples(in, out, n);
+}
+
+void ValueMappingEngine::mapSamples(int handle, const float* in, float* out, qsizetype n) const
+{
+    mapping(handle).mapSamples(in, out, n);
 }
 
 QVariant ValueMappingEngine::mapValue(const QVariant& input, const QVariantMap& mapping)
+{
+    return mapValueInternal(input, definitionFromVariant(mapping));
+}
+
+QVariant ValueMappingEngine::mapValueInternal(const QVariant& input, const MappingDefinition& mapping)
+{
+    return CompiledMapping(mapping).map(input);
+}
+
+MappingDefinition ValueMappingEngine::definitionFromVariant(const QVariantMap& mapping)
 {
     MappingDefinition def;
     def.type = mapping.value("type").toString();
@@ -17,51 +314,84 @@ QVariant ValueMappingEngine::mapValue(const QVariant& input, const QVariantMap&
     def.inMax = mapping.value("in_max", 1.0).toDouble();
     def.outMin = mapping.value("out_min", 0.0).toDouble();
     def.outMax = mapping.value("out_max", 1.0).toDouble();
+    def.period = mapping.value("period", 360.0).toDouble();
+    def.wrapOrigin = mapping.value("origin", 0.0).toDouble();
+    def.unwrap = mapping.value("unwrap", false).toBool();
+    for (const QVariant& point : mapping.value("points").toList()) {
+        QVariantList pair = point.toList();
+        if (pair.size() == 2) {
+            def.points.append(QPointF(pair[0].toDouble(), pair[1].toDouble()));
+        }
+    }
+    for (const QVariant& coefficient : mapping.value("coefficients").toList()) {
+        def.coefficients.append(coefficient.toDouble());
+    }
     def.truePattern = mapping.value("true_pattern").toString();
-    
-    return mapValueInternal(input, def);
+    return def;
 }
 
-QVariant ValueMappingEngine::mapValueInternal(const QVariant& input, const MappingDefinition& mapping)
+QVariantMap ValueMappingEngine::definitionToVariant(const MappingDefinition& definition)
 {
-    if (mapping.type == "none" || mapping.type.isEmpty()) return input;
-    
-    if (mapping.type == "linear") {
-        bool ok;
-        double val = input.toDouble(&ok);
-        if (!ok) return input;
-        return mapLinear(val, mapping.inMin, mapping.inMax, mapping.outMin, mapping.outMax);
-    }
-    
-    if (mapping.type == "binary") {
-        QString str = input.toString();
-        bool isTrue = false;
-        
-        if (!mapping.truePattern.isEmpty()) {
-            QRegularExpression re(mapping.truePattern, QRegularExpression::CaseInsensitiveOption);
-            isTrue = re.match(str).hasMatch();
-        } else {
-            // Default binary detection: 1, true, open, yes
-            static const QStringList truthy = {"1", "true", "open", "yes", "on", "connected"};
-            isTrue = truthy.contains(str.toLower());
-        }
-        
-        return isTrue ? mapping.trueValue : mapping.falseValue;
+    QVariantMap mapping;
+    mapping["type"] = definition.type;
+    mapping["in_min"] = definition.inMin;
+    mapping["in_max"] = definition.inMax;
+    mapping["out_min"] = definition.outMin;
+    mapping["out_max"] = definition.outMax;
+    mapping["period"] = definition.period;
+    mapping["origin"] = definition.wrapOrigin;
+    mapping["unwrap"] = definition.unwrap;
+
+    QVariantList points;
+    for (const QPointF& point : definition.points) {
+        points.append(QVariant(QVariantList{point.x(), point.y()}));
     }
-    
-    return input;
+    mapping["points"] = points;
+
+    QVariantList coefficients;
+    for (double coefficient : definition.coefficients) {
+        coefficients.append(coefficient);
+    }
+    mapping["coefficients"] = coefficients;
+
+    mapping["true_pattern"] = definition.truePattern;
+    return mapping;
 }
 
-double ValueMappingEngine::mapLinear(double value, double inMin, double inMax, double outMin, double outMax)
+QString ValueMappingEngine::mappingKey(const MappingDefinition& definition)
 {
-    if (std::abs(inMax - inMin) < 1e-9) return outMin;
-    double clamped = std::max(std::min(inMin, inMax), std::min(std::max(inMin, inMax), value));
-    
-    // Support inverse mapping (e.g. 0-360 -> 0- -360)
-    double t = (value - inMin) / (inMax - inMin);
-    // We don't necessarily want to clamp 't' if we want to support values outside range, 
-    // but for now let's keep it simple.
-    return t * (outMax - outMin) + outMin;
+    // Only the fields the kind actually uses, so e.g. all identity mappings
+    // share one handle
+    auto number = [](double value) { return QString::number(value, 'g', 17); };
+    const QString& type = definition.type;
+
+    if (type == "linear" || type == "clamped" || type == "angle") {
+        QString key = QString("%1|%2|%3|%4|%5").arg(type, number(definition.inMin), number(definition.inMax),
+                                                      number(definition.outMin), number(definition.outMax));
+        if (type == "angle") {
+            key += QString("|%1|%2|%3").arg(number(definition.period), number(definition.wrapOrigin),
+                                             definition.unwrap ? "unwrap" : "wrap");
+        }
+        return key;
+    }
+    if (type == "lut") {
+        QString key = "lut";
+        for (const QPointF& point : definition.points) {
+            key += QString("|%1,%2").arg(number(point.x()), number(point.y()));
+        }
+        return key;
+    }
+    if (type == "polynomial") {
+        QString key = "polynomial";
+        for (double coefficient : definition.coefficients) {
+            key += "|" + number(coefficient);
+        }
+        return key;
+    }
+    if (type == "binary") {
+        return "binary|" + definition.truePattern;
+    }
+    return "none";
 }
 
 } // namespace ObservatoryMonitor
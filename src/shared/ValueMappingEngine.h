@@ -4,36 +4,137 @@
 #include <QString>
 #include <QVariant>
 #include <QObject>
+#include <QHash>
+#include <QVector>
+#include <QRegularExpression>
+#include <QPointF>
 
 namespace ObservatoryMonitor {
 
 struct MappingDefinition {
-    QString type; // "linear", "binary", "none"
-    
-    // Linear mapping
+    QString type; // "linear", "clamped", "angle", "lut", "polynomial", "binary", "none"
+
+    // Linear mapping; also the scaling step of "clamped" (output held
+    // within [outMin, outMax]) and "angle"
     double inMin = 0.0;
     double inMax = 1.0;
     double outMin = 0.0;
     double outMax = 1.0;
-    
+
+    // Angle mapping: output wrapped into [wrapOrigin, wrapOrigin + period).
+    // With unwrap, the output instead takes whichever turn is nearest the
+    // previous output, so 359 -> 0 continues to 360.
+    double period = 360.0;
+    double wrapOrigin = 0.0;
+    bool unwrap = false;
+
+    // Lookup table: (input, output) points, interpolated linearly and held
+    // at the end values outside their range
+    QVector<QPointF> points;
+
+    // Polynomial: coefficients[i] multiplies input^i
+    QVector<double> coefficients;
+
     // Binary mapping
     QVariant trueValue = true;
     QVariant falseValue = false;
     QString truePattern; // regex or string match
 };
 
+// A MappingDefinition prepared once for repeated use: the linear transform
+// is reduced to slope and offset, lookup tables are sorted (and flagged when
+// evenly spaced, so lookups index instead of searching) and the binary
+// pattern is compiled up front. Immutable after construction, so handles can
+// be shared; continuity state for unwrapped angles is passed in by the
+// caller.
+class CompiledMapping
+{
+public:
+    enum class Kind { Identity, Linear, Clamped, Angle, Lookup, Polynomial, Binary };
+
+    CompiledMapping() = default;
+    explicit CompiledMapping(const MappingDefinition& definition);
+
+    Kind kind() const { return m_kind; }
+
+    QVariant map(const QVariant& input) const;
+    // previous is the last output for this consumer (invalid if none);
+    // only unwrapped angles use it
+    QVariant map(const QVariant& input, const QVariant& previous) const;
+    // Numeric path for numeric kinds; other kinds pass the value through
+    double mapNumber(double value) const;
+    double mapNumber(double value, double previous) const;
+    bool mapBoolean(const QString& input) const;
+
+    // Batch path for sample arrays (trend charts): maps n values from in to
+    // out, which may be the same buffer. Unwrapped angles are made
+    // continuous along the array. Non-numeric kinds copy the input.
+    void mapSamples(const double* in, double* out, qsizetype n) const;
+    void mapSamples(const float* in, float* out, qsizetype n) const;
+
+private:
+    template <typename T>
+    void mapSamplesImpl(const T* in, T* out, qsizetype n) const;
+    double lookup(double value) const;
+    double polynomial(double value) const;
+    double nearestTurn(double wrapped, double previous) const;
+
+    Kind m_kind = Kind::Identity;
+    double m_slope = 1.0;
+    double m_offset = 0.0;
+    double m_lower = 0.0;                 // clamped output range
+    double m_upper = 0.0;
+    double m_period = 360.0;
+    double m_wrapOrigin = 0.0;
+    bool m_unwrap = false;
+    QVector<double> m_xs;                 // lookup inputs, ascending
+    QVector<double> m_ys;
+    QVector<float> m_ysFloat;             // for the float batch path
+    bool m_uniform = false;               // m_xs evenly spaced
+    double m_step = 0.0;
+    QVector<double> m_coefficients;
+    QRegularExpression m_pattern;
+    bool m_hasPattern = false;
+    QVariant m_trueValue = true;
+    QVariant m_falseValue = false;
+};
+
 class ValueMappingEngine : public QObject
 {
     Q_OBJECT
 public:
     explicit ValueMappingEngine(QObject* parent = nullptr);
 
+    // Compiles a mapping (as found in layout variants) and returns a handle
+    // for mapWith(). Identical mappings share a handle, so calling this from
+    // a binding on every layout change doesn't grow the table.
+    Q_INVOKABLE int compile(const QVariantMap& mapping);
+    Q_INVOKABLE QVariant mapWith(int handle, const QVariant& input) const;
+    // As mapWith(), continuing from the consumer's previous output (pass
+    // undefined for the first sample); keeps unwrapped angles continuous
+    Q_INVOKABLE QVariant mapFrom(int handle, const QVariant& input, const QVariant& previous) const;
+
+    // Unknown handles map as identity
+    const CompiledMapping& mapping(int handle) const;
+
+    // Maps a whole column through a handle; see CompiledMapping::mapSamples
+    void mapSamples(int handle, const double* in, double* out, qsizetype n) const;
+    void mapSamples(int handle, const float* in, float* out, qsizetype n) const;
+
+    // One-off mapping; compiles on every call, prefer compile() + mapWith()
     Q_INVOKABLE QVariant mapValue(const QVariant& input, const QVariantMap& mapping);
-    
+
     static QVariant mapValueInternal(const QVariant& input, const MappingDefinition& mapping);
-    
+    // Conversions to and from the snake_case maps used in layout variants
+    // and YAML (in_min, period, points: [[in, out], ...], coefficients, ...)
+    static MappingDefinition definitionFromVariant(const QVariantMap& mapping);
+    static QVariantMap definitionToVariant(const MappingDefinition& definition);
+
 private:
-    static double mapLinear(double value, double inMin, double inMax, double outMin, double outMax);
+    static QString mappingKey(const MappingDefinition& definition);
+
+    QVector<CompiledMapping> m_compiled;   // indexed by handle
+    QHash<QString, int> m_handles;         // mappingKey -> handle
 };
 
 } // namespace ObservatoryMonitor
@@ -0,0 +1,88 @@
+#include "WidgetListModel.h"
+#include "LayoutConfig.h"
+
+namespace ObservatoryMonitor {
+
+WidgetListModel::WidgetListModel(const QList<WidgetConfig>& widgets, QObject* parent)
+    : QAbstractListModel(parent)
+    , m_widgets(widgets)
+{
+}
+
+int WidgetListModel::rowCount(const QModelIndex& parent) const
+{
+    if (parent.isValid())
+        return 0;
+    return m_widgets.count();
+}
+
+QVariant WidgetListModel::data(const QModelIndex& index, int role) const
+{
+    if (!index.isValid() || index.row() >= m_widgets.count())
+        return QVariant();
+
+    const WidgetConfig& w = m_widgets.at(index.row());
+
+    switch (role) {
+    case WidgetIdRole:
+        return w.id;
+    case WidgetTypeRole:
+        return w.type;
+    case LabelRole:
+        return w.label;
+    case PosXRole:
+        return w.x;
+    case PosYRole:
+        return w.y;
+    case PropertyLinkRole:
+        return w.propertyLink;
+    case MappingRole:
+        return ValueMappingEngine::definitionToVariant(w.mapping);
+    case ConfigRole:
+        return LayoutConfig::widgetToVariant(w);
+    default:
+        return QVariant();
+    }
+}
+
+QHash<int, QByteArray> WidgetListModel::roleNames() const
+{
+    QHash<int, QByteArray> roles;
+    roles[WidgetIdRole] = "widgetId";
+    roles[WidgetTypeRole] = "widgetType";
+    roles[LabelRole] = "label";
+    roles[PosXRole] = "posX";
+    roles[PosYRole] = "posY";
+    roles[PropertyLinkRole] = "propertyLink";
+    roles[MappingRole] = "mapping";
+    roles[ConfigRole] = "config";
+    return roles;
+}
+
+int WidgetListModel::rowOf(const QString& widgetId) const
+{
+    for (int i = 0; i < m_widgets.count(); ++i) {
+        if (m_widgets.at(i).id == widgetId)
+            return i;
+    }
+    return -1;
+}
+
+QList<int> WidgetListModel::changedRoles(const WidgetConfig& before, const WidgetConfig& after)
+{
+    QList<int> roles;
+    if (before.id != after.id) roles << WidgetIdRole;
+    if (before.type != after.type) roles << WidgetTypeRole;
+    if (before.label != after.label) roles << LabelRole;
+    if (before.x != after.x) roles << PosXRole;
+    if (before.y != after.y) roles << PosYRole;
+    if (before.propertyLink != after.propertyLink) roles << PropertyLinkRole;
+    if (ValueMappingEngine::definitionToVariant(before.mapping)
+        != ValueMappingEngine::definitionToVariant(after.mapping)) {
+        roles << MappingRole;
+    }
+    if (!roles.isEmpty()) roles << ConfigRole;
+    return roles;
+}
+
+} // namespace ObservatoryMonitor
@@ -0,0 +1,51 @@
+#ifndef WIDGETLISTMODEL_H
+#define WIDGETLISTMODEL_H
+
+#include <QAbstractListModel>
+#include <QList>
+
+namespace ObservatoryMonitor {
+
+struct WidgetConfig;
+class LayoutConfig;
+
+// Row view of LayoutConfig's dashboard widgets. LayoutConfig owns the data
+// and brackets each edit with the matching row signals, so a Repeater keeps
+// its delegates: adding or removing a widget touches one row, and moving or
+// relabelling one only reports the roles that changed.
+class WidgetListModel : public QAbstractListModel
+{
+    Q_OBJECT
+
+public:
+    enum WidgetRoles {
+        WidgetIdRole = Qt::UserRole + 1,
+        WidgetTypeRole,
+        LabelRole,
+        PosXRole,
+        PosYRole,
+        PropertyLinkRole,
+        MappingRole,
+        ConfigRole          // the whole entry, as in LayoutConfig::widgets
+    };
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+    QHash<int, QByteArray> roleNames() const override;
+
+    Q_INVOKABLE int rowOf(const QString& widgetId) const;
+
+private:
+    friend class LayoutConfig;
+
+    explicit WidgetListModel(const QList<WidgetConfig>& widgets, QObject* parent);
+
+    // Roles that differ between two versions of the same widget
+    static QList<int> changedRoles(const WidgetConfig& before, const WidgetConfig& after);
+
+    const QList<WidgetConfig>& m_widgets;
+};
+
+} // namespace ObservatoryMonitor
+
+#endif // WIDGETLISTMODEL_H
@@ -11,6 +11,7 @@
 #include <iostream>
 #include "SimulatorConfig.h"
 #include "Logger.h"
+#include "Lx200Codec.h"
 
 using namespace ObservatoryMonitor;
 
@@ -134,15 +135,24 @@ private slots:
         Logger::instance().debug(QString("Simulator: Received command on %1/cmd: %2").arg(prefix, command));
         
         // Special case for dynamic values
+        // Dome azimuth comes back as a decimal, mount coordinates the way
+        // OnStepX formats them
+        char formatted[Lx200Codec::MaxFormattedLength];
         if (command == ":DZ#" || command == ":GZ#") {
-            QString responseValue = QString("%1#").arg(m_azimuth, 0, 'f', 3);
+            if (command == ":DZ#") {
+                Lx200Codec::formatDecimal(m_azimuth, 3, formatted);
+            } else {
+                Lx200Codec::formatAzimuth(m_azimuth, Lx200Codec::Precision::Standard, formatted);
+            }
+            QString responseValue = QString("%1#").arg(QLatin1String(formatted));
             QString response = QString("Received: %1, Response: %2, Source: MQTT").arg(command, responseValue);
             sendResponse(prefix, command, response);
             return;
         }
 
         if (command == ":GA#") {
-            QString responseValue = QString("%1#").arg(m_altitude, 0, 'f', 3);
+            Lx200Codec::formatSignedDegrees(m_altitude, Lx200Codec::Precision::Standard, formatted);
+            QString responseValue = QString("%1#").arg(QLatin1String(formatted));
             QString response = QString("Received: :GA#, Response: %1, Source: MQTT").arg(responseValue);
             sendResponse(prefix, command, response);
             return;
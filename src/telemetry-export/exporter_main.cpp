@@ -0,0 +1,172 @@
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QStandardPaths>
+#include <QDateTime>
+#include <QFile>
+#include <QDir>
+#include <QTextStream>
+#include <iostream>
+#include "TelemetryReader.h"
+
+using namespace ObservatoryMonitor;
+
+static QString csvField(const QString& value)
+{
+    if (value.contains(',') || value.contains('"') || value.contains('\n')) {
+        QString escaped = value;
+        escaped.replace("\"", "\"\"");
+        return "\"" + escaped + "\"";
+    }
+    return value;
+}
+
+static QString formatTimestamp(qint64 ms)
+{
+    return QDateTime::fromMSecsSinceEpoch(ms).toUTC().toString(Qt::ISODateWithMs);
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    
+    // Set application metadata
+    QCoreApplication::setApplicationName("telemetry-export");
+    QCoreApplication::setApplicationVersion("0.1.0");
+    
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Observatory Monitor telemetry exporter (CSV)");
+    parser.addHelpOption();
+    parser.addVersionOption();
+    
+    QString defaultDir = QStandardPaths::writableLocation(QStandardPaths::GenericDataLocation)
+                       + "/observatory-monitor/telemetry";
+    
+    QCommandLineOption dirOption(QStringList() << "d" << "dir",
+                                 "Telemetry directory (default: " + defaultDir + ")",
+                                 "dir", defaultDir);
+    QCommandLineOption fromOption(QStringList() << "f" << "from",
+                                  "Start time, ISO 8601 UTC (default: 24 hours ago)",
+                                  "time");
+    QCommandLineOption toOption(QStringList() << "t" << "to",
+                                "End time, ISO 8601 UTC (default: now)",
+                                "time");
+    QCommandLineOption tierOption("tier", "Data tier: raw (1 s) or minute (1 min aggregates)", "tier", "raw");
+    QCommandLineOption controllerOption(QStringList() << "c" << "controller",
+                                        "Only export this controller", "name");
+    QCommandLineOption commandOption("command", "Only export this command (e.g. :GZ#)", "command");
+    QCommandLineOption outputOption(QStringList() << "o" << "output",
+                                    "Write CSV to file instead of stdout", "file");
+    QCommandLineOption listOption(QStringList() << "l" << "list", "List recorded series and exit");
+    
+    parser.addOption(dirOption);
+    parser.addOption(fromOption);
+    parser.addOption(toOption);
+    parser.addOption(tierOption);
+    parser.addOption(controllerOption);
+    parser.addOption(commandOption);
+    parser.addOption(outputOption);
+    parser.addOption(listOption);
+    
+    parser.process(app);
+    
+    QString tierName = parser.value(tierOption).toLower();
+    if (tierName != "raw" && tierName != "minute") {
+        std::cerr << "Error: --tier must be 'raw' or 'minute'" << std::endl;
+        return 1;
+    }
+    TelemetryTier tier = tierName == "raw" ? TelemetryTier::Raw : TelemetryTier::Minute;
+    
+    qint64 toMs = QDateTime::currentMSecsSinceEpoch();
+    qint64 fromMs = toMs - 24LL * 3600 * 1000;
+    
+    if (parser.isSet(fromOption)) {
+        QDateTime from = QDateTime::fromString(parser.value(fromOption), Qt::ISODate);
+        if (!from.isValid()) {
+            std::cerr << "Error: Invalid --from time: " << parser.value(fromOption).toStdString() << std::endl;
+            return 1;
+        }
+        fromMs = from.toMSecsSinceEpoch();
+    }
+    
+    if (parser.isSet(toOption)) {
+        QDateTime to = QDateTime::fromString(parser.value(toOption), Qt::ISODate);
+        if (!to.isValid()) {
+            std::cerr << "Error: Invalid --to time: " << parser.value(toOption).toStdString() << std::endl;
+            return 1;
+        }
+        toMs = to.toMSecsSinceEpoch();
+    }
+    
+    QString directory = parser.value(dirOption);
+    if (!QDir(directory).exists()) {
+        std::cerr << "Error: Telemetry directory does not exist: " << directory.toStdString() << std::endl;
+        return 1;
+    }
+    
+    TelemetryReader reader(directory);
+    
+    QList<TelemetrySeriesInfo> series;
+    for (const auto& info : reader.listSeries(tier, fromMs, toMs)) {
+        if (parser.isSet(controllerOption) && info.controller != parser.value(controllerOption)) continue;
+        if (parser.isSet(commandOption) && info.command != parser.value(commandOption)) continue;
+        
+        // Numeric and text series of the same command are read together
+        bool seen = false;
+        for (const auto& s : series) {
+            if (s.controller == info.controller && s.command == info.command) seen = true;
+        }
+        if (!seen) series << info;
+    }
+    
+    if (parser.isSet(listOption)) {
+        for (const auto& info : series) {
+            std::cout << info.controller.toStdString() << "\t" << info.command.toStdString() << std::endl;
+        }
+        return 0;
+    }
+    
+    QFile outFile;
+    if (parser.isSet(outputOption)) {
+        outFile.setFileName(parser.value(outputOption));
+        if (!outFile.open(QIODevice::WriteOnly | QIODevice::Text)) {
+            std::cerr << "Error: Cannot write " << outFile.fileName().toStdString()
+                      << ": " << outFile.errorString().toStdString() << std::endl;
+            return 1;
+        }
+    } else if (!outFile.open(stdout, QIODevice::WriteOnly | QIODevice::Text)) {
+        std::cerr << "Error: Cannot write to stdout" << std::endl;
+        return 1;
+    }
+    
+    QTextStream out(&outFile);
+    
+    if (tier == TelemetryTier::Raw) {
+        out << "timestamp,controller,command,value\n";
+        for (const auto& info : series) {
+            for (const auto& sample : reader.readRaw(info.controller, info.command, fromMs, toMs)) {
+                out << formatTimestamp(sample.timestamp) << ','
+                    << csvField(info.controller) << ','
+                    << csvField(info.command) << ','
+                    << csvField(sample.text) << '\n';
+            }
+        }
+    } else {
+        out << "minute,controller,command,min,max,mean,count,last\n";
+        for (const auto& info : series) {
+            for (const auto& agg : reader.readMinutes(info.controller, info.command, fromMs, toMs)) {
+                out << formatTimestamp(agg.timestamp) << ','
+                    << csvField(info.controller) << ','
+                    << csvField(info.command) << ',';
+                if (agg.numeric) {
+                    out << agg.min << ',' << agg.max << ',' << agg.mean << ',';
+                } else {
+                    out << ",,,";
+                }
+                out << agg.count << ',' << csvField(agg.last) << '\n';
+            }
+        }
+    }
+    
+    out.flush();
+    return 0;
+}
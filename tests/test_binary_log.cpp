@@ -0,0 +1,407 @@
+#include <QtTest>
+#include <QTemporaryDir>
+#include <QFile>
+#include <chrono>
+#include "BinaryLog.h"
+#include "LogCompression.h"
+#include "Logger.h"
+
+using namespace ObservatoryMonitor;
+
+static LogCategory lcBinaryTest("BinaryTest");
+
+class TestBinaryLog : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void testRoundTrip();
+    void testSections();
+    void testTruncatedTail();
+    void testCrashThenReopen();
+    void testCorruptEntry();
+    void testCompressedLog();
+    void testRenderSinglePass();
+    void testLoggerBinaryDebug();
+    void testSizeAgainstText();
+    void benchmarkWrite_data();
+    void benchmarkWrite();
+
+private:
+    // A completed command as MqttClient logs it
+    static void appendTraffic(BinaryLogWriter& writer, int index);
+    static QString trafficLine(int index);
+    // A poll round trip with MqttClient's own debug templates; returns the
+    // size of the same records as text lines
+    static qint64 appendRoundTrip(BinaryLogWriter& writer, qint64& steadyNs,
+                                  const QString& command, const QString& response, int queued);
+
+    QTemporaryDir m_dir;
+    QString m_path;
+};
+
+static qint64 steadyNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static QString command(int index)
+{
+    static const char* const commands[] = {":GR#", ":GD#", ":GZ#", ":GA#", ":GS#", ":GL#"};
+    return QString::fromLatin1(commands[index % 6]);
+}
+
+void TestBinaryLog::init()
+{
+    QVERIFY(m_dir.isValid());
+    m_path = m_dir.filePath("test.omlog");
+    QFile::remove(m_path);
+}
+
+void TestBinaryLog::appendTraffic(BinaryLogWriter& writer, int index)
+{
+    LogArg args[2] = {toLogArg(command(index)), toLogArg(index % 17 + 3)};
+    writer.append(steadyNs(), LogLevel::Debug, "MQTT", "OCS", "Command '%1' completed in %2 ms", args, 2);
+}
+
+QString TestBinaryLog::trafficLine(int index)
+{
+    return LogText::formatLine(QDateTime::currentDateTime(), LogLevel::Debug,
+                               QString("Command '%1' completed in %2 ms").arg(command(index)).arg(index % 17 + 3),
+                               "MQTT", "OCS");
+}
+
+void TestBinaryLog::testRoundTrip()
+{
+    const qint64 before = QDateTime::currentMSecsSinceEpoch();
+    QString errorMessage;
+    {
+        BinaryLogWriter writer;
+        QVERIFY2(writer.open(m_path, errorMessage), qPrintable(errorMessage));
+        LogArg args[4] = {toLogArg(QString("observatory/OCS/echo")), toLogArg(-42), toLogArg(2.5),
+                          toLogArg(QString(1000, 'x'))};
+        writer.append(steadyNs(), LogLevel::Debug, "MQTT", "OCS", "%1 %2 %3 %4", args, 4);
+        writer.append(steadyNs(), LogLevel::Warning, "MQTT", "OCS", "%1 %2 %3 %4", args, 4);
+        writer.appendMessage(steadyNs(), LogLevel::Info, nullptr, QString(), "Plain message");
+    }
+    const qint64 after = QDateTime::currentMSecsSinceEpoch();
+
+    BinaryLogReader reader;
+    QVERIFY2(reader.open(m_path, errorMessage), qPrintable(errorMessage));
+
+    LogEvent event;
+    QVERIFY(reader.next(event));
+    QCOMPARE(event.level, LogLevel::Debug);
+    QCOMPARE(event.category, QString("MQTT"));
+    QCOMPARE(event.controller, QString("OCS"));
+    QCOMPARE(event.args.size(), 4);
+    QCOMPARE(event.args[1].type, LogArg::Type::Int);
+    QCOMPARE(event.args[1].integer, qint64(-42));
+    QCOMPARE(event.args[2].type, LogArg::Type::Double);
+    QCOMPARE(event.args[2].real, 2.5);
+    QCOMPARE(event.message(), "observatory/OCS/echo -42 2.5 " + QString(1000, 'x'));
+    QVERIFY(event.timestampMs >= before - 1 && event.timestampMs <= after + 1);
+
+    QVERIFY(reader.next(event));
+    QCOMPARE(event.level, LogLevel::Warning);
+
+    QVERIFY(reader.next(event));
+    QCOMPARE(event.level, LogLevel::Info);
+    QVERIFY(event.category.isEmpty());
+    QVERIFY(event.controller.isEmpty());
+    QCOMPARE(event.message(), QString("Plain message"));
+
+    QVERIFY(!reader.next(event));
+    QVERIFY(reader.errorString().isEmpty());
+}
+
+void TestBinaryLog::testSections()
+{
+    // Each open starts a new section with its own ids
+    QString errorMessage;
+    for (int run = 0; run < 2; ++run) {
+        BinaryLogWriter writer;
+        QVERIFY(writer.open(m_path, errorMessage));
+        appendTraffic(writer, run);
+        appendTraffic(writer, run);
+    }
+
+    BinaryLogReader reader;
+    QVERIFY(reader.open(m_path, errorMessage));
+    QStringList messages;
+    LogEvent event;
+    while (reader.next(event)) {
+        messages << event.message();
+    }
+    QVERIFY(reader.errorString().isEmpty());
+    QCOMPARE(messages, QStringList({"Command ':GR#' completed in 3 ms", "Command ':GR#' completed in 3 ms",
+                                    "Command ':GD#' completed in 4 ms", "Command ':GD#' completed in 4 ms"}));
+}
+
+void TestBinaryLog::testTruncatedTail()
+{
+    QString errorMessage;
+    {
+        BinaryLogWriter writer;
+        QVERIFY(writer.open(m_path, errorMessage));
+        for (int i = 0; i < 10; ++i) appendTraffic(writer, i);
+    }
+
+    QFile file(m_path);
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    QByteArray data = file.readAll();
+    data.chop(1);
+
+    BinaryLogReader reader;
+    QVERIFY(reader.openData(data, errorMessage));
+    int count = 0;
+    LogEvent event;
+    while (reader.next(event)) ++count;
+    QCOMPARE(count, 9);
+    QVERIFY(reader.errorString().isEmpty());
+}
+
+void TestBinaryLog::testCrashThenReopen()
+{
+    // A run killed mid-entry, then restarted on the same file
+    QString errorMessage;
+    {
+        BinaryLogWriter writer;
+        QVERIFY(writer.open(m_path, errorMessage));
+        for (int i = 0; i < 10; ++i) appendTraffic(writer, i);
+    }
+    QVERIFY(QFile::resize(m_path, QFileInfo(m_path).size() - 2));
+    {
+        BinaryLogWriter writer;
+        QVERIFY2(writer.open(m_path, errorMessage), qPrintable(errorMessage));
+        for (int i = 0; i < 5; ++i) appendTraffic(writer, i);
+    }
+
+    BinaryLogReader reader;
+    QVERIFY(reader.open(m_path, errorMessage));
+    QStringList messages;
+    LogEvent event;
+    while (reader.next(event)) {
+        messages << event.message();
+    }
+    QVERIFY(reader.errorString().isEmpty());
+    QCOMPARE(messages.size(), 14);
+    QCOMPARE(messages.at(9), QString("Command ':GR#' completed in 3 ms"));
+    QCOMPARE(messages.last(), QString("Command ':GS#' completed in 7 ms"));
+
+    // Not a binary log: left alone
+    const QString textPath = m_dir.filePath("test.log");
+    QFile text(textPath);
+    QVERIFY(text.open(QIODevice::WriteOnly));
+    text.write("2024-01-01 00:00:00.000 [INFO] started\n");
+    text.close();
+    BinaryLogWriter writer;
+    QVERIFY(!writer.open(textPath, errorMessage));
+    QCOMPARE(QFileInfo(textPath).size(), qint64(39));
+}
+
+void TestBinaryLog::testCorruptEntry()
+{
+    QString errorMessage;
+    {
+        BinaryLogWriter writer;
+        QVERIFY(writer.open(m_path, errorMessage));
+        appendTraffic(writer, 0);
+    }
+
+    QFile file(m_path);
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    QByteArray data = file.readAll();
+    data.append(char(0x7f));
+    data.append(QByteArray(8, '\0'));
+
+    BinaryLogReader reader;
+    QVERIFY(reader.openData(data, errorMessage));
+    LogEvent event;
+    QVERIFY(reader.next(event));
+    QVERIFY(!reader.next(event));
+    QVERIFY(reader.errorString().contains("Unknown entry"));
+
+    QVERIFY(!reader.openData("not a log", errorMessage));
+}
+
+void TestBinaryLog::testCompressedLog()
+{
+    QString errorMessage;
+    {
+        BinaryLogWriter writer;
+        QVERIFY(writer.open(m_path, errorMessage));
+        for (int i = 0; i < 100; ++i) appendTraffic(writer, i);
+    }
+    
+    const QString compressed = m_path + LogCompression::Extension;
+    QVERIFY2(LogCompression::compressFile(m_path, compressed, errorMessage), qPrintable(errorMessage));
+    QCOMPARE(QFileInfo(compressed).lastModified(), QFileInfo(m_path).lastModified());
+    
+    BinaryLogReader reader;
+    QVERIFY2(reader.open(compressed, errorMessage), qPrintable(errorMessage));
+    int count = 0;
+    LogEvent event;
+    while (reader.next(event)) {
+        QCOMPARE(event.message(), QString("Command '%1' completed in %2 ms").arg(command(count)).arg(count % 17 + 3));
+        ++count;
+    }
+    QCOMPARE(count, 100);
+    QVERIFY(reader.errorString().isEmpty());
+    
+    // A damaged compressed file is an error, not an empty log
+    QFile file(compressed);
+    QVERIFY(file.open(QIODevice::ReadWrite));
+    file.seek(8);
+    file.write("garbage");
+    file.close();
+    QVERIFY(!reader.open(compressed, errorMessage));
+}
+
+void TestBinaryLog::testRenderSinglePass()
+{
+    LogArg args[2] = {toLogArg(QString("%2")), toLogArg(7)};
+    QCOMPARE(LogText::render(u"%1 and %2, %3 100%", args, 2), QString("%2 and 7, %3 100%"));
+}
+
+void TestBinaryLog::testLoggerBinaryDebug()
+{
+    Logger& logger = Logger::instance();
+    logger.setBinaryDebugLog(true);
+    QVERIFY(logger.initialize(m_dir.path(), true, false, 100));
+
+    const QString debugPath = logger.debugLogPath();
+    QVERIFY(debugPath.endsWith(".omlog"));
+
+    OM_DEBUGF(lcBinaryTest, "OCS", "Received on %1: %2", QString("observatory/OCS/echo"), QString(":GR#14:32:10"));
+    OM_INFOF(lcBinaryTest, "OCS", "Connected to %1:%2", QString("localhost"), 1883);
+    const QString userPath = logger.userLogPath();
+    logger.shutdown();
+    logger.setBinaryDebugLog(false);
+
+    BinaryLogReader reader;
+    QString errorMessage;
+    QVERIFY2(reader.open(debugPath, errorMessage), qPrintable(errorMessage));
+    QStringList decoded;
+    LogEvent event;
+    while (reader.next(event)) {
+        decoded << LogText::formatLine(QDateTime::fromMSecsSinceEpoch(event.timestampMs), event.level,
+                                       event.message(), event.category, event.controller);
+    }
+    QVERIFY(decoded.filter("[DEBUG] [BinaryTest] [OCS] Received on observatory/OCS/echo: :GR#14:32:10").size() == 1);
+
+    // Decoded text reads exactly like the text log. The binary timestamp is
+    // monotonic from the section start, so it may differ from the wall clock
+    // by a millisecond; compare past it.
+    QFile userLog(userPath);
+    QVERIFY(userLog.open(QIODevice::ReadOnly | QIODevice::Text));
+    const QStringList userLines = QString::fromUtf8(userLog.readAll()).split('\n', Qt::SkipEmptyParts);
+    const QStringList connected = userLines.filter("[BinaryTest] [OCS] Connected to localhost:1883");
+    QCOMPARE(connected.size(), 1);
+    const qsizetype stamp = QString("[yyyy-MM-dd HH:mm:ss.zzz] ").size();
+    const QStringList decodedConnected = decoded.filter("Connected to localhost:1883");
+    QCOMPARE(decodedConnected.size(), 1);
+    QCOMPARE(decodedConnected.first().mid(stamp), connected.first().mid(stamp));
+}
+
+qint64 TestBinaryLog::appendRoundTrip(BinaryLogWriter& writer, qint64& steadyNs,
+                                     const QString& command, const QString& response, int queued)
+{
+    qint64 textSize = 0;
+    auto record = [&](qint64 afterUs, const char* format, std::initializer_list<LogArg> args) {
+        steadyNs += afterUs * 1000;
+        writer.append(steadyNs, LogLevel::Debug, "MQTT", "OCS", format, args.begin(), qsizetype(args.size()));
+        const QString message = LogText::render(QString::fromUtf8(format), args.begin(), qsizetype(args.size()));
+        textSize += LogText::formatLine(QDateTime::currentDateTime(), LogLevel::Debug, message,
+                                        "MQTT", "OCS").toUtf8().size() + 1;
+    };
+
+    const int responseMs = 40 + int(qHash(response) % 80);
+    const QString echo = QString("Received: %1, Response: %2#, Source: MQTT").arg(command, response);
+    record(200, "Queued command '%1' (queue size: %2)", {toLogArg(command), toLogArg(queued)});
+    record(30, "Publishing to %1: %2", {toLogArg(QString("OCS/cmd")), toLogArg(command)});
+    record(15, "Command '%1' sent (queued for %2 ms)", {toLogArg(command), toLogArg(queued - 1)});
+    record(responseMs * 1000, "Received on %1: %2", {toLogArg(QString("OCS/echo")), toLogArg(echo)});
+    record(40, "Parsed command='%1', response='%2', errorCode=%3",
+           {toLogArg(command), toLogArg(response), toLogArg(0)});
+    record(10, "Command '%1' completed in %2 ms", {toLogArg(command), toLogArg(responseMs)});
+    return textSize;
+}
+
+void TestBinaryLog::testSizeAgainstText()
+{
+    // Half an hour of a tracking mount's poll traffic: RA and Dec hold, the
+    // horizontal coordinates and sidereal time move every poll
+    QString errorMessage;
+    qint64 textSize = 0;
+    {
+        BinaryLogWriter writer;
+        QVERIFY(writer.open(m_path, errorMessage));
+        const auto dms = [](double degrees, int width) {
+            const int arcsec = int(degrees * 3600);
+            return QString("%1*%2'%3").arg(arcsec / 3600, width, 10, QChar('0'))
+                                     .arg(arcsec / 60 % 60, 2, 10, QChar('0'))
+                                     .arg(arcsec % 60, 2, 10, QChar('0'));
+        };
+        qint64 steady = steadyNs();
+        for (int second = 0; second < 1800; ++second) {
+            const double az = 120.0 + second * 0.004;
+            const double alt = 35.0 + second * 0.002;
+            const int lst = 20 * 3600 + second;
+            const QString sidereal = QString("%1:%2:%3").arg(lst / 3600, 2, 10, QChar('0'))
+                                                        .arg(lst / 60 % 60, 2, 10, QChar('0'))
+                                                        .arg(lst % 60, 2, 10, QChar('0'));
+
+            textSize += appendRoundTrip(writer, steady, ":GR#", "14:32:10", 1);
+            textSize += appendRoundTrip(writer, steady, ":GD#", "+22*14'05", 2);
+            textSize += appendRoundTrip(writer, steady, ":GZ#", dms(az, 3), 3);
+            textSize += appendRoundTrip(writer, steady, ":GA#", "+" + dms(alt, 2), 4);
+            if (second % 5 == 0) {
+                textSize += appendRoundTrip(writer, steady, ":GS#", sidereal, 1);
+            }
+            steady += qint64(1000) * 1000 * 1000;
+        }
+    }
+
+    // About 4.5x: each echo payload is too long to intern and each moving
+    // coordinate is a new string, so they are stored as text in both files
+    const qint64 binarySize = QFileInfo(m_path).size();
+    QVERIFY2(binarySize * 4 < textSize,
+             qPrintable(QString("text %1 bytes, binary %2 bytes").arg(textSize).arg(binarySize)));
+}
+
+void TestBinaryLog::benchmarkWrite_data()
+{
+    QTest::addColumn<bool>("binary");
+    QTest::newRow("text") << false;
+    QTest::newRow("binary") << true;
+}
+
+void TestBinaryLog::benchmarkWrite()
+{
+    // Writer-side cost of 1000 traffic records, rendering included for text
+    QFETCH(bool, binary);
+    QString errorMessage;
+
+    if (binary) {
+        BinaryLogWriter writer;
+        QVERIFY(writer.open(m_path, errorMessage));
+        QBENCHMARK {
+            for (int i = 0; i < 1000; ++i) appendTraffic(writer, i);
+            writer.flush();
+        }
+    } else {
+        QFile file(m_dir.filePath("test.log"));
+        QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Text));
+        QTextStream stream(&file);
+        QBENCHMARK {
+            for (int i = 0; i < 1000; ++i) stream << trafficLine(i) << "\n";
+            stream.flush();
+        }
+    }
+}
+
+QTEST_MAIN(TestBinaryLog)
+#include "test_binary_log.moc"
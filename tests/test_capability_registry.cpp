@@ -0,0 +1,110 @@
+#include <QtTest>
+#include <QSignalSpy>
+#include "CapabilityRegistry.h"
+#include "LayoutConfig.h"
+
+using namespace ObservatoryMonitor;
+
+class TestCapabilityRegistry : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testLookupByName();
+    void testLookupByCommand();
+    void testFirstDefinitionWins();
+    void testLinksFollowChanges();
+    void benchmarkValidate();
+};
+
+void TestCapabilityRegistry::testLookupByName()
+{
+    CapabilityRegistry registry;
+
+    const PropertyDefinition* ra = registry.findProperty("Telescope", "RA");
+    QVERIFY(ra);
+    QCOMPARE(ra->command, QString(":GR#"));
+    QCOMPARE(ra->unit, QString("hrs"));
+
+    QVERIFY(!registry.findProperty("Telescope", "Shutter"));
+    QVERIFY(!registry.findProperty("Focuser", "RA"));
+
+    PropertyDefinition missing = registry.getProperty("Telescope", "Nope");
+    QVERIFY(!missing.isValid());
+    QCOMPARE(registry.getProperty("Observatory", "Shutter").command, QString(":RS#"));
+
+    QVERIFY(registry.hasPropertyLink("Telescope.Dec"));
+    QVERIFY(!registry.hasPropertyLink("Telescope"));
+    QVERIFY(!registry.hasPropertyLink("Telescope.Shutter"));
+}
+
+void TestCapabilityRegistry::testLookupByCommand()
+{
+    CapabilityRegistry registry;
+
+    // The same command maps to a different capability per type
+    QCOMPARE(registry.getPropertyForCommand("Telescope", ":GZ#").description, QString("Mount Azimuth"));
+    QCOMPARE(registry.getPropertyForCommand("Observatory", ":GZ#").description, QString("Dome Azimuth"));
+    QVERIFY(!registry.findByCommand("Telescope", ":RS#"));
+}
+
+void TestCapabilityRegistry::testFirstDefinitionWins()
+{
+    CapabilityRegistry registry;
+    registry.registerProperties("Focuser", {
+        {"Position", ":FG#", "first", "", "numeric"},
+        {"Position", ":FP#", "second", "", "numeric"},
+        {"Temperature", ":FG#", "third", "C", "numeric"},
+    });
+
+    QCOMPARE(registry.getProperty("Focuser", "Position").description, QString("first"));
+    QCOMPARE(registry.getPropertyForCommand("Focuser", ":FG#").description, QString("first"));
+    QCOMPARE(registry.getPropertyForCommand("Focuser", ":FP#").description, QString("second"));
+}
+
+void TestCapabilityRegistry::testLinksFollowChanges()
+{
+    CapabilityRegistry registry;
+    QSignalSpy changed(&registry, &CapabilityRegistry::capabilitiesChanged);
+
+    QStringList links = registry.allPropertyLinks();
+    QVERIFY(std::is_sorted(links.cbegin(), links.cend()));
+    QVERIFY(!links.contains("Focuser.Position"));
+
+    registry.registerProperties("Focuser", {{"Position", ":FG#", "", "steps", "numeric"}});
+    QCOMPARE(changed.count(), 1);
+    QVERIFY(registry.allPropertyLinks().contains("Focuser.Position"));
+    QVERIFY(registry.hasPropertyLink("Focuser.Position"));
+
+    registry.registerProperties("Focuser", {});
+    QVERIFY(!registry.allPropertyLinks().contains("Focuser.Position"));
+    QVERIFY(!registry.findByCommand("Focuser", ":FG#"));
+}
+
+void TestCapabilityRegistry::benchmarkValidate()
+{
+    // A busy dashboard: every capability of a few dozen controller types
+    CapabilityRegistry registry;
+    LayoutConfig layout;
+    layout.clear();
+    for (int t = 0; t < 32; ++t) {
+        QString type = QString("Controller%1").arg(t);
+        QList<PropertyDefinition> props;
+        for (int p = 0; p < 16; ++p) {
+            QString name = QString("Property%1").arg(p);
+            props.append(PropertyDefinition{name, QString(":G%1#").arg(p), "", "", "numeric"});
+            layout.addWidget({{"type", "Numeric"}, {"id", type + name}, {"property", type + "." + name}});
+        }
+        registry.registerProperties(type, props);
+    }
+
+    QString errorMessage;
+    bool valid = false;
+    QBENCHMARK {
+        valid = layout.validate(&registry, errorMessage);
+    }
+    QVERIFY2(valid, qPrintable(errorMessage));
+}
+
+QTEST_GUILESS_MAIN(TestCapabilityRegistry)
+#include "test_capability_registry.moc"
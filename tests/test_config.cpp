@@ -22,6 +22,8 @@ private slots:
     void testValidationMissingControllerFields();
     void testValidationDuplicatePrefix();
     void testSaveAndLoad();
+    void testTcpTransport();
+    void testSmallLogTotal();
 };
 
 void TestConfig::initTestCase()
@@ -280,5 +282,96 @@ void TestConfig::testSaveAndLoad()
     QCOMPARE(config2.reconnectInterval(), config1.reconnectInterval());
 }
 
+void TestConfig::testTcpTransport()
+{
+    QTemporaryFile tempFile;
+    QVERIFY(tempFile.open());
+    
+    tempFile.write(R"(
+controllers:
+  - name: "Observatory"
+    type: "Observatory"
+    prefix: "OCS"
+  - name: "Telescope"
+    type: "Telescope"
+    prefix: "OnStepX"
+    transport: "TCP"
+    host: "192.168.1.50"
+    port: 9998
+
+equipment_types:
+  - name: "Observatory"
+    controllers: ["OCS"]
+)");
+    tempFile.close();
+    
+    Config config;
+    QString errorMessage;
+    QVERIFY(config.loadFromFile(tempFile.fileName(), errorMessage));
+    QVERIFY2(config.validate(errorMessage), qPrintable(errorMessage));
+    
+    QCOMPARE(config.controllers()[0].transport, QString("mqtt"));
+    QCOMPARE(config.controllers()[1].transport, QString("tcp"));
+    QCOMPARE(config.controllers()[1].host, QString("192.168.1.50"));
+    QCOMPARE(config.controllers()[1].port, 9998);
+    
+    // Round trip keeps the endpoint
+    QVERIFY(config.saveToFile(tempFile.fileName(), errorMessage));
+    Config reloaded;
+    QVERIFY(reloaded.loadFromFile(tempFile.fileName(), errorMessage));
+    QCOMPARE(reloaded.controllers()[1].transport, QString("tcp"));
+    QCOMPARE(reloaded.controllers()[1].port, 9998);
+    
+    // A TCP controller needs a host; unknown transports are rejected
+    QList<ControllerConfig> controllers = config.controllers();
+    controllers[1].host.clear();
+    config.setControllers(controllers);
+    QVERIFY(!config.validate(errorMessage));
+    QVERIFY(errorMessage.contains("host is empty"));
+    
+    controllers[1].host = "localhost";
+    controllers[1].transport = "serial";
+    config.setControllers(controllers);
+    QVERIFY(!config.validate(errorMessage));
+    QVERIFY(errorMessage.contains("unknown transport"));
+}
+
+void TestConfig::testSmallLogTotal()
+{
+    // Valid before segment sizes existed; the default must not reject it
+    QTemporaryFile tempFile;
+    QVERIFY(tempFile.open());
+    tempFile.write(R"(
+controllers:
+  - name: "Observatory"
+    type: "Observatory"
+    prefix: "OCS"
+
+equipment_types:
+  - name: "Observatory"
+    controllers: ["OCS"]
+
+logging: {max_total_size_mb: 5}
+)");
+    tempFile.close();
+
+    Config config;
+    QString errorMessage;
+    QVERIFY(config.loadFromFile(tempFile.fileName(), errorMessage));
+    QCOMPARE(config.logging().maxTotalSizeMB, 5);
+    QCOMPARE(config.logging().maxFileSizeMB, 0);
+    QVERIFY2(config.validate(errorMessage), qPrintable(errorMessage));
+
+    // Explicit sizes are checked against the total
+    LoggingConfig logging = config.logging();
+    logging.maxFileSizeMB = 6;
+    config.setLogging(logging);
+    QVERIFY(!config.validate(errorMessage));
+    QVERIFY(errorMessage.contains("max_file_size_mb"));
+    logging.maxFileSizeMB = 5;
+    config.setLogging(logging);
+    QVERIFY2(config.validate(errorMessage), qPrintable(errorMessage));
+}
+
 QTEST_MAIN(TestConfig)
 #include "test_config.moc"
@@ -0,0 +1,123 @@
+#include <QtTest>
+#include "ConfigDiff.h"
+#include "ControllerManager.h"
+
+using namespace ObservatoryMonitor;
+
+class TestConfigDiff : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testComputeDiff();
+    void testNoChanges();
+    void testBrokerConnection();
+    void testManagerAppliesOnlyChanges();
+
+private:
+    static ControllerConfig controller(const QString& name, const QString& type, const QString& prefix, bool enabled = true);
+    static Config makeConfig(const QList<ControllerConfig>& controllers);
+};
+
+ControllerConfig TestConfigDiff::controller(const QString& name, const QString& type, const QString& prefix, bool enabled)
+{
+    ControllerConfig config;
+    config.name = name;
+    config.type = type;
+    config.prefix = prefix;
+    config.enabled = enabled;
+    return config;
+}
+
+Config TestConfigDiff::makeConfig(const QList<ControllerConfig>& controllers)
+{
+    Config config;
+    config.setDefaults();
+    config.setControllers(controllers);
+    return config;
+}
+
+void TestConfigDiff::testComputeDiff()
+{
+    QList<ControllerConfig> before = {
+        controller("Dome", "Observatory", "OCS"),
+        controller("Mount", "Telescope", "ONSTEP"),
+        controller("Focuser", "Other", "FOC"),
+        controller("Weather", "Other", "WX"),
+    };
+    QList<ControllerConfig> after = {
+        controller("Dome", "Observatory", "OCS"),          // unchanged
+        controller("Mount", "Telescope", "ONSTEP2"),       // new prefix
+        controller("Focuser", "Other", "FOC", false),      // disabled
+        controller("Camera", "Other", "CAM"),              // new
+    };
+
+    ConfigDiff diff = ConfigDiff::compute(before, after);
+    QCOMPARE(diff.unchanged, QStringList{"Dome"});
+    QCOMPARE(diff.recreated.size(), 1);
+    QCOMPARE(diff.recreated[0].name, QString("Mount"));
+    QCOMPARE(diff.enableChanged.size(), 1);
+    QCOMPARE(diff.enableChanged[0].name, QString("Focuser"));
+    QCOMPARE(diff.added.size(), 1);
+    QCOMPARE(diff.added[0].name, QString("Camera"));
+    QCOMPARE(diff.removed, QStringList{"Weather"});
+    QVERIFY(!diff.isEmpty());
+}
+
+void TestConfigDiff::testNoChanges()
+{
+    QList<ControllerConfig> controllers = {controller("Dome", "Observatory", "OCS")};
+    ConfigDiff diff = ConfigDiff::compute(controllers, controllers);
+    QVERIFY(diff.isEmpty());
+    QCOMPARE(diff.summary(), QString("no changes"));
+}
+
+void TestConfigDiff::testBrokerConnection()
+{
+    BrokerConfig a;
+    BrokerConfig b = a;
+    QVERIFY(ConfigDiff::sameConnection(a, b));
+    b.port = 1884;
+    QVERIFY(!ConfigDiff::sameConnection(a, b));
+    b = a;
+    b.password = "secret";
+    QVERIFY(!ConfigDiff::sameConnection(a, b));
+}
+
+void TestConfigDiff::testManagerAppliesOnlyChanges()
+{
+    ControllerManager manager;
+    manager.loadControllersFromConfig(makeConfig({
+        controller("Dome", "Observatory", "OCS"),
+        controller("Mount", "Telescope", "ONSTEP"),
+        controller("Weather", "Other", "WX"),
+    }));
+
+    AbstractController* dome = manager.controller("Dome");
+    AbstractController* mount = manager.controller("Mount");
+    QVERIFY(dome && mount);
+
+    Config updated = makeConfig({
+        controller("Dome", "Observatory", "OCS"),
+        controller("Mount", "Telescope", "ONSTEP2"),
+        controller("Camera", "Other", "CAM", false),
+    });
+    manager.loadControllersFromConfig(updated);
+
+    // Untouched controller object survives, reconfigured one is replaced
+    QCOMPARE(manager.controller("Dome"), dome);
+    QVERIFY(manager.controller("Mount") != nullptr);
+    QVERIFY(!manager.controller("Weather"));
+    QVERIFY(manager.controller("Camera"));
+    QVERIFY(!manager.isControllerEnabled("Camera"));
+    QCOMPARE(manager.getControllerNames().size(), 3);
+
+    // Re-applying the same configuration changes nothing
+    mount = manager.controller("Mount");
+    manager.loadControllersFromConfig(updated);
+    QCOMPARE(manager.controller("Dome"), dome);
+    QCOMPARE(manager.controller("Mount"), mount);
+}
+
+QTEST_MAIN(TestConfigDiff)
+#include "test_config_diff.moc"
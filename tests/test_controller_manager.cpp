@@ -0,0 +1,277 @@
+#include <QtTest>
+#include <QSignalSpy>
+#include <QThread>
+#include <atomic>
+#include "ControllerManager.h"
+#include "ControllerProxy.h"
+
+using namespace ObservatoryMonitor;
+
+class TestControllerManager : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testDispatchReachesOnlyTargetProxy();
+    void testChannelBeforeController();
+    void testManagerSignalStillEmitted();
+    void testInternerIds();
+    void testInternerLookupWhileInterning();
+    void testIncrementalStatusAccounting();
+    void benchmarkFanOutBroadcast();
+    void benchmarkFanOutDispatch();
+    void benchmarkStatusStorm();
+
+private:
+    static constexpr int ControllerCount = 50;
+    static QString controllerName(int i) { return QString("ctrl%1").arg(i); }
+    static void addControllers(ControllerManager& manager, int count, const QString& type, const QString& prefix);
+    // Dispatches one update per controller per iteration to subscribers
+    // that count what they receive in delivered
+    static void runFanOut(ControllerManager& manager, const int& delivered);
+};
+
+void TestControllerManager::testDispatchReachesOnlyTargetProxy()
+{
+    ControllerManager manager;
+    ControllerProxy first("ctrl0", &manager);
+    ControllerProxy second("ctrl1", &manager);
+
+    QSignalSpy firstSpy(&first, &ControllerProxy::propertyChanged);
+    QSignalSpy secondSpy(&second, &ControllerProxy::propertyChanged);
+
+    manager.dispatchData("ctrl0", ":GZ#", "123.5#");
+    manager.flushUpdates();
+
+    QCOMPARE(firstSpy.count(), 1);
+    QCOMPARE(secondSpy.count(), 0);
+    QCOMPARE(first.getProperty(":GZ#").toString(), QString("123.5#"));
+    QCOMPARE(first.azimuth(), 123.5);
+}
+
+void TestControllerManager::testChannelBeforeController()
+{
+    ControllerManager manager;
+    ControllerChannel* channel = manager.channel("later");
+    QCOMPARE(manager.channel("later"), channel);
+
+    QSignalSpy spy(channel, &ControllerChannel::dataUpdated);
+    manager.dispatchData("later", ":GA#", "45.0#");
+    manager.dispatchData("other", ":GA#", "10.0#");
+
+    QCOMPARE(spy.count(), 1);
+    QCOMPARE(spy.at(0).at(0).toInt(), PropertyInterner::instance().find("later", ":GA#"));
+}
+
+void TestControllerManager::testManagerSignalStillEmitted()
+{
+    ControllerManager manager;
+    QSignalSpy spy(&manager, &ControllerManager::controllerDataUpdated);
+
+    // Manager-wide consumers (telemetry, logging) still see every update
+    manager.dispatchData("nobody", ":GZ#", "1.0#");
+    QCOMPARE(spy.count(), 1);
+}
+
+void TestControllerManager::testInternerIds()
+{
+    PropertyInterner& interner = PropertyInterner::instance();
+
+    PropertyId az = interner.intern("interned", ":GZ#");
+    PropertyId alt = interner.intern("interned", ":GA#");
+    QCOMPARE(interner.intern("interned", ":GZ#"), az);
+    QCOMPARE(alt, az + 1);
+    QCOMPARE(interner.slot(az), 0);
+    QCOMPARE(interner.slot(alt), 1);
+    QCOMPARE(interner.slotCount("interned"), 2);
+
+    // Same command on another controller is a different property
+    PropertyId otherAz = interner.intern("interned2", ":GZ#");
+    QVERIFY(otherAz != az);
+    QCOMPARE(interner.slot(otherAz), 0);
+
+    QCOMPARE(interner.controller(alt), QString("interned"));
+    QCOMPARE(interner.command(alt), QString(":GA#"));
+    QCOMPARE(interner.find("interned", ":XX#"), InvalidPropertyId);
+    QCOMPARE(interner.command(InvalidPropertyId), QString());
+
+    ControllerManager manager;
+    ControllerProxy proxy("interned", &manager);
+    manager.dispatchData(alt, "12.5#");
+    manager.flushUpdates();
+    QCOMPARE(proxy.propertyValue(alt).toString(), QString("12.5#"));
+    QCOMPARE(proxy.propertyId(":GA#"), alt);
+    QCOMPARE(proxy.altitude(), 12.5);
+}
+
+void TestControllerManager::testInternerLookupWhileInterning()
+{
+    PropertyInterner& interner = PropertyInterner::instance();
+    const int controller = interner.internController("growing");
+    const PropertyId base = interner.count();
+    // Several chunks' worth, so readers race chunk allocation too
+    const int total = 5000;
+
+    std::atomic<bool> stop{false};
+    std::atomic<int> inconsistent{0};
+    std::atomic<int> reads{0};
+
+    QList<QThread*> readers;
+    for (int i = 0; i < 4; ++i) {
+        readers << QThread::create([&]() {
+            do {
+                for (PropertyId id = base; id < base + total; ++id) {
+                    int slot = interner.slot(id);
+                    if (slot < 0) break;   // not interned yet
+                    if (slot != id - base || interner.controllerIndex(id) != controller) inconsistent++;
+                    reads++;
+                }
+            } while (!stop);
+        });
+        readers.last()->start();
+    }
+
+    int misnumbered = 0;
+    for (int i = 0; i < total; ++i) {
+        if (interner.intern("growing", QString(":G%1#").arg(i)) != base + i) misnumbered++;
+    }
+    stop = true;
+    for (QThread* thread : readers) {
+        thread->wait();
+        delete thread;
+    }
+
+    QCOMPARE(misnumbered, 0);
+    QCOMPARE(inconsistent.load(), 0);
+    QVERIFY(reads > 0);
+    QCOMPARE(interner.slot(base + total - 1), total - 1);
+    QCOMPARE(interner.controller(base + total - 1), QString("growing"));
+}
+
+void TestControllerManager::addControllers(ControllerManager& manager, int count, const QString& type, const QString& prefix)
+{
+    for (int i = 0; i < count; ++i) {
+        ControllerConfig config;
+        config.name = QString("%1%2").arg(prefix).arg(i);
+        config.type = type;
+        config.prefix = config.name;
+        config.enabled = true;
+        manager.addController(config, BrokerConfig(), 2.0, 10);
+    }
+}
+
+void TestControllerManager::testIncrementalStatusAccounting()
+{
+    ControllerManager manager;
+    manager.setEquipmentTypes({EquipmentType{"Observatory", {"OCS"}}, EquipmentType{"Telescope", {"OnStepX"}}});
+    addControllers(manager, 3, "Observatory", "dome");
+    addControllers(manager, 2, "OnStepX", "mount");
+
+    QCOMPARE(manager.getEnabledControllerCount(), 5);
+    QCOMPARE(manager.getConnectedControllerCount(), 0);
+    QCOMPARE(manager.getDisconnectedControllers().size(), 5);
+    QCOMPARE(manager.getEquipmentAggregate("Observatory").total, 3);
+    QCOMPARE(manager.getEquipmentAggregate("Telescope").total, 2);
+
+    QSignalSpy systemSpy(&manager, &ControllerManager::systemStatusChanged);
+    QSignalSpy equipmentSpy(&manager, &ControllerManager::equipmentStatusChanged);
+
+    emit manager.controller("mount0")->statusChanged(ControllerStatus::Connected);
+    QCOMPARE(manager.getConnectedControllerCount(), 1);
+    QVERIFY(manager.getConnectedControllers().contains("mount0"));
+    QVERIFY(!manager.getDisconnectedControllers().contains("mount0"));
+    QCOMPARE(manager.getSystemStatus(), SystemStatus::PartiallyConnected);
+    QCOMPARE(manager.getEquipmentStatus("Telescope"), SystemStatus::PartiallyConnected);
+    QCOMPARE(manager.getEquipmentStatus("Observatory"), SystemStatus::Disconnected);
+    QCOMPARE(systemSpy.count(), 1);
+    QCOMPARE(equipmentSpy.count(), 1);
+
+    // Disabling the other mount leaves the telescope fully connected
+    manager.enableController("mount1", false);
+    QCOMPARE(manager.getEnabledControllerCount(), 4);
+    QCOMPARE(manager.getEquipmentStatus("Telescope"), SystemStatus::AllConnected);
+    QCOMPARE(manager.getDisconnectedControllers().size(), 3);
+
+    manager.removeController("mount0");
+    QCOMPARE(manager.getConnectedControllerCount(), 0);
+    QCOMPARE(manager.getEquipmentAggregate("Telescope").total, 1);
+    QCOMPARE(manager.getEquipmentStatus("Telescope"), SystemStatus::Disconnected);
+    QCOMPARE(manager.getSystemStatus(), SystemStatus::Disconnected);
+}
+
+void TestControllerManager::runFanOut(ControllerManager& manager, const int& delivered)
+{
+    QVector<PropertyId> ids;
+    for (int i = 0; i < ControllerCount; ++i) {
+        ids << PropertyInterner::instance().intern(controllerName(i), ":GZ#");
+    }
+
+    int rounds = 0;
+    QBENCHMARK {
+        for (PropertyId id : ids) {
+            manager.dispatchData(id, "180.0#");
+        }
+        manager.flushUpdates();
+        rounds++;
+    }
+    // Each update reached exactly its own controller's subscriber
+    QCOMPARE(delivered, rounds * ControllerCount);
+}
+
+void TestControllerManager::benchmarkFanOutBroadcast()
+{
+    // Previous behaviour: every subscriber listens to every update and
+    // filters by name
+    ControllerManager manager;
+    int delivered = 0;
+    for (int i = 0; i < ControllerCount; ++i) {
+        QString name = controllerName(i);
+        connect(&manager, &ControllerManager::controllerDataUpdated, this,
+                [name, &delivered](const QString& controllerName, const QString&, const QString&) {
+            if (controllerName != name) return;
+            delivered++;
+        });
+    }
+    runFanOut(manager, delivered);
+}
+
+void TestControllerManager::benchmarkFanOutDispatch()
+{
+    // The same subscribers on their controller's channel
+    ControllerManager manager;
+    int delivered = 0;
+    for (int i = 0; i < ControllerCount; ++i) {
+        connect(manager.channel(controllerName(i)), &ControllerChannel::dataUpdated, this,
+                [&delivered](PropertyId, const QString&) {
+            delivered++;
+        });
+    }
+    runFanOut(manager, delivered);
+}
+
+void TestControllerManager::benchmarkStatusStorm()
+{
+    // Remote-site scale: a reconnect storm across ~200 controllers
+    ControllerManager manager;
+    manager.setEquipmentTypes({EquipmentType{"Observatory", {"OCS"}}, EquipmentType{"Telescope", {"OnStepX"}}});
+    addControllers(manager, 100, "Observatory", "dome");
+    addControllers(manager, 100, "OnStepX", "mount");
+
+    QList<AbstractController*> controllers;
+    for (const QString& name : manager.getControllerNames()) {
+        controllers << manager.controller(name);
+    }
+
+    QBENCHMARK {
+        for (AbstractController* controller : controllers) {
+            emit controller->statusChanged(ControllerStatus::Connected);
+        }
+        for (AbstractController* controller : controllers) {
+            emit controller->statusChanged(ControllerStatus::Disconnected);
+        }
+    }
+    QCOMPARE(manager.getConnectedControllerCount(), 0);
+}
+
+QTEST_MAIN(TestControllerManager)
+#include "test_controller_manager.moc"
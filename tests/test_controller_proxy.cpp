@@ -0,0 +1,383 @@
+#include <QtTest>
+#include <QSignalSpy>
+#include <QQmlEngine>
+#include <QQmlComponent>
+#include <QQmlContext>
+#include <QJSValue>
+#include <memory>
+#include "ControllerManager.h"
+#include "ControllerProxy.h"
+#include "CapabilityRegistry.h"
+#include "LayoutConfig.h"
+#include "ValueMappingEngine.h"
+
+using namespace ObservatoryMonitor;
+
+// Binds straight to the property map; counts evaluations to show a value
+// only re-evaluates when its own capability changes. The counter is a plain
+// JS object so bumping it doesn't notify anything.
+static const QByteArray ValuesQml = R"(
+import QtQml
+QtObject {
+    property var counter: ({ ra: 0 })
+    property real ra: { counter.ra++; return proxy.values.RA === undefined ? -1 : proxy.values.RA }
+    property string pierSide: proxy.values.PierSide === undefined ? "" : proxy.values.PierSide
+}
+)";
+
+// Stands in for Application's mapping engine and counts mapWith() calls:
+// each dashboard widget binding makes exactly one per evaluation
+class CountingMappingEngine : public QObject
+{
+    Q_OBJECT
+
+public:
+    Q_INVOKABLE int compile(const QVariantMap& mapping) { return m_engine.compile(mapping); }
+    Q_INVOKABLE QVariant mapWith(int handle, const QVariant& input)
+    {
+        ++evaluations;
+        return m_engine.mapWith(handle, input);
+    }
+
+    int evaluations = 0;
+
+private:
+    ValueMappingEngine m_engine;
+};
+
+// The parts of Application that Dashboard.qml and its widgets read
+class DashboardApp : public QObject
+{
+    Q_OBJECT
+    Q_PROPERTY(QString theme READ theme CONSTANT)
+    Q_PROPERTY(bool editorMode READ editorMode CONSTANT)
+
+public:
+    explicit DashboardApp(ControllerProxy* controller) : m_controller(controller) {}
+
+    QString theme() const { return QStringLiteral("Dark"); }
+    bool editorMode() const { return false; }
+    Q_INVOKABLE QObject* getController(const QString& name) const
+    {
+        return name == m_controller->name() ? m_controller : nullptr;
+    }
+    Q_INVOKABLE void saveLayout() {}
+
+private:
+    ControllerProxy* m_controller;
+};
+
+class TestControllerProxy : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testTypedDecoders();
+    void testUnparsableKeepsLastValue();
+    void testUnregisteredCommand();
+    void testRegistryChangeRebuildsTable();
+    void testQmlBindsToValues();
+    void testDashboardBindingEvaluations_data();
+    void testDashboardBindingEvaluations();
+    void testDashboardLinkCleared();
+    void benchmarkDispatch();
+
+private:
+    static void send(ControllerManager& manager, const QString& controller,
+                     const QString& command, const QString& value);
+    static int counter(QObject* root, const QString& name);
+    // Loads resources/qml/Dashboard.qml with the context Application gives it
+    static QObject* createDashboard(QQmlEngine& engine, DashboardApp& app, CapabilityRegistry& registry,
+                                    LayoutConfig& layout, CountingMappingEngine& mappingEngine,
+                                    const QVariantMap& properties, QString& errorMessage);
+    // The loaded widget showing link, not the Loader that also carries it
+    static QObject* dashboardWidget(QObject* root, const QString& link);
+};
+
+void TestControllerProxy::send(ControllerManager& manager, const QString& controller,
+                               const QString& command, const QString& value)
+{
+    manager.dispatchData(controller, command, value);
+    manager.flushUpdates();
+}
+
+int TestControllerProxy::counter(QObject* root, const QString& name)
+{
+    return root->property("counter").value<QJSValue>().property(name).toInt();
+}
+
+QObject* TestControllerProxy::createDashboard(QQmlEngine& engine, DashboardApp& app, CapabilityRegistry& registry,
+                                             LayoutConfig& layout, CountingMappingEngine& mappingEngine,
+                                             const QVariantMap& properties, QString& errorMessage)
+{
+    engine.rootContext()->setContextProperty("app", &app);
+    engine.rootContext()->setContextProperty("caps", &registry);
+    engine.rootContext()->setContextProperty("layout", &layout);
+    engine.rootContext()->setContextProperty("valueMappingEngine", &mappingEngine);
+    QQmlComponent component(&engine, QUrl::fromLocalFile(QStringLiteral(OBSERVATORY_QML_DIR "/Dashboard.qml")));
+    QObject* root = component.createWithInitialProperties(properties);
+    if (!root) {
+        errorMessage = component.errorString();
+    }
+    return root;
+}
+
+QObject* TestControllerProxy::dashboardWidget(QObject* root, const QString& link)
+{
+    const QList<QObject*> objects = root->findChildren<QObject*>();
+    for (QObject* object : objects) {
+        if (object->property("propertyLink").toString() == link && object->property("isSelected").isValid()) {
+            return object;
+        }
+    }
+    return nullptr;
+}
+
+void TestControllerProxy::testTypedDecoders()
+{
+    ControllerManager manager;
+    CapabilityRegistry registry;
+    registry.registerProperties("Telescope", {
+        {"Azimuth", ":GZ#", "", "deg", "numeric"},
+        {"RA", ":GR#", "", "hrs", "numeric"},
+        {"Dec", ":GD#", "", "deg", "numeric"},
+        {"Temperature", ":GX9A#", "", "C", "numeric"},
+        {"PierSide", ":GS#", "", "", "binary"},
+        {"Firmware", ":GVN#", "", "", "string"},
+    });
+    ControllerProxy proxy("Telescope", &manager, &registry);
+
+    QQmlPropertyMap* values = proxy.values();
+    QVERIFY(values->contains("Temperature"));
+    QVERIFY(!values->value("Temperature").isValid());
+
+    send(manager, "Telescope", ":GZ#", "181*30:00#");
+    send(manager, "Telescope", ":GR#", "06:30:00#");
+    send(manager, "Telescope", ":GD#", "-10*15:00#");
+    send(manager, "Telescope", ":GX9A#", "12.5#");
+    send(manager, "Telescope", ":GS#", "W#");
+    send(manager, "Telescope", ":GVN#", "10.24c#");
+
+    QCOMPARE(values->value("Azimuth").toDouble(), 181.5);
+    QCOMPARE(values->value("RA").toDouble(), 6.5);
+    QCOMPARE(values->value("Dec").toDouble(), -10.25);
+    QCOMPARE(values->value("Temperature").toDouble(), 12.5);
+    QCOMPARE(values->value("PierSide").toString(), QString("West"));
+    QCOMPARE(values->value("Firmware").toString(), QString("10.24c"));
+
+    // The dedicated properties come off the same table
+    QCOMPARE(proxy.azimuth(), 181.5);
+    QCOMPARE(proxy.ra(), 6.5);
+    QCOMPARE(proxy.dec(), -10.25);
+    QCOMPARE(proxy.sideOfPier(), QString("West"));
+
+    // Raw replies are still available by command
+    QCOMPARE(proxy.getProperty(":GR#").toString(), QString("06:30:00#"));
+}
+
+void TestControllerProxy::testUnparsableKeepsLastValue()
+{
+    ControllerManager manager;
+    CapabilityRegistry registry;
+    ControllerProxy proxy("Telescope", &manager, &registry);
+    QSignalSpy altitudeSpy(&proxy, &ControllerProxy::altitudeChanged);
+
+    send(manager, "Telescope", ":GA#", "+45*00:00#");
+    send(manager, "Telescope", ":GA#", "garbage#");
+
+    QCOMPARE(altitudeSpy.count(), 1);
+    QCOMPARE(proxy.altitude(), 45.0);
+    QCOMPARE(proxy.values()->value("Altitude").toDouble(), 45.0);
+    QCOMPARE(proxy.getProperty(":GA#").toString(), QString("garbage#"));
+}
+
+void TestControllerProxy::testUnregisteredCommand()
+{
+    ControllerManager manager;
+    CapabilityRegistry registry;
+    ControllerProxy proxy("Telescope", &manager, &registry);
+    QSignalSpy changed(&proxy, &ControllerProxy::propertiesChanged);
+
+    send(manager, "Telescope", ":GXAS#", "abc#");
+
+    QCOMPARE(changed.count(), 1);
+    QCOMPARE(proxy.getProperty(":GXAS#").toString(), QString("abc#"));
+    QVERIFY(!proxy.values()->contains(":GXAS#"));
+}
+
+void TestControllerProxy::testRegistryChangeRebuildsTable()
+{
+    ControllerManager manager;
+    CapabilityRegistry registry;
+    ControllerProxy proxy("Telescope", &manager, &registry);
+
+    send(manager, "Telescope", ":GX9A#", "7.25#");
+    QVERIFY(!proxy.values()->contains("Temperature"));
+
+    // Values that already arrived are decoded as soon as they are registered
+    registry.registerProperties("Telescope", {{"Temperature", ":GX9A#", "", "C", "numeric"}});
+    QCOMPARE(proxy.values()->value("Temperature").toDouble(), 7.25);
+    QVERIFY(!proxy.values()->contains("RA"));
+
+    send(manager, "Telescope", ":GX9A#", "8.0#");
+    QCOMPARE(proxy.values()->value("Temperature").toDouble(), 8.0);
+}
+
+void TestControllerProxy::testQmlBindsToValues()
+{
+    ControllerManager manager;
+    CapabilityRegistry registry;
+    ControllerProxy proxy("Telescope", &manager, &registry);
+
+    QQmlEngine engine;
+    engine.rootContext()->setContextProperty("proxy", &proxy);
+    QQmlComponent component(&engine);
+    component.setData(ValuesQml, QUrl());
+    std::unique_ptr<QObject> root(component.create());
+    QVERIFY2(root, qPrintable(component.errorString()));
+
+    int before = counter(root.get(), "ra");
+    send(manager, "Telescope", ":GR#", "01:30:00#");
+    QCOMPARE(root->property("ra").toDouble(), 1.5);
+    QCOMPARE(counter(root.get(), "ra"), before + 1);
+
+    // Another capability changing leaves the RA binding alone
+    send(manager, "Telescope", ":GS#", "E#");
+    QCOMPARE(root->property("pierSide").toString(), QString("East"));
+    QCOMPARE(counter(root.get(), "ra"), before + 1);
+}
+
+void TestControllerProxy::testDashboardBindingEvaluations_data()
+{
+    QTest::addColumn<bool>("dedicated");
+    QTest::newRow("values") << false;
+    QTest::newRow("bindable") << true;
+}
+
+void TestControllerProxy::testDashboardBindingEvaluations()
+{
+    // A telescope panel on the real dashboard: one widget per coordinate,
+    // bound through controller.values or the proxy's bindable properties
+    QFETCH(bool, dedicated);
+    ControllerManager manager;
+    CapabilityRegistry registry;
+    registry.registerProperties("Telescope", {
+        {"Azimuth", ":GZ#", "", "deg", "numeric"},
+        {"Altitude", ":GA#", "", "deg", "numeric"},
+        {"RA", ":GR#", "", "hrs", "numeric"},
+        {"Dec", ":GD#", "", "deg", "numeric"},
+        {"PierSide", ":GS#", "", "", "binary"},
+    });
+    ControllerProxy proxy("Telescope", &manager, &registry);
+    QCOMPARE(proxy.dedicatedProperty("RA"), QString("ra"));
+    QCOMPARE(proxy.dedicatedProperty("PierSide"), QString("sideOfPier"));
+
+    LayoutConfig layout;
+    layout.clear();
+    const QStringList capabilities = {"Azimuth", "Altitude", "RA", "Dec", "PierSide"};
+    for (int i = 0; i < capabilities.size(); ++i) {
+        layout.addWidget({{"type", "Numeric"}, {"id", capabilities[i]}, {"label", capabilities[i]},
+                          {"x", 130 * i}, {"y", 0}, {"property", "Telescope." + capabilities[i]}});
+    }
+
+    DashboardApp app(&proxy);
+    CountingMappingEngine mappingEngine;
+    QQmlEngine engine;
+    QString errorMessage;
+    std::unique_ptr<QObject> root(createDashboard(engine, app, registry, layout, mappingEngine,
+                                                  {{"bindDedicatedProperties", dedicated}}, errorMessage));
+    QVERIFY2(root, qPrintable(errorMessage));
+
+    auto pollCycle = [&](const QString& azimuth) {
+        int before = mappingEngine.evaluations;
+        manager.dispatchData("Telescope", ":GZ#", azimuth);
+        manager.dispatchData("Telescope", ":GA#", "+45*00:00#");
+        manager.dispatchData("Telescope", ":GR#", "06:30:00#");
+        manager.dispatchData("Telescope", ":GD#", "-10*15:00#");
+        manager.dispatchData("Telescope", ":GS#", "W#");
+        manager.flushUpdates();
+        return mappingEngine.evaluations - before;
+    };
+
+    // First cycle fills every widget; afterwards only what moved re-evaluates
+    int first = pollCycle("181*30:00#");
+    int tracking = pollCycle("181*30:05#");
+    int idle = pollCycle("181*30:05#");
+    qInfo("Dashboard binding evaluations per poll cycle through %s: first %d, tracking %d, idle %d",
+          dedicated ? "bindable properties" : "values", first, tracking, idle);
+
+    QCOMPARE(first, 5);
+    QCOMPARE(tracking, 1);
+    QCOMPARE(idle, 0);
+
+    QObject* azimuthWidget = dashboardWidget(root.get(), "Telescope.Azimuth");
+    QVERIFY(azimuthWidget);
+    QCOMPARE(azimuthWidget->property("value").toDouble(), proxy.azimuth());
+}
+
+void TestControllerProxy::testDashboardLinkCleared()
+{
+    ControllerManager manager;
+    CapabilityRegistry registry;
+    registry.registerProperties("Telescope", {{"Azimuth", ":GZ#", "", "deg", "numeric"}});
+    ControllerProxy proxy("Telescope", &manager, &registry);
+
+    LayoutConfig layout;
+    layout.clear();
+    layout.addWidget({{"type", "Numeric"}, {"id", "az"}, {"property", "Telescope.Azimuth"}});
+
+    DashboardApp app(&proxy);
+    CountingMappingEngine mappingEngine;
+    QQmlEngine engine;
+    QString errorMessage;
+    std::unique_ptr<QObject> root(createDashboard(engine, app, registry, layout, mappingEngine, {}, errorMessage));
+    QVERIFY2(root, qPrintable(errorMessage));
+
+    send(manager, "Telescope", ":GZ#", "100*00:00#");
+    QObject* widget = dashboardWidget(root.get(), "Telescope.Azimuth");
+    QVERIFY(widget);
+    QCOMPARE(widget->property("value").toDouble(), 100.0);
+
+    // Cleared: the old binding goes with the link
+    layout.updateWidget("az", {{"property", ""}});
+    QCOMPARE(widget->property("propertyLink").toString(), QString());
+    QVERIFY(!widget->property("value").isValid());
+    int evaluations = mappingEngine.evaluations;
+    send(manager, "Telescope", ":GZ#", "120*00:00#");
+    QVERIFY(!widget->property("value").isValid());
+    QCOMPARE(mappingEngine.evaluations, evaluations);
+
+    // Relinked to a controller that doesn't exist: still nothing bound
+    layout.updateWidget("az", {{"property", "Telescope.Azimuth"}});
+    QCOMPARE(widget->property("value").toDouble(), 120.0);
+    layout.updateWidget("az", {{"property", "Dome.Azimuth"}});
+    QVERIFY(!widget->property("value").isValid());
+    send(manager, "Telescope", ":GZ#", "130*00:00#");
+    QVERIFY(!widget->property("value").isValid());
+}
+
+void TestControllerProxy::benchmarkDispatch()
+{
+    ControllerManager manager;
+    manager.setUpdateRate(0);
+    CapabilityRegistry registry;
+    ControllerProxy proxy("Telescope", &manager, &registry);
+
+    PropertyInterner& interner = PropertyInterner::instance();
+    const PropertyId ids[] = {interner.intern("Telescope", ":GZ#"), interner.intern("Telescope", ":GA#"),
+                              interner.intern("Telescope", ":GR#"), interner.intern("Telescope", ":GD#")};
+    const QString replies[2][4] = {{"181*30:00#", "+45*00:00#", "06:30:00#", "-10*15:00#"},
+                                   {"181*30:01#", "+45*00:01#", "06:30:01#", "-10*15:01#"}};
+
+    int cycle = 0;
+    QBENCHMARK {
+        const QString* row = replies[cycle++ & 1];
+        for (int i = 0; i < 4; ++i) {
+            manager.dispatchData(ids[i], row[i]);
+        }
+    }
+    QVERIFY(proxy.azimuth() > 181.0);
+}
+
+QTEST_MAIN(TestControllerProxy)
+#include "test_controller_proxy.moc"
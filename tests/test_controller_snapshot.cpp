@@ -0,0 +1,166 @@
+#include <QtTest>
+#include <QThread>
+#include <atomic>
+#include "ControllerManager.h"
+#include "RcuCell.h"
+
+using namespace ObservatoryMonitor;
+
+namespace {
+
+std::atomic<int> g_liveObjects{0};
+
+// Snapshot stand-in whose fields must always agree with each other
+struct Tracked {
+    explicit Tracked(int v) : a(v), b(v) { g_liveObjects++; }
+    ~Tracked() { g_liveObjects--; }
+    int a;
+    int b;
+};
+
+} // namespace
+
+class TestControllerSnapshot : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testPublishAndRead();
+    void testDeferredReclamation();
+    void testConcurrentReaders();
+    void testManagerSnapshot();
+    void benchmarkSnapshotRead();
+};
+
+void TestControllerSnapshot::testPublishAndRead()
+{
+    RcuCell<Tracked> cell;
+    QVERIFY(!cell.read());
+
+    cell.publish(std::make_unique<const Tracked>(1));
+    QCOMPARE(cell.read()->a, 1);
+
+    cell.publish(std::make_unique<const Tracked>(2));
+    QCOMPARE(cell.read()->a, 2);
+
+    // No reader held the first object, so it is already gone
+    QCOMPARE(cell.retiredCount(), 0);
+}
+
+void TestControllerSnapshot::testDeferredReclamation()
+{
+    int baseline = g_liveObjects;
+    {
+        RcuCell<Tracked> cell;
+        cell.publish(std::make_unique<const Tracked>(1));
+
+        {
+            auto guard = cell.read();
+            cell.publish(std::make_unique<const Tracked>(2));
+            cell.publish(std::make_unique<const Tracked>(3));
+
+            // The held object stays alive and unchanged
+            QCOMPARE(guard->a, 1);
+            QVERIFY(cell.retiredCount() >= 1);
+            QCOMPARE(g_liveObjects - baseline, 1 + cell.retiredCount());
+        }
+
+        cell.reclaim();
+        QCOMPARE(cell.retiredCount(), 0);
+        QCOMPARE(g_liveObjects - baseline, 1);
+    }
+    QCOMPARE(g_liveObjects.load(), baseline);
+}
+
+void TestControllerSnapshot::testConcurrentReaders()
+{
+    RcuCell<Tracked> cell;
+    cell.publish(std::make_unique<const Tracked>(0));
+
+    std::atomic<bool> stop{false};
+    std::atomic<int> inconsistent{0};
+    std::atomic<int> reads{0};
+
+    QList<QThread*> readers;
+    for (int i = 0; i < 4; ++i) {
+        readers << QThread::create([&]() {
+            int last = 0;
+            while (!stop) {
+                auto guard = cell.read();
+                // Torn or freed objects would show up as a/b mismatches or
+                // values going backwards
+                if (guard->a != guard->b || guard->a < last) inconsistent++;
+                last = guard->a;
+                reads++;
+            }
+        });
+        readers.last()->start();
+    }
+
+    for (int v = 1; v <= 20000; ++v) {
+        cell.publish(std::make_unique<const Tracked>(v));
+    }
+    stop = true;
+    for (QThread* thread : readers) {
+        thread->wait();
+        delete thread;
+    }
+
+    cell.reclaim();
+    QCOMPARE(inconsistent.load(), 0);
+    QVERIFY(reads > 0);
+    QCOMPARE(cell.retiredCount(), 0);
+}
+
+void TestControllerSnapshot::testManagerSnapshot()
+{
+    ControllerManager manager;
+    quint64 initialVersion = manager.snapshot()->version;
+
+    PropertyId az = PropertyInterner::instance().intern("snap", ":GZ#");
+    PropertyId alt = PropertyInterner::instance().intern("snap", ":GA#");
+
+    manager.dispatchData(az, "10.0#");
+    manager.dispatchData(alt, "20.0#");
+    manager.dispatchData(az, "11.0#");
+
+    // Nothing is published until the batch is flushed
+    QCOMPARE(manager.snapshot()->version, initialVersion);
+    manager.flushUpdates();
+
+    auto snapshot = manager.snapshot();
+    QCOMPARE(snapshot->version, initialVersion + 1);
+    QCOMPARE(snapshot->value(az).value, QString("11.0#"));
+    QVERIFY(snapshot->value(az).valid);
+    QCOMPARE(snapshot->value(alt).value, QString("20.0#"));
+    QVERIFY(!snapshot->value(InvalidPropertyId).valid);
+
+    // A held snapshot is immutable while newer ones are published
+    manager.dispatchData(az, "12.0#");
+    manager.flushUpdates();
+    QCOMPARE(snapshot->value(az).value, QString("11.0#"));
+    QCOMPARE(manager.snapshot()->value(az).value, QString("12.0#"));
+}
+
+void TestControllerSnapshot::benchmarkSnapshotRead()
+{
+    ControllerManager manager;
+    QVector<PropertyId> ids;
+    for (int i = 0; i < 200; ++i) {
+        ids << PropertyInterner::instance().intern(QString("bench%1").arg(i), ":GZ#");
+        manager.dispatchData(ids.last(), "1.0#");
+    }
+    manager.flushUpdates();
+
+    int valid = 0;
+    QBENCHMARK {
+        auto snapshot = manager.snapshot();
+        for (PropertyId id : ids) {
+            if (snapshot->values[id].valid) valid++;
+        }
+    }
+    QVERIFY(valid > 0);
+}
+
+QTEST_GUILESS_MAIN(TestControllerSnapshot)
+#include "test_controller_snapshot.moc"
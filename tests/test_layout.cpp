@@ -1,4 +1,6 @@
 #include <QtTest>
+#include <QTemporaryDir>
+#include <QAbstractItemModelTester>
 #include "LayoutConfig.h"
 #include "CapabilityRegistry.h"
 
@@ -12,6 +14,12 @@ private slots:
     void testCircularDependency();
     void testDuplicateNodeIds();
     void testValidLayout();
+    void testMappingRoundTrip();
+    void testInvalidMapping();
+    void testWidgetModelRows();
+    void testWidgetModelRoles();
+    void testSceneModelTree();
+    void testSceneModelEdits();
 };
 
 void TestLayout::testCircularDependency()
@@ -82,5 +90,202 @@ void TestLayout::testValidLayout()
     QVERIFY(result);
 }
 
+void TestLayout::testMappingRoundTrip()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString path = dir.filePath("layout.yaml");
+
+    LayoutConfig layout;
+    layout.clear();
+    layout.addWidget({{"type", "Numeric"}, {"id", "temp"}, {"property", "Observatory.Temperature"},
+                      {"mapping", QVariantMap{{"type", "polynomial"}, {"coefficients", QVariantList{-40, 0.5}}}}});
+    layout.addWidget({{"type", "Numeric"}, {"id", "humidity"}, {"property", "Observatory.Humidity"},
+                      {"mapping", QVariantMap{{"type", "lut"},
+                                              {"points", QVariantList{QVariantList{0, 0}, QVariantList{3.3, 100}}}}}});
+    layout.addSceneNode({{"id", "dome"}, {"model", "#Cube"},
+                         {"motion", QVariantMap{{"type", "rotation"}, {"property", "Observatory.Azimuth"},
+                                                {"mapping", QVariantMap{{"type", "angle"}, {"in_max", 360},
+                                                                        {"out_max", -360}, {"unwrap", true}}}}}});
+    // Partial updates keep the rest of the mapping
+    layout.updateWidget("temp", {{"mapping", QVariantMap{{"coefficients", QVariantList{-40, 0.25}}}}});
+
+    QString errorMessage;
+    QVERIFY2(layout.saveToFile(path, errorMessage), qPrintable(errorMessage));
+
+    LayoutConfig loaded;
+    QVERIFY2(loaded.loadFromFile(path, errorMessage), qPrintable(errorMessage));
+    QVariantList widgets = loaded.widgetsVariant();
+    QCOMPARE(widgets.size(), 2);
+
+    QVariantMap temp = widgets[0].toMap()["mapping"].toMap();
+    QCOMPARE(temp["type"].toString(), QString("polynomial"));
+    QCOMPARE(temp["coefficients"].toList().value(1).toDouble(), 0.25);
+
+    QVariantMap humidity = widgets[1].toMap()["mapping"].toMap();
+    QCOMPARE(humidity["points"].toList().size(), 2);
+    QCOMPARE(humidity["points"].toList().value(1).toList().value(0).toDouble(), 3.3);
+
+    QVariantMap dome = loaded.sceneNodesVariant()[0].toMap()["motion"].toMap()["mapping"].toMap();
+    QCOMPARE(dome["type"].toString(), QString("angle"));
+    QCOMPARE(dome["out_max"].toDouble(), -360.0);
+    QCOMPARE(dome["period"].toDouble(), 360.0);
+    QVERIFY(dome["unwrap"].toBool());
+}
+
+void TestLayout::testInvalidMapping()
+{
+    LayoutConfig layout;
+    layout.clear();
+    CapabilityRegistry caps;
+    layout.addWidget({{"type", "Numeric"}, {"id", "w"},
+                      {"mapping", QVariantMap{{"type", "lut"}, {"points", QVariantList{QVariant(QVariantList{0, 1})}}}}});
+
+    QString errorMessage;
+    QVERIFY(!layout.validate(&caps, errorMessage));
+    QVERIFY(errorMessage.contains("at least two points"));
+}
+
+void TestLayout::testWidgetModelRows()
+{
+    LayoutConfig layout;
+    WidgetListModel* model = layout.widgetModel();
+    QAbstractItemModelTester tester(model, QAbstractItemModelTester::FailureReportingMode::QtTest);
+    QCOMPARE(model->rowCount(), layout.widgets().size());
+
+    layout.clear();
+    QCOMPARE(model->rowCount(), 0);
+
+    QSignalSpy inserted(model, &QAbstractItemModel::rowsInserted);
+    QSignalSpy removed(model, &QAbstractItemModel::rowsRemoved);
+    QSignalSpy reset(model, &QAbstractItemModel::modelReset);
+
+    layout.addWidget({{"type", "Numeric"}, {"id", "a"}});
+    layout.addWidget({{"type", "Binary"}, {"id", "b"}});
+    QCOMPARE(inserted.count(), 2);
+    QCOMPARE(inserted.last().at(1).toInt(), 1);
+    QCOMPARE(model->rowOf("b"), 1);
+    QCOMPARE(model->data(model->index(1), WidgetListModel::WidgetTypeRole).toString(), QString("Binary"));
+
+    layout.removeWidget("a");
+    QCOMPARE(removed.count(), 1);
+    QCOMPARE(removed.last().at(1).toInt(), 0);
+    QCOMPARE(model->rowOf("b"), 0);
+    QCOMPARE(reset.count(), 0);
+}
+
+void TestLayout::testWidgetModelRoles()
+{
+    LayoutConfig layout;
+    layout.clear();
+    layout.addWidget({{"type", "Numeric"}, {"id", "a"}, {"x", 10}, {"y", 20}});
+    layout.addWidget({{"type", "Numeric"}, {"id", "b"}});
+    WidgetListModel* model = layout.widgetModel();
+
+    QSignalSpy dataChanged(model, &QAbstractItemModel::dataChanged);
+    QSignalSpy widgetsChanged(&layout, &LayoutConfig::widgetsChanged);
+
+    // Moving a widget only touches its position
+    layout.updateWidget("b", {{"x", 40}, {"y", 50}});
+    QCOMPARE(dataChanged.count(), 1);
+    QCOMPARE(dataChanged.last().at(0).value<QModelIndex>().row(), 1);
+    QCOMPARE(dataChanged.last().at(1).value<QModelIndex>().row(), 1);
+    QList<int> roles = dataChanged.last().at(2).value<QList<int>>();
+    std::sort(roles.begin(), roles.end());
+    QCOMPARE(roles, (QList<int>{WidgetListModel::PosXRole, WidgetListModel::PosYRole,
+                                WidgetListModel::ConfigRole}));
+    QCOMPARE(model->data(model->index(1), WidgetListModel::PosXRole).toDouble(), 40.0);
+    QCOMPARE(model->data(model->index(1), WidgetListModel::ConfigRole).toMap()["y"].toDouble(), 50.0);
+
+    // Writing back the current values is not a change
+    layout.updateWidget("a", {{"x", 10}, {"y", 20}, {"type", "Numeric"}});
+    QCOMPARE(dataChanged.count(), 1);
+    QCOMPARE(widgetsChanged.count(), 1);
+
+    layout.updateWidget("a", {{"mapping", QVariantMap{{"type", "linear"}, {"out_max", 100}}}});
+    QCOMPARE(dataChanged.count(), 2);
+    QVERIFY(dataChanged.last().at(2).value<QList<int>>().contains(WidgetListModel::MappingRole));
+    QCOMPARE(model->data(model->index(0), WidgetListModel::MappingRole).toMap()["out_max"].toDouble(), 100.0);
+}
+
+void TestLayout::testSceneModelTree()
+{
+    LayoutConfig layout;
+    SceneNodeTreeModel* model = layout.sceneModel();
+    QAbstractItemModelTester tester(model, QAbstractItemModelTester::FailureReportingMode::QtTest);
+
+    // Defaults: dome, pier and mount at the top, tube under the mount
+    QCOMPARE(model->rowCount(), 3);
+    QModelIndex mount = model->indexOf("mount");
+    QCOMPARE(mount.row(), 2);
+    QCOMPARE(model->rowCount(mount), 1);
+    QModelIndex tube = model->index(0, 0, mount);
+    QCOMPARE(model->data(tube, SceneNodeTreeModel::NodeIdRole).toString(), QString("tube"));
+    QCOMPARE(model->parent(tube), mount);
+
+    layout.clear();
+    QCOMPARE(model->rowCount(), 0);
+
+    // A child added before its parent waits at the top level
+    layout.addSceneNode({{"id", "camera"}, {"model", "#Cube"}, {"parent", "ota"}});
+    QCOMPARE(model->rowCount(), 1);
+    QSignalSpy moved(model, &QAbstractItemModel::rowsMoved);
+    layout.addSceneNode({{"id", "ota"}, {"model", "#Cylinder"}});
+    QCOMPARE(moved.count(), 1);
+    QCOMPARE(model->rowCount(), 1);
+    QCOMPARE(model->parent(model->indexOf("camera")), model->indexOf("ota"));
+
+    // Cycles stay visible: the second link of the loop is dropped
+    layout.updateSceneNode("ota", {{"parent", "camera"}});
+    QCOMPARE(model->rowCount(), 1);
+    QCOMPARE(model->parent(model->indexOf("camera")), model->indexOf("ota"));
+
+    // Removing a parent moves its children up instead of dropping them
+    QSignalSpy removed(model, &QAbstractItemModel::rowsRemoved);
+    layout.removeSceneNode("ota");
+    QCOMPARE(removed.count(), 1);
+    QCOMPARE(model->rowCount(), 1);
+    QCOMPARE(model->data(model->index(0, 0), SceneNodeTreeModel::NodeIdRole).toString(), QString("camera"));
+}
+
+void TestLayout::testSceneModelEdits()
+{
+    LayoutConfig layout;
+    SceneNodeTreeModel* model = layout.sceneModel();
+    QAbstractItemModelTester tester(model, QAbstractItemModelTester::FailureReportingMode::QtTest);
+
+    QSignalSpy dataChanged(model, &QAbstractItemModel::dataChanged);
+    QSignalSpy reset(model, &QAbstractItemModel::modelReset);
+    QSignalSpy moved(model, &QAbstractItemModel::rowsMoved);
+
+    // Nudging the tube touches only the tube
+    layout.updateSceneNode("tube", {{"offset", QVector3D(0, 1, 0)}});
+    QCOMPARE(dataChanged.count(), 1);
+    QModelIndex tube = model->indexOf("tube");
+    QCOMPARE(dataChanged.last().at(0).value<QModelIndex>(), tube);
+    QList<int> roles = dataChanged.last().at(2).value<QList<int>>();
+    std::sort(roles.begin(), roles.end());
+    QCOMPARE(roles, (QList<int>{SceneNodeTreeModel::OffsetRole, SceneNodeTreeModel::ConfigRole}));
+    QCOMPARE(model->data(tube, SceneNodeTreeModel::OffsetRole).value<QVector3D>(), QVector3D(0, 1, 0));
+
+    // Same value again: nothing to report
+    layout.updateSceneNode("tube", {{"offset", QVector3D(0, 1, 0)}});
+    QCOMPARE(dataChanged.count(), 1);
+
+    layout.updateSceneNode("dome", {{"motion", QVariantMap{{"mapping", QVariantMap{{"out_max", -180}}}}}});
+    QCOMPARE(dataChanged.count(), 2);
+    QVERIFY(dataChanged.last().at(2).value<QList<int>>().contains(SceneNodeTreeModel::MotionRole));
+    QVariantMap motion = model->data(model->indexOf("dome"), SceneNodeTreeModel::MotionRole).toMap();
+    QCOMPARE(motion["mapping"].toMap()["out_max"].toDouble(), -180.0);
+    QCOMPARE(motion["mapping"].toMap()["type"].toString(), QString("angle"));
+
+    // Reparenting is a single move
+    layout.updateSceneNode("tube", {{"parent", "pier"}});
+    QCOMPARE(moved.count(), 1);
+    QCOMPARE(model->parent(model->indexOf("tube")), model->indexOf("pier"));
+    QCOMPARE(model->rowCount(model->indexOf("mount")), 0);
+    QCOMPARE(reset.count(), 0);
+}
+
 QTEST_MAIN(TestLayout)
 #include "test_layout.moc"
@@ -0,0 +1,242 @@
+#include <QtTest>
+#include <QTemporaryDir>
+#include "LayoutCache.h"
+#include "LayoutConfig.h"
+#include "CapabilityRegistry.h"
+
+using namespace ObservatoryMonitor;
+
+class TestLayoutCache : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void testRoundTrip();
+    void testStaleSource();
+    void testMissingModel();
+    void testCorruptPayload();
+    void testOtherVersion();
+    void benchmarkStartup_data();
+    void benchmarkStartup();
+
+private:
+    // Writes YAML sources for a dashboard of the given size
+    void writeSources(int widgetCount);
+    bool flipByte(qint64 offset);
+
+    QTemporaryDir m_dir;
+    QString m_capsPath;
+    QString m_layoutPath;
+    QString m_cachePath;
+};
+
+void TestLayoutCache::init()
+{
+    QVERIFY(m_dir.isValid());
+    m_capsPath = m_dir.filePath("capabilities.yaml");
+    m_layoutPath = m_dir.filePath("layout.yaml");
+    m_cachePath = LayoutCache::pathFor(m_layoutPath);
+    QCOMPARE(m_cachePath, m_dir.filePath("layout.cache"));
+    QFile::remove(m_cachePath);
+}
+
+void TestLayoutCache::writeSources(int widgetCount)
+{
+    QString errorMessage;
+    CapabilityRegistry caps;
+    QList<PropertyDefinition> props;
+    for (int p = 0; p < 16; ++p) {
+        props.append(PropertyDefinition{QString("Property%1").arg(p), QString(":G%1#").arg(p), "", "", "numeric"});
+    }
+    caps.registerProperties("Weather", props);
+    QVERIFY2(caps.saveToFile(m_capsPath, errorMessage), qPrintable(errorMessage));
+
+    LayoutConfig layout;
+    layout.clear();
+    for (int i = 0; i < widgetCount; ++i) {
+        layout.addWidget({{"type", "Numeric"}, {"id", QString("w%1").arg(i)}, {"x", i}, {"y", 2 * i},
+                          {"property", QString("Weather.Property%1").arg(i % 16)},
+                          {"mapping", QVariantMap{{"type", "lut"},
+                                                  {"points", QVariantList{QVariantList{0, 0}, QVariantList{1, 10}}}}}});
+    }
+    layout.addSceneNode({{"id", "dome"}, {"model", "#Cube"},
+                         {"motion", QVariantMap{{"type", "rotation"}, {"property", "Telescope.Azimuth"},
+                                                {"mapping", QVariantMap{{"type", "angle"}, {"unwrap", true}}}}}});
+    layout.addSceneNode({{"id", "tube"}, {"model", "#Cylinder"}, {"parent", "dome"},
+                         {"offset", QVector3D(0, 1.5f, 0)}});
+    QVERIFY2(layout.saveToFile(m_layoutPath, errorMessage), qPrintable(errorMessage));
+}
+
+bool TestLayoutCache::flipByte(qint64 offset)
+{
+    QFile file(m_cachePath);
+    char value = 0;
+    if (!file.open(QIODevice::ReadWrite) || !file.seek(offset) || !file.getChar(&value)) return false;
+    value ^= 0x01;
+    return file.seek(offset) && file.putChar(value);
+}
+
+void TestLayoutCache::testRoundTrip()
+{
+    writeSources(8);
+    QString errorMessage;
+
+    CapabilityRegistry caps;
+    LayoutConfig layout;
+    QVERIFY(caps.loadFromFile(m_capsPath, errorMessage));
+    QVERIFY(layout.loadFromFile(m_layoutPath, errorMessage));
+    QVERIFY2(layout.validate(&caps, errorMessage), qPrintable(errorMessage));
+
+    QByteArray hash = LayoutCache::sourceHash({m_capsPath, m_layoutPath});
+    QCOMPARE(hash.size(), 32);
+    QVERIFY2(LayoutCache::write(m_cachePath, hash, layout, caps, errorMessage), qPrintable(errorMessage));
+
+    CapabilityRegistry cachedCaps;
+    LayoutConfig cachedLayout;
+    cachedLayout.clear();
+    QVERIFY2(LayoutCache::read(m_cachePath, hash, cachedLayout, cachedCaps, errorMessage), qPrintable(errorMessage));
+
+    QCOMPARE(cachedCaps.allPropertyLinks(), caps.allPropertyLinks());
+    QCOMPARE(cachedLayout.widgetsVariant(), layout.widgetsVariant());
+    QCOMPARE(cachedLayout.sceneNodesVariant(), layout.sceneNodesVariant());
+    QCOMPARE(cachedLayout.backgroundColor(), layout.backgroundColor());
+    QVERIFY(cachedLayout.isValid());
+
+    // The tree model is rebuilt from the restored nodes
+    QCOMPARE(cachedLayout.sceneModel()->rowCount(), 1);
+}
+
+void TestLayoutCache::testStaleSource()
+{
+    writeSources(2);
+    QString errorMessage;
+    CapabilityRegistry caps;
+    LayoutConfig layout;
+    QVERIFY(layout.loadFromFile(m_layoutPath, errorMessage));
+    QVERIFY(LayoutCache::write(m_cachePath, LayoutCache::sourceHash({m_capsPath, m_layoutPath}),
+                               layout, caps, errorMessage));
+
+    // Edit the layout after the cache was built
+    layout.updateWidget("w0", {{"label", "Edited"}});
+    QVERIFY(layout.saveToFile(m_layoutPath, errorMessage));
+
+    LayoutConfig cachedLayout;
+    cachedLayout.clear();
+    QVERIFY(!LayoutCache::read(m_cachePath, LayoutCache::sourceHash({m_capsPath, m_layoutPath}),
+                               cachedLayout, caps, errorMessage));
+    QVERIFY(errorMessage.contains("stale"));
+    QVERIFY(cachedLayout.widgets().isEmpty());
+
+    QVERIFY(LayoutCache::sourceHash({m_capsPath, m_dir.filePath("missing.yaml")}).isEmpty());
+}
+
+void TestLayoutCache::testMissingModel()
+{
+    // Model files are not part of the source hash
+    writeSources(2);
+    const QString modelPath = m_dir.filePath("mount.mesh");
+    QFile model(modelPath);
+    QVERIFY(model.open(QIODevice::WriteOnly));
+    model.close();
+
+    QString errorMessage;
+    CapabilityRegistry caps;
+    LayoutConfig layout;
+    QVERIFY(caps.loadFromFile(m_capsPath, errorMessage));
+    QVERIFY(layout.loadFromFile(m_layoutPath, errorMessage));
+    layout.updateSceneNode("tube", {{"model", modelPath}});
+    QVERIFY(layout.saveToFile(m_layoutPath, errorMessage));
+    QVERIFY2(layout.validate(&caps, errorMessage), qPrintable(errorMessage));
+    QByteArray hash = LayoutCache::sourceHash({m_capsPath, m_layoutPath});
+    QVERIFY(LayoutCache::write(m_cachePath, hash, layout, caps, errorMessage));
+
+    QVERIFY(QFile::remove(modelPath));
+    QCOMPARE(LayoutCache::sourceHash({m_capsPath, m_layoutPath}), hash);
+
+    LayoutConfig cachedLayout;
+    QVERIFY(LayoutCache::read(m_cachePath, hash, cachedLayout, caps, errorMessage));
+    QVERIFY(cachedLayout.isValid());
+    QVERIFY(!cachedLayout.validateModelFiles(errorMessage));
+    QVERIFY(errorMessage.contains("missing model file"));
+    QVERIFY(!cachedLayout.isValid());
+    QCOMPARE(cachedLayout.validationError(), errorMessage);
+}
+
+void TestLayoutCache::testCorruptPayload()
+{
+    writeSources(2);
+    QString errorMessage;
+    CapabilityRegistry caps;
+    LayoutConfig layout;
+    QByteArray hash = LayoutCache::sourceHash({m_capsPath, m_layoutPath});
+    QVERIFY(LayoutCache::write(m_cachePath, hash, layout, caps, errorMessage));
+    QVERIFY(flipByte(QFileInfo(m_cachePath).size() - 5));
+
+    LayoutConfig cachedLayout;
+    cachedLayout.clear();
+    QVERIFY(!LayoutCache::read(m_cachePath, hash, cachedLayout, caps, errorMessage));
+    QVERIFY(errorMessage.contains("checksum"));
+    QVERIFY(cachedLayout.sceneNodes().isEmpty());
+}
+
+void TestLayoutCache::testOtherVersion()
+{
+    writeSources(2);
+    QString errorMessage;
+    CapabilityRegistry caps;
+    LayoutConfig layout;
+    QByteArray hash = LayoutCache::sourceHash({m_capsPath, m_layoutPath});
+    QVERIFY(LayoutCache::write(m_cachePath, hash, layout, caps, errorMessage));
+    QVERIFY(flipByte(4));
+
+    QVERIFY(!LayoutCache::read(m_cachePath, hash, layout, caps, errorMessage));
+    QVERIFY(errorMessage.contains("version"));
+
+    QVERIFY(flipByte(0));
+    QVERIFY(!LayoutCache::read(m_cachePath, hash, layout, caps, errorMessage));
+}
+
+void TestLayoutCache::benchmarkStartup_data()
+{
+    QTest::addColumn<bool>("fromCache");
+    QTest::newRow("yaml") << false;
+    QTest::newRow("cache") << true;
+}
+
+void TestLayoutCache::benchmarkStartup()
+{
+    // Both paths as Application::loadConfiguration runs them, hashing included
+    QFETCH(bool, fromCache);
+    writeSources(200);
+
+    QString errorMessage;
+    {
+        CapabilityRegistry caps;
+        LayoutConfig layout;
+        QVERIFY(caps.loadFromFile(m_capsPath, errorMessage));
+        QVERIFY(layout.loadFromFile(m_layoutPath, errorMessage));
+        QVERIFY2(layout.validate(&caps, errorMessage), qPrintable(errorMessage));
+        QVERIFY(LayoutCache::write(m_cachePath, LayoutCache::sourceHash({m_capsPath, m_layoutPath}),
+                                   layout, caps, errorMessage));
+    }
+
+    CapabilityRegistry caps;
+    LayoutConfig layout;
+    bool ok = false;
+    QBENCHMARK {
+        if (fromCache) {
+            QByteArray hash = LayoutCache::sourceHash({m_capsPath, m_layoutPath});
+            ok = LayoutCache::read(m_cachePath, hash, layout, caps, errorMessage);
+        } else {
+            ok = caps.loadFromFile(m_capsPath, errorMessage)
+                && layout.loadFromFile(m_layoutPath, errorMessage)
+                && layout.validate(&caps, errorMessage);
+        }
+    }
+    QVERIFY2(ok, qPrintable(errorMessage));
+    QCOMPARE(layout.widgets().size(), 200);
+}
+
+QTEST_MAIN(TestLayoutCache)
+#include "test_layout_cache.moc"
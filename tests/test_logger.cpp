@@ -3,10 +3,15 @@
 #include <QFile>
 #include <QThread>
 #include <QDebug>
+#include <QRegularExpression>
 #include "Logger.h"
+#include "LogCompression.h"
 
 using namespace ObservatoryMonitor;
 
+static LogCategory lcTest("Test");
+static LogCategory lcBench("Bench");
+
 class TestLogger : public QObject
 {
     Q_OBJECT
@@ -23,9 +28,24 @@ private slots:
     void testFileCreation();
     void testLogRotation();
     void testSizeLimit();
+    void testSizeRotation();
+    void testRetentionCountsEachFileOnce();
+    void testCompressRotatedSegments();
     void testConcurrentLogging();
+    void testAsyncBlockKeepsEveryRecord();
+    void testAsyncDropCountsOverflow();
+    void testAsyncFlush();
+    void benchmarkThroughput_data();
+    void benchmarkThroughput();
+    void testCategoryFilter();
+    void benchmarkDisabledDebug_data();
+    void benchmarkDisabledDebug();
     
 private:
+    // Logs messagesPerThread lines "<tag> <thread> <n>" from each thread
+    static void logFromThreads(const QString& tag, int threads, int messagesPerThread);
+    QStringList readUserLog() const;
+
     QTemporaryDir* m_tempDir;
 };
 
@@ -50,6 +70,9 @@ void TestLogger::cleanup()
 {
     qDebug() << "Cleanup: Shutting down logger...";
     Logger::instance().shutdown();
+    Logger::instance().setAsync(false);
+    Logger::instance().setMaxFileSize(0);
+    Logger::instance().setCompression(false);
     qDebug() << "Cleanup: Logger shut down";
     
     if (m_tempDir) {
@@ -222,6 +245,109 @@ void TestLogger::testSizeLimit()
     qDebug() << "TEST: testSizeLimit - END";
 }
 
+void TestLogger::testSizeRotation()
+{
+    Logger& logger = Logger::instance();
+    logger.setMaxFileSize(1);
+    QVERIFY(logger.initialize(m_tempDir->path(), false, false, 3));
+    
+    // About 6 MB through 1 MB segments under a 3 MB budget
+    const QString padding(200, 'x');
+    for (int i = 0; i < 30000; i++) {
+        logger.info(QString("Segment test %1 %2").arg(i).arg(padding));
+    }
+    
+    const QString date = QDate::currentDate().toString("yyyy-MM-dd");
+    const QString current = logger.userLogPath();
+    QVERIFY(current.endsWith(".log"));
+    const int segment = current.section('.', -2, -2).toInt();
+    QVERIFY(segment >= 5);
+    logger.shutdown();
+    
+    // The oldest segments were deleted, the newest kept
+    QDir dir(m_tempDir->path());
+    QVERIFY(!dir.exists("observatory-monitor_" + date + ".log"));
+    QVERIFY(dir.exists(QString("observatory-monitor_%1.%2.log").arg(date).arg(segment - 1)));
+    QVERIFY(QFileInfo(current).exists());
+    
+    qint64 total = 0;
+    for (const QFileInfo& info : dir.entryInfoList(QDir::Files)) {
+        QVERIFY(info.size() < 2 * 1024 * 1024);
+        total += info.size();
+    }
+    QVERIFY(total <= 4 * 1024 * 1024);
+    
+    // A restart continues the last segment
+    QVERIFY(logger.initialize(m_tempDir->path(), false, false, 3));
+    QCOMPARE(logger.userLogPath(), current);
+}
+
+void TestLogger::testRetentionCountsEachFileOnce()
+{
+    // 0.3 MB + 0.6 MB of old logs fit a 1 MB budget; the debug log must not
+    // be counted twice
+    const QDateTime old = QDateTime::currentDateTime().addDays(-30);
+    const QString base = m_tempDir->path() + "/observatory-monitor_2020-01-01";
+    const QList<QPair<QString, int>> files = {{base + ".log", 300}, {base + "_debug.log", 600}};
+    for (const auto& file : files) {
+        QFile f(file.first);
+        QVERIFY(f.open(QIODevice::WriteOnly));
+        f.write(QByteArray(file.second * 1024, 'x'));
+        f.setFileTime(old, QFileDevice::FileModificationTime);
+    }
+    
+    Logger& logger = Logger::instance();
+    QVERIFY(logger.initialize(m_tempDir->path(), false, false, 1));
+    logger.info("Retention check");
+    logger.shutdown();
+    
+    QVERIFY(QFile::exists(base + ".log"));
+    QVERIFY(QFile::exists(base + "_debug.log"));
+}
+
+void TestLogger::testCompressRotatedSegments()
+{
+    // A segment left by an earlier run is compressed on startup
+    const QString leftover = m_tempDir->path() + "/observatory-monitor_2020-01-01.log";
+    {
+        QFile f(leftover);
+        QVERIFY(f.open(QIODevice::WriteOnly | QIODevice::Text));
+        for (int i = 0; i < 1000; i++) {
+            f.write(QString("[2020-01-01 00:00:00.000] [INFO ] Old message %1\n").arg(i).toUtf8());
+        }
+    }
+    
+    Logger& logger = Logger::instance();
+    logger.setMaxFileSize(1);
+    logger.setCompression(true);
+    QVERIFY(logger.initialize(m_tempDir->path(), false, false, 100));
+    
+    const QString padding(200, 'x');
+    for (int i = 0; i < 6000; i++) {
+        logger.info(QString("Compress test %1 %2").arg(i).arg(padding));
+    }
+    
+    const QString first = m_tempDir->path() + "/observatory-monitor_" +
+                          QDate::currentDate().toString("yyyy-MM-dd") + ".log";
+    QTRY_VERIFY_WITH_TIMEOUT(QFile::exists(first + LogCompression::Extension) && !QFile::exists(first), 10000);
+    QTRY_VERIFY_WITH_TIMEOUT(QFile::exists(leftover + LogCompression::Extension) && !QFile::exists(leftover), 10000);
+    QVERIFY(QFile::exists(logger.userLogPath()));
+    logger.shutdown();
+    
+    // The compressed segment reads back whole, at a fraction of the size
+    QByteArray data;
+    QString errorMessage;
+    QVERIFY2(LogCompression::readFile(first + LogCompression::Extension, data, errorMessage),
+             qPrintable(errorMessage));
+    QVERIFY(data.size() >= 1024 * 1024);
+    QVERIFY(data.contains("Compress test 0 "));
+    QVERIFY(QFileInfo(first + LogCompression::Extension).size() * 10 < data.size());
+    
+    // A restart continues after the compressed segment
+    QVERIFY(logger.initialize(m_tempDir->path(), false, false, 100));
+    QVERIFY(logger.userLogPath() != first);
+}
+
 void TestLogger::testConcurrentLogging()
 {
     qDebug() << "TEST: testConcurrentLogging - START";
@@ -256,5 +382,179 @@ void TestLogger::testConcurrentLogging()
     qDebug() << "TEST: testConcurrentLogging - END";
 }
 
+void TestLogger::logFromThreads(const QString& tag, int threads, int messagesPerThread)
+{
+    QList<QThread*> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.append(QThread::create([tag, t, messagesPerThread]() {
+            for (int n = 0; n < messagesPerThread; ++n) {
+                Logger::instance().info(QString("%1 %2 %3").arg(tag).arg(t).arg(n));
+            }
+        }));
+    }
+    for (QThread* worker : workers) worker->start();
+    for (QThread* worker : workers) {
+        worker->wait();
+        delete worker;
+    }
+}
+
+QStringList TestLogger::readUserLog() const
+{
+    QFile logFile(m_tempDir->path() + "/observatory-monitor_" +
+                  QDate::currentDate().toString("yyyy-MM-dd") + ".log");
+    if (!logFile.open(QIODevice::ReadOnly | QIODevice::Text)) return QStringList();
+    return QString::fromUtf8(logFile.readAll()).split('\n', Qt::SkipEmptyParts);
+}
+
+void TestLogger::testAsyncBlockKeepsEveryRecord()
+{
+    Logger& logger = Logger::instance();
+    logger.setAsync(true, LogOverflowPolicy::Block, 64);
+    QVERIFY(logger.initialize(m_tempDir->path(), false, false, 100));
+    QVERIFY(logger.isAsync());
+    
+    const int threads = 4;
+    const int perThread = 5000;
+    logFromThreads("Block", threads, perThread);
+    logger.shutdown();
+    QVERIFY(!logger.isAsync());
+    QCOMPARE(logger.droppedCount(), quint64(0));
+    
+    // Every record is there, and each thread's records stay in order
+    static const QRegularExpression pattern("Block (\\d+) (\\d+)$");
+    QList<int> next(threads, 0);
+    int count = 0;
+    for (const QString& line : readUserLog()) {
+        QRegularExpressionMatch match = pattern.match(line);
+        if (!match.hasMatch()) continue;
+        const int t = match.captured(1).toInt();
+        QCOMPARE(match.captured(2).toInt(), next[t]);
+        ++next[t];
+        ++count;
+    }
+    QCOMPARE(count, threads * perThread);
+}
+
+void TestLogger::testAsyncDropCountsOverflow()
+{
+    Logger& logger = Logger::instance();
+    logger.setAsync(true, LogOverflowPolicy::Drop, 16);
+    QVERIFY(logger.initialize(m_tempDir->path(), false, false, 100));
+    
+    const int threads = 4;
+    const int perThread = 5000;
+    logFromThreads("Drop", threads, perThread);
+    logger.shutdown();
+    
+    const int written = readUserLog().filter(QRegularExpression("Drop \\d+ \\d+$")).size();
+    QVERIFY(written > 0);
+    QCOMPARE(quint64(written) + logger.droppedCount(), quint64(threads * perThread));
+}
+
+void TestLogger::testAsyncFlush()
+{
+    Logger& logger = Logger::instance();
+    logger.setAsync(true);
+    QVERIFY(logger.initialize(m_tempDir->path(), false, false, 100));
+    
+    logger.info("Before flush");
+    logger.flush();
+    
+    // On disk while the logger is still running
+    QVERIFY(readUserLog().filter("Before flush").size() == 1);
+}
+
+void TestLogger::benchmarkThroughput_data()
+{
+    QTest::addColumn<bool>("async");
+    QTest::addColumn<bool>("block");
+    QTest::newRow("sync") << false << false;
+    QTest::newRow("async-drop") << true << false;
+    QTest::newRow("async-block") << true << true;
+}
+
+void TestLogger::benchmarkThroughput()
+{
+    // Cost seen by the logging threads; the async rows exclude the writer
+    QFETCH(bool, async);
+    QFETCH(bool, block);
+    
+    Logger& logger = Logger::instance();
+    logger.setAsync(async, block ? LogOverflowPolicy::Block : LogOverflowPolicy::Drop);
+    QVERIFY(logger.initialize(m_tempDir->path(), false, false, 1000));
+    
+    QBENCHMARK {
+        logFromThreads("Bench", 4, 2500);
+    }
+    logger.shutdown();
+}
+
+void TestLogger::testCategoryFilter()
+{
+    Logger& logger = Logger::instance();
+    QVERIFY(logger.initialize(m_tempDir->path(), false, false, 100));
+    
+    int evaluated = 0;
+    auto message = [&evaluated](const QString& text) {
+        ++evaluated;
+        return text;
+    };
+    
+    logger.setCategoryLevel("Test", LogLevel::Warning);
+    OM_INFO(lcTest, message("Filtered info"));
+    OM_DEBUG(lcTest, message("Filtered debug"));
+    OM_WARNING(lcTest, message("Passed warning"));
+    QCOMPARE(evaluated, 1);
+    
+    // Debug stays off globally whatever the category allows
+    logger.setCategoryLevel("Test", LogLevel::Debug);
+    OM_INFO(lcTest, message("Passed info"));
+    OM_DEBUG(lcTest, message("Filtered debug"));
+    QCOMPARE(evaluated, 2);
+    
+    // Levels set before a category exists apply once it registers
+    logger.setCategoryLevel("Late", LogLevel::Error);
+    LogCategory late("Late");
+    QVERIFY(!late.isEnabled(LogLevel::Warning));
+    QVERIFY(late.isEnabled(LogLevel::Error));
+    
+    logger.shutdown();
+    
+    QStringList lines = readUserLog();
+    QCOMPARE(lines.filter("[Test] Passed warning").size(), 1);
+    QCOMPARE(lines.filter("[Test] Passed info").size(), 1);
+    QVERIFY(lines.filter("Filtered").isEmpty());
+}
+
+void TestLogger::benchmarkDisabledDebug_data()
+{
+    QTest::addColumn<bool>("lazy");
+    QTest::newRow("eager") << false;
+    QTest::newRow("lazy") << true;
+}
+
+void TestLogger::benchmarkDisabledDebug()
+{
+    // A debug line per received MQTT message with debug logging off: the
+    // eager call builds the string before log() drops it
+    QFETCH(bool, lazy);
+    
+    Logger& logger = Logger::instance();
+    QVERIFY(logger.initialize(m_tempDir->path(), false, false, 100));
+    
+    const QString topic = "observatory/OCS/echo";
+    const QString payload = ":GR#14:32:10.5";
+    QBENCHMARK {
+        for (int i = 0; i < 1000; ++i) {
+            if (lazy) {
+                OM_DEBUG(lcBench, QString("Received on %1: %2").arg(topic, payload));
+            } else {
+                logger.debug(QString("MQTT: Received on %1: %2").arg(topic, payload));
+            }
+        }
+    }
+}
+
 QTEST_MAIN(TestLogger)
 #include "test_logger.moc"
@@ -0,0 +1,296 @@
+#include <QtTest>
+#include <QRegularExpression>
+#include <cmath>
+#include "Lx200Codec.h"
+
+using namespace ObservatoryMonitor;
+using Precision = Lx200Codec::Precision;
+
+class TestLx200Codec : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testParseFormats_data();
+    void testParseFormats();
+    void testRejects_data();
+    void testRejects();
+    void testFormatExamples();
+    void testHoursRoundTripExhaustive();
+    void testDegreesRoundTripExhaustive();
+    void testAzimuthRoundTripExhaustive();
+    void testHighPrecisionRoundTrip();
+    void testDecimalRoundTrip();
+    void benchmarkCodec();
+    void benchmarkRegexParser();
+
+private:
+    using Formatter = int (*)(double, Precision, char*);
+    using Parser = bool (*)(QByteArrayView, double&);
+
+    // Formats every step of the given resolution over [first, last], checks the
+    // parser recovers the step and that formatting the parsed value reproduces
+    // the text exactly. Returns the number of failures.
+    static int roundTrip(Formatter format, Parser parse, Precision precision,
+                         qint64 first, qint64 last, double perWhole);
+};
+
+// The parser ControllerProxy used before the codec, kept as a baseline
+static double regexParseDegrees(const QString& value)
+{
+    QString clean = value;
+    if (clean.endsWith('#')) clean.chop(1);
+
+    bool ok;
+    double d = clean.toDouble(&ok);
+    if (ok) return d;
+
+    QRegularExpression re("([-+]?\\d+)[*°](\\d+)['](\\d+)[\"]?");
+    QRegularExpressionMatch match = re.match(clean);
+    if (match.hasMatch()) {
+        double deg = match.captured(1).toDouble();
+        double min = match.captured(2).toDouble();
+        double sec = match.captured(3).toDouble();
+        double sign = deg < 0 ? -1.0 : 1.0;
+        return deg + sign * (min / 60.0 + sec / 3600.0);
+    }
+
+    QRegularExpression re2("(\\d+):(\\d+):(\\d+)");
+    QRegularExpressionMatch match2 = re2.match(clean);
+    if (match2.hasMatch()) {
+        return match2.captured(1).toDouble() + match2.captured(2).toDouble() / 60.0
+             + match2.captured(3).toDouble() / 3600.0;
+    }
+    return 0.0;
+}
+
+int TestLx200Codec::roundTrip(Formatter format, Parser parse, Precision precision,
+                              qint64 first, qint64 last, double perWhole)
+{
+    int failures = 0;
+    char text[Lx200Codec::MaxFormattedLength];
+    char again[Lx200Codec::MaxFormattedLength];
+    for (qint64 step = first; step <= last; ++step) {
+        int length = format(step / perWhole, precision, text);
+        double parsed = 0.0;
+        if (!parse(QByteArrayView(text, length), parsed)
+            || std::llround(parsed * perWhole) != step) {
+            if (failures++ < 5) qWarning() << "parse mismatch" << step << text << parsed;
+            continue;
+        }
+        format(parsed, precision, again);
+        if (qstrcmp(text, again) != 0) {
+            if (failures++ < 5) qWarning() << "format mismatch" << step << text << again;
+        }
+    }
+    return failures;
+}
+
+void TestLx200Codec::testParseFormats_data()
+{
+    QTest::addColumn<QString>("text");
+    QTest::addColumn<bool>("hours");
+    QTest::addColumn<double>("expected");
+
+    QTest::newRow("decimal") << "181.500#" << false << 181.5;
+    QTest::newRow("negative decimal") << "-12.25" << false << -12.25;
+    QTest::newRow("hours standard") << "12:34:56#" << true << 12 + 34 / 60.0 + 56 / 3600.0;
+    QTest::newRow("hours low") << "05:30.5#" << true << 5 + 30.5 / 60.0;
+    QTest::newRow("hours high") << "23:59:59.9999#" << true << 23 + 59 / 60.0 + 59.9999 / 3600.0;
+    QTest::newRow("dec star colon") << "+45*30:00#" << false << 45.5;
+    QTest::newRow("dec star quote") << "+45*30'00#" << false << 45.5;
+    QTest::newRow("dec negative") << "-10*20:30#" << false << -(10 + 20 / 60.0 + 30 / 3600.0);
+    QTest::newRow("dec negative zero") << "-00*30:00" << false << -0.5;
+    QTest::newRow("dec low") << "+89*59#" << false << 89 + 59 / 60.0;
+    QTest::newRow("dec high") << "-05*06:07.125#" << false << -(5 + 6 / 60.0 + 7.125 / 3600.0);
+    QTest::newRow("seconds mark") << "+12*00'36\"" << false << 12.01;
+    QTest::newRow("degree sign") << QString("+12%100:36").arg(QChar(0xB0)) << false << 12.01;
+    QTest::newRow("lx200 glyph") << QString("+12%100:36").arg(QChar(0xDF)) << false << 12.01;
+    QTest::newRow("replacement char") << QString("+12%100:36").arg(QChar(0xFFFD)) << false << 12.01;
+    QTest::newRow("azimuth") << "359*59:59#" << false << 359 + 59 / 60.0 + 59 / 3600.0;
+    QTest::newRow("padded") << "  12:00:00 # " << true << 12.0;
+}
+
+void TestLx200Codec::testParseFormats()
+{
+    QFETCH(QString, text);
+    QFETCH(bool, hours);
+    QFETCH(double, expected);
+
+    double fromString = 0.0;
+    double fromBytes = 0.0;
+    QByteArray latin1 = text.toLatin1();
+    if (hours) {
+        QVERIFY(Lx200Codec::parseHours(QStringView(text), fromString));
+        QVERIFY(Lx200Codec::parseHours(QByteArrayView(latin1), fromBytes));
+    } else {
+        QVERIFY(Lx200Codec::parseDegrees(QStringView(text), fromString));
+        if (!text.contains(QChar(0xFFFD))) {
+            QVERIFY(Lx200Codec::parseDegrees(QByteArrayView(latin1), fromBytes));
+            QCOMPARE(fromBytes, fromString);
+        }
+    }
+    QVERIFY(qAbs(fromString - expected) < 1e-12);
+
+    // The UTF-8 encoding of the degree sign is two bytes
+    if (text.contains(QChar(0xB0))) {
+        QVERIFY(Lx200Codec::parseDegrees(QByteArrayView(text.toUtf8()), fromBytes));
+        QCOMPARE(fromBytes, fromString);
+    }
+}
+
+void TestLx200Codec::testRejects_data()
+{
+    QTest::addColumn<QString>("text");
+    QTest::addColumn<bool>("hours");
+
+    QTest::newRow("empty") << "" << false;
+    QTest::newRow("terminator only") << "#" << false;
+    QTest::newRow("letters") << "abc#" << false;
+    QTest::newRow("minutes 60") << "+10*60:00" << false;
+    QTest::newRow("seconds 60") << "+10*00:60" << false;
+    QTest::newRow("missing seconds") << "+10*00:" << false;
+    QTest::newRow("bad separator") << "+10/00/00" << false;
+    QTest::newRow("trailing garbage") << "12:00:00x" << true;
+    QTest::newRow("decimal then field") << "12.5:00" << false;
+    QTest::newRow("out of range") << "400*00:00" << false;
+    QTest::newRow("negative hours") << "-01:00:00" << true;
+    QTest::newRow("hours 24") << "24:00:00" << true;
+    QTest::newRow("dot only") << "12." << false;
+    QTest::newRow("three digit minutes") << "+10*100:00" << false;
+}
+
+void TestLx200Codec::testRejects()
+{
+    QFETCH(QString, text);
+    QFETCH(bool, hours);
+
+    double value = 42.0;
+    bool ok = hours ? Lx200Codec::parseHours(QStringView(text), value)
+                    : Lx200Codec::parseDegrees(QStringView(text), value);
+    QVERIFY(!ok);
+    QCOMPARE(value, 42.0);   // untouched on failure
+}
+
+void TestLx200Codec::testFormatExamples()
+{
+    char text[Lx200Codec::MaxFormattedLength];
+
+    Lx200Codec::formatHours(12 + 34 / 60.0 + 56 / 3600.0, Precision::Standard, text);
+    QCOMPARE(text, "12:34:56");
+    Lx200Codec::formatHours(5.5 + 0.1 / 60.0, Precision::Low, text);
+    QCOMPARE(text, "05:30.1");
+    Lx200Codec::formatHours(-1.0, Precision::Standard, text);
+    QCOMPARE(text, "23:00:00");
+    Lx200Codec::formatHours(23.9999999, Precision::Standard, text);
+    QCOMPARE(text, "00:00:00");   // rounding carries into the next day
+    Lx200Codec::formatHours(1.0 + 0.5 / 3600.0, Precision::High, text);
+    QCOMPARE(text, "01:00:00.5000");
+
+    Lx200Codec::formatSignedDegrees(-10.3418, Precision::Standard, text);
+    QCOMPARE(text, "-10*20:30");
+    Lx200Codec::formatSignedDegrees(-0.0001, Precision::Standard, text);
+    QCOMPARE(text, "+00*00:00");   // no negative zero
+    Lx200Codec::formatSignedDegrees(95.0, Precision::Low, text);
+    QCOMPARE(text, "+90*00");
+    Lx200Codec::formatSignedDegrees(45.0 + 1.5 / 3600.0, Precision::High, text);
+    QCOMPARE(text, "+45*00:01.500");
+
+    Lx200Codec::formatAzimuth(-90.0, Precision::Standard, text);
+    QCOMPARE(text, "270*00:00");
+    Lx200Codec::formatAzimuth(359.99999, Precision::Standard, text);
+    QCOMPARE(text, "000*00:00");
+
+    QCOMPARE(Lx200Codec::formatDecimal(181.5, 3, text), 7);
+    QCOMPARE(text, "181.500");
+    Lx200Codec::formatDecimal(-0.0004, 3, text);
+    QCOMPARE(text, "0.000");
+    Lx200Codec::formatDecimal(-12.5, 0, text);
+    QCOMPARE(text, "-13");
+}
+
+void TestLx200Codec::testHoursRoundTripExhaustive()
+{
+    QCOMPARE(roundTrip(Lx200Codec::formatHours, Lx200Codec::parseHours,
+                       Precision::Low, 0, 24 * 600 - 1, 600.0), 0);
+    QCOMPARE(roundTrip(Lx200Codec::formatHours, Lx200Codec::parseHours,
+                       Precision::Standard, 0, 24 * 3600 - 1, 3600.0), 0);
+}
+
+void TestLx200Codec::testDegreesRoundTripExhaustive()
+{
+    QCOMPARE(roundTrip(Lx200Codec::formatSignedDegrees, Lx200Codec::parseDegrees,
+                       Precision::Low, -90 * 60, 90 * 60, 60.0), 0);
+    QCOMPARE(roundTrip(Lx200Codec::formatSignedDegrees, Lx200Codec::parseDegrees,
+                       Precision::Standard, -90 * 3600, 90 * 3600, 3600.0), 0);
+}
+
+void TestLx200Codec::testAzimuthRoundTripExhaustive()
+{
+    QCOMPARE(roundTrip(Lx200Codec::formatAzimuth, Lx200Codec::parseDegrees,
+                       Precision::Low, 0, 360 * 60 - 1, 60.0), 0);
+    QCOMPARE(roundTrip(Lx200Codec::formatAzimuth, Lx200Codec::parseDegrees,
+                       Precision::Standard, 0, 360 * 3600 - 1, 3600.0), 0);
+}
+
+void TestLx200Codec::testHighPrecisionRoundTrip()
+{
+    // Every 10^-4 s of a day is 8.64e8 values; a prime stride covers all
+    // fields and digit positions without taking minutes
+    const qint64 hourUnits = 36000000;
+    const qint64 degreeUnits = 3600000;
+    int failures = 0;
+    for (qint64 start = 0; start < 7; ++start) {
+        for (qint64 step = start; step < 24 * hourUnits; step += 7919 * 13) {
+            failures += roundTrip(Lx200Codec::formatHours, Lx200Codec::parseHours,
+                                  Precision::High, step, step, double(hourUnits));
+        }
+        for (qint64 step = -90 * degreeUnits + start; step <= 90 * degreeUnits; step += 7919 * 7) {
+            failures += roundTrip(Lx200Codec::formatSignedDegrees, Lx200Codec::parseDegrees,
+                                  Precision::High, step, step, double(degreeUnits));
+        }
+    }
+    QCOMPARE(failures, 0);
+}
+
+void TestLx200Codec::testDecimalRoundTrip()
+{
+    char text[Lx200Codec::MaxFormattedLength];
+    for (int thousandths = -360000; thousandths <= 360000; ++thousandths) {
+        double value = thousandths / 1000.0;
+        int length = Lx200Codec::formatDecimal(value, 3, text);
+        double parsed = 0.0;
+        QVERIFY(Lx200Codec::parseDecimal(QByteArrayView(text, length), parsed));
+        // Same double strtod gives for the same text
+        QCOMPARE(parsed, QByteArray(text).toDouble());
+        QCOMPARE(std::llround(parsed * 1000.0), qint64(thousandths));
+    }
+}
+
+void TestLx200Codec::benchmarkCodec()
+{
+    const QStringList samples = {"12:34:56", "+45*30'00#", "-10*20:30#", "181.500#", "05:30.5#"};
+    double sum = 0.0;
+    QBENCHMARK {
+        for (const QString& sample : samples) {
+            double value = 0.0;
+            if (Lx200Codec::parseDegrees(QStringView(sample), value)) sum += value;
+        }
+    }
+    QVERIFY(sum != 0.0);
+}
+
+void TestLx200Codec::benchmarkRegexParser()
+{
+    const QStringList samples = {"12:34:56", "+45*30'00#", "-10*20:30#", "181.500#", "05:30.5#"};
+    double sum = 0.0;
+    QBENCHMARK {
+        for (const QString& sample : samples) {
+            sum += regexParseDegrees(sample);
+        }
+    }
+    QVERIFY(sum != 0.0);
+}
+
+QTEST_MAIN(TestLx200Codec)
+#include "test_lx200_codec.moc"
@@ -0,0 +1,123 @@
+#include <QtTest>
+#include <QSignalSpy>
+#include <cmath>
+#include "MotionPredictor.h"
+
+using namespace ObservatoryMonitor;
+
+class TestMotionPredictor : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testFirstSampleIsExact();
+    void testConstantVelocityConverges();
+    void testExtrapolationIsBounded();
+    void testWrapAround();
+    void testSettlesWhenStopped();
+    void testReset();
+};
+
+void TestMotionPredictor::testFirstSampleIsExact()
+{
+    MotionPredictor predictor;
+    predictor.addSample(42.0, 0);
+
+    QCOMPARE(predictor.value(), 42.0);
+    QCOMPARE(predictor.velocity(), 0.0);
+    QVERIFY(!predictor.isMoving());
+}
+
+void TestMotionPredictor::testConstantVelocityConverges()
+{
+    MotionPredictor predictor;
+
+    // 2 units/s, polled at 1 Hz
+    for (int i = 0; i <= 20; ++i) {
+        predictor.addSample(10.0 + 2.0 * i, i * 1000);
+    }
+
+    QVERIFY(predictor.isMoving());
+    QVERIFY(std::abs(predictor.velocity() - 2.0) < 0.05);
+
+    // Halfway to the next poll the prediction is between the samples
+    QVERIFY(std::abs(predictor.predictAt(20500) - 51.0) < 0.1);
+
+    QSignalSpy spy(&predictor, &MotionPredictor::valueChanged);
+    predictor.advanceTo(20250);
+    QCOMPARE(spy.count(), 1);
+    QVERIFY(std::abs(predictor.value() - 50.5) < 0.1);
+}
+
+void TestMotionPredictor::testExtrapolationIsBounded()
+{
+    MotionPredictor predictor;
+    predictor.setMaxExtrapolationMs(1000);
+    for (int i = 0; i <= 20; ++i) {
+        predictor.addSample(5.0 * i, i * 1000);
+    }
+
+    // Polls stop; the prediction must not run away
+    double limit = predictor.predictAt(21000);
+    QCOMPARE(predictor.predictAt(60000), limit);
+}
+
+void TestMotionPredictor::testWrapAround()
+{
+    MotionPredictor predictor;
+    predictor.setWrapPeriod(360.0);
+
+    // 3 deg/s across north: 330, 333, ... 357, 0, 3, ... 27
+    for (int i = 0; i <= 20; ++i) {
+        predictor.addSample(std::fmod(330.0 + 3.0 * i, 360.0), i * 1000);
+    }
+
+    QVERIFY(std::abs(predictor.velocity() - 3.0) < 0.05);
+    // Published value is continuous rather than jumping back to 0
+    QVERIFY(std::abs(predictor.value() - 390.0) < 0.1);
+
+    // Short way round when going the other direction
+    MotionPredictor reverse;
+    reverse.setWrapPeriod(360.0);
+    reverse.addSample(1.0, 0);
+    reverse.addSample(359.0, 1000);
+    QVERIFY(reverse.velocity() < 0.0);
+    QVERIFY(reverse.value() < 1.0 && reverse.value() > -2.0);
+}
+
+void TestMotionPredictor::testSettlesWhenStopped()
+{
+    MotionPredictor predictor;
+    predictor.setWrapPeriod(360.0);
+    for (int i = 0; i <= 10; ++i) {
+        predictor.addSample(std::fmod(350.0 + 2.0 * i, 360.0), i * 1000);
+    }
+    QVERIFY(predictor.isMoving());
+
+    // Mount stops at 10 degrees: first repeat settles exactly on it
+    predictor.addSample(10.0, 11000);
+    predictor.addSample(10.0, 12000);
+
+    QVERIFY(!predictor.isMoving());
+    QCOMPARE(predictor.velocity(), 0.0);
+    QVERIFY(std::abs(std::fmod(predictor.value(), 360.0) - 10.0) < 1e-9);
+    QCOMPARE(predictor.predictAt(15000), predictor.value());
+}
+
+void TestMotionPredictor::testReset()
+{
+    MotionPredictor predictor;
+    predictor.addSample(0.0, 0);
+    predictor.addSample(10.0, 1000);
+    QVERIFY(predictor.isMoving());
+
+    predictor.reset();
+    QVERIFY(!predictor.isMoving());
+
+    predictor.addSample(100.0, 2000);
+    QCOMPARE(predictor.value(), 100.0);
+    QCOMPARE(predictor.velocity(), 0.0);
+}
+
+QTEST_MAIN(TestMotionPredictor)
+#include "test_motion_predictor.moc"
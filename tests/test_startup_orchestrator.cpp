@@ -0,0 +1,159 @@
+#include <QtTest>
+#include <QSignalSpy>
+#include "ControllerManager.h"
+#include "StartupOrchestrator.h"
+#include "ControllerProxy.h"
+
+using namespace ObservatoryMonitor;
+
+class TestStartupOrchestrator : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testConcurrencyLimit();
+    void testTimeToFullState();
+    void testFullStateIgnoresProxyProperties();
+    void testReadyTimeoutReleasesSlot();
+    void testDisabledControllersSkipped();
+
+private:
+    static void addControllers(ControllerManager& manager, int count, const QString& prefix, bool enabled = true);
+};
+
+void TestStartupOrchestrator::addControllers(ControllerManager& manager, int count, const QString& prefix, bool enabled)
+{
+    // Nothing listens on port 1, so controllers only become ready when the test says so
+    BrokerConfig broker;
+    broker.host = "127.0.0.1";
+    broker.port = 1;
+
+    for (int i = 0; i < count; ++i) {
+        ControllerConfig config;
+        config.name = QString("%1%2").arg(prefix).arg(i);
+        config.type = "Observatory";
+        config.prefix = config.name;
+        config.enabled = enabled;
+        manager.addController(config, broker, 2.0, 300);
+    }
+}
+
+void TestStartupOrchestrator::testConcurrencyLimit()
+{
+    ControllerManager manager;
+    addControllers(manager, 5, "limit");
+
+    StartupOrchestrator startup(&manager);
+    startup.setMaxConcurrent(2);
+    QSignalSpy started(&startup, &StartupOrchestrator::controllerStarted);
+
+    startup.start(1000, 5000);
+    QVERIFY(manager.isActive());
+    QCOMPARE(started.count(), 2);
+    QCOMPARE(startup.connectingCount(), 2);
+
+    // A ready controller frees its slot for the next one in line
+    emit manager.controller(started.at(0).at(0).toString())->ready();
+    QCOMPARE(started.count(), 3);
+    QCOMPARE(startup.connectingCount(), 2);
+
+    for (const QString& name : {QString("limit2"), QString("limit3"), QString("limit4")}) {
+        emit manager.controller(name)->ready();
+    }
+    emit manager.controller("limit1")->ready();
+    QCOMPARE(started.count(), 5);
+    QCOMPARE(startup.connectingCount(), 0);
+}
+
+void TestStartupOrchestrator::testTimeToFullState()
+{
+    ControllerManager manager;
+    addControllers(manager, 1, "full");
+
+    StartupOrchestrator startup(&manager);
+    QSignalSpy complete(&startup, &StartupOrchestrator::controllerComplete);
+    QSignalSpy finished(&startup, &StartupOrchestrator::finished);
+    startup.start(1000, 5000);
+
+    // Values arriving before the subscription ack are not part of the full state
+    emit manager.controller("full0")->ready();
+    QVERIFY(startup.metrics("full0").readyMs >= 0);
+
+    // The poller interned :DZ# and :RS# for an Observatory controller
+    QTest::qWait(20);
+    manager.dispatchData("full0", ":DZ#", "123.4#");
+    StartupMetrics partial = startup.metrics("full0");
+    QVERIFY(partial.firstValueMs >= partial.readyMs);
+    QCOMPARE(partial.fullStateMs, qint64(-1));
+    QCOMPARE(complete.count(), 0);
+
+    QTest::qWait(20);
+    manager.dispatchData("full0", ":RS#", "0#");
+    QCOMPARE(complete.count(), 1);
+    QCOMPARE(finished.count(), 1);
+    QVERIFY(!startup.isRunning());
+
+    StartupMetrics metrics = startup.metrics("full0");
+    QVERIFY(metrics.timeToFirstValue() >= 0);
+    QVERIFY(metrics.timeToFullState() > metrics.timeToFirstValue());
+}
+
+void TestStartupOrchestrator::testFullStateIgnoresProxyProperties()
+{
+    ControllerManager manager;
+    addControllers(manager, 1, "dome");
+
+    // As in the application: the proxy exists before startup and interns
+    // its dispatch table (:GR#, :GD#, :GA#, ...) for the controller
+    ControllerProxy proxy("dome0", &manager);
+    QVERIFY(PropertyInterner::instance().properties("dome0").size() > 2);
+
+    StartupOrchestrator startup(&manager);
+    startup.setReadyTimeout(200);
+    QSignalSpy complete(&startup, &StartupOrchestrator::controllerComplete);
+    startup.start(1000, 5000);
+    emit manager.controller("dome0")->ready();
+
+    // An Observatory controller only polls :DZ# and :RS#
+    manager.dispatchData("dome0", ":DZ#", "123.4#");
+    manager.dispatchData("dome0", ":RS#", "0#");
+    QCOMPARE(complete.count(), 1);
+    QVERIFY(startup.metrics("dome0").timeToFullState() >= 0);
+}
+
+void TestStartupOrchestrator::testReadyTimeoutReleasesSlot()
+{
+    ControllerManager manager;
+    addControllers(manager, 2, "timeout");
+
+    StartupOrchestrator startup(&manager);
+    startup.setMaxConcurrent(1);
+    startup.setReadyTimeout(100);
+    QSignalSpy started(&startup, &StartupOrchestrator::controllerStarted);
+    QSignalSpy finished(&startup, &StartupOrchestrator::finished);
+
+    startup.start(1000, 5000);
+    QCOMPARE(started.count(), 1);
+
+    // Neither controller ever becomes ready; each is given up on in turn
+    QTRY_COMPARE_WITH_TIMEOUT(started.count(), 2, 2000);
+    QTRY_COMPARE_WITH_TIMEOUT(finished.count(), 1, 2000);
+    QCOMPARE(startup.metrics("timeout0").readyMs, qint64(-1));
+    QCOMPARE(startup.metrics("timeout1").fullStateMs, qint64(-1));
+}
+
+void TestStartupOrchestrator::testDisabledControllersSkipped()
+{
+    ControllerManager manager;
+    addControllers(manager, 2, "off", false);
+
+    StartupOrchestrator startup(&manager);
+    QSignalSpy finished(&startup, &StartupOrchestrator::finished);
+    startup.start(1000, 5000);
+
+    QCOMPARE(finished.count(), 1);
+    QVERIFY(startup.metrics().isEmpty());
+}
+
+QTEST_MAIN(TestStartupOrchestrator)
+#include "test_startup_orchestrator.moc"
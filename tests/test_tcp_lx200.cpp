@@ -0,0 +1,244 @@
+#include <QtTest>
+#include <QSignalSpy>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include "TcpLx200Controller.h"
+#include "ControllerManager.h"
+
+using namespace ObservatoryMonitor;
+
+// Minimal LX200 endpoint standing in for OnStepX's port 9999. Replies are
+// canned per command; with holdUntil > 1 replies are withheld until that many
+// commands have arrived, which only a pipelining client can satisfy.
+class Lx200StandIn
+{
+public:
+    Lx200StandIn()
+    {
+        QObject::connect(&server, &QTcpServer::newConnection, &server, [this]() {
+            client = server.nextPendingConnection();
+            connections++;
+            QObject::connect(client, &QTcpSocket::readyRead, client, [this]() { onRead(); });
+        });
+        server.listen(QHostAddress::LocalHost, 0);
+    }
+
+    quint16 port() const { return server.serverPort(); }
+    void dropClient() { if (client) client->abort(); }
+
+    QHash<QByteArray, QByteArray> replies;
+    int holdUntil = 1;
+    int largestBatch = 0;
+    int connections = 0;
+    QList<QByteArray> received;
+
+private:
+    void onRead()
+    {
+        m_buffer += client->readAll();
+        qsizetype end;
+        while ((end = m_buffer.indexOf('#')) >= 0) {
+            QByteArray command = m_buffer.left(end + 1);
+            m_buffer.remove(0, end + 1);
+            received << command;
+            m_pending << command;
+        }
+
+        if (m_pending.size() < holdUntil) return;
+        largestBatch = qMax(largestBatch, int(m_pending.size()));
+        QByteArray out;
+        for (const QByteArray& command : std::as_const(m_pending)) {
+            out += replies.value(command);   // unknown commands stay silent
+        }
+        m_pending.clear();
+        client->write(out);
+    }
+
+    QTcpServer server;
+    QPointer<QTcpSocket> client;
+    QByteArray m_buffer;
+    QList<QByteArray> m_pending;
+};
+
+class TestTcpLx200 : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testReplyKinds();
+    void testPipelinedReplies();
+    void testSetCommandReply();
+    void testTimeoutResynchronizes();
+    void testDisconnectFailsPending();
+    void testPollerOverTcp();
+    void benchmarkPipelinedRoundTrip();
+
+private:
+    static ControllerConfig tcpConfig(const QString& name, quint16 port);
+    static bool connectTo(TcpLx200Controller& controller);
+};
+
+ControllerConfig TestTcpLx200::tcpConfig(const QString& name, quint16 port)
+{
+    ControllerConfig config;
+    config.name = name;
+    config.type = "Telescope";
+    config.prefix = name;
+    config.transport = "tcp";
+    config.host = "127.0.0.1";
+    config.port = port;
+    return config;
+}
+
+bool TestTcpLx200::connectTo(TcpLx200Controller& controller)
+{
+    QSignalSpy ready(&controller, &AbstractController::ready);
+    controller.connect();
+    return ready.wait(2000) && controller.status() == ControllerStatus::Connected;
+}
+
+void TestTcpLx200::testReplyKinds()
+{
+    QCOMPARE(TcpLx200Controller::replyKind(":GR#"), TcpLx200Controller::ReplyKind::Terminated);
+    QCOMPARE(TcpLx200Controller::replyKind(":DZ#"), TcpLx200Controller::ReplyKind::Terminated);
+    QCOMPARE(TcpLx200Controller::replyKind(":SG+05.0#"), TcpLx200Controller::ReplyKind::SingleChar);
+    QCOMPARE(TcpLx200Controller::replyKind(":Q#"), TcpLx200Controller::ReplyKind::None);
+    QCOMPARE(TcpLx200Controller::replyKind(":Ms#"), TcpLx200Controller::ReplyKind::None);
+    QCOMPARE(TcpLx200Controller::replyKind(":MS#"), TcpLx200Controller::ReplyKind::Terminated);
+}
+
+void TestTcpLx200::testPipelinedReplies()
+{
+    Lx200StandIn standIn;
+    standIn.replies = {{":GR#", "12:34:56#"}, {":GD#", "+45*30:00#"}, {":GZ#", "123.4#"}};
+    standIn.holdUntil = 3;
+
+    TcpLx200Controller controller(tcpConfig("pipe", standIn.port()), 2.0, 10);
+    QVERIFY(connectTo(controller));
+
+    QStringList responses;
+    auto collect = [&](const QString&, const QString& response, bool success, int) {
+        QVERIFY(success);
+        responses << response;
+    };
+    controller.sendCommand(":GR#", collect);
+    controller.sendCommand(":GD#", collect);
+    controller.sendCommand(":GZ#", collect);
+    QCOMPARE(controller.inFlightCount(), 3);
+
+    // The stand-in answers only once all three are on the wire
+    QTRY_COMPARE(responses.size(), 3);
+    QCOMPARE(responses, QStringList({"12:34:56", "+45*30:00", "123.4"}));
+    QCOMPARE(standIn.largestBatch, 3);
+    QCOMPARE(controller.inFlightCount(), 0);
+}
+
+void TestTcpLx200::testSetCommandReply()
+{
+    Lx200StandIn standIn;
+    standIn.replies = {{":SG+05.0#", "1"}, {":Sd+99:00#", "0"}, {":GR#", "01:02:03#"}};
+    standIn.holdUntil = 3;
+
+    TcpLx200Controller controller(tcpConfig("set", standIn.port()), 2.0, 10);
+    QVERIFY(connectTo(controller));
+
+    QList<bool> results;
+    QStringList responses;
+    auto collect = [&](const QString&, const QString& response, bool success, int) {
+        results << success;
+        responses << response;
+    };
+    controller.sendCommand(":SG+05.0#", collect);
+    controller.sendCommand(":Sd+99:00#", collect);
+    controller.sendCommand(":GR#", collect);
+
+    // Unterminated single-character replies must not swallow the next reply
+    QTRY_COMPARE(results.size(), 3);
+    QCOMPARE(results, QList<bool>({true, false, true}));
+    QCOMPARE(responses.last(), QString("01:02:03"));
+}
+
+void TestTcpLx200::testTimeoutResynchronizes()
+{
+    Lx200StandIn standIn;
+    standIn.replies = {{":GR#", "12:00:00#"}};
+
+    TcpLx200Controller controller(tcpConfig("timeout", standIn.port()), 0.2, 10);
+    QVERIFY(connectTo(controller));
+
+    bool failed = false;
+    controller.sendCommand(":GA#", [&](const QString&, const QString&, bool success, int) { failed = !success; });
+    QTRY_VERIFY_WITH_TIMEOUT(failed, 2000);
+
+    // A fresh connection replaces the one that lost track of its replies
+    QTRY_COMPARE_WITH_TIMEOUT(standIn.connections, 2, 2000);
+    QTRY_COMPARE_WITH_TIMEOUT(controller.status(), ControllerStatus::Connected, 2000);
+
+    QString response;
+    controller.sendCommand(":GR#", [&](const QString&, const QString& r, bool, int) { response = r; });
+    QTRY_COMPARE(response, QString("12:00:00"));
+}
+
+void TestTcpLx200::testDisconnectFailsPending()
+{
+    Lx200StandIn standIn;
+
+    TcpLx200Controller controller(tcpConfig("drop", standIn.port()), 5.0, 10);
+    QVERIFY(connectTo(controller));
+
+    int failures = 0;
+    auto collect = [&](const QString&, const QString&, bool success, int) { if (!success) failures++; };
+    controller.sendCommand(":GR#", collect);
+    controller.sendCommand(":GD#", collect);
+    QTRY_COMPARE(standIn.received.size(), 2);
+
+    standIn.dropClient();
+    QTRY_COMPARE(failures, 2);
+    QCOMPARE(controller.status(), ControllerStatus::Disconnected);
+    controller.disconnect();
+}
+
+void TestTcpLx200::testPollerOverTcp()
+{
+    Lx200StandIn standIn;
+    standIn.replies = {{":GR#", "05:06:07#"}, {":GD#", "-10*20:30#"}, {":GZ#", "181.5#"},
+                       {":GA#", "33.0#"}, {":GS#", "12:00:00#"}};
+
+    ControllerManager manager;
+    manager.addController(tcpConfig("direct", standIn.port()), BrokerConfig(), 2.0, 10);
+    QVERIFY(qobject_cast<TcpLx200Controller*>(manager.controller("direct")));
+
+    QSignalSpy data(manager.channel("direct"), &ControllerChannel::dataUpdated);
+    manager.startPolling(1000, 5000);
+    manager.connectAll();
+
+    // The poller and its cache are shared with the MQTT backend
+    QTRY_VERIFY(data.count() >= 5);
+    QCOMPARE(manager.getControllerValue("direct", ":GZ#").value, QString("181.5"));
+    QCOMPARE(manager.getControllerValue("direct", ":GS#").value, QString("12:00:00"));
+    QCOMPARE(manager.getControllerStatus("direct"), ControllerStatus::Connected);
+    manager.disconnectAll();
+}
+
+void TestTcpLx200::benchmarkPipelinedRoundTrip()
+{
+    Lx200StandIn standIn;
+    standIn.replies = {{":GR#", "05:06:07#"}, {":GD#", "-10*20:30#"}, {":GZ#", "181.5#"}, {":GA#", "33.0#"}};
+
+    TcpLx200Controller controller(tcpConfig("bench", standIn.port()), 2.0, 10);
+    QVERIFY(connectTo(controller));
+
+    // One fast-poll cycle of a telescope: four commands, one network round trip
+    QBENCHMARK {
+        int done = 0;
+        QEventLoop loop;
+        auto collect = [&](const QString&, const QString&, bool, int) { if (++done == 4) loop.quit(); };
+        for (const char* command : {":GR#", ":GD#", ":GZ#", ":GA#"}) {
+            controller.sendCommand(command, collect);
+        }
+        if (done < 4) loop.exec();
+    }
+}
+
+QTEST_MAIN(TestTcpLx200)
+#include "test_tcp_lx200.moc"
@@ -0,0 +1,283 @@
+#include <QtTest>
+#include <QTemporaryDir>
+#include <QDir>
+#include "TelemetryStore.h"
+#include "TelemetryReader.h"
+#include "TelemetrySegment.h"
+
+using namespace ObservatoryMonitor;
+
+class TestTelemetry : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testVarintRoundTrip();
+    void testRawRoundTrip();
+    void testLastValueWinsWithinSecond();
+    void testTextSeries();
+    void testMinuteAggregates();
+    void testDailyRoll();
+    void testReopenAppends();
+    void testReopenAfterCrash();
+    void testRetention();
+
+private:
+    static qint64 ms(const QString& isoUtc);
+};
+
+qint64 TestTelemetry::ms(const QString& isoUtc)
+{
+    return QDateTime::fromString(isoUtc, Qt::ISODate).toMSecsSinceEpoch();
+}
+
+void TestTelemetry::testVarintRoundTrip()
+{
+    const QList<qint64> values = {0, 1, -1, 63, -64, 64, 1000, -1000, 1768000000000LL, -1768000000000LL};
+    for (qint64 v : values) {
+        QByteArray bytes = TelemetryFormat::encodeVarint(v);
+        const uchar* pos = reinterpret_cast<const uchar*>(bytes.constData());
+        const uchar* end = pos + bytes.size();
+        qint64 decoded = 0;
+        QVERIFY(TelemetryFormat::decodeVarint(pos, end, decoded));
+        QCOMPARE(decoded, v);
+        QCOMPARE(pos, end);
+    }
+
+    // Small deltas stay one byte
+    QCOMPARE(TelemetryFormat::encodeVarint(50).size(), 1);
+}
+
+void TestTelemetry::testRawRoundTrip()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+
+    qint64 t0 = ms("2026-01-20T22:00:00Z");
+    {
+        TelemetryStore store;
+        QVERIFY(store.open(dir.path()));
+        for (int i = 0; i < 10; ++i) {
+            store.record("Observatory", ":DZ#", QString("%1#").arg(100.0 + i, 0, 'f', 3), t0 + i * 1000);
+        }
+        store.close();
+    }
+
+    TelemetryReader reader(dir.path());
+    QList<TelemetrySample> samples = reader.readRaw("Observatory", ":DZ#", t0, t0 + 60000);
+    QCOMPARE(samples.size(), 10);
+    for (int i = 0; i < 10; ++i) {
+        QCOMPARE(samples[i].timestamp, t0 + i * 1000);
+        QVERIFY(samples[i].numeric);
+        QCOMPARE(samples[i].value, 100.0 + i);
+    }
+
+    // Range filtering
+    QCOMPARE(reader.readRaw("Observatory", ":DZ#", t0 + 2000, t0 + 4000).size(), 3);
+    QVERIFY(reader.readRaw("Telescope", ":DZ#", t0, t0 + 60000).isEmpty());
+}
+
+void TestTelemetry::testLastValueWinsWithinSecond()
+{
+    QTemporaryDir dir;
+    qint64 t0 = ms("2026-01-20T22:00:00Z");
+    {
+        TelemetryStore store;
+        QVERIFY(store.open(dir.path()));
+        store.record("Telescope", ":GA#", "10.0", t0 + 100);
+        store.record("Telescope", ":GA#", "11.0", t0 + 500);
+        store.record("Telescope", ":GA#", "12.0", t0 + 900);
+        store.record("Telescope", ":GA#", "13.0", t0 + 1200);
+        store.close();
+    }
+
+    TelemetryReader reader(dir.path());
+    QList<TelemetrySample> samples = reader.readRaw("Telescope", ":GA#", t0, t0 + 2000);
+    QCOMPARE(samples.size(), 2);
+    QCOMPARE(samples[0].value, 12.0);
+    QCOMPARE(samples[0].timestamp, t0 + 900);
+    QCOMPARE(samples[1].value, 13.0);
+}
+
+void TestTelemetry::testTextSeries()
+{
+    QTemporaryDir dir;
+    qint64 t0 = ms("2026-01-20T22:00:00Z");
+    {
+        TelemetryStore store;
+        QVERIFY(store.open(dir.path()));
+        store.record("Telescope", ":GD#", "+45*30'00#", t0);
+        store.record("Telescope", ":GD#", "+45*30'05#", t0 + 1000);
+        store.record("Telescope", ":GD#", "+45*30'00#", t0 + 2000);
+        store.close();
+    }
+
+    TelemetryReader reader(dir.path());
+    QList<TelemetrySample> samples = reader.readRaw("Telescope", ":GD#", t0, t0 + 5000);
+    QCOMPARE(samples.size(), 3);
+    QVERIFY(!samples[0].numeric);
+    QCOMPARE(samples[0].text, QString("+45*30'00#"));
+    QCOMPARE(samples[1].text, QString("+45*30'05#"));
+    QCOMPARE(samples[2].text, QString("+45*30'00#"));
+
+    // Repeated strings share one dictionary entry
+    QFile dict(dir.path() + "/raw/2026-01-20/" + TelemetryFormat::DictFile);
+    QVERIFY(dict.open(QIODevice::ReadOnly));
+    QCOMPARE(dict.readAll().count('\n'), 2);
+}
+
+void TestTelemetry::testMinuteAggregates()
+{
+    QTemporaryDir dir;
+    qint64 t0 = ms("2026-01-20T22:00:00Z");
+    {
+        TelemetryStore store;
+        QVERIFY(store.open(dir.path()));
+        // Minute 0: 1..60, minute 1: constant 5
+        for (int i = 0; i < 60; ++i) {
+            store.record("Observatory", ":DZ#", QString::number(i + 1), t0 + i * 1000);
+        }
+        for (int i = 0; i < 30; ++i) {
+            store.record("Observatory", ":DZ#", "5", t0 + 60000 + i * 2000);
+        }
+        store.close();
+    }
+
+    TelemetryReader reader(dir.path());
+    QList<TelemetryAggregate> minutes = reader.readMinutes("Observatory", ":DZ#", t0, t0 + 3600000);
+    QCOMPARE(minutes.size(), 2);
+
+    QCOMPARE(minutes[0].timestamp, t0);
+    QCOMPARE(minutes[0].min, 1.0);
+    QCOMPARE(minutes[0].max, 60.0);
+    QCOMPARE(minutes[0].mean, 30.5);
+    QCOMPARE(minutes[0].count, 60u);
+
+    QCOMPARE(minutes[1].timestamp, t0 + 60000);
+    QCOMPARE(minutes[1].min, 5.0);
+    QCOMPARE(minutes[1].max, 5.0);
+    QCOMPARE(minutes[1].count, 30u);
+}
+
+void TestTelemetry::testDailyRoll()
+{
+    QTemporaryDir dir;
+    qint64 t0 = ms("2026-01-20T23:59:58Z");
+    {
+        TelemetryStore store;
+        QVERIFY(store.open(dir.path()));
+        for (int i = 0; i < 4; ++i) {
+            store.record("Observatory", ":DZ#", QString::number(i), t0 + i * 1000);
+        }
+        store.close();
+    }
+
+    QVERIFY(QDir(dir.path() + "/raw/2026-01-20").exists());
+    QVERIFY(QDir(dir.path() + "/raw/2026-01-21").exists());
+
+    TelemetryReader reader(dir.path());
+    QList<TelemetrySample> samples = reader.readRaw("Observatory", ":DZ#", t0, t0 + 10000);
+    QCOMPARE(samples.size(), 4);
+    for (int i = 0; i < 4; ++i) {
+        QCOMPARE(samples[i].value, double(i));
+    }
+}
+
+void TestTelemetry::testReopenAppends()
+{
+    QTemporaryDir dir;
+    qint64 t0 = ms("2026-01-20T22:00:00Z");
+
+    for (int run = 0; run < 2; ++run) {
+        TelemetryStore store;
+        QVERIFY(store.open(dir.path()));
+        for (int i = 0; i < 5; ++i) {
+            store.record("Observatory", ":DZ#", QString::number(run * 5 + i), t0 + (run * 5 + i) * 1000);
+        }
+        store.close();
+    }
+
+    TelemetryReader reader(dir.path());
+    QList<TelemetrySample> samples = reader.readRaw("Observatory", ":DZ#", t0, t0 + 60000);
+    QCOMPARE(samples.size(), 10);
+    for (int i = 0; i < 10; ++i) {
+        QCOMPARE(samples[i].timestamp, t0 + i * 1000);
+        QCOMPARE(samples[i].value, double(i));
+    }
+}
+
+void TestTelemetry::testReopenAfterCrash()
+{
+    QTemporaryDir dir;
+    qint64 t0 = ms("2026-01-20T22:00:00Z");
+    auto run = [&](int first) {
+        TelemetryStore store;
+        QVERIFY(store.open(dir.path()));
+        for (int i = first; i < first + 5; ++i) {
+            store.record("Observatory", ":DZ#", QString::number(i), t0 + i * 1000);
+            store.record("Telescope", ":GS#", QString("Side%1#").arg(i), t0 + i * 1000);
+        }
+        store.close();
+    };
+    run(0);
+
+    // What a crash can leave behind: a timestamp without its value followed
+    // by half a varint, half a text code, and a dictionary line cut short
+    const QString segment = dir.path() + "/raw/2026-01-20";
+    int numericId = -1;
+    int textId = -1;
+    {
+        TelemetrySegmentReader reader;
+        QString errorMessage;
+        QVERIFY(reader.open(segment, errorMessage));
+        numericId = reader.findSeries("Observatory", ":DZ#", TelemetryValueKind::Numeric);
+        textId = reader.findSeries("Telescope", ":GS#", TelemetryValueKind::Text);
+    }
+    QVERIFY(numericId >= 0 && textId >= 0);
+    auto appendTo = [&](const QString& name, const QByteArray& bytes) {
+        QFile file(segment + "/" + name);
+        QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Append));
+        file.write(bytes);
+    };
+    appendTo(QString("%1.ts").arg(numericId), TelemetryFormat::encodeVarint(1000) + char(0x80));
+    appendTo(QString("%1.str").arg(textId), QByteArray(2, '\x01'));
+    appendTo(TelemetryFormat::DictFile, "Sid");
+
+    run(5);
+
+    TelemetryReader reader(dir.path());
+    QList<TelemetrySample> numeric = reader.readRaw("Observatory", ":DZ#", t0, t0 + 60000);
+    QCOMPARE(numeric.size(), 10);
+    QList<TelemetrySample> text = reader.readRaw("Telescope", ":GS#", t0, t0 + 60000);
+    QCOMPARE(text.size(), 10);
+    for (int i = 0; i < 10; ++i) {
+        QCOMPARE(numeric[i].timestamp, t0 + i * 1000);
+        QCOMPARE(numeric[i].value, double(i));
+        QCOMPARE(text[i].timestamp, t0 + i * 1000);
+        QCOMPARE(text[i].text, QString("Side%1#").arg(i));
+    }
+}
+
+void TestTelemetry::testRetention()
+{
+    QTemporaryDir dir;
+    qint64 t0 = ms("2026-01-01T12:00:00Z");
+    {
+        TelemetryStore store;
+        QVERIFY(store.open(dir.path(), 2, 365));
+        for (int day = 0; day < 5; ++day) {
+            store.record("Observatory", ":DZ#", "1", t0 + day * 86400000LL);
+        }
+        store.close();
+    }
+
+    QDir raw(dir.path() + "/raw");
+    QStringList segments = raw.entryList(QDir::Dirs | QDir::NoDotAndDotDot, QDir::Name);
+    QCOMPARE(segments, QStringList({"2026-01-03", "2026-01-04", "2026-01-05"}));
+
+    // Aggregates outlive the raw tier
+    QVERIFY(QDir(dir.path() + "/minute/2026-01").exists());
+}
+
+QTEST_MAIN(TestTelemetry)
+#include "test_telemetry.moc"
@@ -0,0 +1,133 @@
+#include <QtTest>
+#include <QSignalSpy>
+#include <QQmlEngine>
+#include <QQmlComponent>
+#include <QQmlContext>
+#include <memory>
+#include "ControllerManager.h"
+#include "ControllerProxy.h"
+#include "UpdateBatcher.h"
+
+using namespace ObservatoryMonitor;
+
+// Headless QML consumer: a binding on a proxy property and a batch handler,
+// each counting how often it runs
+static const char* BindingQml = R"(
+import QtQml
+QtObject {
+    property int azimuthEvaluations: 0
+    property int batchEvaluations: 0
+    property real azimuth: proxy.azimuth
+    onAzimuthChanged: azimuthEvaluations++
+    property Connections batches: Connections {
+        target: proxy
+        function onPropertiesChanged(ids) { batchEvaluations++ }
+    }
+}
+)";
+
+class TestUpdateBatching : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testLastValueWins();
+    void testImmediateWhenRateIsZero();
+    void testTimerFlush();
+    void testQmlBindingEvaluations_data();
+    void testQmlBindingEvaluations();
+};
+
+void TestUpdateBatching::testLastValueWins()
+{
+    UpdateBatcher batcher;
+    QSignalSpy spy(&batcher, &UpdateBatcher::flushed);
+
+    PropertyId a = PropertyInterner::instance().intern("batcher", ":GZ#");
+    PropertyId b = PropertyInterner::instance().intern("batcher", ":GA#");
+
+    batcher.post(a, "1");
+    batcher.post(b, "2");
+    batcher.post(a, "3");
+    QVERIFY(batcher.hasPending());
+    QCOMPARE(spy.count(), 0);
+
+    batcher.flush();
+    QCOMPARE(spy.count(), 1);
+    PropertyBatch batch = spy.at(0).at(0).value<PropertyBatch>();
+    QCOMPARE(batch.size(), 2);
+    QCOMPARE(batch[0].id, a);
+    QCOMPARE(batch[0].value, QString("3"));
+    QCOMPARE(batch[1].id, b);
+    QCOMPARE(batch[1].value, QString("2"));
+
+    // Nothing pending, nothing emitted
+    batcher.flush();
+    QCOMPARE(spy.count(), 1);
+}
+
+void TestUpdateBatching::testImmediateWhenRateIsZero()
+{
+    UpdateBatcher batcher;
+    batcher.setMaxRate(0);
+    QSignalSpy spy(&batcher, &UpdateBatcher::flushed);
+
+    PropertyId id = PropertyInterner::instance().intern("batcher", ":GZ#");
+    batcher.post(id, "1");
+    batcher.post(id, "2");
+    QCOMPARE(spy.count(), 2);
+    QVERIFY(!batcher.hasPending());
+}
+
+void TestUpdateBatching::testTimerFlush()
+{
+    UpdateBatcher batcher;
+    batcher.setMaxRate(50);
+    QSignalSpy spy(&batcher, &UpdateBatcher::flushed);
+
+    // Without a frame-driven flush the timer still delivers
+    batcher.post(PropertyInterner::instance().intern("batcher", ":GZ#"), "1");
+    QVERIFY(spy.wait(1000));
+    QCOMPARE(spy.count(), 1);
+}
+
+void TestUpdateBatching::testQmlBindingEvaluations_data()
+{
+    QTest::addColumn<int>("rate");
+    QTest::addColumn<int>("expectedEvaluations");
+
+    // Ten updates of the same property inside one frame
+    QTest::newRow("batched") << 60 << 1;
+    QTest::newRow("unbatched") << 0 << 10;
+}
+
+void TestUpdateBatching::testQmlBindingEvaluations()
+{
+    QFETCH(int, rate);
+    QFETCH(int, expectedEvaluations);
+
+    ControllerManager manager;
+    manager.setUpdateRate(rate);
+    ControllerProxy proxy("qml", &manager);
+
+    QQmlEngine engine;
+    engine.rootContext()->setContextProperty("proxy", &proxy);
+    QQmlComponent component(&engine);
+    component.setData(BindingQml, QUrl());
+    std::unique_ptr<QObject> root(component.create());
+    QVERIFY2(root, qPrintable(component.errorString()));
+
+    int azimuthBefore = root->property("azimuthEvaluations").toInt();
+
+    for (int i = 1; i <= 10; ++i) {
+        manager.dispatchData("qml", ":GZ#", QString::number(i * 1.5) + "#");
+    }
+    manager.flushUpdates();
+
+    QCOMPARE(root->property("azimuthEvaluations").toInt() - azimuthBefore, expectedEvaluations);
+    QCOMPARE(root->property("batchEvaluations").toInt(), expectedEvaluations);
+    QCOMPARE(root->property("azimuth").toDouble(), 15.0);
+}
+
+QTEST_GUILESS_MAIN(TestUpdateBatching)
+#include "test_update_batching.moc"
@@ -0,0 +1,462 @@
+#include <QtTest>
+#include <cmath>
+#include <cstring>
+#include <vector>
+#include "ValueMappingEngine.h"
+#include "MappingKernels.h"
+
+using namespace ObservatoryMonitor;
+
+class TestValueMapping : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testLinear();
+    void testDegenerateRange();
+    void testBinary();
+    void testIdentity();
+    void testHandlesAreShared();
+    void testUnknownHandle();
+    void testClamped();
+    void testAngleWrap();
+    void testAngleUnwrap();
+    void testLookup();
+    void testPolynomial();
+    void testVariantRoundTrip();
+    void testKernels();
+    void testKernelsMatchAcrossIsa_data();
+    void testKernelsMatchAcrossIsa();
+    void testMapSamples();
+    void benchmarkPerUpdate_data();
+    void benchmarkPerUpdate();
+    void benchmarkSamples_data();
+    void benchmarkSamples();
+
+private:
+    static QVariantMap linearVariant(double inMin, double inMax, double outMin, double outMax);
+    template <typename T>
+    static void runKernel(const QString& kernel, const T* in, T* out, qsizetype n);
+    static std::vector<double> samples(qsizetype n);
+};
+
+QVariantMap TestValueMapping::linearVariant(double inMin, double inMax, double outMin, double outMax)
+{
+    return {{"type", "linear"}, {"in_min", inMin}, {"in_max", inMax},
+            {"out_min", outMin}, {"out_max", outMax}};
+}
+
+void TestValueMapping::testLinear()
+{
+    ValueMappingEngine engine;
+    int handle = engine.compile(linearVariant(0, 360, 0, -360));
+
+    QCOMPARE(engine.mapWith(handle, 90.0).toDouble(), -90.0);
+    QCOMPARE(engine.mapWith(handle, "180").toDouble(), -180.0);
+    // Non-numeric input passes through untouched
+    QCOMPARE(engine.mapWith(handle, "n/a").toString(), QString("n/a"));
+
+    int scaled = engine.compile(linearVariant(4, 20, 0, 100));
+    QCOMPARE(engine.mapWith(scaled, 12.0).toDouble(), 50.0);
+    QCOMPARE(engine.mapping(scaled).mapNumber(20.0), 100.0);
+
+    // Same results as the one-off path
+    QCOMPARE(engine.mapValue(12.0, linearVariant(4, 20, 0, 100)).toDouble(), 50.0);
+}
+
+void TestValueMapping::testDegenerateRange()
+{
+    ValueMappingEngine engine;
+    int handle = engine.compile(linearVariant(5, 5, 7, 9));
+    QCOMPARE(engine.mapWith(handle, 100.0).toDouble(), 7.0);
+}
+
+void TestValueMapping::testBinary()
+{
+    ValueMappingEngine engine;
+    int defaults = engine.compile({{"type", "binary"}});
+    QCOMPARE(engine.mapWith(defaults, "Open").toBool(), true);
+    QCOMPARE(engine.mapWith(defaults, "1").toBool(), true);
+    QCOMPARE(engine.mapWith(defaults, "Closed").toBool(), false);
+
+    int pattern = engine.compile({{"type", "binary"}, {"true_pattern", "^(track|slew)"}});
+    QCOMPARE(engine.mapWith(pattern, "Tracking").toBool(), true);
+    QCOMPARE(engine.mapWith(pattern, "parked").toBool(), false);
+
+    // An invalid pattern never matches rather than failing every update
+    int invalid = engine.compile({{"type", "binary"}, {"true_pattern", "(unclosed"}});
+    QCOMPARE(engine.mapWith(invalid, "(unclosed").toBool(), false);
+}
+
+void TestValueMapping::testIdentity()
+{
+    ValueMappingEngine engine;
+    QCOMPARE(engine.compile({}), 0);
+    QCOMPARE(engine.compile({{"type", "none"}}), 0);
+    QCOMPARE(engine.mapWith(0, "raw").toString(), QString("raw"));
+}
+
+void TestValueMapping::testHandlesAreShared()
+{
+    ValueMappingEngine engine;
+    int first = engine.compile(linearVariant(0, 90, 0, -90));
+    int second = engine.compile(linearVariant(0, 90, 0, -90));
+    int other = engine.compile(linearVariant(0, 90, 0, 90));
+    QCOMPARE(first, second);
+    QVERIFY(other != first);
+
+    // Fields the kind doesn't use don't split handles
+    QVariantMap withPattern = linearVariant(0, 90, 0, -90);
+    withPattern["true_pattern"] = "ignored";
+    QCOMPARE(engine.compile(withPattern), first);
+}
+
+void TestValueMapping::testUnknownHandle()
+{
+    ValueMappingEngine engine;
+    QCOMPARE(engine.mapWith(-1, 3.5).toDouble(), 3.5);
+    QCOMPARE(engine.mapWith(1000, 3.5).toDouble(), 3.5);
+}
+
+void TestValueMapping::testClamped()
+{
+    ValueMappingEngine engine;
+    QVariantMap mapping = linearVariant(4, 20, 100, 0);
+    mapping["type"] = "clamped";
+    int handle = engine.compile(mapping);
+
+    QCOMPARE(engine.mapWith(handle, 12.0).toDouble(), 50.0);
+    QCOMPARE(engine.mapWith(handle, 2.0).toDouble(), 100.0);
+    QCOMPARE(engine.mapWith(handle, 25.0).toDouble(), 0.0);
+
+    // Plain linear still extrapolates
+    int linear = engine.compile(linearVariant(4, 20, 100, 0));
+    QCOMPARE(engine.mapWith(linear, 25.0).toDouble(), -31.25);
+}
+
+void TestValueMapping::testAngleWrap()
+{
+    ValueMappingEngine engine;
+    QVariantMap mapping = linearVariant(0, 360, 0, 360);
+    mapping["type"] = "angle";
+    mapping["origin"] = -180;
+    int handle = engine.compile(mapping);
+
+    QCOMPARE(engine.mapWith(handle, 90.0).toDouble(), 90.0);
+    QCOMPARE(engine.mapWith(handle, 270.0).toDouble(), -90.0);
+    QCOMPARE(engine.mapWith(handle, 180.0).toDouble(), -180.0);
+    QCOMPARE(engine.mapWith(handle, -540.0).toDouble(), -180.0);
+    // Without unwrap the previous value doesn't matter
+    QCOMPARE(engine.mapFrom(handle, 270.0, 265.0).toDouble(), -90.0);
+}
+
+void TestValueMapping::testAngleUnwrap()
+{
+    // The default dome mapping: azimuth to a negative rotation about Y
+    ValueMappingEngine engine;
+    QVariantMap mapping = linearVariant(0, 360, 0, -360);
+    mapping["type"] = "angle";
+    mapping["unwrap"] = true;
+    int handle = engine.compile(mapping);
+
+    QVariant rotation;
+    QVector<double> path;
+    for (double azimuth : {357.0, 358.0, 359.0, 0.0, 1.0, 2.0}) {
+        rotation = engine.mapFrom(handle, azimuth, rotation);
+        path.append(rotation.toDouble());
+    }
+    // Each step is one degree: the model never swings the long way round
+    for (int i = 1; i < path.size(); ++i) {
+        QVERIFY2(std::abs(path[i] - path[i - 1] - -1.0) < 1e-9,
+                 qPrintable(QString("%1 -> %2").arg(path[i - 1]).arg(path[i])));
+    }
+
+    // Batch path gives the same continuous track
+    const double azimuths[] = {357.0, 358.0, 359.0, 0.0, 1.0, 2.0};
+    double track[6];
+    engine.mapSamples(handle, azimuths, track, 6);
+    QCOMPARE(track[0], path[0]);
+    for (int i = 1; i < 6; ++i) {
+        QVERIFY(std::abs(track[i] - track[i - 1] - -1.0) < 1e-9);
+    }
+}
+
+void TestValueMapping::testLookup()
+{
+    ValueMappingEngine engine;
+
+    // Evenly spaced points take the grid path, uneven ones the search
+    QVariantMap uniform = {{"type", "lut"},
+                           {"points", QVariantList{QVariantList{0, 0}, QVariantList{50, 10}, QVariantList{100, 40}}}};
+    QVariantMap uneven = {{"type", "lut"},
+                          {"points", QVariantList{QVariantList{100, 40}, QVariantList{0, 0}, QVariantList{10, 10}}}};
+    int grid = engine.compile(uniform);
+    int search = engine.compile(uneven);
+
+    QCOMPARE(engine.mapWith(grid, 25.0).toDouble(), 5.0);
+    QCOMPARE(engine.mapWith(grid, 75.0).toDouble(), 25.0);
+    QCOMPARE(engine.mapWith(grid, -10.0).toDouble(), 0.0);
+    QCOMPARE(engine.mapWith(grid, 150.0).toDouble(), 40.0);
+
+    // Unsorted input points are sorted at compile time
+    QCOMPARE(engine.mapWith(search, 5.0).toDouble(), 5.0);
+    QCOMPARE(engine.mapWith(search, 55.0).toDouble(), 25.0);
+    QCOMPARE(engine.mapWith(search, 100.0).toDouble(), 40.0);
+    QCOMPARE(engine.mapWith(search, 1000.0).toDouble(), 40.0);
+
+    // Batch matches per-value for both
+    std::vector<double> in = samples(301);
+    std::vector<double> out(in.size());
+    for (int handle : {grid, search}) {
+        engine.mapSamples(handle, in.data(), out.data(), qsizetype(in.size()));
+        for (size_t i = 0; i < in.size(); ++i) {
+            QCOMPARE(out[i], engine.mapping(handle).mapNumber(in[i]));
+        }
+    }
+
+    // A single point can't interpolate; it maps as identity
+    int single = engine.compile({{"type", "lut"}, {"points", QVariantList{QVariant(QVariantList{1, 2})}}});
+    QCOMPARE(engine.mapWith(single, 7.0).toDouble(), 7.0);
+}
+
+void TestValueMapping::testPolynomial()
+{
+    ValueMappingEngine engine;
+    // 1 + 2x + 0.5x^2
+    int handle = engine.compile({{"type", "polynomial"}, {"coefficients", QVariantList{1, 2, 0.5}}});
+    QCOMPARE(engine.mapWith(handle, 0.0).toDouble(), 1.0);
+    QCOMPARE(engine.mapWith(handle, 2.0).toDouble(), 7.0);
+    QCOMPARE(engine.mapWith(handle, -4.0).toDouble(), 1.0);
+
+    double in[] = {0.0, 2.0, -4.0};
+    engine.mapSamples(handle, in, in, 3);
+    QCOMPARE(in[1], 7.0);
+}
+
+void TestValueMapping::testVariantRoundTrip()
+{
+    MappingDefinition definition;
+    definition.type = "lut";
+    definition.points = {QPointF(0, 1), QPointF(10, 3)};
+    definition.coefficients = {1.5};
+    definition.period = 24.0;
+    definition.unwrap = true;
+
+    MappingDefinition copy = ValueMappingEngine::definitionFromVariant(
+        ValueMappingEngine::definitionToVariant(definition));
+    QCOMPARE(copy.type, definition.type);
+    QCOMPARE(copy.points, definition.points);
+    QCOMPARE(copy.coefficients, definition.coefficients);
+    QCOMPARE(copy.period, 24.0);
+    QVERIFY(copy.unwrap);
+}
+
+template <typename T>
+void TestValueMapping::runKernel(const QString& kernel, const T* in, T* out, qsizetype n)
+{
+    static const T table[] = {T(0), T(10), T(15), T(40), T(42)};
+    if (kernel == "linear") {
+        MappingKernels::linear(in, out, n, T(-1), T(360));
+    } else if (kernel == "clamp") {
+        MappingKernels::clamp(in, out, n, T(-10), T(90));
+    } else if (kernel == "wrap") {
+        MappingKernels::wrap(in, out, n, T(-180), T(360));
+    } else if (kernel == "lookup") {
+        MappingKernels::lookup(in, out, n, table, 5, T(-100), T(50));
+    }
+}
+
+std::vector<double> TestValueMapping::samples(qsizetype n)
+{
+    // Spread over several turns in both directions, hitting edges exactly
+    std::vector<double> values(n);
+    for (qsizetype i = 0; i < n; ++i) {
+        values[i] = (i - n / 2) * 1.37 + 0.001 * i * i;
+    }
+    if (n > 8) {
+        values[1] = 180.0;
+        values[2] = -180.0;
+        values[3] = 540.0;
+        values[4] = std::nan("");
+    }
+    return values;
+}
+
+void TestValueMapping::testKernels()
+{
+    const double in[] = {-720.5, -180.0, -0.25, 0.0, 179.999, 180.0, 359.5, 1e6};
+    double out[8];
+
+    MappingKernels::wrap(in, out, 8, -180.0, 360.0);
+    const double wrapped[] = {-0.5, -180.0, -0.25, 0.0, 179.999, -180.0, -0.5, -80.0};
+    for (int i = 0; i < 8; ++i) {
+        QVERIFY2(std::abs(out[i] - wrapped[i]) < 1e-9, qPrintable(QString::number(i)));
+    }
+
+    MappingKernels::clamp(in, out, 8, -10.0, 90.0);
+    QCOMPARE(out[0], -10.0);
+    QCOMPARE(out[2], -0.25);
+    QCOMPARE(out[7], 90.0);
+
+    // 0..100 mapped onto a bent curve
+    const double table[] = {0.0, 10.0, 40.0};
+    const double probes[] = {-5.0, 0.0, 25.0, 50.0, 75.0, 100.0, 500.0, std::nan("")};
+    MappingKernels::lookup(probes, out, 8, table, 3, 0.0, 50.0);
+    const double looked[] = {0.0, 0.0, 5.0, 10.0, 25.0, 40.0, 40.0, 0.0};
+    for (int i = 0; i < 8; ++i) {
+        QCOMPARE(out[i], looked[i]);
+    }
+}
+
+void TestValueMapping::testKernelsMatchAcrossIsa_data()
+{
+    QTest::addColumn<QString>("kernel");
+    for (const char* kernel : {"linear", "clamp", "wrap", "lookup"}) {
+        QTest::newRow(kernel) << QString(kernel);
+    }
+}
+
+void TestValueMapping::testKernelsMatchAcrossIsa()
+{
+    QFETCH(QString, kernel);
+    if (MappingKernels::bestIsa() == MappingKernels::Isa::Generic) {
+        QSKIP("No wider instruction set on this CPU");
+    }
+
+    // Odd length so the scalar tail runs too
+    const qsizetype n = 1003;
+    std::vector<double> in = samples(n);
+    std::vector<float> inF(in.begin(), in.end());
+    std::vector<double> generic(n), wide(n);
+    std::vector<float> genericF(n), wideF(n);
+
+    MappingKernels::setActiveIsa(MappingKernels::Isa::Generic);
+    runKernel(kernel, in.data(), generic.data(), n);
+    runKernel(kernel, inF.data(), genericF.data(), n);
+    MappingKernels::setActiveIsa(MappingKernels::bestIsa());
+    runKernel(kernel, in.data(), wide.data(), n);
+    runKernel(kernel, inF.data(), wideF.data(), n);
+
+    // Bit-identical, NaN included
+    QVERIFY(std::memcmp(generic.data(), wide.data(), n * sizeof(double)) == 0);
+    QVERIFY(std::memcmp(genericF.data(), wideF.data(), n * sizeof(float)) == 0);
+}
+
+void TestValueMapping::testMapSamples()
+{
+    ValueMappingEngine engine;
+    int handle = engine.compile(linearVariant(4, 20, 0, 100));
+    std::vector<double> in = samples(257);
+    std::vector<double> out(in.size());
+
+    engine.mapSamples(handle, in.data(), out.data(), qsizetype(in.size()));
+    for (size_t i = 5; i < in.size(); ++i) {
+        QCOMPARE(out[i], engine.mapping(handle).mapNumber(in[i]));
+    }
+
+    // In place, and float
+    std::vector<float> inF(in.begin(), in.end());
+    engine.mapSamples(handle, inF.data(), inF.data(), qsizetype(inF.size()));
+    QVERIFY(std::abs(inF[100] - float(out[100])) < 1e-2f);
+
+    // Identity and non-numeric kinds copy
+    int binary = engine.compile({{"type", "binary"}});
+    engine.mapSamples(binary, in.data(), out.data(), qsizetype(in.size()));
+    QCOMPARE(out[42], in[42]);
+}
+
+void TestValueMapping::benchmarkPerUpdate_data()
+{
+    QTest::addColumn<bool>("compiled");
+    QTest::addColumn<QVariantMap>("mapping");
+    QTest::addColumn<QVariant>("input");
+
+    QVariantMap linear = linearVariant(0, 360, 0, -360);
+    QVariantMap binary = {{"type", "binary"}, {"true_pattern", "^open"}};
+    QVariantMap angle = linear;
+    angle["type"] = "angle";
+    QVariantList points;
+    for (double x : {0.0, 1.0, 3.0, 7.0, 15.0, 31.0, 63.0, 127.0}) {
+        points.append(QVariant(QVariantList{x, std::sqrt(x)}));
+    }
+    QVariantMap lut = {{"type", "lut"}, {"points", points}};
+    QTest::newRow("linear/variant map") << false << linear << QVariant(123.4);
+    QTest::newRow("linear/handle") << true << linear << QVariant(123.4);
+    QTest::newRow("angle/handle") << true << angle << QVariant(123.4);
+    QTest::newRow("lut/variant map") << false << lut << QVariant(50.0);
+    QTest::newRow("lut/handle") << true << lut << QVariant(50.0);
+    QTest::newRow("binary/variant map") << false << binary << QVariant("Opening");
+    QTest::newRow("binary/handle") << true << binary << QVariant("Opening");
+}
+
+void TestValueMapping::benchmarkPerUpdate()
+{
+    QFETCH(bool, compiled);
+    QFETCH(QVariantMap, mapping);
+    QFETCH(QVariant, input);
+
+    // What one property update costs the UI thread
+    ValueMappingEngine engine;
+    int handle = engine.compile(mapping);
+    QVariant result;
+    if (compiled) {
+        QBENCHMARK {
+            result = engine.mapWith(handle, input);
+        }
+    } else {
+        QBENCHMARK {
+            result = engine.mapValue(input, mapping);
+        }
+    }
+    QVERIFY(result.isValid());
+}
+
+void TestValueMapping::benchmarkSamples_data()
+{
+    QTest::addColumn<QString>("kernel");
+    QTest::addColumn<bool>("perSample");
+    QTest::addColumn<int>("isa");
+
+    const int generic = int(MappingKernels::Isa::Generic);
+    const int best = int(MappingKernels::bestIsa());
+    const QString bestName = MappingKernels::isaName(MappingKernels::bestIsa());
+
+    // What a trend chart would pay mapping one QVariant at a time
+    QTest::newRow("linear/per-QVariant") << QString("linear") << true << generic;
+    for (const char* kernel : {"linear", "clamp", "wrap", "lookup"}) {
+        QTest::addRow("%s/generic", kernel) << QString(kernel) << false << generic;
+        if (best != generic) {
+            QTest::addRow("%s/%s", kernel, qPrintable(bestName)) << QString(kernel) << false << best;
+        }
+    }
+}
+
+void TestValueMapping::benchmarkSamples()
+{
+    QFETCH(QString, kernel);
+    QFETCH(bool, perSample);
+    QFETCH(int, isa);
+
+    const qsizetype n = 4096;
+    std::vector<double> in = samples(n);
+    std::vector<double> out(n);
+    MappingKernels::setActiveIsa(MappingKernels::Isa(isa));
+
+    if (perSample) {
+        CompiledMapping linear(ValueMappingEngine::definitionFromVariant(linearVariant(0, 360, 360, 0)));
+        QBENCHMARK {
+            for (qsizetype i = 0; i < n; ++i) {
+                out[i] = linear.map(in[i]).toDouble();
+            }
+        }
+    } else {
+        QBENCHMARK {
+            runKernel(kernel, in.data(), out.data(), n);
+        }
+    }
+
+    MappingKernels::setActiveIsa(MappingKernels::bestIsa());
+}
+
+QTEST_GUILESS_MAIN(TestValueMapping)
+#include "test_value_mapping.moc"